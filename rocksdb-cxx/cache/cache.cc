@@ -64,6 +64,30 @@ static std::unordered_map<std::string, OptionTypeInfo>
                    enable_custom_split_merge),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"num_decompression_threads",
+         {offsetof(struct CompressedSecondaryCacheOptions,
+                   num_decompression_threads),
+          OptionType::kInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+};
+
+static std::unordered_map<std::string, OptionTypeInfo>
+    file_sec_cache_options_type_info = {
+        {"dir",
+         {offsetof(struct FileSecondaryCacheOptions, dir), OptionType::kString,
+          OptionVerificationType::kNormal, OptionTypeFlags::kNone}},
+        {"capacity",
+         {offsetof(struct FileSecondaryCacheOptions, capacity),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
+        {"segment_size",
+         {offsetof(struct FileSecondaryCacheOptions, segment_size),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"num_threads",
+         {offsetof(struct FileSecondaryCacheOptions, num_threads),
+          OptionType::kInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
 };
 
 Status SecondaryCache::CreateFromString(
@@ -84,6 +108,22 @@ Status SecondaryCache::CreateFromString(
     }
 
 
+    if (status.ok()) {
+      result->swap(sec_cache);
+    }
+    return status;
+  } else if (value.find("file_secondary_cache://") == 0) {
+    std::string args = value;
+    args.erase(0, std::strlen("file_secondary_cache://"));
+    std::shared_ptr<SecondaryCache> sec_cache;
+
+    FileSecondaryCacheOptions sec_cache_opts;
+    Status status = OptionTypeInfo::ParseStruct(
+        config_options, "", &file_sec_cache_options_type_info, "", args,
+        &sec_cache_opts);
+    if (status.ok()) {
+      status = NewFileSecondaryCache(sec_cache_opts, &sec_cache);
+    }
     if (status.ok()) {
       result->swap(sec_cache);
     }
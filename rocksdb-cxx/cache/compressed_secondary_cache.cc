@@ -6,6 +6,7 @@
 #include "cache/compressed_secondary_cache.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <memory>
 
@@ -18,16 +19,109 @@ namespace ROCKSDB_NAMESPACE {
 
 CompressedSecondaryCache::CompressedSecondaryCache(
     const CompressedSecondaryCacheOptions& opts)
-    : cache_(opts.LRUCacheOptions::MakeSharedCache()), cache_options_(opts) {}
+    : cache_(opts.LRUCacheOptions::MakeSharedCache()), cache_options_(opts) {
+  if (opts.num_decompression_threads > 0) {
+    decompression_pool_.reset(NewThreadPool(opts.num_decompression_threads));
+  }
+}
 
-CompressedSecondaryCache::~CompressedSecondaryCache() { cache_.reset(); }
+CompressedSecondaryCache::~CompressedSecondaryCache() {
+  if (decompression_pool_) {
+    decompression_pool_->JoinAllThreads();
+  }
+  cache_.reset();
+}
+
+CompressedSecondaryCacheResultHandle::~CompressedSecondaryCacheResultHandle() {
+  if (lru_handle_ != nullptr) {
+    // Never waited on
+    cache_->cache_->Release(lru_handle_, /*erase_if_last_ref=*/false);
+  }
+}
+
+void CompressedSecondaryCacheResultHandle::Wait() {
+  if (!is_ready_) {
+    Uncompress();
+    Complete();
+  }
+}
+
+void CompressedSecondaryCacheResultHandle::Uncompress() {
+  assert(lru_handle_ != nullptr);
+  const CompressedSecondaryCacheOptions& opts = cache_->cache_options_;
+  void* handle_value = cache_->cache_->Value(lru_handle_);
+
+  CacheAllocationPtr merged_value;
+  const char* data{nullptr};
+  size_t handle_value_charge{0};
+  if (opts.enable_custom_split_merge) {
+    merged_value =
+        cache_->MergeChunksIntoValue(handle_value, handle_value_charge);
+    data = merged_value.get();
+  } else {
+    data = reinterpret_cast<CacheAllocationPtr*>(handle_value)->get();
+    handle_value_charge = cache_->cache_->GetCharge(lru_handle_);
+  }
+
+  if (opts.compression_type == kNoCompression ||
+      opts.do_not_compress_roles.Contains(helper_->role)) {
+    // Either points into the pinned entry or into the merged copy.
+    uncompressed_buf_ = std::move(merged_value);
+    uncompressed_ = Slice(data, handle_value_charge);
+    uncompressed_ok_ = true;
+    return;
+  }
+
+  UncompressionContext uncompression_context(opts.compression_type);
+  UncompressionInfo uncompression_info(uncompression_context,
+                                       UncompressionDict::GetEmptyDict(),
+                                       opts.compression_type);
+  size_t uncompressed_size{0};
+  uncompressed_buf_ = UncompressData(
+      uncompression_info, data, handle_value_charge, &uncompressed_size,
+      opts.compress_format_version, opts.memory_allocator.get());
+  if (uncompressed_buf_) {
+    uncompressed_ = Slice(uncompressed_buf_.get(), uncompressed_size);
+    uncompressed_ok_ = true;
+  }
+}
+
+void CompressedSecondaryCacheResultHandle::Complete() {
+  assert(lru_handle_ != nullptr);
+  Cache* lru_cache = cache_->cache_.get();
+  Status s;
+  if (uncompressed_ok_) {
+    s = helper_->create_cb(uncompressed_, create_context_,
+                           cache_->cache_options_.memory_allocator.get(),
+                           &value_, &size_);
+  }
+  uncompressed_ = Slice();
+  uncompressed_buf_.reset();
+
+  if (!uncompressed_ok_ || !s.ok()) {
+    value_ = nullptr;
+    size_ = 0;
+    lru_cache->Release(lru_handle_, /*erase_if_last_ref=*/true);
+  } else if (advise_erase_) {
+    lru_cache->Release(lru_handle_, /*erase_if_last_ref=*/true);
+    // Insert a dummy handle.
+    const bool split_merge = cache_->cache_options_.enable_custom_split_merge;
+    lru_cache
+        ->Insert(key_, /*obj=*/nullptr, cache_->GetHelper(split_merge),
+                 /*charge=*/0)
+        .PermitUncheckedError();
+  } else {
+    lru_cache->Release(lru_handle_, /*erase_if_last_ref=*/false);
+  }
+  lru_handle_ = nullptr;
+  is_ready_ = true;
+}
 
 std::unique_ptr<SecondaryCacheResultHandle> CompressedSecondaryCache::Lookup(
     const Slice& key, const Cache::CacheItemHelper* helper,
-    Cache::CreateContext* create_context, bool /*wait*/, bool advise_erase,
+    Cache::CreateContext* create_context, bool wait, bool advise_erase,
     bool& kept_in_sec_cache) {
   assert(helper);
-  std::unique_ptr<SecondaryCacheResultHandle> handle;
   kept_in_sec_cache = false;
   Cache::Handle* lru_handle = cache_->Lookup(key);
   if (lru_handle == nullptr) {
@@ -40,83 +134,105 @@ std::unique_ptr<SecondaryCacheResultHandle> CompressedSecondaryCache::Lookup(
     return nullptr;
   }
 
-  CacheAllocationPtr* ptr{nullptr};
-  CacheAllocationPtr merged_value;
-  size_t handle_value_charge{0};
-  if (cache_options_.enable_custom_split_merge) {
-    CacheValueChunk* value_chunk_ptr =
-        reinterpret_cast<CacheValueChunk*>(handle_value);
-    merged_value = MergeChunksIntoValue(value_chunk_ptr, handle_value_charge);
-    ptr = &merged_value;
-  } else {
-    ptr = reinterpret_cast<CacheAllocationPtr*>(handle_value);
-    handle_value_charge = cache_->GetCharge(lru_handle);
+  // The handle keeps the entry pinned until it is completed.
+  std::unique_ptr<CompressedSecondaryCacheResultHandle> handle(
+      new CompressedSecondaryCacheResultHandle(this, key, lru_handle, helper,
+                                               create_context, advise_erase));
+  if (wait) {
+    handle->Wait();
+    if (handle->Value() == nullptr) {
+      return nullptr;
+    }
   }
-  MemoryAllocator* allocator = cache_options_.memory_allocator.get();
+  // For a pending handle, a failure to uncompress or create the object is
+  // reported later through a nullptr Value().
+  kept_in_sec_cache = !advise_erase;
+  return handle;
+}
 
-  Status s;
-  Cache::ObjectPtr value{nullptr};
-  size_t charge{0};
-  if (cache_options_.compression_type == kNoCompression ||
-      cache_options_.do_not_compress_roles.Contains(helper->role)) {
-    s = helper->create_cb(Slice(ptr->get(), handle_value_charge),
-                          create_context, allocator, &value, &charge);
-  } else {
-    UncompressionContext uncompression_context(cache_options_.compression_type);
-    UncompressionInfo uncompression_info(uncompression_context,
-                                         UncompressionDict::GetEmptyDict(),
-                                         cache_options_.compression_type);
-
-    size_t uncompressed_size{0};
-    CacheAllocationPtr uncompressed = UncompressData(
-        uncompression_info, (char*)ptr->get(), handle_value_charge,
-        &uncompressed_size, cache_options_.compress_format_version, allocator);
-
-    if (!uncompressed) {
-      cache_->Release(lru_handle, /*erase_if_last_ref=*/true);
-      return nullptr;
+void CompressedSecondaryCache::WaitAll(
+    std::vector<SecondaryCacheResultHandle*> handles) {
+  std::vector<CompressedSecondaryCacheResultHandle*> pending;
+  for (SecondaryCacheResultHandle* h : handles) {
+    auto handle = static_cast<CompressedSecondaryCacheResultHandle*>(h);
+    if (!handle->IsReady()) {
+      pending.push_back(handle);
     }
-    s = helper->create_cb(Slice(uncompressed.get(), uncompressed_size),
-                          create_context, allocator, &value, &charge);
+  }
+  if (pending.empty()) {
+    return;
   }
 
-  if (!s.ok()) {
-    cache_->Release(lru_handle, /*erase_if_last_ref=*/true);
-    return nullptr;
+  // Decompression is the expensive part, so spread it over the pool and this
+  // thread. Creating objects and releasing the pinned entries stays on this
+  // thread.
+  std::atomic<size_t> next{0};
+  auto uncompress_pending = [&pending, &next]() {
+    for (size_t i = next.fetch_add(1); i < pending.size();
+         i = next.fetch_add(1)) {
+      pending[i]->Uncompress();
+    }
+  };
+  size_t num_helpers = 0;
+  if (decompression_pool_) {
+    num_helpers = std::min(
+        static_cast<size_t>(decompression_pool_->GetBackgroundThreads()),
+        pending.size() - 1);
+  }
+  port::Mutex mu;
+  port::CondVar cv(&mu);
+  size_t helpers_done = 0;
+  for (size_t i = 0; i < num_helpers; ++i) {
+    decompression_pool_->SubmitJob([&]() {
+      uncompress_pending();
+      MutexLock l(&mu);
+      ++helpers_done;
+      cv.SignalAll();
+    });
+  }
+  uncompress_pending();
+  {
+    MutexLock l(&mu);
+    while (helpers_done < num_helpers) {
+      cv.Wait();
+    }
   }
 
-  if (advise_erase) {
-    cache_->Release(lru_handle, /*erase_if_last_ref=*/true);
-    // Insert a dummy handle.
-    cache_
-        ->Insert(key, /*obj=*/nullptr,
-                 GetHelper(cache_options_.enable_custom_split_merge),
-                 /*charge=*/0)
-        .PermitUncheckedError();
-  } else {
-    kept_in_sec_cache = true;
-    cache_->Release(lru_handle, /*erase_if_last_ref=*/false);
+  for (CompressedSecondaryCacheResultHandle* handle : pending) {
+    handle->Complete();
   }
-  handle.reset(new CompressedSecondaryCacheResultHandle(value, charge));
-  return handle;
 }
 
 Status CompressedSecondaryCache::Insert(const Slice& key,
                                         Cache::ObjectPtr value,
                                         const Cache::CacheItemHelper* helper) {
+  return InsertInternal(key, value, helper, /*force_insert=*/false);
+}
+
+Status CompressedSecondaryCache::InsertAdmitted(
+    const Slice& key, Cache::ObjectPtr value,
+    const Cache::CacheItemHelper* helper) {
+  return InsertInternal(key, value, helper, /*force_insert=*/true);
+}
+
+Status CompressedSecondaryCache::InsertInternal(
+    const Slice& key, Cache::ObjectPtr value,
+    const Cache::CacheItemHelper* helper, bool force_insert) {
   if (value == nullptr) {
     return Status::InvalidArgument();
   }
 
-  Cache::Handle* lru_handle = cache_->Lookup(key);
   auto internal_helper = GetHelper(cache_options_.enable_custom_split_merge);
-  if (lru_handle == nullptr) {
-    PERF_COUNTER_ADD(compressed_sec_cache_insert_dummy_count, 1);
-    // Insert a dummy handle if the handle is evicted for the first time.
-    return cache_->Insert(key, /*obj=*/nullptr, internal_helper,
-                          /*charge=*/0);
-  } else {
-    cache_->Release(lru_handle, /*erase_if_last_ref=*/false);
+  if (!force_insert) {
+    Cache::Handle* lru_handle = cache_->Lookup(key);
+    if (lru_handle == nullptr) {
+      PERF_COUNTER_ADD(compressed_sec_cache_insert_dummy_count, 1);
+      // Insert a dummy handle if the handle is evicted for the first time.
+      return cache_->Insert(key, /*obj=*/nullptr, internal_helper,
+                            /*charge=*/0);
+    } else {
+      cache_->Release(lru_handle, /*erase_if_last_ref=*/false);
+    }
   }
 
   size_t size = (*helper->size_cb)(value);
@@ -197,6 +313,9 @@ std::string CompressedSecondaryCache::GetPrintableOptions() const {
   snprintf(buffer, kBufferSize, "    compress_format_version : %d\n",
            cache_options_.compress_format_version);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    num_decompression_threads : %d\n",
+           cache_options_.num_decompression_threads);
+  ret.append(buffer);
   return ret;
 }
 
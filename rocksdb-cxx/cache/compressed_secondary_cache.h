@@ -8,39 +8,80 @@
 #include <array>
 #include <cstddef>
 #include <memory>
+#include <string>
 
 #include "cache/lru_cache.h"
 #include "memory/memory_allocator.h"
 #include "rocksdb/secondary_cache.h"
 #include "rocksdb/slice.h"
 #include "rocksdb/status.h"
+#include "rocksdb/threadpool.h"
 #include "util/compression.h"
 #include "util/mutexlock.h"
 
 namespace ROCKSDB_NAMESPACE {
 
+class CompressedSecondaryCache;
+
+// A lookup result from CompressedSecondaryCache. Lookups with wait=true are
+// completed before being returned. Lookups with wait=false only pin the
+// compressed entry; the (potentially expensive) decompression is deferred to
+// Wait() or CompressedSecondaryCache::WaitAll(), which can spread a batch of
+// pending handles over several threads.
 class CompressedSecondaryCacheResultHandle : public SecondaryCacheResultHandle {
  public:
   CompressedSecondaryCacheResultHandle(Cache::ObjectPtr value, size_t size)
-      : value_(value), size_(size) {}
-  ~CompressedSecondaryCacheResultHandle() override = default;
+      : value_(value), size_(size), is_ready_(true) {}
+  CompressedSecondaryCacheResultHandle(CompressedSecondaryCache* cache,
+                                       const Slice& key,
+                                       Cache::Handle* lru_handle,
+                                       const Cache::CacheItemHelper* helper,
+                                       Cache::CreateContext* create_context,
+                                       bool advise_erase)
+      : cache_(cache),
+        key_(key.ToString()),
+        lru_handle_(lru_handle),
+        helper_(helper),
+        create_context_(create_context),
+        advise_erase_(advise_erase) {}
+  ~CompressedSecondaryCacheResultHandle() override;
 
   CompressedSecondaryCacheResultHandle(
       const CompressedSecondaryCacheResultHandle&) = delete;
   CompressedSecondaryCacheResultHandle& operator=(
       const CompressedSecondaryCacheResultHandle&) = delete;
 
-  bool IsReady() override { return true; }
+  bool IsReady() override { return is_ready_; }
 
-  void Wait() override {}
+  void Wait() override;
 
   Cache::ObjectPtr Value() override { return value_; }
 
   size_t Size() override { return size_; }
 
  private:
-  Cache::ObjectPtr value_;
-  size_t size_;
+  friend class CompressedSecondaryCache;
+
+  // Phase 1 (thread-safe, no side effects on the cache): produce the
+  // uncompressed form of the pinned entry.
+  void Uncompress();
+  // Phase 2: create the object and release the pinned entry.
+  void Complete();
+
+  Cache::ObjectPtr value_ = nullptr;
+  size_t size_ = 0;
+  bool is_ready_ = false;
+
+  // Only used while pending
+  CompressedSecondaryCache* cache_ = nullptr;
+  std::string key_;
+  Cache::Handle* lru_handle_ = nullptr;
+  const Cache::CacheItemHelper* helper_ = nullptr;
+  Cache::CreateContext* create_context_ = nullptr;
+  bool advise_erase_ = false;
+  bool uncompressed_ok_ = false;
+  Slice uncompressed_;
+  CacheAllocationPtr uncompressed_buf_;
 };
 
 // The CompressedSecondaryCache is a concrete implementation of
@@ -78,6 +119,9 @@ class CompressedSecondaryCache : public SecondaryCache {
   Status Insert(const Slice& key, Cache::ObjectPtr value,
                 const Cache::CacheItemHelper* helper) override;
 
+  Status InsertAdmitted(const Slice& key, Cache::ObjectPtr value,
+                        const Cache::CacheItemHelper* helper) override;
+
   std::unique_ptr<SecondaryCacheResultHandle> Lookup(
       const Slice& key, const Cache::CacheItemHelper* helper,
       Cache::CreateContext* create_context, bool /*wait*/, bool advise_erase,
@@ -87,7 +131,7 @@ class CompressedSecondaryCache : public SecondaryCache {
 
   void Erase(const Slice& key) override;
 
-  void WaitAll(std::vector<SecondaryCacheResultHandle*> /*handles*/) override {}
+  void WaitAll(std::vector<SecondaryCacheResultHandle*> handles) override;
 
   Status SetCapacity(size_t capacity) override;
 
@@ -97,6 +141,7 @@ class CompressedSecondaryCache : public SecondaryCache {
 
  private:
   friend class CompressedSecondaryCacheTestBase;
+  friend class CompressedSecondaryCacheResultHandle;
   static constexpr std::array<uint16_t, 8> malloc_bin_sizes_{
       128, 256, 512, 1024, 2048, 4096, 8192, 16384};
 
@@ -110,6 +155,12 @@ class CompressedSecondaryCache : public SecondaryCache {
     void Free() { delete[] reinterpret_cast<char*>(this); }
   };
 
+  // With `force_insert` false, the first insertion of a key only leaves a
+  // dummy entry behind.
+  Status InsertInternal(const Slice& key, Cache::ObjectPtr value,
+                        const Cache::CacheItemHelper* helper,
+                        bool force_insert);
+
   // Split value into chunks to better fit into jemalloc bins. The chunks
   // are stored in CacheValueChunk and extra charge is needed for each chunk,
   // so the cache charge is recalculated here.
@@ -127,6 +178,9 @@ class CompressedSecondaryCache : public SecondaryCache {
   std::shared_ptr<Cache> cache_;
   CompressedSecondaryCacheOptions cache_options_;
   mutable port::Mutex capacity_mutex_;
+  // Helps WaitAll() decompress a batch of pending lookups in parallel.
+  // nullptr if num_decompression_threads == 0.
+  std::unique_ptr<ThreadPool> decompression_pool_;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -863,6 +863,85 @@ TEST_P(CompressedSecondaryCacheTestWithCompressionParam,
   IntegrationFullCapacityTest(sec_cache_is_compressed_);
 }
 
+TEST_P(CompressedSecondaryCacheTestWithCompressionParam, AsyncLookupWaitAll) {
+  for (int num_threads : {0, 3}) {
+    CompressedSecondaryCacheOptions opts;
+    opts.capacity = 1 << 20;
+    opts.num_shard_bits = 0;
+    opts.num_decompression_threads = num_threads;
+    if (!sec_cache_is_compressed_ || !LZ4_Supported()) {
+      opts.compression_type = CompressionType::kNoCompression;
+    }
+    std::shared_ptr<SecondaryCache> sec_cache =
+        NewCompressedSecondaryCache(opts);
+
+    Random rnd(301);
+    const int kNumItems = 20;
+    std::vector<std::string> keys;
+    std::vector<std::string> values;
+    for (int i = 0; i < kNumItems; ++i) {
+      keys.push_back("____    ____key" + std::to_string(100 + i));
+      values.push_back(rnd.RandomString(1000));
+      TestItem item(values.back().data(), values.back().length());
+      // First insert only leaves a dummy
+      ASSERT_OK(sec_cache->Insert(keys.back(), &item, GetHelper()));
+      ASSERT_OK(sec_cache->Insert(keys.back(), &item, GetHelper()));
+    }
+
+    std::vector<std::unique_ptr<SecondaryCacheResultHandle>> handles;
+    std::vector<SecondaryCacheResultHandle*> handle_ptrs;
+    for (int i = 0; i < kNumItems; ++i) {
+      bool kept_in_sec_cache = false;
+      // Erase every other entry on completion
+      handles.push_back(sec_cache->Lookup(keys[i], GetHelper(), this,
+                                          /*wait=*/false,
+                                          /*advise_erase=*/i % 2 == 0,
+                                          kept_in_sec_cache));
+      ASSERT_NE(handles.back(), nullptr);
+      ASSERT_FALSE(handles.back()->IsReady());
+      ASSERT_EQ(kept_in_sec_cache, i % 2 != 0);
+      handle_ptrs.push_back(handles.back().get());
+    }
+    // An unused pending handle must not leak its pinned entry
+    bool kept_in_sec_cache = false;
+    ASSERT_NE(sec_cache->Lookup(keys[1], GetHelper(), this, /*wait=*/false,
+                                /*advise_erase=*/false, kept_in_sec_cache),
+              nullptr);
+
+    sec_cache->WaitAll(handle_ptrs);
+    for (int i = 0; i < kNumItems; ++i) {
+      ASSERT_TRUE(handles[i]->IsReady());
+      std::unique_ptr<TestItem> val(
+          static_cast<TestItem*>(handles[i]->Value()));
+      ASSERT_NE(val, nullptr);
+      ASSERT_EQ(val->ToString(), values[i]);
+    }
+
+    for (int i = 0; i < kNumItems; ++i) {
+      std::unique_ptr<SecondaryCacheResultHandle> handle =
+          sec_cache->Lookup(keys[i], GetHelper(), this, /*wait=*/true,
+                            /*advise_erase=*/false, kept_in_sec_cache);
+      if (i % 2 == 0) {
+        ASSERT_EQ(handle, nullptr);
+      } else {
+        ASSERT_NE(handle, nullptr);
+        delete static_cast<TestItem*>(handle->Value());
+      }
+    }
+
+    // Failures to create the object surface as a nullptr value
+    SetFailCreate(true);
+    std::unique_ptr<SecondaryCacheResultHandle> handle =
+        sec_cache->Lookup(keys[1], GetHelper(), this, /*wait=*/false,
+                          /*advise_erase=*/false, kept_in_sec_cache);
+    ASSERT_NE(handle, nullptr);
+    sec_cache->WaitAll({handle.get()});
+    ASSERT_TRUE(handle->IsReady());
+    ASSERT_EQ(handle->Value(), nullptr);
+    SetFailCreate(false);
+  }
+}
+
 TEST_P(CompressedSecondaryCacheTestWithCompressionParam, EntryRoles) {
   CompressedSecondaryCacheOptions opts;
   opts.capacity = 2048;
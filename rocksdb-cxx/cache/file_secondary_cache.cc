@@ -0,0 +1,523 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/file_secondary_cache.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+#include <limits>
+
+#include "util/coding.h"
+#include "util/crc32c.h"
+#include "util/string_util.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+const std::string kSegmentFileSuffix = ".seccache";
+}  // namespace
+
+struct FileSecondaryCache::Segment {
+  Segment(std::shared_ptr<FileSystem> _fs, std::string _fname)
+      : fs(std::move(_fs)), fname(std::move(_fname)) {}
+
+  // The file goes away with the last reference, so that reads still in
+  // flight on a reclaimed segment can complete.
+  ~Segment() {
+    reader.reset();
+    fs->DeleteFile(fname, IOOptions(), nullptr).PermitUncheckedError();
+  }
+
+  std::shared_ptr<FileSystem> fs;
+  std::string fname;
+  std::unique_ptr<FSRandomAccessFile> reader;
+  // Bytes appended so far. Only changes while this is the active segment.
+  uint64_t size = 0;
+  // Keys of the records appended, in order, so that reclaim can find the
+  // index entries still pointing into this segment.
+  std::vector<std::string> keys;
+};
+
+// State shared between a pending lookup and the thread performing its read.
+// Whoever wins TryClaim() does the read; everyone else waits for kDone.
+struct FileSecondaryCache::ReadState {
+  enum Phase : int { kQueued, kReading, kDone };
+
+  ReadState(std::shared_ptr<Segment> _segment, uint64_t _offset, size_t _size)
+      : segment(std::move(_segment)),
+        offset(_offset),
+        size(_size),
+        buf(new char[_size]),
+        cv(&mu) {}
+
+  bool TryClaim() {
+    int expected = kQueued;
+    return phase.compare_exchange_strong(expected, kReading);
+  }
+
+  void Finish() {
+    MutexLock l(&mu);
+    phase.store(kDone);
+    cv.SignalAll();
+  }
+
+  void WaitDone() {
+    MutexLock l(&mu);
+    while (phase.load() != kDone) {
+      cv.Wait();
+    }
+  }
+
+  std::shared_ptr<Segment> segment;
+  uint64_t offset;
+  size_t size;
+  std::unique_ptr<char[]> buf;
+  Slice result;
+  IOStatus status;
+  std::atomic<int> phase{kQueued};
+  port::Mutex mu;
+  port::CondVar cv;
+};
+
+class FileSecondaryCache::ResultHandle : public SecondaryCacheResultHandle {
+ public:
+  ResultHandle(const Slice& key, const Cache::CacheItemHelper* helper,
+               Cache::CreateContext* create_context,
+               std::shared_ptr<ReadState> state)
+      : key_(key.ToString()),
+        helper_(helper),
+        create_context_(create_context),
+        state_(std::move(state)) {}
+  ~ResultHandle() override = default;
+
+  ResultHandle(const ResultHandle&) = delete;
+  ResultHandle& operator=(const ResultHandle&) = delete;
+
+  bool IsReady() override { return ready_; }
+
+  void Wait() override {
+    if (ready_) {
+      return;
+    }
+    if (state_->TryClaim()) {
+      ReadBatch(state_->segment.get(), {state_.get()});
+    } else {
+      state_->WaitDone();
+    }
+    Complete();
+  }
+
+  Cache::ObjectPtr Value() override {
+    assert(ready_);
+    return value_;
+  }
+
+  size_t Size() override { return charge_; }
+
+  ReadState* state() const { return state_.get(); }
+
+ private:
+  // Verify the record read from disk and turn it into a cache object.
+  // REQUIRES: the read has finished.
+  void Complete() {
+    ready_ = true;
+    std::shared_ptr<ReadState> state = std::move(state_);
+    if (!state->status.ok() || state->result.size() != state->size) {
+      return;
+    }
+    const char* p = state->result.data();
+    const uint32_t key_size = DecodeFixed32(p);
+    const uint32_t value_size = DecodeFixed32(p + 4);
+    if (kRecordHeaderSize + size_t{key_size} + value_size +
+            kRecordTrailerSize !=
+        state->size) {
+      return;
+    }
+    const size_t crc_offset = state->size - kRecordTrailerSize;
+    if (crc32c::Unmask(DecodeFixed32(p + crc_offset)) !=
+        crc32c::Value(p, crc_offset)) {
+      return;
+    }
+    if (Slice(p + kRecordHeaderSize, key_size) != Slice(key_)) {
+      return;
+    }
+    Status s = helper_->create_cb(
+        Slice(p + kRecordHeaderSize + key_size, value_size), create_context_,
+        /*allocator=*/nullptr, &value_, &charge_);
+    if (!s.ok()) {
+      value_ = nullptr;
+      charge_ = 0;
+    }
+  }
+
+  std::string key_;
+  const Cache::CacheItemHelper* helper_;
+  Cache::CreateContext* create_context_;
+  std::shared_ptr<ReadState> state_;
+  bool ready_ = false;
+  Cache::ObjectPtr value_ = nullptr;
+  size_t charge_ = 0;
+};
+
+FileSecondaryCache::FileSecondaryCache(const FileSecondaryCacheOptions& opts)
+    : opts_(opts),
+      fs_(opts.fs ? opts.fs : FileSystem::Default()),
+      thread_pool_(NewThreadPool(std::max(opts.num_threads, 1))),
+      reclaim_cv_(&mutex_),
+      capacity_(opts.capacity) {}
+
+FileSecondaryCache::~FileSecondaryCache() {
+  thread_pool_->WaitForJobsAndJoinAllThreads();
+  if (active_writer_) {
+    active_writer_->Close(IOOptions(), nullptr).PermitUncheckedError();
+  }
+}
+
+Status FileSecondaryCache::Open() {
+  if (opts_.dir.empty()) {
+    return Status::InvalidArgument("FileSecondaryCache needs a directory");
+  }
+  if (opts_.segment_size == 0) {
+    return Status::InvalidArgument("FileSecondaryCache segment_size is 0");
+  }
+  IOStatus s = fs_->CreateDirIfMissing(opts_.dir, IOOptions(), nullptr);
+  std::vector<std::string> children;
+  if (s.ok()) {
+    s = fs_->GetChildren(opts_.dir, IOOptions(), &children, nullptr);
+  }
+  for (const auto& child : children) {
+    if (!s.ok()) {
+      break;
+    }
+    if (EndsWith(child, kSegmentFileSuffix)) {
+      s = fs_->DeleteFile(opts_.dir + "/" + child, IOOptions(), nullptr);
+    }
+  }
+  return s;
+}
+
+Status FileSecondaryCache::Insert(const Slice& key, Cache::ObjectPtr value,
+                                  const Cache::CacheItemHelper* helper) {
+  if (value == nullptr) {
+    return Status::InvalidArgument();
+  }
+  assert(helper && helper->IsSecondaryCacheCompatible());
+
+  std::string key_str = key.ToString();
+  {
+    MutexLock l(&mutex_);
+    if (index_.find(key_str) != index_.end()) {
+      // Already on disk. Cache keys identify immutable contents.
+      return Status::OK();
+    }
+    if (usage_ >= capacity_ + opts_.segment_size) {
+      // Reclaim has fallen behind; drop the entry rather than grow further.
+      return Status::OK();
+    }
+  }
+
+  const size_t value_size = helper->size_cb(value);
+  if (value_size > std::numeric_limits<uint32_t>::max() ||
+      key.size() > std::numeric_limits<uint32_t>::max()) {
+    return Status::OK();
+  }
+  std::string record;
+  record.resize(kRecordHeaderSize + key.size() + value_size +
+                kRecordTrailerSize);
+  EncodeFixed32(&record[0], static_cast<uint32_t>(key.size()));
+  EncodeFixed32(&record[4], static_cast<uint32_t>(value_size));
+  memcpy(&record[kRecordHeaderSize], key.data(), key.size());
+  Status s = helper->saveto_cb(value, 0, value_size,
+                               &record[kRecordHeaderSize + key.size()]);
+  if (!s.ok()) {
+    return s;
+  }
+  const size_t crc_offset = record.size() - kRecordTrailerSize;
+  EncodeFixed32(&record[crc_offset],
+                crc32c::Mask(crc32c::Value(record.data(), crc_offset)));
+
+  MutexLock wl(&write_mutex_);
+  return AppendRecord(key_str, record, /*relocated_from=*/nullptr);
+}
+
+Status FileSecondaryCache::AppendRecord(const std::string& key,
+                                        const Slice& record,
+                                        const Segment* relocated_from) {
+  write_mutex_.AssertHeld();
+  std::shared_ptr<Segment> active;
+  {
+    MutexLock l(&mutex_);
+    if (!segments_.empty()) {
+      active = segments_.back();
+    }
+  }
+  if (active == nullptr || active_writer_ == nullptr ||
+      (active->size > 0 &&
+       active->size + record.size() > opts_.segment_size)) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "/%06" PRIu64, next_segment_id_++);
+    std::string fname = opts_.dir + buf + kSegmentFileSuffix;
+    std::unique_ptr<FSWritableFile> writer;
+    IOStatus io_s = fs_->NewWritableFile(fname, FileOptions(), &writer, nullptr);
+    if (!io_s.ok()) {
+      return io_s;
+    }
+    auto segment = std::make_shared<Segment>(fs_, fname);
+    io_s = fs_->NewRandomAccessFile(fname, FileOptions(), &segment->reader,
+                                    nullptr);
+    if (!io_s.ok()) {
+      return io_s;
+    }
+    if (active_writer_) {
+      active_writer_->Close(IOOptions(), nullptr).PermitUncheckedError();
+    }
+    active_writer_ = std::move(writer);
+    active = segment;
+    MutexLock l(&mutex_);
+    segments_.push_back(std::move(segment));
+  }
+
+  const uint64_t offset = active->size;
+  IOStatus io_s = active_writer_->Append(record, IOOptions(), nullptr);
+  if (io_s.ok()) {
+    io_s = active_writer_->Flush(IOOptions(), nullptr);
+  }
+  if (!io_s.ok()) {
+    // The tail of the segment is in an unknown state; start a new one on the
+    // next append.
+    active_writer_.reset();
+    return io_s;
+  }
+  active->size += record.size();
+  active->keys.push_back(key);
+
+  MutexLock l(&mutex_);
+  usage_ += record.size();
+  if (relocated_from != nullptr) {
+    // Only take over entries that were not erased or replaced meanwhile.
+    auto it = index_.find(key);
+    if (it != index_.end() && it->second.segment.get() == relocated_from) {
+      it->second = IndexEntry{active, offset, record.size(), false};
+    }
+  } else {
+    index_[key] = IndexEntry{active, offset, record.size(), false};
+  }
+  MaybeScheduleReclaim();
+  return Status::OK();
+}
+
+std::unique_ptr<SecondaryCacheResultHandle> FileSecondaryCache::Lookup(
+    const Slice& key, const Cache::CacheItemHelper* helper,
+    Cache::CreateContext* create_context, bool wait, bool /*advise_erase*/,
+    bool& kept_in_sec_cache) {
+  assert(helper);
+  kept_in_sec_cache = false;
+  IndexEntry entry;
+  {
+    MutexLock l(&mutex_);
+    auto it = index_.find(key.ToString());
+    if (it == index_.end()) {
+      return nullptr;
+    }
+    it->second.referenced = true;
+    entry = it->second;
+  }
+  kept_in_sec_cache = true;
+
+  auto state = std::make_shared<ReadState>(std::move(entry.segment),
+                                           entry.offset, entry.record_size);
+  std::unique_ptr<ResultHandle> handle(
+      new ResultHandle(key, helper, create_context, state));
+  if (wait) {
+    handle->Wait();
+  } else {
+    thread_pool_->SubmitJob([state]() {
+      if (state->TryClaim()) {
+        ReadBatch(state->segment.get(), {state.get()});
+      }
+    });
+  }
+  return handle;
+}
+
+void FileSecondaryCache::Erase(const Slice& key) {
+  MutexLock l(&mutex_);
+  // The record stays on disk as garbage until its segment is reclaimed.
+  index_.erase(key.ToString());
+}
+
+void FileSecondaryCache::WaitAll(
+    std::vector<SecondaryCacheResultHandle*> handles) {
+  // Take over every read that has not been started by the thread pool and
+  // issue them together, grouped by segment file.
+  std::unordered_map<Segment*, std::vector<ReadState*>> batches;
+  for (SecondaryCacheResultHandle* h : handles) {
+    auto handle = static_cast<ResultHandle*>(h);
+    if (!handle->IsReady() && handle->state()->TryClaim()) {
+      ReadState* state = handle->state();
+      batches[state->segment.get()].push_back(state);
+    }
+  }
+  for (auto& batch : batches) {
+    ReadBatch(batch.first, batch.second);
+  }
+  for (SecondaryCacheResultHandle* h : handles) {
+    h->Wait();
+  }
+}
+
+void FileSecondaryCache::ReadBatch(Segment* segment,
+                                   const std::vector<ReadState*>& states) {
+  std::vector<FSReadRequest> reqs(states.size());
+  for (size_t i = 0; i < states.size(); ++i) {
+    reqs[i].offset = states[i]->offset;
+    reqs[i].len = states[i]->size;
+    reqs[i].scratch = states[i]->buf.get();
+  }
+  IOStatus s = segment->reader->MultiRead(reqs.data(), reqs.size(),
+                                          IOOptions(), nullptr);
+  for (size_t i = 0; i < states.size(); ++i) {
+    states[i]->status = s.ok() ? reqs[i].status : s;
+    states[i]->result = reqs[i].result;
+    states[i]->Finish();
+  }
+}
+
+void FileSecondaryCache::MaybeScheduleReclaim() {
+  mutex_.AssertHeld();
+  if (!reclaim_scheduled_ && usage_ > capacity_ && segments_.size() > 1) {
+    reclaim_scheduled_ = true;
+    thread_pool_->SubmitJob([this]() { ReclaimSpace(); });
+  }
+}
+
+void FileSecondaryCache::ReclaimSpace() {
+  while (ReclaimOldestSegment()) {
+  }
+  MutexLock l(&mutex_);
+  reclaim_scheduled_ = false;
+  // Appends that raced with the last round may have pushed usage back over.
+  MaybeScheduleReclaim();
+  if (!reclaim_scheduled_) {
+    reclaim_cv_.SignalAll();
+  }
+}
+
+bool FileSecondaryCache::ReclaimOldestSegment() {
+  std::shared_ptr<Segment> victim;
+  std::vector<std::string> hot_keys;
+  std::vector<std::shared_ptr<ReadState>> hot_reads;
+  {
+    MutexLock l(&mutex_);
+    // Never reclaim the active segment
+    if (usage_ <= capacity_ || segments_.size() <= 1) {
+      return false;
+    }
+    victim = segments_.front();
+    segments_.pop_front();
+    usage_ -= victim->size;
+    for (const auto& key : victim->keys) {
+      auto it = index_.find(key);
+      if (it == index_.end() || it->second.segment != victim) {
+        continue;
+      }
+      if (it->second.referenced) {
+        // Second chance: keep it visible while it is copied forward.
+        hot_keys.push_back(key);
+        hot_reads.push_back(std::make_shared<ReadState>(
+            victim, it->second.offset, it->second.record_size));
+      } else {
+        index_.erase(it);
+      }
+    }
+  }
+
+  if (!hot_reads.empty()) {
+    std::vector<ReadState*> states;
+    for (auto& state : hot_reads) {
+      state->TryClaim();
+      states.push_back(state.get());
+    }
+    ReadBatch(victim.get(), states);
+    MutexLock wl(&write_mutex_);
+    for (size_t i = 0; i < hot_reads.size(); ++i) {
+      if (hot_reads[i]->status.ok()) {
+        AppendRecord(hot_keys[i], hot_reads[i]->result, victim.get())
+            .PermitUncheckedError();
+      }
+    }
+  }
+
+  MutexLock l(&mutex_);
+  // Drop whatever could not be copied forward.
+  for (const auto& key : hot_keys) {
+    auto it = index_.find(key);
+    if (it != index_.end() && it->second.segment == victim) {
+      index_.erase(it);
+    }
+  }
+  return true;
+}
+
+Status FileSecondaryCache::SetCapacity(size_t capacity) {
+  MutexLock l(&mutex_);
+  capacity_ = capacity;
+  MaybeScheduleReclaim();
+  return Status::OK();
+}
+
+Status FileSecondaryCache::GetCapacity(size_t& capacity) {
+  MutexLock l(&mutex_);
+  capacity = capacity_;
+  return Status::OK();
+}
+
+size_t FileSecondaryCache::GetUsage() const {
+  MutexLock l(&mutex_);
+  return usage_;
+}
+
+size_t FileSecondaryCache::TEST_GetNumSegments() const {
+  MutexLock l(&mutex_);
+  return segments_.size();
+}
+
+void FileSecondaryCache::TEST_WaitForReclaim() {
+  MutexLock l(&mutex_);
+  while (reclaim_scheduled_) {
+    reclaim_cv_.Wait();
+  }
+}
+
+std::string FileSecondaryCache::GetPrintableOptions() const {
+  MutexLock l(&mutex_);
+  std::string ret;
+  const int kBufferSize{200};
+  char buffer[kBufferSize];
+  snprintf(buffer, kBufferSize, "    dir : %s\n", opts_.dir.c_str());
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    capacity : %" ROCKSDB_PRIszt "\n",
+           capacity_);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    segment_size : %" ROCKSDB_PRIszt "\n",
+           opts_.segment_size);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    num_threads : %d\n", opts_.num_threads);
+  ret.append(buffer);
+  return ret;
+}
+
+Status NewFileSecondaryCache(const FileSecondaryCacheOptions& opts,
+                             std::shared_ptr<SecondaryCache>* result) {
+  auto cache = std::make_shared<FileSecondaryCache>(opts);
+  Status s = cache->Open();
+  if (s.ok()) {
+    *result = std::move(cache);
+  }
+  return s;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,137 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/cache.h"
+#include "rocksdb/file_system.h"
+#include "rocksdb/secondary_cache.h"
+#include "rocksdb/threadpool.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// FileSecondaryCache is a SecondaryCache that keeps the persistable form of
+// evicted entries in log-structured segment files on a local device.
+//
+// Insert() appends a self-describing record to the active segment
+//
+//    fixed32 key_size | fixed32 value_size | key | value | fixed32 crc
+//
+// (crc is the masked crc32c of everything before it) and records the
+// location in an in-memory index. Segments are written strictly in order and
+// never modified, so space is reclaimed a whole segment at a time: once usage
+// exceeds capacity, a background job drops the oldest segment. Records in it
+// that were looked up since they were written get a second chance and are
+// copied forward into the active segment; everything else is dropped from the
+// index.
+//
+// Lookup() with wait=false returns a pending handle and queues the read on
+// the background thread pool. WaitAll() claims every handle whose read has
+// not started yet and issues the reads itself, one MultiRead per segment
+// file, so a batch of lookups costs roughly one round trip to the device.
+// The create callback always runs on the thread calling Wait()/WaitAll().
+//
+// Entries are kept in the cache after a successful Lookup(), so
+// SupportForceErase() is false and `kept_in_sec_cache` is always set on a hit.
+class FileSecondaryCache : public SecondaryCache {
+ public:
+  explicit FileSecondaryCache(const FileSecondaryCacheOptions& opts);
+  ~FileSecondaryCache() override;
+
+  // Create the cache directory and remove segment files left behind by a
+  // previous instance. Must succeed before the cache is used.
+  Status Open();
+
+  const char* Name() const override { return "FileSecondaryCache"; }
+
+  Status Insert(const Slice& key, Cache::ObjectPtr value,
+                const Cache::CacheItemHelper* helper) override;
+
+  std::unique_ptr<SecondaryCacheResultHandle> Lookup(
+      const Slice& key, const Cache::CacheItemHelper* helper,
+      Cache::CreateContext* create_context, bool wait, bool advise_erase,
+      bool& kept_in_sec_cache) override;
+
+  bool SupportForceErase() const override { return false; }
+
+  void Erase(const Slice& key) override;
+
+  void WaitAll(std::vector<SecondaryCacheResultHandle*> handles) override;
+
+  Status SetCapacity(size_t capacity) override;
+
+  Status GetCapacity(size_t& capacity) override;
+
+  std::string GetPrintableOptions() const override;
+
+  // Bytes currently held by segment files, including garbage.
+  size_t GetUsage() const;
+
+  size_t TEST_GetNumSegments() const;
+  void TEST_WaitForReclaim();
+
+ private:
+  static constexpr size_t kRecordHeaderSize = 8;
+  static constexpr size_t kRecordTrailerSize = 4;
+
+  struct Segment;
+  struct ReadState;
+  class ResultHandle;
+
+  struct IndexEntry {
+    std::shared_ptr<Segment> segment;
+    uint64_t offset = 0;
+    size_t record_size = 0;
+    // Set on lookup, cleared when the record is copied forward by reclaim
+    bool referenced = false;
+  };
+
+  // Append a complete record to the active segment, rolling over to a new
+  // segment if needed, and publish it in the index. When copying a record
+  // forward out of `relocated_from`, the index is only updated if it still
+  // points there. REQUIRES: write_mutex_ held.
+  Status AppendRecord(const std::string& key, const Slice& record,
+                      const Segment* relocated_from);
+
+  // REQUIRES: mutex_ held
+  void MaybeScheduleReclaim();
+  void ReclaimSpace();
+  // Returns false if there was nothing left to reclaim.
+  bool ReclaimOldestSegment();
+
+  // Issue the reads of `states` (all on the same segment) as one MultiRead.
+  static void ReadBatch(Segment* segment,
+                        const std::vector<ReadState*>& states);
+
+  const FileSecondaryCacheOptions opts_;
+  const std::shared_ptr<FileSystem> fs_;
+  std::unique_ptr<ThreadPool> thread_pool_;
+
+  // Serializes appends to the active segment (and segment rollover).
+  port::Mutex write_mutex_;
+  std::unique_ptr<FSWritableFile> active_writer_;
+  uint64_t next_segment_id_ = 0;
+
+  // Protects everything below.
+  mutable port::Mutex mutex_;
+  port::CondVar reclaim_cv_;
+  std::unordered_map<std::string, IndexEntry> index_;
+  // Oldest first; the last one is the active segment.
+  std::deque<std::shared_ptr<Segment>> segments_;
+  size_t capacity_;
+  size_t usage_ = 0;
+  bool reclaim_scheduled_ = false;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,284 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/file_secondary_cache.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/convenience.h"
+#include "test_util/secondary_cache_test_util.h"
+#include "test_util/testharness.h"
+#include "test_util/testutil.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+using secondary_cache_test_util::WithCacheType;
+
+class FileSecondaryCacheTest : public testing::Test, public WithCacheType {
+ public:
+  FileSecondaryCacheTest()
+      : dir_(test::PerThreadDBPath("file_secondary_cache_test")) {}
+
+  const std::string& Type() override {
+    static const std::string kType = kLRU;
+    return kType;
+  }
+
+ protected:
+  std::shared_ptr<SecondaryCache> NewSecondaryCache(size_t capacity,
+                                                    size_t segment_size) {
+    FileSecondaryCacheOptions opts;
+    opts.dir = dir_;
+    opts.capacity = capacity;
+    opts.segment_size = segment_size;
+    std::shared_ptr<SecondaryCache> sec_cache;
+    EXPECT_OK(NewFileSecondaryCache(opts, &sec_cache));
+    return sec_cache;
+  }
+
+  static std::string Key(int i) {
+    // 16 bytes for HCC compatibility
+    char buf[17];
+    snprintf(buf, sizeof(buf), "____%012d", i);
+    return buf;
+  }
+
+  void CheckLookup(SecondaryCache* sec_cache, const std::string& key,
+                   const std::string& expected) {
+    bool kept_in_sec_cache = false;
+    std::unique_ptr<SecondaryCacheResultHandle> handle =
+        sec_cache->Lookup(key, GetHelper(), this, /*wait=*/true,
+                          /*advise_erase=*/false, kept_in_sec_cache);
+    ASSERT_NE(handle, nullptr);
+    ASSERT_TRUE(handle->IsReady());
+    ASSERT_TRUE(kept_in_sec_cache);
+    std::unique_ptr<TestItem> val(static_cast<TestItem*>(handle->Value()));
+    ASSERT_NE(val, nullptr);
+    ASSERT_EQ(val->ToString(), expected);
+    ASSERT_EQ(handle->Size(), expected.size());
+  }
+
+  std::string dir_;
+};
+
+TEST_F(FileSecondaryCacheTest, BasicTest) {
+  std::shared_ptr<SecondaryCache> sec_cache =
+      NewSecondaryCache(/*capacity=*/1 << 20, /*segment_size=*/64 << 10);
+  ASSERT_NE(sec_cache, nullptr);
+  ASSERT_FALSE(sec_cache->SupportForceErase());
+
+  bool kept_in_sec_cache = true;
+  ASSERT_EQ(sec_cache->Lookup(Key(0), GetHelper(), this, /*wait=*/true,
+                              /*advise_erase=*/false, kept_in_sec_cache),
+            nullptr);
+  ASSERT_FALSE(kept_in_sec_cache);
+
+  Random rnd(301);
+  std::string str1 = rnd.RandomString(1000);
+  TestItem item1(str1.data(), str1.length());
+  ASSERT_OK(sec_cache->Insert(Key(1), &item1, GetHelper()));
+  std::string str2 = rnd.RandomString(2000);
+  TestItem item2(str2.data(), str2.length());
+  ASSERT_OK(sec_cache->Insert(Key(2), &item2, GetHelper()));
+
+  CheckLookup(sec_cache.get(), Key(1), str1);
+  CheckLookup(sec_cache.get(), Key(2), str2);
+  // Entries stay after a lookup
+  CheckLookup(sec_cache.get(), Key(1), str1);
+
+  // Re-inserting an existing key is a no-op
+  size_t usage = static_cast<FileSecondaryCache*>(sec_cache.get())->GetUsage();
+  ASSERT_OK(sec_cache->Insert(Key(1), &item1, GetHelper()));
+  ASSERT_EQ(static_cast<FileSecondaryCache*>(sec_cache.get())->GetUsage(),
+            usage);
+
+  sec_cache->Erase(Key(1));
+  ASSERT_EQ(sec_cache->Lookup(Key(1), GetHelper(), this, /*wait=*/true,
+                              /*advise_erase=*/false, kept_in_sec_cache),
+            nullptr);
+  CheckLookup(sec_cache.get(), Key(2), str2);
+
+  // A failing create callback is reported as a miss
+  SetFailCreate(true);
+  std::unique_ptr<SecondaryCacheResultHandle> handle =
+      sec_cache->Lookup(Key(2), GetHelper(), this, /*wait=*/true,
+                        /*advise_erase=*/false, kept_in_sec_cache);
+  ASSERT_NE(handle, nullptr);
+  ASSERT_EQ(handle->Value(), nullptr);
+  SetFailCreate(false);
+
+  size_t capacity = 0;
+  ASSERT_OK(sec_cache->SetCapacity(2 << 20));
+  ASSERT_OK(sec_cache->GetCapacity(capacity));
+  ASSERT_EQ(capacity, 2 << 20);
+}
+
+TEST_F(FileSecondaryCacheTest, AsyncLookupAndWaitAll) {
+  std::shared_ptr<SecondaryCache> sec_cache =
+      NewSecondaryCache(/*capacity=*/1 << 20, /*segment_size=*/8 << 10);
+  ASSERT_NE(sec_cache, nullptr);
+
+  Random rnd(301);
+  const int kNumItems = 40;
+  std::vector<std::string> values;
+  for (int i = 0; i < kNumItems; ++i) {
+    values.push_back(rnd.RandomString(500 + i));
+    TestItem item(values.back().data(), values.back().length());
+    ASSERT_OK(sec_cache->Insert(Key(i), &item, GetHelper()));
+  }
+  // Spread over several segment files
+  ASSERT_GT(
+      static_cast<FileSecondaryCache*>(sec_cache.get())->TEST_GetNumSegments(),
+      1);
+
+  std::vector<std::unique_ptr<SecondaryCacheResultHandle>> handles;
+  std::vector<SecondaryCacheResultHandle*> handle_ptrs;
+  for (int i = 0; i < kNumItems; ++i) {
+    bool kept_in_sec_cache = false;
+    handles.push_back(sec_cache->Lookup(Key(i), GetHelper(), this,
+                                        /*wait=*/false,
+                                        /*advise_erase=*/false,
+                                        kept_in_sec_cache));
+    ASSERT_NE(handles.back(), nullptr);
+    ASSERT_TRUE(kept_in_sec_cache);
+    handle_ptrs.push_back(handles.back().get());
+  }
+  sec_cache->WaitAll(handle_ptrs);
+  for (int i = 0; i < kNumItems; ++i) {
+    ASSERT_TRUE(handles[i]->IsReady());
+    std::unique_ptr<TestItem> val(static_cast<TestItem*>(handles[i]->Value()));
+    ASSERT_NE(val, nullptr);
+    ASSERT_EQ(val->ToString(), values[i]);
+  }
+
+  // Single pending handle
+  bool kept_in_sec_cache = false;
+  std::unique_ptr<SecondaryCacheResultHandle> handle =
+      sec_cache->Lookup(Key(7), GetHelper(), this, /*wait=*/false,
+                        /*advise_erase=*/false, kept_in_sec_cache);
+  ASSERT_NE(handle, nullptr);
+  handle->Wait();
+  ASSERT_TRUE(handle->IsReady());
+  std::unique_ptr<TestItem> val(static_cast<TestItem*>(handle->Value()));
+  ASSERT_NE(val, nullptr);
+  ASSERT_EQ(val->ToString(), values[7]);
+}
+
+TEST_F(FileSecondaryCacheTest, ReclaimSpace) {
+  const size_t kCapacity = 16 << 10;
+  std::shared_ptr<SecondaryCache> sec_cache =
+      NewSecondaryCache(kCapacity, /*segment_size=*/4 << 10);
+  ASSERT_NE(sec_cache, nullptr);
+  auto file_cache = static_cast<FileSecondaryCache*>(sec_cache.get());
+
+  Random rnd(301);
+  std::vector<std::string> values;
+  for (int i = 0; i < 8; ++i) {
+    values.push_back(rnd.RandomString(1000));
+    TestItem item(values.back().data(), values.back().length());
+    ASSERT_OK(sec_cache->Insert(Key(i), &item, GetHelper()));
+  }
+  // Reference key 0 so that it survives reclaim of the first segment
+  CheckLookup(sec_cache.get(), Key(0), values[0]);
+
+  for (int i = 8; i < 40; ++i) {
+    values.push_back(rnd.RandomString(1000));
+    TestItem item(values.back().data(), values.back().length());
+    ASSERT_OK(sec_cache->Insert(Key(i), &item, GetHelper()));
+    file_cache->TEST_WaitForReclaim();
+  }
+  ASSERT_LE(file_cache->GetUsage(), kCapacity);
+
+  bool kept_in_sec_cache = false;
+  ASSERT_EQ(sec_cache->Lookup(Key(1), GetHelper(), this, /*wait=*/true,
+                              /*advise_erase=*/false, kept_in_sec_cache),
+            nullptr);
+  CheckLookup(sec_cache.get(), Key(39), values[39]);
+
+  // Shrinking the capacity reclaims more
+  ASSERT_OK(sec_cache->SetCapacity(kCapacity / 2));
+  file_cache->TEST_WaitForReclaim();
+  ASSERT_LE(file_cache->GetUsage(), kCapacity / 2);
+  CheckLookup(sec_cache.get(), Key(39), values[39]);
+}
+
+TEST_F(FileSecondaryCacheTest, IntegrationWithPrimaryCache) {
+  std::shared_ptr<SecondaryCache> sec_cache =
+      NewSecondaryCache(/*capacity=*/1 << 20, /*segment_size=*/64 << 10);
+  ASSERT_NE(sec_cache, nullptr);
+  std::shared_ptr<Cache> cache =
+      NewCache(/*capacity=*/2048, /*num_shard_bits=*/0,
+               /*strict_capacity_limit=*/false, sec_cache);
+  std::shared_ptr<Statistics> stats = CreateDBStatistics();
+
+  Random rnd(301);
+  std::vector<std::string> values;
+  for (int i = 0; i < 10; ++i) {
+    values.push_back(rnd.RandomString(1000));
+    auto item = new TestItem(values.back().data(), values.back().length());
+    ASSERT_OK(cache->Insert(Key(i), item, GetHelper(), values.back().size()));
+  }
+
+  // Evicted entries come back from the secondary cache
+  Cache::Handle* handle = cache->Lookup(Key(0), GetHelper(), this,
+                                        Cache::Priority::LOW, stats.get());
+  ASSERT_NE(handle, nullptr);
+  ASSERT_EQ(static_cast<TestItem*>(cache->Value(handle))->ToString(),
+            values[0]);
+  cache->Release(handle);
+  ASSERT_EQ(stats->getTickerCount(SECONDARY_CACHE_HITS), 1);
+
+  // Batched async lookups through the primary cache
+  std::vector<Cache::AsyncLookupHandle> async_handles(4);
+  std::vector<std::string> keys;
+  for (int i = 1; i < 5; ++i) {
+    keys.push_back(Key(i));
+  }
+  for (int i = 0; i < 4; ++i) {
+    async_handles[i].key = keys[i];
+    async_handles[i].helper = GetHelper();
+    async_handles[i].create_context = this;
+    async_handles[i].stats = stats.get();
+    cache->StartAsyncLookup(async_handles[i]);
+  }
+  cache->WaitAll(async_handles.data(), async_handles.size());
+  for (int i = 0; i < 4; ++i) {
+    handle = async_handles[i].Result();
+    ASSERT_NE(handle, nullptr);
+    ASSERT_EQ(static_cast<TestItem*>(cache->Value(handle))->ToString(),
+              values[i + 1]);
+    cache->Release(handle);
+  }
+  ASSERT_EQ(stats->getTickerCount(SECONDARY_CACHE_HITS), 5);
+
+  cache.reset();
+  sec_cache.reset();
+}
+
+TEST_F(FileSecondaryCacheTest, CreateFromString) {
+  ConfigOptions config_options;
+  std::shared_ptr<SecondaryCache> sec_cache;
+  ASSERT_OK(SecondaryCache::CreateFromString(
+      config_options,
+      "file_secondary_cache://dir=" + dir_ +
+          ";capacity=2097152;segment_size=65536;num_threads=1",
+      &sec_cache));
+  ASSERT_NE(sec_cache, nullptr);
+  ASSERT_STREQ(sec_cache->Name(), "FileSecondaryCache");
+  size_t capacity = 0;
+  ASSERT_OK(sec_cache->GetCapacity(capacity));
+  ASSERT_EQ(capacity, 2097152);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,422 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/tiered_secondary_cache.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+
+#include "cache/cache_entry_roles.h"
+#include "port/port.h"
+#include "rocksdb/advanced_cache.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+
+using EvictionCount = std::atomic<uint32_t>;
+
+const Cache::CacheItemHelper kEvictionCountHelper{
+    CacheEntryRole::kMisc, [](Cache::ObjectPtr obj, MemoryAllocator*) {
+      delete static_cast<EvictionCount*>(obj);
+    }};
+
+size_t RoleIndex(CacheEntryRole role) { return static_cast<size_t>(role); }
+
+}  // namespace
+
+void TieredSecondaryCacheStats::Counters::Reset() {
+  for (auto* per_tier : {&admissions, &hits}) {
+    for (PerRole& per_role : *per_tier) {
+      for (auto& c : per_role) {
+        c.store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+  for (auto* per_role : {&rejections, &misses}) {
+    for (auto& c : *per_role) {
+      c.store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+TieredSecondaryCacheStats::TieredSecondaryCacheStats() = default;
+
+TieredSecondaryCacheStats::~TieredSecondaryCacheStats() = default;
+
+uint64_t TieredSecondaryCacheStats::GetAdmissions(size_t tier,
+                                                  CacheEntryRole role) const {
+  if (!counters_ || tier >= counters_->admissions.size()) {
+    return 0;
+  }
+  return counters_->admissions[tier][RoleIndex(role)].load(
+      std::memory_order_relaxed);
+}
+
+uint64_t TieredSecondaryCacheStats::GetHits(size_t tier,
+                                            CacheEntryRole role) const {
+  if (!counters_ || tier >= counters_->hits.size()) {
+    return 0;
+  }
+  return counters_->hits[tier][RoleIndex(role)].load(
+      std::memory_order_relaxed);
+}
+
+uint64_t TieredSecondaryCacheStats::GetRejections(CacheEntryRole role) const {
+  if (!counters_) {
+    return 0;
+  }
+  return counters_->rejections[RoleIndex(role)].load(
+      std::memory_order_relaxed);
+}
+
+uint64_t TieredSecondaryCacheStats::GetMisses(CacheEntryRole role) const {
+  if (!counters_) {
+    return 0;
+  }
+  return counters_->misses[RoleIndex(role)].load(std::memory_order_relaxed);
+}
+
+void TieredSecondaryCacheStats::Reset() {
+  if (counters_) {
+    counters_->Reset();
+  }
+}
+
+std::string TieredSecondaryCacheStats::ToString() const {
+  std::string ret;
+  if (!counters_) {
+    return ret;
+  }
+  char buf[200];
+  for (size_t tier = 0; tier < counters_->admissions.size(); ++tier) {
+    for (uint32_t i = 0; i < kNumCacheEntryRoles; ++i) {
+      CacheEntryRole role = static_cast<CacheEntryRole>(i);
+      uint64_t admissions = GetAdmissions(tier, role);
+      uint64_t hits = GetHits(tier, role);
+      if (admissions == 0 && hits == 0) {
+        continue;
+      }
+      snprintf(buf, sizeof(buf),
+               "tier %" ROCKSDB_PRIszt " %s: admissions %" PRIu64
+               " hits %" PRIu64 "\n",
+               tier, kCacheEntryRoleToCamelString[i].c_str(), admissions,
+               hits);
+      ret.append(buf);
+    }
+  }
+  for (uint32_t i = 0; i < kNumCacheEntryRoles; ++i) {
+    CacheEntryRole role = static_cast<CacheEntryRole>(i);
+    uint64_t rejections = GetRejections(role);
+    uint64_t misses = GetMisses(role);
+    if (rejections == 0 && misses == 0) {
+      continue;
+    }
+    snprintf(buf, sizeof(buf),
+             "%s: rejections %" PRIu64 " misses %" PRIu64 "\n",
+             kCacheEntryRoleToCamelString[i].c_str(), rejections, misses);
+    ret.append(buf);
+  }
+  return ret;
+}
+
+// Wraps the handle of the tier currently being looked up. If that lookup
+// completes without a value, WaitAll() moves the handle to the next tier.
+// The caller's `kept_in_sec_cache` is updated once the handle is ready, from
+// the tier that returned the value.
+class TieredSecondaryCache::ResultHandle : public SecondaryCacheResultHandle {
+ public:
+  ResultHandle(TieredSecondaryCache* cache, const Slice& key,
+               const Cache::CacheItemHelper* helper,
+               Cache::CreateContext* create_context, bool advise_erase,
+               bool* kept_in_sec_cache, size_t tier,
+               std::unique_ptr<SecondaryCacheResultHandle>&& inner)
+      : cache_(cache),
+        key_(key.ToString()),
+        helper_(helper),
+        create_context_(create_context),
+        advise_erase_(advise_erase),
+        kept_in_sec_cache_(kept_in_sec_cache),
+        tier_(tier),
+        inner_(std::move(inner)) {}
+
+  bool IsReady() override { return inner_ == nullptr; }
+
+  void Wait() override { cache_->WaitAll({this}); }
+
+  Cache::ObjectPtr Value() override { return value_; }
+
+  size_t Size() override { return size_; }
+
+ private:
+  friend class TieredSecondaryCache;
+
+  // Consume the result of the (ready) inner handle. On a miss, start the
+  // lookup in the following tiers, leaving inner_ set if one is pending.
+  void Advance() {
+    assert(inner_ && inner_->IsReady());
+    value_ = inner_->Value();
+    size_ = inner_->Size();
+    inner_.reset();
+    if (value_ != nullptr) {
+      cache_->RecordHit(tier_, helper_->role);
+      return;
+    }
+    size_ = 0;
+    *kept_in_sec_cache_ = false;
+    inner_ = cache_->LookupFrom(tier_ + 1, key_, helper_, create_context_,
+                                /*wait=*/false, advise_erase_, &tier_,
+                                kept_in_sec_cache_);
+    if (inner_ == nullptr) {
+      cache_->RecordMiss(helper_->role);
+    }
+  }
+
+  TieredSecondaryCache* const cache_;
+  const std::string key_;
+  const Cache::CacheItemHelper* const helper_;
+  Cache::CreateContext* const create_context_;
+  const bool advise_erase_;
+  bool* const kept_in_sec_cache_;
+  size_t tier_;
+  std::unique_ptr<SecondaryCacheResultHandle> inner_;
+  Cache::ObjectPtr value_ = nullptr;
+  size_t size_ = 0;
+};
+
+TieredSecondaryCache::TieredSecondaryCache(
+    const TieredSecondaryCacheOptions& opts)
+    : tiers_(opts.tiers), stats_(opts.stats) {
+  LRUCacheOptions history_opts;
+  // Each remembered key is charged one unit
+  history_opts.capacity = std::max(opts.eviction_history_size, size_t{1});
+  history_opts.metadata_charge_policy = kDontChargeCacheMetadata;
+  eviction_history_ = history_opts.MakeSharedCache();
+  for (const auto& t : tiers_) {
+    support_force_erase_ |= t.cache->SupportForceErase();
+  }
+  if (stats_) {
+    stats_->counters_.reset(
+        new TieredSecondaryCacheStats::Counters(tiers_.size()));
+  }
+}
+
+uint32_t TieredSecondaryCache::RecordEviction(const Slice& key) {
+  Cache::Handle* handle = eviction_history_->Lookup(key);
+  if (handle != nullptr) {
+    auto count =
+        static_cast<EvictionCount*>(eviction_history_->Value(handle));
+    uint32_t ret = count->fetch_add(1, std::memory_order_relaxed) + 1;
+    eviction_history_->Release(handle);
+    return ret;
+  }
+  // A concurrent first eviction of the same key could overwrite this entry
+  // and lose one count, which is harmless for an admission heuristic.
+  eviction_history_
+      ->Insert(key, new EvictionCount(1), &kEvictionCountHelper, /*charge=*/1)
+      .PermitUncheckedError();
+  return 1;
+}
+
+uint32_t TieredSecondaryCache::TEST_GetEvictionCount(const Slice& key) {
+  Cache::Handle* handle = eviction_history_->Lookup(key);
+  if (handle == nullptr) {
+    return 0;
+  }
+  uint32_t ret = static_cast<EvictionCount*>(eviction_history_->Value(handle))
+                     ->load(std::memory_order_relaxed);
+  eviction_history_->Release(handle);
+  return ret;
+}
+
+Status TieredSecondaryCache::Insert(const Slice& key, Cache::ObjectPtr value,
+                                    const Cache::CacheItemHelper* helper) {
+  uint32_t evictions = RecordEviction(key);
+  // Pick the deepest tier the entry qualifies for. min_evictions is
+  // non-decreasing, so scan from the back.
+  size_t tier = tiers_.size();
+  for (size_t i = tiers_.size(); i > 0; --i) {
+    const TieredSecondaryCacheOptions::Tier& t = tiers_[i - 1];
+    if (evictions >= t.min_evictions && t.roles.Contains(helper->role)) {
+      tier = i - 1;
+      break;
+    }
+  }
+  if (tier == tiers_.size()) {
+    if (stats_) {
+      stats_->counters_->rejections[RoleIndex(helper->role)].fetch_add(
+          1, std::memory_order_relaxed);
+    }
+    return Status::OK();
+  }
+
+  // Keep the entry in one tier only
+  for (size_t i = 0; i < tiers_.size(); ++i) {
+    if (i != tier) {
+      tiers_[i].cache->Erase(key);
+    }
+  }
+  Status s = tiers_[tier].cache->InsertAdmitted(key, value, helper);
+  if (s.ok() && stats_) {
+    stats_->counters_->admissions[tier][RoleIndex(helper->role)].fetch_add(
+        1, std::memory_order_relaxed);
+  }
+  return s;
+}
+
+std::unique_ptr<SecondaryCacheResultHandle> TieredSecondaryCache::LookupFrom(
+    size_t first_tier, const Slice& key, const Cache::CacheItemHelper* helper,
+    Cache::CreateContext* create_context, bool wait, bool advise_erase,
+    size_t* tier, bool* kept_in_sec_cache) {
+  for (size_t i = first_tier; i < tiers_.size(); ++i) {
+    if (!tiers_[i].roles.Contains(helper->role)) {
+      continue;
+    }
+    bool kept = false;
+    std::unique_ptr<SecondaryCacheResultHandle> handle =
+        tiers_[i].cache->Lookup(key, helper, create_context, wait,
+                                advise_erase, kept);
+    if (handle == nullptr) {
+      continue;
+    }
+    if (wait && handle->Value() == nullptr) {
+      continue;
+    }
+    *tier = i;
+    *kept_in_sec_cache = kept;
+    return handle;
+  }
+  return nullptr;
+}
+
+std::unique_ptr<SecondaryCacheResultHandle> TieredSecondaryCache::Lookup(
+    const Slice& key, const Cache::CacheItemHelper* helper,
+    Cache::CreateContext* create_context, bool wait, bool advise_erase,
+    bool& kept_in_sec_cache) {
+  kept_in_sec_cache = false;
+  size_t tier = 0;
+  std::unique_ptr<SecondaryCacheResultHandle> handle =
+      LookupFrom(0, key, helper, create_context, wait, advise_erase, &tier,
+                 &kept_in_sec_cache);
+  if (handle == nullptr) {
+    RecordMiss(helper->role);
+    return nullptr;
+  }
+  if (wait) {
+    RecordHit(tier, helper->role);
+    return handle;
+  }
+  return std::make_unique<ResultHandle>(this, key, helper, create_context,
+                                        advise_erase, &kept_in_sec_cache, tier,
+                                        std::move(handle));
+}
+
+void TieredSecondaryCache::Erase(const Slice& key) {
+  eviction_history_->Erase(key);
+  for (const auto& t : tiers_) {
+    t.cache->Erase(key);
+  }
+}
+
+void TieredSecondaryCache::WaitAll(
+    std::vector<SecondaryCacheResultHandle*> handles) {
+  std::vector<ResultHandle*> pending;
+  for (SecondaryCacheResultHandle* h : handles) {
+    auto handle = static_cast<ResultHandle*>(h);
+    if (!handle->IsReady()) {
+      pending.push_back(handle);
+    }
+  }
+  std::vector<SecondaryCacheResultHandle*> tier_handles;
+  while (!pending.empty()) {
+    // One batch per tier, so each tier can overlap its own lookups
+    for (size_t i = 0; i < tiers_.size(); ++i) {
+      tier_handles.clear();
+      for (ResultHandle* h : pending) {
+        if (h->tier_ == i && !h->inner_->IsReady()) {
+          tier_handles.push_back(h->inner_.get());
+        }
+      }
+      if (!tier_handles.empty()) {
+        tiers_[i].cache->WaitAll(tier_handles);
+      }
+    }
+    // Handles that missed move on to the next tier that has the key
+    size_t num_pending = 0;
+    for (ResultHandle* h : pending) {
+      h->Advance();
+      if (!h->IsReady()) {
+        pending[num_pending++] = h;
+      }
+    }
+    pending.resize(num_pending);
+  }
+}
+
+Status TieredSecondaryCache::GetCapacity(size_t& capacity) {
+  capacity = 0;
+  for (const auto& t : tiers_) {
+    size_t tier_capacity = 0;
+    Status s = t.cache->GetCapacity(tier_capacity);
+    if (!s.ok()) {
+      return s;
+    }
+    capacity += tier_capacity;
+  }
+  return Status::OK();
+}
+
+std::string TieredSecondaryCache::GetPrintableOptions() const {
+  std::string ret;
+  char buffer[200];
+  snprintf(buffer, sizeof(buffer),
+           "    eviction_history_size : %" ROCKSDB_PRIszt "\n",
+           eviction_history_->GetCapacity());
+  ret.append(buffer);
+  for (size_t i = 0; i < tiers_.size(); ++i) {
+    snprintf(buffer, sizeof(buffer),
+             "    tier %" ROCKSDB_PRIszt " (%s) min_evictions : %u\n", i,
+             tiers_[i].cache->Name(), tiers_[i].min_evictions);
+    ret.append(buffer);
+    ret.append(tiers_[i].cache->GetPrintableOptions());
+  }
+  return ret;
+}
+
+void TieredSecondaryCache::RecordHit(size_t tier, CacheEntryRole role) {
+  if (stats_) {
+    stats_->counters_->hits[tier][RoleIndex(role)].fetch_add(
+        1, std::memory_order_relaxed);
+  }
+}
+
+void TieredSecondaryCache::RecordMiss(CacheEntryRole role) {
+  if (stats_) {
+    stats_->counters_->misses[RoleIndex(role)].fetch_add(
+        1, std::memory_order_relaxed);
+  }
+}
+
+Status NewTieredSecondaryCache(const TieredSecondaryCacheOptions& opts,
+                               std::shared_ptr<SecondaryCache>* result) {
+  if (opts.tiers.empty()) {
+    return Status::InvalidArgument("No secondary cache tiers");
+  }
+  for (size_t i = 0; i < opts.tiers.size(); ++i) {
+    if (opts.tiers[i].cache == nullptr) {
+      return Status::InvalidArgument("Secondary cache tier is null");
+    }
+    if (i > 0 &&
+        opts.tiers[i].min_evictions < opts.tiers[i - 1].min_evictions) {
+      return Status::InvalidArgument(
+          "Tier min_evictions must be non-decreasing");
+    }
+  }
+  *result = std::make_shared<TieredSecondaryCache>(opts);
+  return Status::OK();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,111 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/cache.h"
+#include "rocksdb/secondary_cache.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+struct TieredSecondaryCacheStats::Counters {
+  using PerRole = std::array<std::atomic<uint64_t>, kNumCacheEntryRoles>;
+
+  explicit Counters(size_t num_tiers)
+      : admissions(num_tiers), hits(num_tiers) {
+    Reset();
+  }
+
+  void Reset();
+
+  // Indexed by tier, then role
+  std::vector<PerRole> admissions;
+  std::vector<PerRole> hits;
+  PerRole rejections;
+  PerRole misses;
+};
+
+// TieredSecondaryCache applies one admission policy across several secondary
+// caches. See TieredSecondaryCacheOptions for the policy.
+//
+// The eviction count of each key lives in a small LRU cache of its own, so
+// memory use is bounded by `eviction_history_size`. Admitted entries are
+// stored with SecondaryCache::InsertAdmitted() so that tiers don't apply
+// their own admission policy on top.
+//
+// Lookup() with wait=false returns a handle on the first tier that has the
+// key. If that lookup turns out to be a miss once complete, WaitAll() moves
+// on to the next tier, waiting on each tier's handles as one batch.
+// `advise_erase` is passed on to the tiers, and `kept_in_sec_cache` is
+// reported by the tier that returns the entry. With wait=false it is only
+// final once the handle is ready, so the caller's flag must outlive the
+// handle's pending state (as CacheWithSecondaryAdapter's does).
+class TieredSecondaryCache : public SecondaryCache {
+ public:
+  explicit TieredSecondaryCache(const TieredSecondaryCacheOptions& opts);
+  ~TieredSecondaryCache() override = default;
+
+  const char* Name() const override { return "TieredSecondaryCache"; }
+
+  Status Insert(const Slice& key, Cache::ObjectPtr value,
+                const Cache::CacheItemHelper* helper) override;
+
+  std::unique_ptr<SecondaryCacheResultHandle> Lookup(
+      const Slice& key, const Cache::CacheItemHelper* helper,
+      Cache::CreateContext* create_context, bool wait, bool advise_erase,
+      bool& kept_in_sec_cache) override;
+
+  // True if any tier can erase on lookup. The tier holding an entry still
+  // decides whether it is kept.
+  bool SupportForceErase() const override { return support_force_erase_; }
+
+  void Erase(const Slice& key) override;
+
+  void WaitAll(std::vector<SecondaryCacheResultHandle*> handles) override;
+
+  // Capacity is managed per tier.
+  Status SetCapacity(size_t /*capacity*/) override {
+    return Status::NotSupported();
+  }
+
+  Status GetCapacity(size_t& capacity) override;
+
+  std::string GetPrintableOptions() const override;
+
+  // Number of times `key` has been evicted from the primary cache, as far as
+  // the eviction history remembers.
+  uint32_t TEST_GetEvictionCount(const Slice& key);
+
+ private:
+  class ResultHandle;
+
+  // Returns the incremented eviction count of `key`.
+  uint32_t RecordEviction(const Slice& key);
+
+  // Look `key` up in the tiers starting with `first_tier`. Returns the handle
+  // of the first tier that might have it and sets `*tier` to its index, or
+  // returns nullptr if none does.
+  std::unique_ptr<SecondaryCacheResultHandle> LookupFrom(
+      size_t first_tier, const Slice& key,
+      const Cache::CacheItemHelper* helper,
+      Cache::CreateContext* create_context, bool wait, bool advise_erase,
+      size_t* tier, bool* kept_in_sec_cache);
+
+  void RecordHit(size_t tier, CacheEntryRole role);
+  void RecordMiss(CacheEntryRole role);
+
+  const std::vector<TieredSecondaryCacheOptions::Tier> tiers_;
+  bool support_force_erase_ = false;
+  std::shared_ptr<Cache> eviction_history_;
+  std::shared_ptr<TieredSecondaryCacheStats> stats_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
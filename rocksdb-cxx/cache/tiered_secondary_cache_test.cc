@@ -0,0 +1,354 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/tiered_secondary_cache.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "test_util/secondary_cache_test_util.h"
+#include "test_util/testharness.h"
+#include "test_util/testutil.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+using secondary_cache_test_util::WithCacheType;
+
+class TieredSecondaryCacheTest : public testing::Test, public WithCacheType {
+ public:
+  TieredSecondaryCacheTest()
+      : dir_(test::PerThreadDBPath("tiered_secondary_cache_test")),
+        stats_(std::make_shared<TieredSecondaryCacheStats>()) {}
+
+  const std::string& Type() override {
+    static const std::string kType = kLRU;
+    return kType;
+  }
+
+ protected:
+  // A compressed tier admitting on the second eviction, followed by a file
+  // tier admitting data blocks on the third.
+  void NewTieredCache() {
+    CompressedSecondaryCacheOptions compressed_opts;
+    compressed_opts.capacity = 1 << 20;
+    compressed_opts.compression_type = kNoCompression;
+    FileSecondaryCacheOptions file_opts;
+    file_opts.dir = dir_;
+    file_opts.capacity = 1 << 20;
+    file_opts.segment_size = 64 << 10;
+    std::shared_ptr<SecondaryCache> file_cache;
+    ASSERT_OK(NewFileSecondaryCache(file_opts, &file_cache));
+
+    TieredSecondaryCacheOptions opts;
+    opts.tiers.push_back({compressed_opts.MakeSharedSecondaryCache(), 2,
+                          CacheEntryRoleSet::All()});
+    opts.tiers.push_back(
+        {file_cache, 3, CacheEntryRoleSet({CacheEntryRole::kDataBlock})});
+    opts.eviction_history_size = 1000;
+    opts.stats = stats_;
+    ASSERT_OK(NewTieredSecondaryCache(opts, &sec_cache_));
+  }
+
+  TieredSecondaryCache* tiered() {
+    return static_cast<TieredSecondaryCache*>(sec_cache_.get());
+  }
+
+  static std::string Key(int i) {
+    // 16 bytes for HCC compatibility
+    char buf[17];
+    snprintf(buf, sizeof(buf), "____%012d", i);
+    return buf;
+  }
+
+  void Evict(const std::string& key, const std::string& value,
+             CacheEntryRole role = CacheEntryRole::kDataBlock) {
+    TestItem item(value.data(), value.length());
+    ASSERT_OK(sec_cache_->Insert(key, &item, GetHelper(role)));
+  }
+
+  // Look up `key` with wait=false and Wait(). Returns the value, or an empty
+  // string on a miss.
+  std::string LookupAsync(const std::string& key, bool* kept_in_sec_cache,
+                          CacheEntryRole role = CacheEntryRole::kDataBlock,
+                          bool advise_erase = true) {
+    std::unique_ptr<SecondaryCacheResultHandle> handle =
+        sec_cache_->Lookup(key, GetHelper(role), this, /*wait=*/false,
+                           advise_erase, *kept_in_sec_cache);
+    if (handle == nullptr) {
+      return "";
+    }
+    handle->Wait();
+    EXPECT_TRUE(handle->IsReady());
+    std::unique_ptr<TestItem> val(static_cast<TestItem*>(handle->Value()));
+    return val ? val->ToString() : "";
+  }
+
+  std::string dir_;
+  std::shared_ptr<TieredSecondaryCacheStats> stats_;
+  std::shared_ptr<SecondaryCache> sec_cache_;
+};
+
+TEST_F(TieredSecondaryCacheTest, AdmissionByEvictionCount) {
+  NewTieredCache();
+  // From the compressed tier
+  ASSERT_TRUE(sec_cache_->SupportForceErase());
+  const CacheEntryRole kData = CacheEntryRole::kDataBlock;
+
+  Random rnd(301);
+  std::string str1 = rnd.RandomString(1000);
+  bool kept_in_sec_cache = true;
+
+  // First eviction is only remembered
+  Evict(Key(1), str1);
+  ASSERT_EQ(tiered()->TEST_GetEvictionCount(Key(1)), 1);
+  ASSERT_EQ(LookupAsync(Key(1), &kept_in_sec_cache), "");
+  ASSERT_EQ(stats_->GetRejections(kData), 1);
+  ASSERT_EQ(stats_->GetMisses(kData), 1);
+
+  // Second eviction goes to the compressed tier, which keeps the entry
+  // unless advised to erase it
+  Evict(Key(1), str1);
+  ASSERT_EQ(stats_->GetAdmissions(0, kData), 1);
+  ASSERT_EQ(LookupAsync(Key(1), &kept_in_sec_cache, kData,
+                        /*advise_erase=*/false),
+            str1);
+  ASSERT_TRUE(kept_in_sec_cache);
+  ASSERT_EQ(LookupAsync(Key(1), &kept_in_sec_cache), str1);
+  ASSERT_FALSE(kept_in_sec_cache);
+  ASSERT_EQ(stats_->GetHits(0, kData), 2);
+  ASSERT_EQ(LookupAsync(Key(1), &kept_in_sec_cache), "");
+
+  // Third eviction goes to the file tier, which keeps the entry
+  Evict(Key(1), str1);
+  ASSERT_EQ(stats_->GetAdmissions(1, kData), 1);
+  bool kept = false;
+  std::unique_ptr<SecondaryCacheResultHandle> handle =
+      sec_cache_->Lookup(Key(1), GetHelper(), this, /*wait=*/true,
+                         /*advise_erase=*/false, kept);
+  ASSERT_NE(handle, nullptr);
+  ASSERT_TRUE(kept);
+  std::unique_ptr<TestItem> val(static_cast<TestItem*>(handle->Value()));
+  ASSERT_NE(val, nullptr);
+  ASSERT_EQ(val->ToString(), str1);
+  ASSERT_EQ(stats_->GetHits(1, kData), 1);
+  ASSERT_NE(stats_->ToString().find("tier 1 DataBlock: admissions 1 hits 1"),
+            std::string::npos);
+
+  // Erase forgets the entry and its history
+  sec_cache_->Erase(Key(1));
+  ASSERT_EQ(tiered()->TEST_GetEvictionCount(Key(1)), 0);
+  ASSERT_EQ(LookupAsync(Key(1), &kept_in_sec_cache), "");
+
+  stats_->Reset();
+  ASSERT_EQ(stats_->GetHits(1, kData), 0);
+  ASSERT_EQ(stats_->ToString(), "");
+}
+
+TEST_F(TieredSecondaryCacheTest, DemoteByRole) {
+  NewTieredCache();
+  const CacheEntryRole kFilter = CacheEntryRole::kFilterBlock;
+
+  Random rnd(301);
+  std::string str1 = rnd.RandomString(1000);
+  for (int i = 0; i < 3; ++i) {
+    Evict(Key(1), str1, kFilter);
+  }
+  // The file tier does not take filter blocks, so the third eviction lands in
+  // the compressed tier again
+  ASSERT_EQ(stats_->GetRejections(kFilter), 1);
+  ASSERT_EQ(stats_->GetAdmissions(0, kFilter), 2);
+  ASSERT_EQ(stats_->GetAdmissions(1, kFilter), 0);
+  bool kept_in_sec_cache = true;
+  ASSERT_EQ(LookupAsync(Key(1), &kept_in_sec_cache, kFilter), str1);
+  ASSERT_EQ(stats_->GetHits(0, kFilter), 1);
+}
+
+TEST_F(TieredSecondaryCacheTest, WaitAllAcrossTiers) {
+  NewTieredCache();
+
+  Random rnd(301);
+  const int kNumItems = 20;
+  std::vector<std::string> values;
+  for (int i = 0; i < kNumItems; ++i) {
+    values.push_back(rnd.RandomString(500 + i));
+    // Even keys end up in the compressed tier, odd keys in the file tier
+    for (int j = 0; j < 2 + (i % 2); ++j) {
+      Evict(Key(i), values.back());
+    }
+  }
+
+  std::vector<std::unique_ptr<SecondaryCacheResultHandle>> handles;
+  std::vector<SecondaryCacheResultHandle*> handle_ptrs;
+  // Must stay valid until the handles are ready
+  bool kept_in_sec_cache[kNumItems + 1];
+  for (int i = 0; i < kNumItems + 1; ++i) {
+    auto handle = sec_cache_->Lookup(Key(i), GetHelper(), this,
+                                     /*wait=*/false, /*advise_erase=*/true,
+                                     kept_in_sec_cache[i]);
+    if (i == kNumItems) {
+      // Never inserted
+      ASSERT_EQ(handle, nullptr);
+      continue;
+    }
+    ASSERT_NE(handle, nullptr);
+    handle_ptrs.push_back(handle.get());
+    handles.push_back(std::move(handle));
+  }
+  sec_cache_->WaitAll(handle_ptrs);
+  for (int i = 0; i < kNumItems; ++i) {
+    ASSERT_TRUE(handles[i]->IsReady());
+    // The compressed tier gives entries up, the file tier keeps them
+    ASSERT_EQ(kept_in_sec_cache[i], i % 2 == 1);
+    std::unique_ptr<TestItem> val(static_cast<TestItem*>(handles[i]->Value()));
+    ASSERT_NE(val, nullptr);
+    ASSERT_EQ(val->ToString(), values[i]);
+  }
+  ASSERT_EQ(stats_->GetHits(0, CacheEntryRole::kDataBlock), kNumItems / 2);
+  ASSERT_EQ(stats_->GetHits(1, CacheEntryRole::kDataBlock), kNumItems / 2);
+}
+
+namespace {
+
+// A tier that claims to keep every entry, but whose async lookups all
+// complete as misses
+class MissingTier : public SecondaryCache {
+ public:
+  class Handle : public SecondaryCacheResultHandle {
+   public:
+    bool IsReady() override { return ready_; }
+    void Wait() override { ready_ = true; }
+    Cache::ObjectPtr Value() override { return nullptr; }
+    size_t Size() override { return 0; }
+
+   private:
+    bool ready_ = false;
+  };
+
+  const char* Name() const override { return "MissingTier"; }
+  Status Insert(const Slice& /*key*/, Cache::ObjectPtr /*obj*/,
+                const Cache::CacheItemHelper* /*helper*/) override {
+    return Status::OK();
+  }
+  std::unique_ptr<SecondaryCacheResultHandle> Lookup(
+      const Slice& /*key*/, const Cache::CacheItemHelper* /*helper*/,
+      Cache::CreateContext* /*create_context*/, bool wait,
+      bool /*advise_erase*/, bool& kept_in_sec_cache) override {
+    if (wait) {
+      return nullptr;
+    }
+    kept_in_sec_cache = true;
+    return std::make_unique<Handle>();
+  }
+  bool SupportForceErase() const override { return false; }
+  void Erase(const Slice& /*key*/) override {}
+  void WaitAll(std::vector<SecondaryCacheResultHandle*> handles) override {
+    for (SecondaryCacheResultHandle* h : handles) {
+      h->Wait();
+    }
+  }
+};
+
+}  // namespace
+
+TEST_F(TieredSecondaryCacheTest, KeptFromReturningTier) {
+  // Every async lookup misses in the first tier, so that WaitAll() moves
+  // the handle on to the compressed tier
+  CompressedSecondaryCacheOptions compressed_opts;
+  compressed_opts.capacity = 1 << 20;
+  compressed_opts.compression_type = kNoCompression;
+  TieredSecondaryCacheOptions opts;
+  opts.tiers.push_back(
+      {std::make_shared<MissingTier>(), 1, CacheEntryRoleSet::All()});
+  opts.tiers.push_back(
+      {compressed_opts.MakeSharedSecondaryCache(), 1, CacheEntryRoleSet::All()});
+  opts.stats = stats_;
+  ASSERT_OK(NewTieredSecondaryCache(opts, &sec_cache_));
+
+  Random rnd(301);
+  std::string str1 = rnd.RandomString(1000);
+  // Lands in the compressed tier
+  Evict(Key(1), str1);
+
+  for (bool advise_erase : {false, true}) {
+    bool kept_in_sec_cache = advise_erase;
+    std::unique_ptr<SecondaryCacheResultHandle> handle =
+        sec_cache_->Lookup(Key(1), GetHelper(), this, /*wait=*/false,
+                           advise_erase, kept_in_sec_cache);
+    ASSERT_NE(handle, nullptr);
+    sec_cache_->WaitAll({handle.get()});
+    ASSERT_TRUE(handle->IsReady());
+    std::unique_ptr<TestItem> val(static_cast<TestItem*>(handle->Value()));
+    ASSERT_NE(val, nullptr);
+    ASSERT_EQ(val->ToString(), str1);
+    ASSERT_EQ(kept_in_sec_cache, !advise_erase);
+  }
+  ASSERT_EQ(stats_->GetHits(0, CacheEntryRole::kDataBlock), 0);
+  ASSERT_EQ(stats_->GetHits(1, CacheEntryRole::kDataBlock), 2);
+
+  // The compressed tier gave the entry up on the last lookup
+  bool kept_in_sec_cache = true;
+  ASSERT_EQ(LookupAsync(Key(1), &kept_in_sec_cache), "");
+  ASSERT_FALSE(kept_in_sec_cache);
+}
+
+TEST_F(TieredSecondaryCacheTest, IntegrationWithPrimaryCache) {
+  NewTieredCache();
+  std::shared_ptr<Cache> cache =
+      NewCache(/*capacity=*/2300, /*num_shard_bits=*/0,
+               /*strict_capacity_limit=*/false, sec_cache_);
+
+  Random rnd(301);
+  std::vector<std::string> values;
+  for (int i = 0; i < 6; ++i) {
+    values.push_back(rnd.RandomString(1000));
+  }
+  // Cycle through more entries than fit, so that each is evicted repeatedly
+  for (int round = 0; round < 4; ++round) {
+    for (int i = 0; i < 6; ++i) {
+      Cache::Handle* handle = cache->Lookup(Key(i), GetHelper(), this,
+                                            Cache::Priority::LOW);
+      if (handle == nullptr) {
+        auto item = new TestItem(values[i].data(), values[i].length());
+        ASSERT_OK(cache->Insert(Key(i), item, GetHelper(), values[i].length()));
+      } else {
+        auto val = static_cast<TestItem*>(cache->Value(handle));
+        ASSERT_EQ(val->ToString(), values[i]);
+        cache->Release(handle);
+      }
+    }
+  }
+  const CacheEntryRole kData = CacheEntryRole::kDataBlock;
+  ASSERT_GT(stats_->GetRejections(kData), 0);
+  ASSERT_GT(stats_->GetHits(0, kData), 0);
+  ASSERT_GT(stats_->GetAdmissions(1, kData), 0);
+  cache.reset();
+}
+
+TEST_F(TieredSecondaryCacheTest, InvalidOptions) {
+  std::shared_ptr<SecondaryCache> sec_cache;
+  TieredSecondaryCacheOptions opts;
+  ASSERT_TRUE(NewTieredSecondaryCache(opts, &sec_cache).IsInvalidArgument());
+
+  CompressedSecondaryCacheOptions compressed_opts;
+  compressed_opts.capacity = 1 << 20;
+  opts.tiers.push_back({compressed_opts.MakeSharedSecondaryCache(), 3,
+                        CacheEntryRoleSet::All()});
+  opts.tiers.push_back({compressed_opts.MakeSharedSecondaryCache(), 2,
+                        CacheEntryRoleSet::All()});
+  ASSERT_TRUE(NewTieredSecondaryCache(opts, &sec_cache).IsInvalidArgument());
+  opts.tiers.pop_back();
+  ASSERT_OK(NewTieredSecondaryCache(opts, &sec_cache));
+  ASSERT_STREQ(sec_cache->Name(), "TieredSecondaryCache");
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
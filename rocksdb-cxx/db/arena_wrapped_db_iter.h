@@ -69,6 +69,9 @@ class ArenaWrappedDBIter : public Iterator {
     db_iter_->SeekForPrev(target);
   }
   void Next() override { db_iter_->Next(); }
+  Status NextBatch(size_t max_entries, IteratorBatch* batch) override {
+    return db_iter_->NextBatch(max_entries, batch);
+  }
   void Prev() override { db_iter_->Prev(); }
   Slice key() const override { return db_iter_->key(); }
   Slice value() const override { return db_iter_->value(); }
@@ -9,6 +9,7 @@
 
 #include "db/compaction/compaction.h"
 
+#include <algorithm>
 #include <cinttypes>
 #include <vector>
 
@@ -296,12 +297,33 @@ Compaction::Compaction(
   }
 #endif
 
+  PopulateFilesToMove(vstorage);
+
   // setup input_levels_
   {
     input_levels_.resize(num_input_levels());
+    if (!files_to_move_.empty()) {
+      input_boundaries_.resize(num_input_levels());
+    }
     for (size_t which = 0; which < num_input_levels(); which++) {
-      DoGenerateLevelFilesBrief(&input_levels_[which], inputs_[which].files,
-                                &arena_);
+      if (files_to_move_.empty()) {
+        DoGenerateLevelFilesBrief(&input_levels_[which], inputs_[which].files,
+                                  &arena_);
+        continue;
+      }
+      std::vector<FileMetaData*> files;
+      const CompactionInputFiles& level_inputs = inputs_[which];
+      for (size_t i = 0; i < level_inputs.size(); i++) {
+        if (IsFileToMove(level_inputs[i])) {
+          continue;
+        }
+        files.push_back(level_inputs[i]);
+        if (!level_inputs.atomic_compaction_unit_boundaries.empty()) {
+          input_boundaries_[which].push_back(
+              level_inputs.atomic_compaction_unit_boundaries[i]);
+        }
+      }
+      DoGenerateLevelFilesBrief(&input_levels_[which], files, &arena_);
     }
   }
 
@@ -436,6 +458,124 @@ bool Compaction::InputCompressionMatchesOutput() const {
   return matches;
 }
 
+void Compaction::PopulateFilesToMove(VersionStorageInfo* vstorage) {
+  if (!immutable_options_.compaction_move_non_overlapping_files ||
+      output_level_ == 0 || start_level_ == output_level_ ||
+      deletion_compaction_ || is_manual_compaction_ || !trim_ts_.empty() ||
+      SupportsPerKeyPlacement() ||
+      immutable_options_.compaction_filter != nullptr ||
+      immutable_options_.compaction_filter_factory != nullptr ||
+      immutable_options_.compaction_service != nullptr) {
+    return;
+  }
+  switch (compaction_reason_) {
+    case CompactionReason::kLevelL0FilesNum:
+    case CompactionReason::kLevelMaxLevelSize:
+    case CompactionReason::kUniversalSizeAmplification:
+    case CompactionReason::kUniversalSizeRatio:
+    case CompactionReason::kUniversalSortedRunNum:
+      break;
+    default:
+      // Compactions for other reasons, like TTL or files marked for
+      // compaction, are meant to rewrite their input files.
+      return;
+  }
+
+  const Comparator* ucmp = vstorage->InternalComparator()->user_comparator();
+  const int base_level = vstorage->base_level();
+  std::unique_ptr<SstPartitioner> partitioner = CreateSstPartitioner();
+  for (const CompactionInputFiles& level_inputs : inputs_) {
+    // Files of the output level stay where they are anyway
+    if (level_inputs.level == output_level_ ||
+        GetCompressionType(vstorage, mutable_cf_options_, level_inputs.level,
+                           base_level) != output_compression_) {
+      continue;
+    }
+    for (FileMetaData* f : level_inputs.files) {
+      if (f->fd.GetPathId() != output_path_id_ || f->marked_for_compaction) {
+        continue;
+      }
+      // In the bottommost level the compaction could drop the tombstones
+      if (bottommost_level_ &&
+          (!f->init_stats_from_file || f->num_deletions > 0)) {
+        continue;
+      }
+      if (enable_blob_garbage_collection_ &&
+          f->oldest_blob_file_number != kInvalidBlobFileNumber) {
+        continue;
+      }
+      const Slice smallest = f->smallest.user_key();
+      const Slice largest = f->largest.user_key();
+      if (vstorage->OverlapInLevel(output_level_, &smallest, &largest)) {
+        continue;
+      }
+      bool overlaps = false;
+      for (const CompactionInputFiles& other_inputs : inputs_) {
+        if (other_inputs.level == output_level_) {
+          continue;
+        }
+        for (const FileMetaData* other : other_inputs.files) {
+          if (other != f &&
+              ucmp->CompareWithoutTimestamp(other->smallest.user_key(),
+                                            largest) <= 0 &&
+              ucmp->CompareWithoutTimestamp(smallest,
+                                            other->largest.user_key()) <= 0) {
+            overlaps = true;
+            break;
+          }
+        }
+        if (overlaps) {
+          break;
+        }
+      }
+      if (overlaps) {
+        continue;
+      }
+      // Same as for a trivial move, avoid creating a file that would require
+      // a very expensive compaction into the next level later on.
+      if (output_level_ + 1 < number_levels_) {
+        std::vector<FileMetaData*> file_grand_parents;
+        vstorage->GetOverlappingInputs(output_level_ + 1, &f->smallest,
+                                       &f->largest, &file_grand_parents);
+        if (f->fd.GetFileSize() + TotalFileSize(file_grand_parents) >
+            max_compaction_bytes_) {
+          continue;
+        }
+      }
+      if (partitioner != nullptr &&
+          !partitioner->CanDoTrivialMove(smallest, largest)) {
+        continue;
+      }
+      files_to_move_.push_back(f);
+    }
+  }
+
+  // Output files take the range tombstones up to the next output's first key,
+  // or up to the end of the subcompaction, not only up to their last point
+  // key. A tombstone from another input could then make an output span a
+  // moved file, so nothing is moved when the rewritten inputs have any.
+  for (const CompactionInputFiles& level_inputs : inputs_) {
+    for (const FileMetaData* f : level_inputs.files) {
+      if (!IsFileToMove(f) &&
+          (!f->init_stats_from_file || f->num_range_deletions > 0)) {
+        files_to_move_.clear();
+        return;
+      }
+    }
+  }
+
+  const InternalKeyComparator* icmp = vstorage->InternalComparator();
+  std::sort(files_to_move_.begin(), files_to_move_.end(),
+            [icmp](const FileMetaData* a, const FileMetaData* b) {
+              return icmp->Compare(a->smallest, b->smallest) < 0;
+            });
+}
+
+bool Compaction::IsFileToMove(const FileMetaData* f) const {
+  return std::find(files_to_move_.begin(), files_to_move_.end(), f) !=
+         files_to_move_.end();
+}
+
 bool Compaction::IsTrivialMove() const {
   // Avoid a move if there is lots of overlapping grandparent data.
   // Otherwise, the move could create a parent file that will require
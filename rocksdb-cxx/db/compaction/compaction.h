@@ -146,9 +146,14 @@ class Compaction {
     return inputs_[compaction_input_level][i];
   }
 
+  // Returns the atomic compaction unit boundaries of the files in
+  // input_levels(compaction_input_level).
   const std::vector<AtomicCompactionUnitBoundary>* boundaries(
       size_t compaction_input_level) const {
     assert(compaction_input_level < inputs_.size());
+    if (!files_to_move_.empty()) {
+      return &input_boundaries_[compaction_input_level];
+    }
     return &inputs_[compaction_input_level].atomic_compaction_unit_boundaries;
   }
 
@@ -164,11 +169,21 @@ class Compaction {
 
   const std::vector<CompactionInputFiles>* inputs() { return &inputs_; }
 
-  // Returns the LevelFilesBrief of the specified compaction input level.
+  // Returns the LevelFilesBrief of the specified compaction input level,
+  // without the files in files_to_move().
   const LevelFilesBrief* input_levels(size_t compaction_input_level) const {
     return &input_levels_[compaction_input_level];
   }
 
+  // Input files that are moved to the output level unchanged instead of
+  // being read and rewritten, sorted by smallest key. See
+  // `AdvancedColumnFamilyOptions::compaction_move_non_overlapping_files`.
+  const std::vector<FileMetaData*>& files_to_move() const {
+    return files_to_move_;
+  }
+
+  bool IsFileToMove(const FileMetaData* f) const;
+
   // Maximum size of files to build during this compaction.
   uint64_t max_output_file_size() const { return max_output_file_size_; }
 
@@ -423,6 +438,10 @@ class Compaction {
   // `Compaction::WithinPenultimateLevelOutputRange()`.
   void PopulatePenultimateLevelOutputRange();
 
+  // populate files_to_move_ with the input files whose key range no other
+  // input overlaps, and that can move to the output level as they are
+  void PopulateFilesToMove(VersionStorageInfo* vstorage);
+
   // Get the atomic file boundaries for all files in the compaction. Necessary
   // in order to avoid the scenario described in
   // https://github.com/facebook/rocksdb/pull/4432#discussion_r221072219 and
@@ -473,9 +492,16 @@ class Compaction {
   // Compaction input files organized by level. Constant after construction
   const std::vector<CompactionInputFiles> inputs_;
 
-  // A copy of inputs_, organized more closely in memory
+  // A copy of inputs_ without files_to_move_, organized more closely in memory
   autovector<LevelFilesBrief, 2> input_levels_;
 
+  // Atomic compaction unit boundaries of the files in input_levels_. Only
+  // set if files_to_move_ is not empty.
+  autovector<std::vector<AtomicCompactionUnitBoundary>, 2> input_boundaries_;
+
+  // Input files moved to the output level without being rewritten
+  std::vector<FileMetaData*> files_to_move_;
+
   // State used to check for number of overlapping grandparent files
   // (grandparent == "output_level_ + 1")
   std::vector<FileMetaData*> grandparents_;
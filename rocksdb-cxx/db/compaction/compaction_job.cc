@@ -1674,6 +1674,24 @@ Status CompactionJob::InstallCompactionResults(
   // Add compaction inputs
   compaction->AddInputDeletions(edit);
 
+  // Add back the input files moved to the output level as they are
+  for (const FileMetaData* f : compaction->files_to_move()) {
+    edit->AddFile(compaction->output_level(), f->fd.GetNumber(),
+                  f->fd.GetPathId(), f->fd.GetFileSize(), f->smallest,
+                  f->largest, f->fd.smallest_seqno, f->fd.largest_seqno,
+                  f->marked_for_compaction, f->temperature,
+                  f->oldest_blob_file_number, f->oldest_ancester_time,
+                  f->file_creation_time, f->epoch_number, f->file_checksum,
+                  f->file_checksum_func_name, f->unique_id,
+                  f->compensated_range_deletion_size);
+    ROCKS_LOG_BUFFER(log_buffer_,
+                     "[%s] [JOB %d] Moving #%" PRIu64 " to level-%d %" PRIu64
+                     " bytes",
+                     compaction->column_family_data()->GetName().c_str(),
+                     job_id_, f->fd.GetNumber(), compaction->output_level(),
+                     f->fd.GetFileSize());
+  }
+
   std::unordered_map<uint64_t, BlobGarbageMeter::BlobStats> blob_total_garbage;
 
   for (const auto& sub_compact : compact_->sub_compact_states) {
@@ -1925,6 +1943,10 @@ void CompactionJob::UpdateCompactionStats() {
     }
   }
 
+  for (const FileMetaData* f : compaction->files_to_move()) {
+    compaction_stats_.stats.bytes_moved += f->fd.GetFileSize();
+  }
+
   assert(compaction_job_stats_);
   compaction_stats_.stats.bytes_read_blob =
       compaction_job_stats_->total_blob_bytes_read;
@@ -1938,10 +1960,14 @@ void CompactionJob::UpdateCompactionInputStatsHelper(int* num_files,
                                                      int input_level) {
   const Compaction* compaction = compact_->compaction;
   auto num_input_files = compaction->num_input_files(input_level);
-  *num_files += static_cast<int>(num_input_files);
 
   for (size_t i = 0; i < num_input_files; ++i) {
     const auto* file_meta = compaction->input(input_level, i);
+    if (compaction->IsFileToMove(file_meta)) {
+      // Not read by the compaction
+      continue;
+    }
+    ++*num_files;
     *bytes_read += file_meta->fd.GetFileSize();
     compaction_stats_.stats.num_input_records +=
         static_cast<uint64_t>(file_meta->num_entries);
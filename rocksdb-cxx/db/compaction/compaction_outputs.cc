@@ -116,6 +116,23 @@ bool CompactionOutputs::UpdateFilesToCutForTTLStates(
   return false;
 }
 
+bool CompactionOutputs::UpdateFilesToMoveStates(const Slice& internal_key) {
+  const std::vector<FileMetaData*>& files_to_move =
+      compaction_->files_to_move();
+  const InternalKeyComparator* icmp =
+      &compaction_->column_family_data()->internal_comparator();
+  bool crossed = false;
+  // No compaction key is within the range of a moved file
+  while (next_file_to_move_ < files_to_move.size() &&
+         icmp->Compare(internal_key,
+                       files_to_move[next_file_to_move_]->largest.Encode()) >
+             0) {
+    crossed = true;
+    next_file_to_move_++;
+  }
+  return crossed;
+}
+
 size_t CompactionOutputs::UpdateGrandparentBoundaryInfo(
     const Slice& internal_key) {
   size_t curr_key_boundary_switched_num = 0;
@@ -240,21 +257,23 @@ bool CompactionOutputs::ShouldStopBefore(const CompactionIterator& c_iter) {
       &compaction_->column_family_data()->internal_comparator();
   size_t num_grandparent_boundaries_crossed = 0;
   bool should_stop_for_ttl = false;
+  bool should_stop_for_moved_file = false;
   // Always update grandparent information like overlapped file number, size
-  // etc., and TTL states.
+  // etc., TTL states and moved files states.
   // If compaction_->output_level() == 0, there is no need to update grandparent
   // info, and that `grandparent` should be empty.
   if (compaction_->output_level() > 0) {
     num_grandparent_boundaries_crossed =
         UpdateGrandparentBoundaryInfo(internal_key);
     should_stop_for_ttl = UpdateFilesToCutForTTLStates(internal_key);
+    should_stop_for_moved_file = UpdateFilesToMoveStates(internal_key);
   }
 
   if (!HasBuilder()) {
     return false;
   }
 
-  if (should_stop_for_ttl) {
+  if (should_stop_for_ttl || should_stop_for_moved_file) {
     return true;
   }
 
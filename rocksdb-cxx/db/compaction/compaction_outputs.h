@@ -234,6 +234,12 @@ class CompactionOutputs {
   // @param internal_key the current key to be added to output.
   bool UpdateFilesToCutForTTLStates(const Slice& internal_key);
 
+  // Updates the position among the files the compaction moves to the output
+  // level. Returns true if `internal_key` is after a moved file that the
+  // previous key was before, so that the current output file has to be cut
+  // to not overlap the moved file.
+  bool UpdateFilesToMoveStates(const Slice& internal_key);
+
   // update tracked grandparents information like grandparent index, if it's
   // in the gap between 2 grandparent files, accumulated grandparent files size
   // etc.
@@ -334,6 +340,10 @@ class CompactionOutputs {
   int cur_files_to_cut_for_ttl_ = -1;
   int next_files_to_cut_for_ttl_ = 0;
 
+  // Index of the first file in compaction_->files_to_move() that is after
+  // the last key checked by ShouldStopBefore()
+  size_t next_file_to_move_ = 0;
+
   // An index that used to speed up ShouldStopBefore().
   size_t grandparent_index_ = 0;
 
@@ -444,6 +444,61 @@ TEST_F(DBBasicTest, GetSnapshot) {
   } while (ChangeOptions());
 }
 
+TEST_F(DBBasicTest, ConcurrentL0Probes) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.statistics = CreateDBStatistics();
+  options.merge_operator = MergeOperators::CreateStringAppendOperator();
+  BlockBasedTableOptions table_options;
+  table_options.filter_policy.reset(NewBloomFilterPolicy(10));
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  // Four overlapping L0 files
+  const Snapshot* snapshot = nullptr;
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_OK(Put("a", "a" + std::to_string(i)));
+    ASSERT_OK(Merge("m", std::to_string(i)));
+    ASSERT_OK(Put("z", "z"));
+    if (i == 1) {
+      snapshot = db_->GetSnapshot();
+    }
+    ASSERT_OK(Flush());
+  }
+  ASSERT_EQ("4", FilesPerLevel());
+
+  // The probes do not start before the newest file answers the key, and
+  // then skip the older files
+  SyncPoint::GetInstance()->LoadDependency(
+      {{"Version::L0Probes::Stop", "Version::L0Probes::RunJob"}});
+  SyncPoint::GetInstance()->EnableProcessing();
+  ReadOptions read_options;
+  read_options.concurrent_l0_probes = 3;
+  std::string value;
+  uint64_t data_blocks = TestGetTickerCount(options, BLOCK_CACHE_DATA_ADD);
+  ASSERT_OK(db_->Get(read_options, "a", &value));
+  ASSERT_EQ("a3", value);
+  ASSERT_EQ(data_blocks + 1, TestGetTickerCount(options, BLOCK_CACHE_DATA_ADD));
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearTrace();
+
+  // All of the files are needed for the merge operands
+  ASSERT_OK(db_->Get(read_options, "m", &value));
+  ASSERT_EQ("0,1,2,3", value);
+  ASSERT_EQ(data_blocks + 4, TestGetTickerCount(options, BLOCK_CACHE_DATA_ADD));
+  read_options.snapshot = snapshot;
+  ASSERT_OK(db_->Get(read_options, "a", &value));
+  ASSERT_EQ("a1", value);
+  ASSERT_OK(db_->Get(read_options, "m", &value));
+  ASSERT_EQ("0,1", value);
+  read_options.snapshot = nullptr;
+
+  // Outside of all of the files
+  ASSERT_TRUE(db_->Get(read_options, "zz", &value).IsNotFound());
+  ASSERT_EQ(data_blocks + 4, TestGetTickerCount(options, BLOCK_CACHE_DATA_ADD));
+  db_->ReleaseSnapshot(snapshot);
+}
+
 TEST_F(DBBasicTest, CheckLock) {
   do {
     DB* localdb = nullptr;
@@ -1061,6 +1116,61 @@ TEST_F(DBBasicTest, MultiGetEmpty) {
   } while (ChangeCompactOptions());
 }
 
+TEST_F(DBBasicTest, MultiGetSeparatedValuesNoBlockCache) {
+  Options options = CurrentOptions();
+  if (Snappy_Supported()) {
+    options.compression = kSnappyCompression;
+  }
+  BlockBasedTableOptions table_options;
+  table_options.no_block_cache = true;
+  table_options.data_block_separate_values = true;
+  table_options.block_size = 256;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+
+  for (int i = 0; i < 200; i += 2) {
+    ASSERT_OK(Put(Key(i), "value" + std::to_string(i)));
+  }
+  ASSERT_OK(Flush());
+
+  // Data blocks are read into owned blocks, which have to be parsed with the
+  // table's data block format
+  std::vector<std::string> keys;
+  std::vector<std::string> expected;
+  for (int i = 0; i < 200; i += 5) {
+    keys.push_back(Key(i));
+    expected.push_back(i % 2 == 0 ? "value" + std::to_string(i) : "NOT_FOUND");
+  }
+  ASSERT_EQ(expected, MultiGet(keys, nullptr));
+}
+
+TEST_F(DBBasicTest, MultiGetMiniBlocksNoBlockCache) {
+  Options options = CurrentOptions();
+  if (Snappy_Supported()) {
+    options.compression = kSnappyCompression;
+  }
+  BlockBasedTableOptions table_options;
+  table_options.no_block_cache = true;
+  table_options.data_block_mini_block_restarts = 2;
+  table_options.block_restart_interval = 4;
+  table_options.block_size = 1024;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+
+  for (int i = 0; i < 400; i += 2) {
+    ASSERT_OK(Put(Key(i), "value" + std::to_string(i)));
+  }
+  ASSERT_OK(Flush());
+
+  std::vector<std::string> keys;
+  std::vector<std::string> expected;
+  for (int i = 0; i < 400; i += 5) {
+    keys.push_back(Key(i));
+    expected.push_back(i % 2 == 0 ? "value" + std::to_string(i) : "NOT_FOUND");
+  }
+  ASSERT_EQ(expected, MultiGet(keys, nullptr));
+}
+
 class DBBlockChecksumTest : public DBBasicTest,
                             public testing::WithParamInterface<uint32_t> {};
 
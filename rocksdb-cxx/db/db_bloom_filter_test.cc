@@ -790,6 +790,65 @@ TEST_F(DBBloomFilterTest, BloomFilterRate) {
   }
 }
 
+TEST_F(DBBloomFilterTest, PinFiltersInFileMetadata) {
+  for (bool partition_filters : {false, true}) {
+    Options options = CurrentOptions();
+    options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+    options.max_open_files = -1;
+    BlockBasedTableOptions table_options;
+    table_options.filter_policy.reset(NewBloomFilterPolicy(20));
+    table_options.cache_index_and_filter_blocks = true;
+    table_options.pin_filters_in_file_metadata = true;
+    if (partition_filters) {
+      table_options.partition_filters = true;
+      table_options.index_type =
+          BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch;
+      table_options.metadata_block_size = 256;
+    }
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    DestroyAndReopen(options);
+
+    const int kNumKeys = 2000;
+    for (int i = 0; i < kNumKeys; i++) {
+      ASSERT_OK(Put(Key(2 * i), "v" + std::to_string(i)));
+    }
+    ASSERT_OK(Flush());
+    MoveFilesToLevel(1);
+    ASSERT_EQ("0,1", FilesPerLevel());
+
+    ASSERT_OK(options.statistics->Reset());
+    for (int i = 0; i < kNumKeys; i++) {
+      ASSERT_EQ("v" + std::to_string(i), Get(Key(2 * i)));
+    }
+    ASSERT_EQ(TestGetTickerCount(options, BLOOM_FILTER_USEFUL), 0);
+
+    // Keys ruled out by the copies of the filters do not touch the block cache
+    ASSERT_OK(options.statistics->Reset());
+    for (int i = 0; i < kNumKeys - 1; i++) {
+      ASSERT_EQ("NOT_FOUND", Get(Key(2 * i + 1)));
+    }
+    ASSERT_GE(TestGetTickerCount(options, BLOOM_FILTER_USEFUL),
+              (kNumKeys - 1) * 0.98);
+    ASSERT_LE(TestGetTickerCount(options, BLOCK_CACHE_FILTER_HIT) +
+                  TestGetTickerCount(options, BLOCK_CACHE_FILTER_MISS),
+              2 * TestGetTickerCount(options, BLOOM_FILTER_FULL_POSITIVE));
+
+    // A file with range deletions must still be read for its tombstones
+    DestroyAndReopen(options);
+    ASSERT_OK(Put(Key(0), "v0"));
+    ASSERT_OK(Flush());
+    MoveFilesToLevel(2);
+    ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                               Key(0), Key(1)));
+    ASSERT_OK(Put(Key(1), "v1"));
+    ASSERT_OK(Flush());
+    MoveFilesToLevel(1);
+    ASSERT_EQ("0,1,1", FilesPerLevel());
+    ASSERT_EQ("NOT_FOUND", Get(Key(0)));
+    ASSERT_EQ("v1", Get(Key(1)));
+  }
+}
+
 namespace {
 struct CompatibilityConfig {
   std::shared_ptr<const FilterPolicy> policy;
@@ -3470,6 +3529,100 @@ TEST_F(DBBloomFilterTest, WeirdPrefixExtractorWithFilter3) {
   }
 }
 
+TEST_F(DBBloomFilterTest, RangeFilter) {
+  Options options = CurrentOptions();
+  options.statistics = CreateDBStatistics();
+  options.disable_auto_compactions = true;
+  BlockBasedTableOptions bbto;
+  bbto.range_filter_bits_per_key = 20;
+  bbto.block_size = 256;
+  options.table_factory.reset(NewBlockBasedTableFactory(bbto));
+  DestroyAndReopen(options);
+
+  auto key = [](int i) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "key%05d", i);
+    return std::string(buf);
+  };
+  std::map<std::string, std::string> expected;
+  auto put = [&](int i) {
+    ASSERT_OK(Put(key(i), "v" + std::to_string(i)));
+    expected[key(i)] = "v" + std::to_string(i);
+  };
+  // L0 files whose key ranges overlap but whose keys are clustered apart
+  for (int i = 0; i < 1000; ++i) {
+    put(i);
+    put(9000 + i);
+  }
+  ASSERT_OK(Flush());
+  for (int i = 4000; i < 5000; i += 2) {
+    put(i);
+  }
+  ASSERT_OK(Flush());
+  // A tombstone in a newer file must still hide the older value. The file
+  // needs enough keys for its filter to tell them apart.
+  for (int i = 9500; i < 9600; ++i) {
+    put(i);
+  }
+  ASSERT_OK(Delete(key(4100)));
+  expected.erase(key(4100));
+  ASSERT_OK(Flush());
+
+  auto scan = [&](int lower, int upper) {
+    std::string lower_key = key(lower);
+    std::string upper_key = key(upper);
+    Slice lower_bound(lower_key);
+    Slice upper_bound(upper_key);
+    ReadOptions ro;
+    ro.iterate_lower_bound = &lower_bound;
+    ro.iterate_upper_bound = &upper_bound;
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ro));
+    std::vector<std::string> found;
+    for (iter->Seek(lower_key); iter->Valid(); iter->Next()) {
+      found.push_back(iter->key().ToString());
+    }
+    EXPECT_OK(iter->status());
+    std::vector<std::string> found_backward;
+    for (iter->SeekForPrev(upper_key); iter->Valid(); iter->Prev()) {
+      if (iter->key().compare(upper_bound) < 0) {
+        found_backward.insert(found_backward.begin(), iter->key().ToString());
+      }
+    }
+    EXPECT_OK(iter->status());
+    EXPECT_EQ(found, found_backward);
+    std::vector<std::string> want;
+    for (auto it = expected.lower_bound(lower_key);
+         it != expected.end() && it->first < upper_key; ++it) {
+      want.push_back(it->first);
+    }
+    EXPECT_EQ(want, found);
+    return static_cast<int>(found.size());
+  };
+
+  for (int compacted = 0; compacted < 2; ++compacted) {
+    // Overlaps every file's key range but only the second file's keys
+    TestGetAndResetTickerCount(options, RANGE_FILTER_USEFUL);
+    ASSERT_EQ(50, scan(4500, 4600));
+    if (!compacted) {
+      // The first and third files are skipped for both Seek() and
+      // SeekForPrev()
+      ASSERT_GE(TestGetTickerCount(options, RANGE_FILTER_USEFUL), 4);
+    }
+    ASSERT_EQ(0, scan(5000, 6000));
+    ASSERT_EQ(49, scan(4099, 4199));
+    ASSERT_EQ(0, scan(2000, 3000));
+    ASSERT_GT(TestGetTickerCount(options, RANGE_FILTER_USEFUL), 0);
+    ASSERT_EQ(static_cast<int>(expected.size()), scan(0, 99999));
+    Random rnd(301);
+    for (int i = 0; i < 200; ++i) {
+      int lower = rnd.Uniform(10000);
+      scan(lower, lower + rnd.Uniform(200));
+    }
+    ASSERT_GT(TestGetTickerCount(options, RANGE_FILTER_CHECKED), 0);
+
+    ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  }
+}
 
 }  // namespace ROCKSDB_NAMESPACE
 
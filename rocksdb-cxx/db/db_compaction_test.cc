@@ -9413,6 +9413,103 @@ TEST_F(DBCompactionTest, DrainUnnecessaryLevelsAfterDBBecomesSmall) {
   ASSERT_GT(after_delete_range_nonempty, final_num_nonempty);
 }
 
+TEST_F(DBCompactionTest, MoveNonOverlappingFiles) {
+  Options options = CurrentOptions();
+  options.level0_file_num_compaction_trigger = 5;
+  options.compaction_move_non_overlapping_files = true;
+  DestroyAndReopen(options);
+
+  // Two pairs of overlapping L0 files with a file between them that no other
+  // file overlaps
+  ASSERT_OK(Put("a1", "v1"));
+  ASSERT_OK(Put("a2", "v1"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put("a1", "v2"));
+  ASSERT_OK(Put("a3", "v1"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put("b1", "v1"));
+  ASSERT_OK(Put("b2", "v1"));
+  ASSERT_OK(Flush());
+
+  std::vector<LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  uint64_t moved_file_number = 0;
+  for (const auto& file : files) {
+    if (file.smallestkey == "b1") {
+      moved_file_number = file.file_number;
+    }
+  }
+  ASSERT_NE(moved_file_number, 0U);
+
+  ASSERT_OK(Put("c1", "v1"));
+  ASSERT_OK(Put("c2", "v1"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put("c1", "v2"));
+  ASSERT_OK(Put("c3", "v1"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+
+  // The output is cut around the moved file
+  ASSERT_EQ("0,3", FilesPerLevel());
+  files.clear();
+  db_->GetLiveFilesMetaData(&files);
+  bool found = false;
+  for (const auto& file : files) {
+    if (file.file_number == moved_file_number) {
+      ASSERT_EQ(1, file.level);
+      found = true;
+    }
+  }
+  ASSERT_TRUE(found);
+
+  Reopen(options);
+  ASSERT_EQ("v2", Get("a1"));
+  ASSERT_EQ("v1", Get("a3"));
+  ASSERT_EQ("v1", Get("b1"));
+  ASSERT_EQ("v1", Get("b2"));
+  ASSERT_EQ("v2", Get("c1"));
+  ASSERT_EQ("v1", Get("c2"));
+}
+
+TEST_F(DBCompactionTest, MoveNonOverlappingFilesWithRangeDeletion) {
+  Options options = CurrentOptions();
+  options.level0_file_num_compaction_trigger = 4;
+  options.compaction_move_non_overlapping_files = true;
+  DestroyAndReopen(options);
+
+  // Keys before the file no other file overlaps, and an input with only a
+  // range tombstone after it
+  ASSERT_OK(Put("a1", "v1"));
+  ASSERT_OK(Put("a2", "v1"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put("a1", "v2"));
+  ASSERT_OK(Put("a3", "v1"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put("b1", "v1"));
+  ASSERT_OK(Put("b2", "v1"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(), "c1",
+                             "c5"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+
+  // The files of L1 do not overlap
+  std::vector<std::vector<FileMetaData>> level_files;
+  dbfull()->TEST_GetFilesMetaData(db_->DefaultColumnFamily(), &level_files);
+  InternalKeyComparator icmp(options.comparator);
+  for (size_t i = 1; i < level_files[1].size(); ++i) {
+    ASSERT_LT(icmp.Compare(level_files[1][i - 1].largest,
+                           level_files[1][i].smallest),
+              0);
+  }
+
+  ASSERT_EQ("v2", Get("a1"));
+  ASSERT_EQ("v1", Get("a2"));
+  ASSERT_EQ("v1", Get("b1"));
+  ASSERT_EQ("v1", Get("b2"));
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -3218,6 +3218,7 @@ Status DBImpl::CreateColumnFamilyImpl(const ColumnFamilyOptions& cf_options,
       if (!cfd->mem()->IsSnapshotSupported()) {
         is_snapshot_supported_ = false;
       }
+      MaybeAddFixedWidthColumnFamily(cfd);
 
       cfd->set_initialized();
 
@@ -3588,6 +3589,187 @@ Status DBImpl::NewIterators(
   return Status::OK();
 }
 
+namespace {
+class ParallelScanImpl : public ParallelScan {
+ public:
+  // Parts are cut at `split_keys`, within [*begin, *end)
+  ParallelScanImpl(DB* db, const Snapshot* owned_snapshot, const Slice* begin,
+                   const Slice* end, std::vector<std::string>&& split_keys)
+      : db_(db), owned_snapshot_(owned_snapshot) {
+    const size_t num_partitions = split_keys.size() + 1;
+    if (begin != nullptr) {
+      keys_.push_back(begin->ToString());
+    }
+    for (std::string& key : split_keys) {
+      keys_.push_back(std::move(key));
+    }
+    if (end != nullptr) {
+      keys_.push_back(end->ToString());
+    }
+    slices_.assign(keys_.begin(), keys_.end());
+    size_t next = 0;
+    for (size_t i = 0; i < num_partitions; ++i) {
+      if (i > 0 || begin != nullptr) {
+        lower_bounds_.push_back(&slices_[next++]);
+      } else {
+        lower_bounds_.push_back(nullptr);
+      }
+      upper_bounds_.push_back(next < slices_.size() ? &slices_[next]
+                                                    : nullptr);
+    }
+  }
+
+  ~ParallelScanImpl() override {
+    iterators_.clear();
+    if (owned_snapshot_ != nullptr) {
+      db_->ReleaseSnapshot(owned_snapshot_);
+    }
+  }
+
+  size_t NumPartitions() const override { return lower_bounds_.size(); }
+  const Slice* LowerBound(size_t i) const override { return lower_bounds_[i]; }
+  const Slice* UpperBound(size_t i) const override { return upper_bounds_[i]; }
+  Iterator* GetIterator(size_t i) override { return iterators_[i].get(); }
+
+  void AddIterator(Iterator* iter) { iterators_.emplace_back(iter); }
+
+ private:
+  DB* const db_;
+  const Snapshot* const owned_snapshot_;
+  std::vector<std::string> keys_;
+  // Not resized once bounds point into it
+  std::vector<Slice> slices_;
+  std::vector<const Slice*> lower_bounds_;
+  std::vector<const Slice*> upper_bounds_;
+  std::vector<std::unique_ptr<Iterator>> iterators_;
+};
+}  // namespace
+
+Status DBImpl::NewParallelScan(const ReadOptions& read_options,
+                               ColumnFamilyHandle* column_family,
+                               size_t num_partitions,
+                               std::unique_ptr<ParallelScan>* scan) {
+  if (num_partitions == 0) {
+    return Status::InvalidArgument("num_partitions must be positive");
+  }
+  if (read_options.tailing) {
+    return Status::NotSupported(
+        "Tailing iterators are not supported in NewParallelScan()");
+  }
+  auto cfd = static_cast_with_check<ColumnFamilyHandleImpl>(column_family)
+                 ->cfd();
+  const Comparator* ucmp = cfd->user_comparator();
+  const size_t ts_sz = ucmp->timestamp_size();
+  const Slice* begin = read_options.iterate_lower_bound;
+  const Slice* end = read_options.iterate_upper_bound;
+  auto in_range = [&](const Slice& user_key) {
+    return (begin == nullptr ||
+            ucmp->CompareWithoutTimestamp(user_key, /*a_has_ts=*/true, *begin,
+                                          /*b_has_ts=*/false) >= 0) &&
+           (end == nullptr ||
+            ucmp->CompareWithoutTimestamp(user_key, /*a_has_ts=*/true, *end,
+                                          /*b_has_ts=*/false) < 0);
+  };
+
+  // As in CompactionJob::GenSubcompactionBoundaries(), sample every file
+  // overlapping the range with the anchor points of its index, each one
+  // the end of a range of about equal size, and cut where the sizes add up.
+  std::vector<TableReader::Anchor> anchors;
+  uint64_t total_size = 0;
+  if (num_partitions > 1) {
+    SuperVersion* sv = GetAndRefSuperVersion(cfd);
+    const VersionStorageInfo* vstorage = sv->current->storage_info();
+    for (int level = 0; level < vstorage->num_non_empty_levels(); ++level) {
+      for (FileMetaData* f : vstorage->LevelFiles(level)) {
+        if ((begin != nullptr &&
+             ucmp->CompareWithoutTimestamp(f->largest.user_key(),
+                                           /*a_has_ts=*/true, *begin,
+                                           /*b_has_ts=*/false) < 0) ||
+            (end != nullptr &&
+             ucmp->CompareWithoutTimestamp(f->smallest.user_key(),
+                                           /*a_has_ts=*/true, *end,
+                                           /*b_has_ts=*/false) >= 0)) {
+          continue;
+        }
+        std::vector<TableReader::Anchor> file_anchors;
+        Status s = cfd->table_cache()->ApproximateKeyAnchors(
+            read_options, cfd->internal_comparator(), *f,
+            sv->mutable_cf_options.block_protection_bytes_per_key,
+            file_anchors);
+        if (!s.ok() || file_anchors.empty()) {
+          file_anchors.clear();
+          file_anchors.emplace_back(f->largest.user_key(),
+                                    f->fd.GetFileSize());
+        }
+        for (TableReader::Anchor& anchor : file_anchors) {
+          if (in_range(anchor.user_key)) {
+            total_size += anchor.range_size;
+            anchors.push_back(std::move(anchor));
+          }
+        }
+      }
+    }
+    ReturnAndCleanupSuperVersion(cfd, sv);
+  }
+  std::sort(anchors.begin(), anchors.end(),
+            [ucmp](const TableReader::Anchor& a, const TableReader::Anchor& b) {
+              return ucmp->CompareWithoutTimestamp(a.user_key, b.user_key) < 0;
+            });
+
+  std::vector<std::string> split_keys;
+  const uint64_t target_size = total_size / num_partitions;
+  uint64_t next_threshold = target_size;
+  uint64_t cumulative_size = 0;
+  for (const TableReader::Anchor& anchor : anchors) {
+    if (split_keys.size() + 1 >= num_partitions) {
+      break;
+    }
+    cumulative_size += anchor.range_size;
+    if (cumulative_size < next_threshold) {
+      continue;
+    }
+    // Keep split keys increasing and after `begin`, so that no part is an
+    // empty range
+    Slice key = StripTimestampFromUserKey(anchor.user_key, ts_sz);
+    if ((begin != nullptr &&
+         ucmp->CompareWithoutTimestamp(key, /*a_has_ts=*/false, *begin,
+                                       /*b_has_ts=*/false) <= 0) ||
+        (!split_keys.empty() &&
+         ucmp->CompareWithoutTimestamp(key, /*a_has_ts=*/false,
+                                       split_keys.back(),
+                                       /*b_has_ts=*/false) <= 0)) {
+      continue;
+    }
+    split_keys.push_back(key.ToString());
+    next_threshold += target_size;
+  }
+
+  ReadOptions part_options(read_options);
+  const Snapshot* owned_snapshot = nullptr;
+  if (part_options.snapshot == nullptr) {
+    owned_snapshot = GetSnapshot();
+    if (owned_snapshot == nullptr) {
+      return Status::NotSupported(
+          "NewParallelScan() needs a snapshot, which is not supported with "
+          "inplace_update_support");
+    }
+    part_options.snapshot = owned_snapshot;
+  }
+  std::unique_ptr<ParallelScanImpl> result(new ParallelScanImpl(
+      this, owned_snapshot, begin, end, std::move(split_keys)));
+  for (size_t i = 0; i < result->NumPartitions(); ++i) {
+    part_options.iterate_lower_bound = result->LowerBound(i);
+    part_options.iterate_upper_bound = result->UpperBound(i);
+    Iterator* iter = NewIterator(part_options, column_family);
+    result->AddIterator(iter);
+    if (!iter->status().ok()) {
+      return iter->status();
+    }
+  }
+  *scan = std::move(result);
+  return Status::OK();
+}
+
 const Snapshot* DBImpl::GetSnapshot() { return GetSnapshotImpl(false); }
 
 const Snapshot* DBImpl::GetSnapshotForWriteConflictBoundary() {
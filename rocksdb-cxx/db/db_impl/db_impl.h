@@ -54,6 +54,7 @@
 #include "rocksdb/env.h"
 #include "rocksdb/memtablerep.h"
 #include "rocksdb/status.h"
+#include "rocksdb/table.h"
 #include "rocksdb/trace_reader_writer.h"
 #include "rocksdb/transaction_log.h"
 #include "rocksdb/utilities/replayer.h"
@@ -342,6 +343,10 @@ class DBImpl : public DB {
       const ReadOptions& options,
       const std::vector<ColumnFamilyHandle*>& column_families,
       std::vector<Iterator*>* iterators) override;
+  virtual Status NewParallelScan(const ReadOptions& options,
+                                 ColumnFamilyHandle* column_family,
+                                 size_t num_partitions,
+                                 std::unique_ptr<ParallelScan>* scan) override;
 
   virtual const Snapshot* GetSnapshot() override;
   virtual void ReleaseSnapshot(const Snapshot* snapshot) override;
@@ -1439,6 +1444,15 @@ class DBImpl : public DB {
                    PreReleaseCallback* pre_release_callback = nullptr,
                    PostMemTableCallback* post_memtable_callback = nullptr);
 
+  // Records the key and value sizes of a column family using fixed-width
+  // tables, so that writes of other sizes are rejected.
+  // REQUIRES: mutex_ held
+  void MaybeAddFixedWidthColumnFamily(ColumnFamilyData* cfd);
+
+  // Returns InvalidArgument if `batch` writes a key or value that a
+  // fixed-width table of its column family cannot store.
+  Status CheckFixedWidthWrites(const WriteBatch& batch) const;
+
   Status PipelinedWriteImpl(const WriteOptions& options, WriteBatch* updates,
                             WriteCallback* callback = nullptr,
                             uint64_t* log_used = nullptr, uint64_t log_ref = 0,
@@ -2462,6 +2476,12 @@ class DBImpl : public DB {
 
   bool is_snapshot_supported_;
 
+  // Options of the column families using fixed-width tables, by column family
+  // ID, or nullptr if there are none. Replaced (atomically, as writes read it
+  // without mutex_) while holding mutex_.
+  std::shared_ptr<const std::unordered_map<uint32_t, FixedWidthTableOptions>>
+      fixed_width_cf_options_;
+
   std::map<uint64_t, std::map<std::string, uint64_t>> stats_history_;
 
   std::map<std::string, uint64_t> stats_slice_;
@@ -18,6 +18,115 @@
 #include "util/cast_util.h"
 
 namespace ROCKSDB_NAMESPACE {
+namespace {
+// Checks the sizes of the keys and values written to column families using
+// fixed-width tables, which cannot store other sizes.
+class FixedWidthWriteChecker : public WriteBatch::Handler {
+ public:
+  explicit FixedWidthWriteChecker(
+      const std::unordered_map<uint32_t, FixedWidthTableOptions>& cf_options)
+      : cf_options_(cf_options) {}
+
+  Status PutCF(uint32_t cf, const Slice& key, const Slice& value) override {
+    return Check(cf, key, &value);
+  }
+
+  Status PutEntityCF(uint32_t cf, const Slice& key,
+                     const Slice& entity) override {
+    return Check(cf, key, &entity);
+  }
+
+  Status DeleteCF(uint32_t cf, const Slice& key) override {
+    return Check(cf, key, nullptr);
+  }
+
+  Status SingleDeleteCF(uint32_t cf, const Slice& key) override {
+    return Check(cf, key, nullptr);
+  }
+
+  Status DeleteRangeCF(uint32_t, const Slice&, const Slice&) override {
+    return Status::OK();
+  }
+
+  Status MergeCF(uint32_t cf, const Slice& key, const Slice& value) override {
+    return Check(cf, key, &value);
+  }
+
+  Status PutBlobIndexCF(uint32_t cf, const Slice& key,
+                        const Slice& value) override {
+    return Check(cf, key, &value);
+  }
+
+  Status MarkBeginPrepare(bool) override { return Status::OK(); }
+
+  Status MarkEndPrepare(const Slice&) override { return Status::OK(); }
+
+  Status MarkCommit(const Slice&) override { return Status::OK(); }
+
+  Status MarkCommitWithTimestamp(const Slice&, const Slice&) override {
+    return Status::OK();
+  }
+
+  Status MarkRollback(const Slice&) override { return Status::OK(); }
+
+  Status MarkNoop(bool /*empty_batch*/) override { return Status::OK(); }
+
+ private:
+  // `value` is nullptr for deletions
+  Status Check(uint32_t cf, const Slice& key, const Slice* value) const {
+    auto it = cf_options_.find(cf);
+    if (it == cf_options_.end()) {
+      return Status::OK();
+    }
+    const FixedWidthTableOptions& options = it->second;
+    if (key.size() != options.key_size) {
+      return Status::InvalidArgument(
+          "Fixed-width table expects keys of size " +
+          std::to_string(options.key_size) + ", got " +
+          std::to_string(key.size()));
+    }
+    if (value != nullptr && value->size() != options.value_size) {
+      return Status::InvalidArgument(
+          "Fixed-width table expects values of size " +
+          std::to_string(options.value_size) + ", got " +
+          std::to_string(value->size()));
+    }
+    return Status::OK();
+  }
+
+  const std::unordered_map<uint32_t, FixedWidthTableOptions>& cf_options_;
+};
+}  // namespace
+
+void DBImpl::MaybeAddFixedWidthColumnFamily(ColumnFamilyData* cfd) {
+  mutex_.AssertHeld();
+  const auto* options =
+      cfd->ioptions()->table_factory->GetOptions<FixedWidthTableOptions>();
+  if (options == nullptr) {
+    return;
+  }
+  auto cf_options =
+      std::make_shared<std::unordered_map<uint32_t, FixedWidthTableOptions>>();
+  if (fixed_width_cf_options_ != nullptr) {
+    *cf_options = *fixed_width_cf_options_;
+  }
+  (*cf_options)[cfd->GetID()] = *options;
+  std::atomic_store(
+      &fixed_width_cf_options_,
+      std::shared_ptr<
+          const std::unordered_map<uint32_t, FixedWidthTableOptions>>(
+          std::move(cf_options)));
+}
+
+Status DBImpl::CheckFixedWidthWrites(const WriteBatch& batch) const {
+  auto cf_options = std::atomic_load(&fixed_width_cf_options_);
+  if (cf_options == nullptr) {
+    return Status::OK();
+  }
+  FixedWidthWriteChecker checker(*cf_options);
+  return batch.Iterate(&checker);
+}
+
 // Convenience methods
 Status DBImpl::Put(const WriteOptions& o, ColumnFamilyHandle* column_family,
                    const Slice& key, const Slice& val) {
@@ -209,6 +318,12 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
              write_options.protection_bytes_per_key != 8) {
     return Status::InvalidArgument(
         "`WriteOptions::protection_bytes_per_key` must be zero or eight");
+  } else if (!disable_memtable) {
+    // Fail writes that would fail to flush before they reach the WAL
+    Status s = CheckFixedWidthWrites(*my_batch);
+    if (!s.ok()) {
+      return s;
+    }
   }
   // TODO: this use of operator bool on `tracer_` can avoid unnecessary lock
   // grabs but does not seem thread-safe.
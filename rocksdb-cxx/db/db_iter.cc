@@ -29,6 +29,7 @@
 #include "rocksdb/system_clock.h"
 #include "table/internal_iterator.h"
 #include "table/iterator_wrapper.h"
+#include "test_util/sync_point.h"
 #include "trace_replay/trace_replay.h"
 #include "util/mutexlock.h"
 #include "util/string_util.h"
@@ -81,7 +82,12 @@ DBIter::DBIter(Env* _env, const ReadOptions& read_options,
       cfd_(cfd),
       timestamp_ub_(read_options.timestamp),
       timestamp_lb_(read_options.iter_start_ts),
-      timestamp_size_(timestamp_ub_ ? timestamp_ub_->size() : 0) {
+      timestamp_size_(timestamp_ub_ ? timestamp_ub_->size() : 0),
+      scan_filter_(read_options.scan_filter),
+      key_only_(read_options.key_only),
+      fast_path_(cmp == BytewiseComparator() && timestamp_size_ == 0 &&
+                 merge_operator_ == nullptr && read_callback_ == nullptr &&
+                 !scan_filter_ && max_skippable_internal_keys_ == 0) {
   RecordTick(statistics_, NO_ITERATOR_CREATED);
   if (pin_thru_lifetime_) {
     pinned_iters_mgr_.StartPinning();
@@ -178,6 +184,18 @@ void DBIter::Next() {
   }
 }
 
+Status DBIter::NextBatch(size_t max_entries, IteratorBatch* batch) {
+  assert(batch != nullptr);
+  batch->Clear();
+  // DBIter is final, so unlike a loop in the caller, this one makes no
+  // virtual calls of its own
+  while (batch->size() < max_entries && valid_) {
+    batch->Add(key(), value());
+    Next();
+  }
+  return status();
+}
+
 bool DBIter::SetBlobValueIfNeeded(const Slice& user_key,
                                   const Slice& blob_index) {
   assert(!is_blob_);
@@ -253,9 +271,102 @@ bool DBIter::SetValueAndColumnsFromEntity(Slice slice) {
 // more entry for the prefix can be found.
 bool DBIter::FindNextUserEntry(bool skipping_saved_key, const Slice* prefix) {
   PERF_TIMER_GUARD(find_next_user_entry_time);
+  if (fast_path_ && prefix == nullptr) {
+    return FindNextUserEntryFast(skipping_saved_key);
+  }
   return FindNextUserEntryInternal(skipping_saved_key, prefix);
 }
 
+// Same as FindNextUserEntryInternal() for the common case of fast_path_. The
+// user keys are compared inline with memcmp, and plain values and deletions
+// visible at sequence_ are handled here. Any other entry, such as one newer
+// than sequence_, a blob index or a merge operand, is handed over to
+// FindNextUserEntryInternal() where it is.
+bool DBIter::FindNextUserEntryFast(bool skipping_saved_key) {
+  assert(iter_.Valid());
+  assert(status_.ok());
+  assert(direction_ == kForward);
+  assert(fast_path_);
+  TEST_SYNC_POINT("DBIter::FindNextUserEntryFast");
+  current_entry_is_merged_ = false;
+
+  // See FindNextUserEntryInternal()
+  uint64_t num_skipped = 0;
+  bool reseek_done = false;
+
+  do {
+    bool is_prev_key_seqnum_zero = is_key_seqnum_zero_;
+    if (!ParseKey(&ikey_)) {
+      is_key_seqnum_zero_ = false;
+      return false;
+    }
+    is_key_seqnum_zero_ = (ikey_.sequence == 0);
+
+    if (iterate_upper_bound_ != nullptr &&
+        iter_.UpperBoundCheckResult() != IterBoundCheck::kInbound &&
+        ikey_.user_key.compare(*iterate_upper_bound_) >= 0) {
+      break;
+    }
+
+    const bool is_deletion =
+        ikey_.type == kTypeDeletion || ikey_.type == kTypeSingleDeletion;
+    if (ikey_.sequence > sequence_ ||
+        (ikey_.type != kTypeValue && !is_deletion)) {
+      is_key_seqnum_zero_ = is_prev_key_seqnum_zero;
+      return FindNextUserEntryInternal(skipping_saved_key, nullptr);
+    }
+
+    if (TooManyInternalKeysSkipped()) {
+      return false;
+    }
+
+    if (!is_prev_key_seqnum_zero && skipping_saved_key &&
+        ikey_.user_key.compare(saved_key_.GetUserKey()) <= 0) {
+      num_skipped++;  // skip this entry
+      PERF_COUNTER_ADD(internal_key_skipped_count, 1);
+    } else {
+      assert(!skipping_saved_key ||
+             ikey_.user_key.compare(saved_key_.GetUserKey()) > 0);
+      num_skipped = 0;
+      reseek_done = false;
+      saved_key_.SetUserKey(
+          ikey_.user_key,
+          !pin_thru_lifetime_ || !iter_.iter()->IsKeyPinned() /* copy */);
+      if (is_deletion) {
+        // Skip all upcoming entries for this key
+        skipping_saved_key = true;
+        PERF_COUNTER_ADD(internal_delete_skipped_count, 1);
+      } else {
+        if (!iter_.PrepareValue()) {
+          assert(!iter_.status().ok());
+          valid_ = false;
+          return false;
+        }
+        SetValueAndColumnsFromPlain(key_only_ ? Slice() : iter_.value());
+        valid_ = true;
+        return true;
+      }
+    }
+
+    if (num_skipped > max_skip_ && !reseek_done) {
+      // Many older versions of saved_key_: seek past them
+      is_key_seqnum_zero_ = false;
+      num_skipped = 0;
+      reseek_done = true;
+      std::string last_key;
+      AppendInternalKey(&last_key, ParsedInternalKey(saved_key_.GetUserKey(),
+                                                     0, kTypeDeletion));
+      iter_.Seek(last_key);
+      RecordTick(statistics_, NUMBER_OF_RESEEKS_IN_ITERATION);
+    } else {
+      iter_.Next();
+    }
+  } while (iter_.Valid());
+
+  valid_ = false;
+  return iter_.status().ok();
+}
+
 // Actual implementation of DBIter::FindNextUserEntry()
 bool DBIter::FindNextUserEntryInternal(bool skipping_saved_key,
                                        const Slice* prefix) {
@@ -379,7 +490,9 @@ bool DBIter::FindNextUserEntryInternal(bool skipping_saved_key,
                                       !iter_.iter()->IsKeyPinned() /* copy */);
             }
 
-            if (ikey_.type == kTypeBlobIndex) {
+            if (key_only_) {
+              SetValueAndColumnsFromPlain(Slice());
+            } else if (ikey_.type == kTypeBlobIndex) {
               if (!SetBlobValueIfNeeded(ikey_.user_key, iter_.value())) {
                 return false;
               }
@@ -395,6 +508,14 @@ bool DBIter::FindNextUserEntryInternal(bool skipping_saved_key,
               SetValueAndColumnsFromPlain(iter_.value());
             }
 
+            if (!PassesScanFilter()) {
+              // Skip all upcoming entries for this key, as for a deletion
+              ResetBlobValue();
+              ResetValueAndColumns();
+              skipping_saved_key = true;
+              PERF_COUNTER_ADD(internal_scan_filter_skipped_count, 1);
+              break;
+            }
             valid_ = true;
             return true;
             break;
@@ -407,11 +528,38 @@ bool DBIter::FindNextUserEntryInternal(bool skipping_saved_key,
             saved_key_.SetUserKey(
                 ikey_.user_key,
                 !pin_thru_lifetime_ || !iter_.iter()->IsKeyPinned() /* copy */);
+            if (key_only_) {
+              // The key has a value, but there is no need to merge it, so
+              // go on like for a plain value
+              SetValueAndColumnsFromPlain(Slice());
+              if (!PassesScanFilter()) {
+                ResetValueAndColumns();
+                skipping_saved_key = true;
+                PERF_COUNTER_ADD(internal_scan_filter_skipped_count, 1);
+                break;
+              }
+              valid_ = true;
+              return true;
+            }
             // By now, we are sure the current ikey is going to yield a value
             current_entry_is_merged_ = true;
             valid_ = true;
-            return MergeValuesNewToOld();  // Go to a different state machine
-            break;
+            // Go to a different state machine
+            if (!MergeValuesNewToOld()) {
+              return false;
+            }
+            if (PassesScanFilter()) {
+              return true;
+            }
+            // iter_ is already past the merged entries, so go on from there,
+            // without the operands pinned by MergeValuesNewToOld()
+            ReleaseTempPinnedData();
+            ResetValueAndColumns();
+            current_entry_is_merged_ = false;
+            valid_ = false;
+            skipping_saved_key = true;
+            PERF_COUNTER_ADD(internal_scan_filter_skipped_count, 1);
+            continue;
           default:
             valid_ = false;
             status_ = Status::Corruption(
@@ -788,8 +936,14 @@ void DBIter::PrevInternal(const Slice* prefix) {
     }
 
     if (valid_) {
-      // Found the value.
-      return;
+      if (PassesScanFilter()) {
+        // Found the value.
+        return;
+      }
+      ResetBlobValue();
+      ResetValueAndColumns();
+      valid_ = false;
+      PERF_COUNTER_ADD(internal_scan_filter_skipped_count, 1);
     }
 
     if (TooManyInternalKeysSkipped(false)) {
@@ -964,6 +1118,12 @@ bool DBIter::FindValueForCurrentKey() {
     assert(last_key_entry_type == ikey_.type);
   }
 
+  if (key_only_ && HasValue(last_key_entry_type)) {
+    SetValueAndColumnsFromPlain(Slice());
+    valid_ = true;
+    return true;
+  }
+
   switch (last_key_entry_type) {
     case kTypeDeletion:
     case kTypeDeletionWithTimestamp:
@@ -1121,6 +1281,14 @@ bool DBIter::FindValueForCurrentKeyUsingSeek() {
     Slice ts = ExtractTimestampFromUserKey(ikey.user_key, timestamp_size_);
     saved_timestamp_.assign(ts.data(), ts.size());
   }
+  if (key_only_ && HasValue(ikey.type)) {
+    SetValueAndColumnsFromPlain(Slice());
+    if (timestamp_lb_ != nullptr) {
+      saved_key_.SetInternalKey(ikey);
+    }
+    valid_ = true;
+    return true;
+  }
   if (ikey.type == kTypeValue || ikey.type == kTypeBlobIndex ||
       ikey.type == kTypeWideColumnEntity) {
     assert(iter_.iter()->IsValuePinned());
@@ -9,6 +9,7 @@
 
 #pragma once
 #include <cstdint>
+#include <functional>
 #include <string>
 
 #include "db/db_impl/db_impl.h"
@@ -196,6 +197,7 @@ class DBIter final : public Iterator {
   Status GetProperty(std::string prop_name, std::string* prop) override;
 
   void Next() final override;
+  Status NextBatch(size_t max_entries, IteratorBatch* batch) override;
   void Prev() final override;
   // 'target' does not contain timestamp, even if user timestamp feature is
   // enabled.
@@ -237,6 +239,8 @@ class DBIter final : public Iterator {
   bool FindNextUserEntry(bool skipping_saved_key, const Slice* prefix);
   // Internal implementation of FindNextUserEntry().
   bool FindNextUserEntryInternal(bool skipping_saved_key, const Slice* prefix);
+  // FindNextUserEntryInternal() without a prefix when fast_path_ is set.
+  bool FindNextUserEntryFast(bool skipping_saved_key);
   bool ParseKey(ParsedInternalKey* key);
   bool MergeValuesNewToOld();
 
@@ -279,6 +283,16 @@ class DBIter final : public Iterator {
     num_internal_keys_skipped_ = 0;
   }
 
+  // Whether ReadOptions::scan_filter, if any, keeps the current entry. With
+  // iter_start_ts, versions are not resolved, so it is not applied.
+  // Called before valid_ is set, so it reads saved_key_ rather than key().
+  bool PassesScanFilter() const {
+    return !scan_filter_ || timestamp_lb_ != nullptr ||
+           scan_filter_(StripTimestampFromUserKey(saved_key_.GetUserKey(),
+                                                  timestamp_size_),
+                        value_);
+  }
+
   bool expect_total_order_inner_iter() {
     assert(expect_total_order_inner_iter_ || prefix_extractor_ != nullptr);
     return expect_total_order_inner_iter_;
@@ -312,6 +326,13 @@ class DBIter final : public Iterator {
 
   bool SetValueAndColumnsFromEntity(Slice slice);
 
+  // Whether entries of the type make the key exist. With key_only_, their
+  // values are neither read nor merged.
+  static bool HasValue(ValueType type) {
+    return type == kTypeValue || type == kTypeBlobIndex ||
+           type == kTypeWideColumnEntity || type == kTypeMerge;
+  }
+
   void ResetValueAndColumns() {
     value_.clear();
     wide_columns_.clear();
@@ -394,6 +415,13 @@ class DBIter final : public Iterator {
   const Slice* const timestamp_lb_;
   const size_t timestamp_size_;
   std::string saved_timestamp_;
+  const std::function<bool(const Slice& key, const Slice& value)> scan_filter_;
+  // See ReadOptions::key_only
+  const bool key_only_;
+  // Whether forward iteration can take FindNextUserEntryFast(): the user keys
+  // are ordered by BytewiseComparator() and have no timestamps, there is no
+  // merge operator, read callback, scan filter or limit on skipped keys.
+  const bool fast_path_;
 };
 
 // Return a new iterator that converts internal keys (yielded by
@@ -775,6 +775,634 @@ TEST_P(DBIteratorTest, IterMultiWithDelete) {
   } while (ChangeOptions());
 }
 
+TEST_P(DBIteratorTest, NextBatch) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  DestroyAndReopen(options);
+  Random rnd(301);
+  // Overwrites and deletions spread over two files and the memtable
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < 200; ++i) {
+      std::string key = "key" + std::to_string(rnd.Uniform(300));
+      if (rnd.OneIn(4)) {
+        ASSERT_OK(Delete(key));
+      } else {
+        ASSERT_OK(Put(key, rnd.RandomString(rnd.Uniform(20))));
+      }
+    }
+    if (round < 2) {
+      ASSERT_OK(Flush());
+    }
+  }
+
+  for (const char* upper : {"", "key2"}) {
+    ReadOptions ro;
+    Slice upper_bound(upper);
+    if (upper_bound.size() > 0) {
+      ro.iterate_upper_bound = &upper_bound;
+    }
+    std::vector<std::pair<std::string, std::string>> expected;
+    std::unique_ptr<Iterator> iter(NewIterator(ro));
+    for (iter->Seek("key1"); iter->Valid(); iter->Next()) {
+      expected.emplace_back(iter->key().ToString(), iter->value().ToString());
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_GT(expected.size(), size_t{10});
+
+    for (size_t batch_size : {size_t{1}, size_t{7}, size_t{1000}}) {
+      std::vector<std::pair<std::string, std::string>> actual;
+      IteratorBatch batch;
+      iter->Seek("key1");
+      while (iter->Valid()) {
+        ASSERT_OK(iter->NextBatch(batch_size, &batch));
+        ASSERT_GE(batch.size(), size_t{1});
+        ASSERT_LE(batch.size(), batch_size);
+        // The iterator is left on the entry after the batch
+        if (iter->Valid()) {
+          ASSERT_EQ(batch.size(), batch_size);
+          ASSERT_GT(iter->key().compare(batch.key(batch.size() - 1)), 0);
+        }
+        for (size_t i = 0; i < batch.size(); ++i) {
+          actual.emplace_back(batch.key(i).ToString(),
+                              batch.value(i).ToString());
+        }
+      }
+      ASSERT_EQ(expected, actual);
+      ASSERT_OK(iter->NextBatch(batch_size, &batch));
+      ASSERT_TRUE(batch.empty());
+    }
+  }
+}
+
+TEST_P(DBIteratorTest, ScanFilter) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.merge_operator = MergeOperators::CreateStringAppendOperator();
+  DestroyAndReopen(options);
+  Random rnd(301);
+  // Keep values that end with 'a'
+  auto keep = [](const Slice& /*key*/, const Slice& value) {
+    return !value.empty() && value[value.size() - 1] == 'a';
+  };
+  // The expected contents, at the end and at a snapshot
+  std::map<std::string, std::string> model;
+  std::map<std::string, std::string> snapshot_model;
+  const Snapshot* snapshot = nullptr;
+  for (int round = 0; round < 4; ++round) {
+    for (int i = 0; i < 300; ++i) {
+      std::string key = "key" + std::to_string(100 + rnd.Uniform(100));
+      std::string value = rnd.OneIn(2) ? "a" : "b";
+      switch (rnd.Uniform(3)) {
+        case 0:
+          ASSERT_OK(Put(key, value));
+          model[key] = value;
+          break;
+        case 1:
+          ASSERT_OK(Delete(key));
+          model.erase(key);
+          break;
+        default:
+          ASSERT_OK(Merge(key, value));
+          if (model.count(key) > 0) {
+            model[key] += "," + value;
+          } else {
+            model[key] = value;
+          }
+      }
+    }
+    if (round == 1) {
+      snapshot = db_->GetSnapshot();
+      snapshot_model = model;
+    }
+    if (round < 3) {
+      ASSERT_OK(Flush());
+    }
+  }
+
+  SetPerfLevel(kEnableCount);
+  for (bool use_snapshot : {false, true}) {
+    std::vector<std::pair<std::string, std::string>> expected;
+    for (const auto& kv : use_snapshot ? snapshot_model : model) {
+      if (keep(kv.first, kv.second)) {
+        expected.push_back(kv);
+      }
+    }
+    ASSERT_GT(expected.size(), size_t{10});
+
+    ReadOptions ro;
+    ro.scan_filter = keep;
+    ro.snapshot = use_snapshot ? snapshot : nullptr;
+    std::unique_ptr<Iterator> iter(NewIterator(ro));
+    get_perf_context()->Reset();
+    std::vector<std::pair<std::string, std::string>> actual;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      actual.emplace_back(iter->key().ToString(), iter->value().ToString());
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(expected, actual);
+    ASSERT_GT(get_perf_context()->internal_scan_filter_skipped_count, 0);
+
+    actual.clear();
+    for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+      actual.emplace_back(iter->key().ToString(), iter->value().ToString());
+    }
+    ASSERT_OK(iter->status());
+    std::reverse(actual.begin(), actual.end());
+    ASSERT_EQ(expected, actual);
+
+    // Seeks land on the first kept key, and direction changes stay on kept
+    // keys
+    for (int i = 0; i < 100; ++i) {
+      std::string target = "key" + std::to_string(100 + rnd.Uniform(100));
+      auto it = std::lower_bound(expected.begin(), expected.end(),
+                                 std::make_pair(target, std::string()));
+      iter->Seek(target);
+      if (it == expected.end()) {
+        ASSERT_FALSE(iter->Valid());
+      } else {
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_EQ(it->first, iter->key().ToString());
+        iter->Prev();
+        if (it == expected.begin()) {
+          ASSERT_FALSE(iter->Valid());
+        } else {
+          ASSERT_TRUE(iter->Valid());
+          ASSERT_EQ((it - 1)->first, iter->key().ToString());
+        }
+      }
+
+      auto rit = std::upper_bound(
+          expected.begin(), expected.end(),
+          std::make_pair(target, std::string(1, '\xff')));
+      iter->SeekForPrev(target);
+      if (rit == expected.begin()) {
+        ASSERT_FALSE(iter->Valid());
+      } else {
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_EQ((rit - 1)->first, iter->key().ToString());
+        ASSERT_EQ((rit - 1)->second, iter->value().ToString());
+        iter->Next();
+        if (rit == expected.end()) {
+          ASSERT_FALSE(iter->Valid());
+        } else {
+          ASSERT_TRUE(iter->Valid());
+          ASSERT_EQ(rit->first, iter->key().ToString());
+        }
+      }
+      ASSERT_OK(iter->status());
+    }
+  }
+  SetPerfLevel(kDisable);
+  db_->ReleaseSnapshot(snapshot);
+}
+
+TEST_P(DBIteratorTest, ScanFilterOnKey) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  DestroyAndReopen(options);
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_OK(Put(Key(i), "v" + std::to_string(i)));
+    if (i == 50) {
+      ASSERT_OK(Flush());
+    }
+  }
+
+  // Keep keys that are multiples of 7. The filter runs on a fresh iterator
+  // before any entry has been returned.
+  ReadOptions ro;
+  ro.scan_filter = [](const Slice& key, const Slice& value) {
+    EXPECT_EQ(std::to_string(std::stoi(key.ToString().substr(3))),
+              value.ToString().substr(1));
+    return std::stoi(key.ToString().substr(3)) % 7 == 0;
+  };
+  {
+    std::unique_ptr<Iterator> iter(NewIterator(ro));
+    iter->Seek(Key(1));
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(Key(7), iter->key());
+    ASSERT_OK(iter->status());
+  }
+  {
+    std::unique_ptr<Iterator> iter(NewIterator(ro));
+    iter->SeekForPrev(Key(99));
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(Key(98), iter->key());
+    ASSERT_OK(iter->status());
+  }
+  std::unique_ptr<Iterator> iter(NewIterator(ro));
+  int expected = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next(), expected += 7) {
+    ASSERT_EQ(Key(expected), iter->key());
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(105, expected);
+}
+
+TEST_P(DBIteratorTest, KeyOnly) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.merge_operator = MergeOperators::CreateStringAppendOperator();
+  if (Snappy_Supported()) {
+    options.compression = kSnappyCompression;
+  }
+  BlockBasedTableOptions table_options;
+  table_options.data_block_separate_values = true;
+  table_options.block_size = 256;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  std::map<std::string, std::string> model;
+  for (int i = 0; i < 200; ++i) {
+    std::string key = "key" + std::to_string(100 + i);
+    std::string value(20, static_cast<char>('a' + i % 26));
+    ASSERT_OK(Put(key, value));
+    model[key] = value;
+  }
+  ASSERT_OK(Flush());
+  for (int i = 0; i < 200; i += 3) {
+    std::string key = "key" + std::to_string(100 + i);
+    ASSERT_OK(Merge(key, "m"));
+    model[key] += ",m";
+  }
+  for (int i = 1; i < 200; i += 7) {
+    std::string key = "key" + std::to_string(100 + i);
+    ASSERT_OK(Delete(key));
+    model.erase(key);
+  }
+  ASSERT_OK(Flush());
+
+  std::vector<std::string> expected_keys;
+  for (const auto& kv : model) {
+    expected_keys.push_back(kv.first);
+  }
+
+  ReadOptions ro;
+  ro.key_only = true;
+  std::unique_ptr<Iterator> iter(NewIterator(ro));
+  std::vector<std::string> actual_keys;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    actual_keys.push_back(iter->key().ToString());
+    ASSERT_TRUE(iter->value().empty());
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(expected_keys, actual_keys);
+
+  actual_keys.clear();
+  for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+    actual_keys.push_back(iter->key().ToString());
+    ASSERT_TRUE(iter->value().empty());
+  }
+  ASSERT_OK(iter->status());
+  std::reverse(actual_keys.begin(), actual_keys.end());
+  ASSERT_EQ(expected_keys, actual_keys);
+
+  // Values are still read as usual without key_only
+  iter.reset(NewIterator(ReadOptions()));
+  std::map<std::string, std::string> actual;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    actual[iter->key().ToString()] = iter->value().ToString();
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(model, actual);
+  for (const auto& kv : model) {
+    ASSERT_EQ(kv.second, Get(kv.first));
+  }
+}
+
+// Forward iteration over bytewise keys without a merge operator takes the
+// fast path, which must return the same as the generic one.
+TEST_P(DBIteratorTest, FastPathMatchesGenericPath) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.max_sequential_skip_in_iterations = 3;
+  DestroyAndReopen(options);
+
+  Random rnd(301);
+  const Snapshot* snapshot = nullptr;
+  for (int i = 0; i < 2000; ++i) {
+    std::string key = Key(static_cast<int>(rnd.Uniform(200)));
+    switch (rnd.Uniform(4)) {
+      case 0:
+        ASSERT_OK(Delete(key));
+        break;
+      case 1:
+        // Many versions of one key, to reseek past them
+        ASSERT_OK(Put(Key(100), rnd.RandomString(5)));
+        break;
+      default:
+        ASSERT_OK(Put(key, rnd.RandomString(5)));
+        break;
+    }
+    if (i == 1000) {
+      snapshot = db_->GetSnapshot();
+    }
+    if (i % 500 == 499) {
+      ASSERT_OK(Flush());
+    }
+  }
+
+  int fast_calls = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBIter::FindNextUserEntryFast", [&](void*) { ++fast_calls; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  std::string upper_bound = Key(150);
+  Slice upper_bound_slice = upper_bound;
+  for (const Snapshot* s : {static_cast<const Snapshot*>(nullptr), snapshot}) {
+    for (bool bounded : {false, true}) {
+      for (bool key_only : {false, true}) {
+        ReadOptions fast_ro;
+        fast_ro.snapshot = s;
+        fast_ro.iterate_upper_bound = bounded ? &upper_bound_slice : nullptr;
+        fast_ro.key_only = key_only;
+        ReadOptions generic_ro = fast_ro;
+        // Also disables the fast path, without changing the results
+        generic_ro.max_skippable_internal_keys = 1 << 30;
+        std::unique_ptr<Iterator> fast_iter(NewIterator(fast_ro));
+        std::unique_ptr<Iterator> generic_iter(NewIterator(generic_ro));
+
+        fast_calls = 0;
+        fast_iter->SeekToFirst();
+        generic_iter->SeekToFirst();
+        int count = 0;
+        for (; generic_iter->Valid(); generic_iter->Next(), fast_iter->Next()) {
+          ASSERT_TRUE(fast_iter->Valid());
+          ASSERT_EQ(generic_iter->key(), fast_iter->key());
+          ASSERT_EQ(generic_iter->value(), fast_iter->value());
+          ++count;
+        }
+        ASSERT_FALSE(fast_iter->Valid());
+        ASSERT_OK(fast_iter->status());
+        ASSERT_OK(generic_iter->status());
+        ASSERT_GT(count, 0);
+        ASSERT_GE(fast_calls, count);
+
+        for (int i = 0; i < 200; i += 3) {
+          fast_iter->Seek(Key(i));
+          generic_iter->Seek(Key(i));
+          ASSERT_EQ(generic_iter->Valid(), fast_iter->Valid());
+          if (generic_iter->Valid()) {
+            ASSERT_EQ(generic_iter->key(), fast_iter->key());
+            ASSERT_EQ(generic_iter->value(), fast_iter->value());
+            fast_iter->Next();
+            generic_iter->Next();
+            ASSERT_EQ(generic_iter->Valid(), fast_iter->Valid());
+            if (generic_iter->Valid()) {
+              ASSERT_EQ(generic_iter->key(), fast_iter->key());
+            }
+          }
+          ASSERT_OK(fast_iter->status());
+        }
+      }
+    }
+  }
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  db_->ReleaseSnapshot(snapshot);
+}
+
+TEST_P(DBIteratorTest, MiniBlocks) {
+  for (auto index_type : {BlockBasedTableOptions::kDataBlockBinarySearch,
+                          BlockBasedTableOptions::kDataBlockBinaryAndHash}) {
+    Options options = CurrentOptions();
+    options.disable_auto_compactions = true;
+    if (Snappy_Supported()) {
+      options.compression = kSnappyCompression;
+    }
+    options.statistics = CreateDBStatistics();
+    BlockBasedTableOptions table_options;
+    table_options.data_block_index_type = index_type;
+    table_options.block_size = 16 << 10;
+    table_options.block_restart_interval = 4;
+    table_options.data_block_mini_block_restarts = 4;
+    table_options.verify_compression = true;
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    DestroyAndReopen(options);
+
+    Random rnd(301);
+    std::map<std::string, std::string> model;
+    for (int i = 0; i < 2000; ++i) {
+      std::string key = "key" + std::to_string(10000 + i * 2);
+      // Compressible values
+      std::string value = rnd.RandomString(10) + std::string(40, 'v');
+      ASSERT_OK(Put(key, value));
+      model[key] = value;
+    }
+    ASSERT_OK(Flush());
+
+    for (const auto& kv : model) {
+      ASSERT_EQ(kv.second, Get(kv.first));
+    }
+    ASSERT_EQ("NOT_FOUND", Get("key10001"));
+
+    std::unique_ptr<Iterator> iter(NewIterator(ReadOptions()));
+    std::map<std::string, std::string> actual;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      actual[iter->key().ToString()] = iter->value().ToString();
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(model, actual);
+    actual.clear();
+    for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+      actual[iter->key().ToString()] = iter->value().ToString();
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(model, actual);
+    for (int i = 0; i < 100; ++i) {
+      std::string target = "key" + std::to_string(10000 + rnd.Uniform(4000));
+      auto it = model.lower_bound(target);
+      iter->Seek(target);
+      if (it == model.end()) {
+        ASSERT_FALSE(iter->Valid());
+      } else {
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_EQ(it->first, iter->key().ToString());
+        ASSERT_EQ(it->second, iter->value().ToString());
+      }
+    }
+    ASSERT_OK(iter->status());
+    if (Snappy_Supported()) {
+      ASSERT_GT(options.statistics->getTickerCount(NUMBER_BLOCK_COMPRESSED),
+                0);
+    }
+  }
+}
+
+TEST_P(DBIteratorTest, DeltaOfDeltaKeys) {
+  for (bool no_block_cache : {false, true}) {
+    Options options = CurrentOptions();
+    options.disable_auto_compactions = true;
+    BlockBasedTableOptions table_options;
+    table_options.no_block_cache = no_block_cache;
+    table_options.data_block_delta_of_delta_keys = true;
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    DestroyAndReopen(options);
+
+    // Time series keys, with a big-endian timestamp after the series id
+    auto make_key = [](int series, uint64_t ts) {
+      std::string key = "series" + std::to_string(100 + series);
+      PutFixed64(&key, EndianSwapValue(ts));
+      return key;
+    };
+    Random rnd(301);
+    std::map<std::string, std::string> model;
+    for (int series = 0; series < 10; ++series) {
+      uint64_t ts = 1600000000;
+      for (int i = 0; i < 300; ++i) {
+        std::string key = make_key(series, ts);
+        std::string value = rnd.RandomString(8);
+        ASSERT_OK(Put(key, value));
+        model[key] = value;
+        ts += rnd.OneIn(10) ? rnd.Uniform(1000) : 10;
+      }
+    }
+    ASSERT_OK(Flush());
+    for (int i = 0; i < 100; ++i) {
+      auto it = model.begin();
+      std::advance(it, rnd.Uniform(static_cast<int>(model.size())));
+      ASSERT_OK(Delete(it->first));
+      model.erase(it);
+    }
+    ASSERT_OK(Flush());
+    ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+
+    TablePropertiesCollection props;
+    ASSERT_OK(db_->GetPropertiesOfAllTables(&props));
+    ASSERT_EQ(1, props.size());
+    const auto& user_props = props.begin()->second->user_collected_properties;
+    auto prop_pos = user_props.find(
+        BlockBasedTablePropertyNames::kDataBlockDeltaOfDeltaKeys);
+    ASSERT_TRUE(prop_pos != user_props.end());
+    ASSERT_EQ("1", prop_pos->second);
+
+    for (const auto& kv : model) {
+      ASSERT_EQ(kv.second, Get(kv.first));
+    }
+    ASSERT_EQ("NOT_FOUND", Get(make_key(3, 1600000001)));
+    std::vector<std::string> multiget_keys;
+    for (const auto& kv : model) {
+      if (rnd.OneIn(7)) {
+        multiget_keys.push_back(kv.first);
+      }
+    }
+    std::vector<std::string> multiget_values = MultiGet(multiget_keys);
+    for (size_t i = 0; i < multiget_keys.size(); ++i) {
+      ASSERT_EQ(model[multiget_keys[i]], multiget_values[i]);
+    }
+
+    std::unique_ptr<Iterator> iter(NewIterator(ReadOptions()));
+    std::map<std::string, std::string> actual;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      actual[iter->key().ToString()] = iter->value().ToString();
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(model, actual);
+    for (int i = 0; i < 100; ++i) {
+      std::string target = make_key(static_cast<int>(rnd.Uniform(10)),
+                                    1600000000 + rnd.Uniform(10000));
+      auto it = model.lower_bound(target);
+      iter->Seek(target);
+      if (it == model.end()) {
+        ASSERT_FALSE(iter->Valid());
+      } else {
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_EQ(it->first, iter->key().ToString());
+        ASSERT_EQ(it->second, iter->value().ToString());
+      }
+    }
+    ASSERT_OK(iter->status());
+  }
+}
+
+TEST_F(DBIteratorBaseTest, ParallelScan) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.target_file_size_base = 64 << 10;
+  DestroyAndReopen(options);
+  Random rnd(301);
+  auto make_key = [](int i) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "key%06d", i);
+    return std::string(buf);
+  };
+  std::map<std::string, std::string> model;
+  for (int i = 0; i < 4000; ++i) {
+    std::string value = rnd.RandomString(100);
+    ASSERT_OK(Put(make_key(i), value));
+    model[make_key(i)] = value;
+    if (i % 1000 == 999) {
+      ASSERT_OK(Flush());
+    }
+  }
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_GT(NumTableFilesAtLevel(1), 1);
+
+  ReadOptions ro;
+  ASSERT_TRUE(db_->NewParallelScan(ro, db_->DefaultColumnFamily(), 0, nullptr)
+                  .IsInvalidArgument());
+  ro.tailing = true;
+  std::unique_ptr<ParallelScan> scan;
+  ASSERT_TRUE(db_->NewParallelScan(ro, db_->DefaultColumnFamily(), 4, &scan)
+                  .IsNotSupported());
+  ro.tailing = false;
+
+  std::string lower = make_key(500);
+  std::string upper = make_key(3500);
+  Slice lower_slice(lower);
+  Slice upper_slice(upper);
+  for (bool bounded : {false, true}) {
+    ro.iterate_lower_bound = bounded ? &lower_slice : nullptr;
+    ro.iterate_upper_bound = bounded ? &upper_slice : nullptr;
+    std::vector<std::pair<std::string, std::string>> expected(
+        bounded ? model.lower_bound(lower) : model.begin(),
+        bounded ? model.lower_bound(upper) : model.end());
+    for (size_t num_partitions : {size_t{1}, size_t{4}}) {
+      ASSERT_OK(db_->NewParallelScan(ro, db_->DefaultColumnFamily(),
+                                     num_partitions, &scan));
+      ASSERT_EQ(num_partitions, scan->NumPartitions());
+      // Later writes are not seen
+      ASSERT_OK(Put(make_key(1000), "new"));
+      ASSERT_OK(Delete(make_key(2000)));
+      ASSERT_OK(Put("zzz", "new"));
+
+      std::vector<std::vector<std::pair<std::string, std::string>>> parts(
+          num_partitions);
+      std::vector<port::Thread> threads;
+      for (size_t i = 0; i < num_partitions; ++i) {
+        threads.emplace_back([&scan, &parts, i]() {
+          Iterator* iter = scan->GetIterator(i);
+          for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+            parts[i].emplace_back(iter->key().ToString(),
+                                  iter->value().ToString());
+          }
+          EXPECT_OK(iter->status());
+        });
+      }
+      for (auto& t : threads) {
+        t.join();
+      }
+      ASSERT_EQ(bounded, scan->LowerBound(0) != nullptr);
+      ASSERT_EQ(bounded, scan->UpperBound(num_partitions - 1) != nullptr);
+      std::vector<std::pair<std::string, std::string>> actual;
+      for (size_t i = 0; i < num_partitions; ++i) {
+        if (i > 0) {
+          ASSERT_EQ(*scan->UpperBound(i - 1), *scan->LowerBound(i));
+        }
+        // About a quarter each
+        ASSERT_GT(parts[i].size(), expected.size() / num_partitions / 2);
+        actual.insert(actual.end(), parts[i].begin(), parts[i].end());
+      }
+      ASSERT_EQ(expected, actual);
+      scan.reset();
+      // Restore the model's contents
+      ASSERT_OK(Put(make_key(1000), model[make_key(1000)]));
+      ASSERT_OK(Put(make_key(2000), model[make_key(2000)]));
+      ASSERT_OK(Delete("zzz"));
+    }
+  }
+}
+
 TEST_P(DBIteratorTest, IterPrevMaxSkip) {
   do {
     CreateAndReopenWithCF({"pikachu"}, CurrentOptions());
@@ -2976,6 +3604,73 @@ TEST_P(DBIteratorTest, IterateWithLowerBoundAcrossFileBoundary) {
   ASSERT_OK(iter->status());
 }
 
+TEST_P(DBIteratorTest, OpenNextFileAsync) {
+  Options options = CurrentOptions();
+  // A small table cache, so that most files are opened as they are scanned
+  options.max_open_files = 20;
+  DestroyAndReopen(options);
+  for (int file = 0; file < 4; ++file) {
+    for (int i = 0; i < 10; ++i) {
+      ASSERT_OK(Put(Key(file * 10 + i), "v" + std::to_string(file * 10 + i)));
+    }
+    ASSERT_OK(Flush());
+  }
+  MoveFilesToLevel(1);
+  ASSERT_EQ("0,4", FilesPerLevel());
+  Reopen(options);
+
+  std::atomic<int> files_opened{0};
+  std::atomic<int> jobs_scheduled{0};
+  SyncPoint::GetInstance()->SetCallBack(
+      "LevelIterator::MaybeOpenNextFileAsync:Done",
+      [&](void* /*arg*/) { files_opened.fetch_add(1); });
+  SyncPoint::GetInstance()->SetCallBack(
+      "LevelIterator::MaybeOpenNextFileAsync:Scheduled",
+      [&](void* /*arg*/) { jobs_scheduled.fetch_add(1); });
+  // Let every job run rather than be cancelled when the scan catches up
+  // with it
+  SyncPoint::GetInstance()->SetCallBack(
+      "LevelIterator::WaitForNextFile:Pending", [&](void* /*arg*/) {
+        while (files_opened.load() < jobs_scheduled.load()) {
+          std::this_thread::yield();
+        }
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  auto scan = [&](const ReadOptions& read_options) {
+    std::unique_ptr<Iterator> iter(NewIterator(read_options));
+    int count = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      EXPECT_EQ(Key(count), iter->key());
+      EXPECT_EQ("v" + std::to_string(count), iter->value());
+      ++count;
+    }
+    EXPECT_OK(iter->status());
+    return count;
+  };
+
+  ReadOptions read_options;
+  ASSERT_EQ(40, scan(read_options));
+  ASSERT_EQ(0, files_opened.load());
+
+  // Each file after the first is opened ahead of the scan
+  read_options.async_io = true;
+  ASSERT_EQ(40, scan(read_options));
+  ASSERT_EQ(3, files_opened.load());
+
+  // Not past the upper bound
+  files_opened = 0;
+  jobs_scheduled = 0;
+  std::string upper_bound = Key(15);
+  Slice upper_bound_slice(upper_bound);
+  read_options.iterate_upper_bound = &upper_bound_slice;
+  ASSERT_EQ(15, scan(read_options));
+  ASSERT_EQ(1, files_opened.load());
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 TEST_P(DBIteratorTest, Blob) {
   Options options = CurrentOptions();
   options.enable_blob_files = true;
@@ -131,6 +131,61 @@ TEST_F(DBStatisticsTest, CompressionStatsTest) {
   }
 }
 
+TEST_F(DBStatisticsTest, AdaptiveCompressionStats) {
+  for (CompressionType type : GetSupportedCompressions()) {
+    if (type == kNoCompression || type == kBZip2Compression) {
+      continue;
+    }
+    SCOPED_TRACE("Compression type: " + std::to_string(type));
+
+    Options options = CurrentOptions();
+    options.compression = type;
+    options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+    BlockBasedTableOptions bbto;
+    bbto.enable_index_compression = false;
+    bbto.adaptive_compression = true;
+    bbto.verify_compression = true;
+    options.table_factory.reset(NewBlockBasedTableFactory(bbto));
+    DestroyAndReopen(options);
+
+    auto PopStat = [&](Tickers t) -> uint64_t {
+      return options.statistics->getAndResetTickerCount(t);
+    };
+
+    int kNumKeysWritten = 100;
+    // About three KVs per block
+    int len = static_cast<int>(BlockBasedTableOptions().block_size / 3);
+    Random rnd(301);
+    std::string buf;
+
+    // Compressible blocks are still compressed
+    for (int i = 0; i < kNumKeysWritten; ++i) {
+      ASSERT_OK(Put(Key(i), test::CompressibleString(&rnd, 0.5, len, &buf)));
+    }
+    ASSERT_OK(Flush());
+    EXPECT_EQ(34, PopStat(NUMBER_BLOCK_COMPRESSED));
+    EXPECT_EQ(0, PopStat(NUMBER_BLOCK_COMPRESSION_BYPASSED));
+    EXPECT_EQ(0, PopStat(NUMBER_BLOCK_COMPRESSION_REJECTED));
+
+    // Blocks of mostly random bytes are stored without trying to compress
+    // them, and all blocks read back correctly
+    DestroyAndReopen(options);
+    std::vector<std::string> values;
+    for (int i = 0; i < kNumKeysWritten; ++i) {
+      values.push_back(i % 2 == 0 ? rnd.RandomBinaryString(len)
+                                  : rnd.RandomBinaryString(len / 3) +
+                                        std::string(len / 3, 'a') +
+                                        rnd.RandomBinaryString(len / 3));
+      ASSERT_OK(Put(Key(i), values.back()));
+    }
+    ASSERT_OK(Flush());
+    EXPECT_GT(PopStat(NUMBER_BLOCK_COMPRESSION_BYPASSED), 0U);
+    for (int i = 0; i < kNumKeysWritten; ++i) {
+      ASSERT_EQ(values[i], Get(Key(i)));
+    }
+  }
+}
+
 TEST_F(DBStatisticsTest, MutexWaitStatsDisabledByDefault) {
   Options options = CurrentOptions();
   options.create_if_missing = true;
@@ -551,6 +551,54 @@ TEST_F(DBBasicTestWithTimestamp, SimpleIterate) {
   Close();
 }
 
+TEST_F(DBBasicTestWithTimestamp, ScanFilter) {
+  Options options = CurrentOptions();
+  options.env = env_;
+  options.create_if_missing = true;
+  const size_t kTimestampSize = Timestamp(0, 0).size();
+  TestComparator test_cmp(kTimestampSize);
+  options.comparator = &test_cmp;
+  DestroyAndReopen(options);
+  const uint64_t kMaxKey = 64;
+  for (uint64_t key = 0; key < kMaxKey; ++key) {
+    ASSERT_OK(db_->Put(WriteOptions(), Key1(key), Timestamp(1, 0),
+                       "value" + std::to_string(key)));
+  }
+  ASSERT_OK(Flush());
+
+  // The filter sees user keys without their timestamps
+  std::set<std::string> kept;
+  for (uint64_t key = 0; key < kMaxKey; key += 3) {
+    kept.insert(Key1(key));
+  }
+  ReadOptions read_opts;
+  std::string read_ts = Timestamp(2, 0);
+  Slice read_ts_slice = read_ts;
+  read_opts.timestamp = &read_ts_slice;
+  read_opts.scan_filter = [&](const Slice& key, const Slice& /*value*/) {
+    EXPECT_EQ(Key1(0).size(), key.size());
+    return kept.count(key.ToString()) > 0;
+  };
+  std::unique_ptr<Iterator> it(db_->NewIterator(read_opts));
+  it->Seek(Key1(1));
+  ASSERT_TRUE(it->Valid());
+  CheckIterUserEntry(it.get(), Key1(3), kTypeValue, "value3", Timestamp(1, 0));
+  std::set<std::string> actual;
+  for (it->SeekToFirst(); it->Valid(); it->Next()) {
+    actual.insert(it->key().ToString());
+  }
+  ASSERT_OK(it->status());
+  ASSERT_EQ(kept, actual);
+  actual.clear();
+  for (it->SeekToLast(); it->Valid(); it->Prev()) {
+    actual.insert(it->key().ToString());
+  }
+  ASSERT_OK(it->status());
+  ASSERT_EQ(kept, actual);
+  it.reset();
+  Close();
+}
+
 TEST_F(DBBasicTestWithTimestamp, TrimHistoryTest) {
   Options options = CurrentOptions();
   options.env = env_;
@@ -283,6 +283,12 @@ class InternalKeyComparator
     return user_comparator_.user_comparator();
   }
 
+  // Compares user keys with the user comparator, without its virtual call
+  // for the built-in comparators
+  int CompareUserKey(const Slice& a, const Slice& b) const {
+    return user_comparator_.Compare(a, b);
+  }
+
   int Compare(const InternalKey& a, const InternalKey& b) const;
   int Compare(const ParsedInternalKey& a, const ParsedInternalKey& b) const;
   int Compare(const Slice& a, const ParsedInternalKey& b) const;
@@ -204,6 +204,32 @@ TEST_F(FormatTest, RangeTombstoneSerializeEndKey) {
   ASSERT_LT(cmp.Compare(t.SerializeEndKey(), k), 0);
 }
 
+TEST_F(FormatTest, UserComparatorWrapper) {
+  // The built-in comparators are compared inline, and must agree with their
+  // virtual implementations
+  test::SimpleSuffixReverseComparator custom;
+  // At least 8 bytes, for SimpleSuffixReverseComparator
+  std::vector<std::string> keys = {"prefix_a",  "prefix_ab", "prefix_b",
+                                   "prefix_\xff", "zzzzzzzz", "prefix_aab",
+                                   std::string(8, '\0')};
+  for (const Comparator* raw :
+       {BytewiseComparator(), ReverseBytewiseComparator(),
+        static_cast<const Comparator*>(&custom)}) {
+    UserComparatorWrapper wrapper(raw);
+    const InternalKeyComparator icmp(raw);
+    for (const std::string& a : keys) {
+      for (const std::string& b : keys) {
+        const int expected = raw->Compare(a, b);
+        ASSERT_EQ(expected, wrapper.Compare(a, b)) << raw->Name();
+        ASSERT_EQ(expected, wrapper.CompareWithoutTimestamp(a, b));
+        ASSERT_EQ(expected, icmp.CompareUserKey(a, b));
+        ASSERT_EQ(raw->Equal(a, b), wrapper.Equal(a, b));
+        ASSERT_EQ(raw->Equal(a, b), wrapper.EqualWithoutTimestamp(a, b));
+      }
+    }
+  }
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
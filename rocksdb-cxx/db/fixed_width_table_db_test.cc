@@ -0,0 +1,244 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include <map>
+#include <string>
+#include <tuple>
+
+#include "db/db_test_util.h"
+#include "port/stack_trace.h"
+#include "rocksdb/table.h"
+#include "test_util/testharness.h"
+#include "util/coding.h"
+#include "utilities/merge_operators.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Param: compaction style, whether to mmap reads
+class FixedWidthTableDBTest
+    : public DBTestBase,
+      public testing::WithParamInterface<std::tuple<CompactionStyle, bool>> {
+ public:
+  FixedWidthTableDBTest()
+      : DBTestBase("fixed_width_table_db_test", /*env_do_fsync=*/false) {}
+
+  Options CurrentOptions() {
+    Options options = DBTestBase::CurrentOptions();
+    FixedWidthTableOptions table_options;
+    table_options.key_size = 16;
+    table_options.value_size = 8;
+    table_options.records_per_group = 7;
+    options.table_factory.reset(NewFixedWidthTableFactory(table_options));
+    options.merge_operator = MergeOperators::CreateUInt64AddOperator();
+    options.compaction_style = std::get<0>(GetParam());
+    options.allow_mmap_reads = std::get<1>(GetParam());
+    options.disable_auto_compactions = true;
+    if (options.compaction_style == kCompactionStyleFIFO) {
+      // Required by FIFO compaction
+      options.max_open_files = -1;
+    }
+    return options;
+  }
+
+  // 16-byte keys, ordered as i
+  static std::string Key(uint64_t i) {
+    std::string key;
+    PutFixed64(&key, EndianSwapValue(i));
+    key.append("counter_");
+    return key;
+  }
+
+  static std::string Value(uint64_t v) {
+    std::string value;
+    PutFixed64(&value, v);
+    return value;
+  }
+
+  // Checks that the DB holds `expected`, through gets and iterators
+  void Verify(const std::map<std::string, std::string>& expected,
+              const Snapshot* snapshot = nullptr) {
+    for (uint64_t i = 0; i < 300; ++i) {
+      auto it = expected.find(Key(i));
+      ASSERT_EQ(it == expected.end() ? "NOT_FOUND" : it->second,
+                Get(Key(i), snapshot));
+    }
+    ReadOptions ro;
+    ro.snapshot = snapshot;
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ro));
+    auto it = expected.begin();
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++it) {
+      ASSERT_TRUE(it != expected.end());
+      ASSERT_EQ(it->first, iter->key());
+      ASSERT_EQ(it->second, iter->value());
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_TRUE(it == expected.end());
+    auto rit = expected.rbegin();
+    for (iter->SeekToLast(); iter->Valid(); iter->Prev(), ++rit) {
+      ASSERT_TRUE(rit != expected.rend());
+      ASSERT_EQ(rit->first, iter->key());
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_TRUE(rit == expected.rend());
+    for (uint64_t i = 0; i < 300; i += 7) {
+      auto lb = expected.lower_bound(Key(i));
+      iter->Seek(Key(i));
+      ASSERT_EQ(lb != expected.end(), iter->Valid());
+      if (iter->Valid()) {
+        ASSERT_EQ(lb->first, iter->key());
+      }
+      auto ub = expected.upper_bound(Key(i));
+      iter->SeekForPrev(Key(i));
+      ASSERT_EQ(ub != expected.begin(), iter->Valid());
+      if (iter->Valid()) {
+        ASSERT_EQ(std::prev(ub)->first, iter->key());
+      }
+    }
+    ASSERT_OK(iter->status());
+  }
+};
+
+TEST_P(FixedWidthTableDBTest, ReadWrite) {
+  Options options = CurrentOptions();
+  DestroyAndReopen(options);
+
+  std::map<std::string, std::string> expected;
+  for (uint64_t i = 0; i < 300; i += 2) {
+    ASSERT_OK(Put(Key(i), Value(i)));
+    expected[Key(i)] = Value(i);
+  }
+  ASSERT_OK(Flush());
+  Verify(expected);
+
+  // Several versions of keys across files, kept by a snapshot
+  const Snapshot* snapshot = db_->GetSnapshot();
+  std::map<std::string, std::string> expected_at_snapshot = expected;
+  for (uint64_t i = 0; i < 300; i += 3) {
+    if (i % 4 == 0) {
+      ASSERT_OK(Delete(Key(i)));
+      expected.erase(Key(i));
+    } else {
+      ASSERT_OK(Merge(Key(i), Value(1)));
+      auto it = expected.find(Key(i));
+      expected[Key(i)] = Value(
+          (it == expected.end() ? 0 : DecodeFixed64(it->second.data())) + 1);
+    }
+  }
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             Key(100), Key(120)));
+  for (auto it = expected.lower_bound(Key(100));
+       it != expected.end() && it->first < Key(120);) {
+    it = expected.erase(it);
+  }
+  ASSERT_OK(Flush());
+  ASSERT_EQ(2, NumTableFilesAtLevel(0));
+  Verify(expected);
+  Verify(expected_at_snapshot, snapshot);
+
+  // The snapshot keeps older versions through compaction
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  Verify(expected);
+  Verify(expected_at_snapshot, snapshot);
+
+  db_->ReleaseSnapshot(snapshot);
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  Verify(expected);
+  ASSERT_OK(db_->VerifyChecksum());
+
+  Reopen(options);
+  Verify(expected);
+}
+
+TEST_P(FixedWidthTableDBTest, Corruption) {
+  Options options = CurrentOptions();
+  DestroyAndReopen(options);
+  for (uint64_t i = 0; i < 100; ++i) {
+    ASSERT_OK(Put(Key(i), Value(i)));
+  }
+  ASSERT_OK(Flush());
+
+  std::vector<LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  ASSERT_EQ(1, files.size());
+  Close();
+  // Flip a byte of a value in the middle of the data
+  ASSERT_OK(test::CorruptFile(env_, dbname_ + files[0].name,
+                              static_cast<int>(50 * 32 + 20), 1,
+                              false /* verify_checksum */));
+  Reopen(options);
+  ASSERT_TRUE(db_->VerifyChecksum().IsCorruption());
+  std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+  }
+  ASSERT_TRUE(iter->status().IsCorruption());
+}
+
+INSTANTIATE_TEST_CASE_P(
+    FixedWidthTableDBTest, FixedWidthTableDBTest,
+    ::testing::Combine(::testing::Values(kCompactionStyleLevel,
+                                         kCompactionStyleUniversal,
+                                         kCompactionStyleFIFO),
+                       ::testing::Bool()));
+
+class FixedWidthTableSizesTest : public DBTestBase {
+ public:
+  FixedWidthTableSizesTest()
+      : DBTestBase("fixed_width_table_sizes_test", /*env_do_fsync=*/false) {}
+};
+
+TEST_F(FixedWidthTableSizesTest, WrongSizes) {
+  Options options = CurrentOptions();
+  FixedWidthTableOptions table_options;
+  options.table_factory.reset(NewFixedWidthTableFactory(table_options));
+  // key_size must be set
+  ASSERT_TRUE(TryReopen(options).IsInvalidArgument());
+
+  table_options.key_size = 4;
+  table_options.value_size = 2;
+  options.table_factory.reset(NewFixedWidthTableFactory(table_options));
+  options.merge_operator = MergeOperators::CreateStringAppendOperator();
+  DestroyAndReopen(options);
+  ASSERT_OK(Put("key1", "v1"));
+  ASSERT_OK(Delete("key2"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ("v1", Get("key1"));
+  ASSERT_EQ("NOT_FOUND", Get("key2"));
+
+  // Writes the table cannot store fail, and leave the DB writable
+  ASSERT_TRUE(Put("key3", "value3").IsInvalidArgument());
+  ASSERT_TRUE(Put("key", "v3").IsInvalidArgument());
+  ASSERT_TRUE(Delete("key").IsInvalidArgument());
+  ASSERT_TRUE(Merge("key3", "v").IsInvalidArgument());
+  WriteBatch batch;
+  ASSERT_OK(batch.Put("key4", "v4"));
+  ASSERT_OK(batch.Put("key5", "value5"));
+  ASSERT_TRUE(db_->Write(WriteOptions(), &batch).IsInvalidArgument());
+  ASSERT_EQ("NOT_FOUND", Get("key3"));
+  ASSERT_EQ("NOT_FOUND", Get("key4"));
+
+  ASSERT_OK(Put("key3", "v3"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ("v3", Get("key3"));
+
+  // Only column families using fixed-width tables are checked
+  Options other_options = options;
+  other_options.table_factory.reset(NewBlockBasedTableFactory());
+  CreateColumnFamilies({"other"}, other_options);
+  ReopenWithColumnFamilies({kDefaultColumnFamilyName, "other"},
+                           std::vector<Options>{options, other_options});
+  ASSERT_OK(Put(1, "other_key", "other_value"));
+  ASSERT_OK(Flush(1));
+  ASSERT_EQ("other_value", Get(1, "other_key"));
+  ASSERT_OK(db_->Put(WriteOptions(), "key6", "v6"));
+  ASSERT_TRUE(db_->Put(WriteOptions(), "key66", "v6").IsInvalidArgument());
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -310,6 +310,40 @@ InternalIterator* TableCache::NewIterator(
   return result;
 }
 
+Status TableCache::PrefetchTable(
+    const ReadOptions& options, const FileOptions& toptions,
+    const InternalKeyComparator& internal_comparator,
+    const FileMetaData& file_meta, uint8_t block_protection_bytes_per_key,
+    const std::shared_ptr<const SliceTransform>& prefix_extractor,
+    TableReaderCaller caller, bool skip_filters, int level) {
+  Status s;
+  TypedHandle* handle = nullptr;
+  TableReader* table_reader = file_meta.fd.table_reader;
+  if (table_reader == nullptr) {
+    s = FindTable(options, toptions, internal_comparator, file_meta, &handle,
+                  block_protection_bytes_per_key, prefix_extractor,
+                  options.read_tier == kBlockCacheTier /* no_io */,
+                  true /* record_read_stats */, nullptr /* file_read_hist */,
+                  skip_filters, level,
+                  true /* prefetch_index_and_filter_in_cache */,
+                  0 /* max_file_size_for_l0_meta_pin */, file_meta.temperature);
+    if (s.ok()) {
+      table_reader = cache_.Value(handle);
+    }
+  }
+  if (s.ok() && options.fill_cache) {
+    std::unique_ptr<InternalIterator> iter(table_reader->NewIterator(
+        options, prefix_extractor.get(), /*arena=*/nullptr, skip_filters,
+        caller));
+    iter->SeekToFirst();
+    s = iter->status();
+  }
+  if (handle != nullptr) {
+    cache_.Release(handle);
+  }
+  return s;
+}
+
 Status TableCache::GetRangeTombstoneIterator(
     const ReadOptions& options,
     const InternalKeyComparator& internal_comparator,
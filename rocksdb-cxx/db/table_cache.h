@@ -118,6 +118,17 @@ class TableCache {
       HistogramImpl* file_read_hist = nullptr, bool skip_filters = false,
       int level = -1, size_t max_file_size_for_l0_meta_pin = 0);
 
+  // Opens the table of `file_meta`, unless it is already open, and reads its
+  // first data block into the block cache if options.fill_cache, so that an
+  // iterator moving into the file later waits for neither. Used to prepare
+  // the next file of a scan in the background.
+  Status PrefetchTable(
+      const ReadOptions& options, const FileOptions& toptions,
+      const InternalKeyComparator& internal_comparator,
+      const FileMetaData& file_meta, uint8_t block_protection_bytes_per_key,
+      const std::shared_ptr<const SliceTransform>& prefix_extractor,
+      TableReaderCaller caller, bool skip_filters, int level);
+
   // Return the range delete tombstone iterator of the file specified by
   // `file_meta`.
   Status GetRangeTombstoneIterator(
@@ -225,6 +236,8 @@ class TableCache {
 
   CacheInterface& get_cache() { return cache_; }
 
+  Env* env() const { return ioptions_.env; }
+
   // Capacity of the backing Cache that indicates infinite TableCache capacity.
   // For example when max_open_files is -1 we set the backing Cache to this.
   static const int kInfiniteCapacity = 0x400000;
@@ -1336,6 +1336,12 @@ class VersionBuilder::Rep {
           file_meta->table_reader_handle = handle;
           // Load table_reader
           file_meta->fd.table_reader = table_cache_->get_cache().Value(handle);
+          if (level > 0) {
+            // Best effort, like the prefetching of the index and filter
+            file_meta->fd.table_reader
+                ->GetPinnedFilters(read_options, &file_meta->pinned_filters)
+                .PermitUncheckedError();
+          }
         }
       }
     });
@@ -99,6 +99,7 @@ enum NewFileCustomTag : uint32_t {
   kPathId,
 };
 
+class PinnedFilters;
 class VersionSet;
 
 constexpr uint64_t kFileNumberMask = 0x3FFFFFFFFFFFFFFF;
@@ -178,6 +179,11 @@ struct FileMetaData {
   // Needs to be disposed when refs becomes 0.
   Cache::Handle* table_reader_handle = nullptr;
 
+  // In-memory copies of the file's filters, set along with
+  // table_reader_handle before the file is visible to readers when
+  // BlockBasedTableOptions::pin_filters_in_file_metadata is true.
+  std::shared_ptr<const PinnedFilters> pinned_filters;
+
   FileSampledStats stats;
 
   // Stats for compensating deletion entries during compaction
@@ -11,8 +11,10 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cinttypes>
 #include <cstdio>
+#include <limits>
 #include <list>
 #include <map>
 #include <set>
@@ -40,10 +42,6 @@
 #include "db/version_edit_handler.h"
 #include "table/compaction_merging_iterator.h"
 
-#if USE_COROUTINES
-#include "folly/experimental/coro/BlockingWait.h"
-#include "folly/experimental/coro/Collect.h"
-#endif
 #include "file/filename.h"
 #include "file/random_access_file_reader.h"
 #include "file/read_write_util.h"
@@ -62,6 +60,7 @@
 #include "table/merging_iterator.h"
 #include "table/meta_blocks.h"
 #include "table/multiget_context.h"
+#include "table/pinned_filters.h"
 #include "table/plain/plain_table_factory.h"
 #include "table/table_reader.h"
 #include "table/two_level_iterator.h"
@@ -70,6 +69,7 @@
 #include "util/cast_util.h"
 #include "util/coding.h"
 #include "util/coro_utils.h"
+#include "util/mutexlock.h"
 #include "util/stop_watch.h"
 #include "util/string_util.h"
 #include "util/user_comparator_wrapper.h"
@@ -974,7 +974,10 @@ class LevelIterator final : public InternalIterator {
     }
   }
 
-  ~LevelIterator() override { delete file_iter_.Set(nullptr); }
+  ~LevelIterator() override {
+    WaitForNextFile();
+    delete file_iter_.Set(nullptr);
+  }
 
   // Seek to the first file with a key >= target.
   // If range_tombstone_iter_ is not nullptr, then we pretend that file
@@ -1059,6 +1062,17 @@ class LevelIterator final : public InternalIterator {
   void SkipEmptyFileBackward();
   void SetFileIterator(InternalIterator* iter);
   void InitFileIterator(size_t new_file_index);
+  // With ReadOptions::async_io, opens the file after the current one and
+  // reads its first data block in a job on the Env's USER thread pool, so
+  // that a forward scan does not stall on the table cache miss when it gets
+  // there.
+  void MaybeOpenNextFileAsync();
+  static void OpenNextFileJob(void* arg);
+  static void UnscheduleNextFileJob(void* arg);
+  void NextFileJobDone();
+  // Cancels the job of MaybeOpenNextFileAsync() if it did not start yet, or
+  // waits for it
+  void WaitForNextFile();
 
   const Slice& file_smallest_key(size_t file_index) {
     assert(file_index < flevel_->num_files);
@@ -1188,8 +1202,58 @@ class LevelIterator final : public InternalIterator {
   // and the next file has a different prefix. SkipEmptyFileForward()
   // will not move to next file when this flag is set.
   bool prefix_exhausted_ = false;
+
+  // The file last opened ahead by MaybeOpenNextFileAsync(), if any
+  size_t next_file_index_ = std::numeric_limits<size_t>::max();
+  // The options of the job opening the next file, which are not changed
+  // while it is pending
+  ReadOptions next_file_read_options_;
+  // Whether the job is scheduled or running
+  bool next_file_job_pending_ = false;
+  port::Mutex next_file_mutex_;
+  port::CondVar next_file_cv_{&next_file_mutex_};
 };
 
+void LevelIterator::OpenNextFileJob(void* arg) {
+  LevelIterator* iter = static_cast<LevelIterator*>(arg);
+  const FileMetaData* file_meta =
+      iter->flevel_->files[iter->next_file_index_].file_metadata;
+  Status s = iter->table_cache_->PrefetchTable(
+      iter->next_file_read_options_, iter->file_options_, iter->icomparator_,
+      *file_meta, iter->block_protection_bytes_per_key_,
+      iter->prefix_extractor_, iter->caller_, iter->skip_filters_,
+      iter->level_);
+  // Errors are reported by the scan itself when it opens the file
+  s.PermitUncheckedError();
+  TEST_SYNC_POINT("LevelIterator::MaybeOpenNextFileAsync:Done");
+  iter->NextFileJobDone();
+}
+
+void LevelIterator::UnscheduleNextFileJob(void* arg) {
+  static_cast<LevelIterator*>(arg)->NextFileJobDone();
+}
+
+void LevelIterator::NextFileJobDone() {
+  MutexLock l(&next_file_mutex_);
+  next_file_job_pending_ = false;
+  next_file_cv_.SignalAll();
+}
+
+void LevelIterator::WaitForNextFile() {
+  {
+    MutexLock l(&next_file_mutex_);
+    if (!next_file_job_pending_) {
+      return;
+    }
+  }
+  TEST_SYNC_POINT("LevelIterator::WaitForNextFile:Pending");
+  table_cache_->env()->UnSchedule(this, Env::Priority::USER);
+  MutexLock l(&next_file_mutex_);
+  while (next_file_job_pending_) {
+    next_file_cv_.Wait();
+  }
+}
+
 void LevelIterator::TrySetDeleteRangeSentinel(const Slice& boundary_key) {
   assert(range_tombstone_iter_);
   if (file_iter_.iter() != nullptr && !file_iter_.Valid() &&
@@ -1333,6 +1397,7 @@ void LevelIterator::SeekToFirst() {
   prefix_exhausted_ = false;
   ClearSentinel();
   InitFileIterator(0);
+  MaybeOpenNextFileAsync();
   if (file_iter_.iter() != nullptr) {
     file_iter_.SeekToFirst();
     if (range_tombstone_iter_) {
@@ -1439,6 +1504,7 @@ bool LevelIterator::SkipEmptyFileForward() {
     }
     // may init a new *range_tombstone_iter
     InitFileIterator(file_index_ + 1);
+    MaybeOpenNextFileAsync();
     // We moved to a new SST file
     // Seek range_tombstone_iter_ to reset its !Valid() default state.
     // We do not need to call range_tombstone_iter_.Seek* in
@@ -1507,6 +1573,35 @@ void LevelIterator::SetFileIterator(InternalIterator* iter) {
   }
 }
 
+void LevelIterator::MaybeOpenNextFileAsync() {
+  const size_t next_file_index = file_index_ + 1;
+  if (!read_options_.async_io || read_options_.read_tier == kBlockCacheTier ||
+      next_file_index >= flevel_->num_files ||
+      next_file_index == next_file_index_ || prefix_exhausted_ ||
+      KeyReachedUpperBound(file_smallest_key(next_file_index))) {
+    return;
+  }
+  // At most one file is opened ahead
+  WaitForNextFile();
+  next_file_index_ = next_file_index;
+  next_file_read_options_ = read_options_;
+  // The bounds may be changed by the user while the job runs, and
+  // SeekToFirst() does not need them
+  next_file_read_options_.iterate_lower_bound = nullptr;
+  next_file_read_options_.iterate_upper_bound = nullptr;
+  Env* env = table_cache_->env();
+  // The pool is shared by all iterators. Env::SetBackgroundThreads() can
+  // give it more threads.
+  env->IncBackgroundThreadsIfNeeded(1, Env::Priority::USER);
+  {
+    MutexLock l(&next_file_mutex_);
+    next_file_job_pending_ = true;
+  }
+  env->Schedule(&LevelIterator::OpenNextFileJob, this, Env::Priority::USER,
+                this, &LevelIterator::UnscheduleNextFileJob);
+  TEST_SYNC_POINT("LevelIterator::MaybeOpenNextFileAsync:Scheduled");
+}
+
 void LevelIterator::InitFileIterator(size_t new_file_index) {
   if (new_file_index >= flevel_->num_files) {
     file_index_ = new_file_index;
@@ -2277,6 +2372,152 @@ void Version::MultiGetBlob(
   }
 }
 
+class Version::L0Probes {
+ public:
+  // Starts looking `key` up in the L0 files after the newest one that may
+  // contain it, on up to read_options.concurrent_l0_probes - 1 threads of the
+  // Env's USER pool. Returns nullptr if that could not help.
+  static std::unique_ptr<L0Probes> Start(Version* version,
+                                         const ReadOptions& read_options,
+                                         const LookupKey& key) {
+    // The probes only help if they leave the blocks in the block cache
+    if (!read_options.fill_cache || read_options.read_tier == kBlockCacheTier ||
+        version->cfd_->ioptions()->row_cache != nullptr ||
+        version->storage_info_.num_non_empty_levels_ == 0) {
+      return nullptr;
+    }
+    std::unique_ptr<L0Probes> probes(
+        new L0Probes(version, read_options, key));
+    const LevelFilesBrief& l0 = version->storage_info_.level_files_brief_[0];
+    const Slice user_key = key.user_key();
+    const UserComparatorWrapper ucmp(version->user_comparator());
+    for (size_t i = 0; i < l0.num_files; ++i) {
+      const FdWithKeyRange& f = l0.files[i];
+      if (ucmp.CompareWithoutTimestamp(user_key,
+                                       ExtractUserKey(f.smallest_key)) >= 0 &&
+          ucmp.CompareWithoutTimestamp(user_key,
+                                       ExtractUserKey(f.largest_key)) <= 0) {
+        probes->files_.emplace_back(
+            &f, version->IsFilterSkipped(0, i == l0.num_files - 1));
+      }
+    }
+    if (probes->files_.size() < 2) {
+      return nullptr;
+    }
+
+    // Get() itself reads the newest file
+    const int num_jobs = static_cast<int>(std::min(
+        probes->files_.size() - 1, read_options.concurrent_l0_probes - 1));
+    Env* env = version->env_;
+    env->IncBackgroundThreadsIfNeeded(
+        static_cast<int>(read_options.concurrent_l0_probes - 1),
+        Env::Priority::USER);
+    probes->pending_jobs_ = num_jobs;
+    for (int i = 0; i < num_jobs; ++i) {
+      env->Schedule(&L0Probes::RunJob, probes.get(), Env::Priority::USER,
+                    probes.get(), &L0Probes::UnscheduleJob);
+    }
+    return probes;
+  }
+
+  // Stops the probes that did not start yet, and waits for the others, which
+  // read the version's files.
+  ~L0Probes() {
+    stop_after_.store(0, std::memory_order_release);
+    version_->env_->UnSchedule(this, Env::Priority::USER);
+    TEST_SYNC_POINT("Version::L0Probes::Stop");
+    MutexLock l(&mutex_);
+    while (pending_jobs_ > 0) {
+      cv_.Wait();
+    }
+  }
+
+ private:
+  L0Probes(Version* version, const ReadOptions& read_options,
+           const LookupKey& key)
+      : version_(version),
+        read_options_(read_options),
+        key_(key),
+        stop_after_(std::numeric_limits<size_t>::max()),
+        cv_(&mutex_) {}
+
+  static void RunJob(void* arg) {
+    L0Probes* probes = static_cast<L0Probes*>(arg);
+    TEST_SYNC_POINT("Version::L0Probes::RunJob");
+    probes->Run();
+    probes->JobDone();
+  }
+
+  static void UnscheduleJob(void* arg) {
+    static_cast<L0Probes*>(arg)->JobDone();
+  }
+
+  void JobDone() {
+    MutexLock l(&mutex_);
+    if (--pending_jobs_ == 0) {
+      cv_.SignalAll();
+    }
+  }
+
+  void Run() {
+    for (;;) {
+      const size_t i = next_file_.fetch_add(1, std::memory_order_relaxed);
+      // Files older than one that answers the key are not needed
+      if (i >= files_.size() ||
+          i > stop_after_.load(std::memory_order_acquire)) {
+        return;
+      }
+      if (Probe(i)) {
+        size_t stop_after = stop_after_.load(std::memory_order_relaxed);
+        while (i < stop_after &&
+               !stop_after_.compare_exchange_weak(stop_after, i,
+                                                  std::memory_order_release,
+                                                  std::memory_order_relaxed)) {
+        }
+      }
+    }
+  }
+
+  // Looks the key up in files_[i], throwing the result away. Returns whether
+  // the file answers the key, so that older files need not be read.
+  bool Probe(size_t i) {
+    MergeContext merge_context;
+    SequenceNumber max_covering_tombstone_seq = 0;
+    // Collects whatever the file has for the key without merging
+    GetContext get_context(
+        version_->user_comparator(), version_->merge_operator_,
+        version_->info_log_, /*statistics=*/nullptr, GetContext::kNotFound,
+        key_.user_key(), /*value=*/nullptr, /*columns=*/nullptr,
+        /*timestamp=*/nullptr, /*value_found=*/nullptr, &merge_context,
+        /*do_merge=*/false, &max_covering_tombstone_seq, version_->clock_);
+    Status s = version_->table_cache_->Get(
+        read_options_, *version_->internal_comparator(),
+        *files_[i].first->file_metadata, key_.internal_key(), &get_context,
+        version_->mutable_cf_options_.block_protection_bytes_per_key,
+        version_->mutable_cf_options_.prefix_extractor,
+        /*file_read_hist=*/nullptr, files_[i].second, /*level=*/0,
+        version_->max_file_size_for_l0_meta_pin_);
+    // Errors are reported by the lookup in Get()
+    s.PermitUncheckedError();
+    return s.ok() && (get_context.State() != GetContext::kNotFound &&
+                      get_context.State() != GetContext::kMerge);
+  }
+
+  Version* const version_;
+  const ReadOptions& read_options_;
+  const LookupKey& key_;
+  // <file, skip_filters> of the L0 files that may contain the key, newest
+  // first
+  std::vector<std::pair<const FdWithKeyRange*, bool>> files_;
+  std::atomic<size_t> next_file_{1};
+  // Index of the newest file known to answer the key, or 0 once Get() no
+  // longer needs the probes
+  std::atomic<size_t> stop_after_;
+  port::Mutex mutex_;
+  port::CondVar cv_;
+  int pending_jobs_ = 0;
+};
+
 void Version::Get(const ReadOptions& read_options, const LookupKey& k,
                   PinnableSlice* value, PinnableWideColumns* columns,
                   std::string* timestamp, Status* status,
@@ -2329,16 +2570,40 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
                 internal_comparator());
   FdWithKeyRange* f = fp.GetNextFile();
 
+  // Stopped, and waited for, on return
+  std::unique_ptr<L0Probes> l0_probes;
+  if (read_options.concurrent_l0_probes > 1 &&
+      *max_covering_tombstone_seq == 0) {
+    l0_probes = L0Probes::Start(this, read_options, k);
+  }
+
   while (f != nullptr) {
     if (*max_covering_tombstone_seq > 0) {
       // The remaining files we look at will only contain covered keys, so we
       // stop here.
       break;
     }
+    if (l0_probes != nullptr && fp.GetHitFileLevel() > 0) {
+      // All of the L0 files were read
+      l0_probes.reset();
+    }
     if (get_context.sample()) {
       sample_file_read_inc(f->file_metadata);
     }
 
+    const bool skip_filters = IsFilterSkipped(
+        static_cast<int>(fp.GetHitFileLevel()), fp.IsHitFileLastInLevel());
+    const PinnedFilters* pinned_filters =
+        f->file_metadata->pinned_filters.get();
+    if (pinned_filters != nullptr && !skip_filters &&
+        !pinned_filters->KeyMayMatch(user_comparator(), user_key)) {
+      // The file's filter rules out the key, without the table reader
+      RecordTick(db_statistics_, BLOOM_FILTER_USEFUL);
+      PERF_COUNTER_BY_LEVEL_ADD(bloom_filter_useful, 1, fp.GetHitFileLevel());
+      f = fp.GetNextFile();
+      continue;
+    }
+
     bool timer_enabled =
         GetPerfLevel() >= PerfLevel::kEnableTimeExceptForMutex &&
         get_perf_context()->per_level_perf_context_enabled;
@@ -2348,9 +2613,7 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
         &get_context, mutable_cf_options_.block_protection_bytes_per_key,
         mutable_cf_options_.prefix_extractor,
         cfd_->internal_stats()->GetFileReadHist(fp.GetHitFileLevel()),
-        IsFilterSkipped(static_cast<int>(fp.GetHitFileLevel()),
-                        fp.IsHitFileLastInLevel()),
-        fp.GetHitFileLevel(), max_file_size_for_l0_meta_pin_);
+        skip_filters, fp.GetHitFileLevel(), max_file_size_for_l0_meta_pin_);
     // TODO: examine the behavior for corrupted key
     if (timer_enabled) {
       PERF_COUNTER_BY_LEVEL_ADD(get_from_table_nanos, timer.ElapsedNanos(),
@@ -2578,7 +2841,7 @@ void Version::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
         }
 #if USE_COROUTINES
       } else {
-        std::vector<folly::coro::Task<Status>> mget_tasks;
+        std::vector<CoroTask<Status>> mget_tasks;
         while (f != nullptr) {
           MultiGetRange file_range = fp.CurrentFileRange();
           TableCache::TypedHandle* table_handle = nullptr;
@@ -2620,9 +2883,8 @@ void Version::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
           RecordTick(db_statistics_, MULTIGET_COROUTINE_COUNT,
                      mget_tasks.size());
           // Collect all results so far
-          std::vector<Status> statuses = folly::coro::blockingWait(
-              folly::coro::collectAllRange(std::move(mget_tasks))
-                  .scheduleOn(&range->context()->executor()));
+          std::vector<Status> statuses =
+              range->context()->executor().CollectAll(std::move(mget_tasks));
           if (s.ok()) {
             for (Status stat : statuses) {
               if (!stat.ok()) {
@@ -2748,7 +3010,7 @@ void Version::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
 #ifdef USE_COROUTINES
 Status Version::ProcessBatch(
     const ReadOptions& read_options, FilePickerMultiGet* batch,
-    std::vector<folly::coro::Task<Status>>& mget_tasks,
+    std::vector<CoroTask<Status>>& mget_tasks,
     std::unordered_map<uint64_t, BlobReadContexts>* blob_ctxs,
     autovector<FilePickerMultiGet, 4>& batches, std::deque<size_t>& waiting,
     std::deque<size_t>& to_process, unsigned int& num_tasks_queued,
@@ -2863,7 +3125,7 @@ Status Version::MultiGetAsync(
   std::deque<size_t> waiting;
   std::deque<size_t> to_process;
   Status s;
-  std::vector<folly::coro::Task<Status>> mget_tasks;
+  std::vector<CoroTask<Status>> mget_tasks;
   std::unordered_map<int, std::tuple<uint64_t, uint64_t, uint64_t>> mget_stats;
 
   // Create the initial batch with the input range
@@ -2912,9 +3174,8 @@ Status Version::MultiGetAsync(
         assert(waiting.size());
         RecordTick(db_statistics_, MULTIGET_COROUTINE_COUNT, mget_tasks.size());
         // Collect all results so far
-        std::vector<Status> statuses = folly::coro::blockingWait(
-            folly::coro::collectAllRange(std::move(mget_tasks))
-                .scheduleOn(&range->context()->executor()));
+        std::vector<Status> statuses =
+            range->context()->executor().CollectAll(std::move(mget_tasks));
         mget_tasks.clear();
         if (s.ok()) {
           for (Status stat : statuses) {
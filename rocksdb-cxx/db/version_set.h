@@ -47,10 +47,6 @@
 #include "db/version_edit.h"
 #include "db/write_controller.h"
 #include "env/file_system_tracer.h"
-#if USE_COROUTINES
-#include "folly/experimental/coro/BlockingWait.h"
-#include "folly/experimental/coro/Collect.h"
-#endif
 #include "monitoring/instrumented_mutex.h"
 #include "options/db_options.h"
 #include "port/port.h"
@@ -1026,6 +1022,11 @@ class Version {
   // that it eventually expires from the cache.
   bool IsFilterSkipped(int level, bool is_file_last_in_level = false);
 
+  // Looks a key up in the older L0 files that may contain it in the
+  // background, while Get() reads the newest one, so that Get() then finds
+  // their blocks in the block cache. See ReadOptions::concurrent_l0_probes.
+  class L0Probes;
+
   // The helper function of UpdateAccumulatedStats, which may fill the missing
   // fields of file_meta from its associated TableProperties.
   // Returns true if it does initialize FileMetaData.
@@ -1058,7 +1059,7 @@ class Version {
   // enqueuing it to to_process.
   Status ProcessBatch(
       const ReadOptions& read_options, FilePickerMultiGet* batch,
-      std::vector<folly::coro::Task<Status>>& mget_tasks,
+      std::vector<CoroTask<Status>>& mget_tasks,
       std::unordered_map<uint64_t, BlobReadContexts>* blob_ctxs,
       autovector<FilePickerMultiGet, 4>& batches, std::deque<size_t>& waiting,
       std::deque<size_t>& to_process, unsigned int& num_tasks_queued,
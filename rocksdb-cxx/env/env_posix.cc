@@ -347,12 +347,12 @@ class PosixEnv : public CompositeEnv {
 
   // Allow increasing the number of worker threads.
   void SetBackgroundThreads(int num, Priority pri) override {
-    assert(pri >= Priority::BOTTOM && pri <= Priority::HIGH);
+    assert(pri >= Priority::BOTTOM && pri < Priority::TOTAL);
     thread_pools_[pri].SetBackgroundThreads(num);
   }
 
   int GetBackgroundThreads(Priority pri) override {
-    assert(pri >= Priority::BOTTOM && pri <= Priority::HIGH);
+    assert(pri >= Priority::BOTTOM && pri < Priority::TOTAL);
     return thread_pools_[pri].GetBackgroundThreads();
   }
 
@@ -363,7 +363,7 @@ class PosixEnv : public CompositeEnv {
 
   // Allow increasing the number of worker threads.
   void IncBackgroundThreadsIfNeeded(int num, Priority pri) override {
-    assert(pri >= Priority::BOTTOM && pri <= Priority::HIGH);
+    assert(pri >= Priority::BOTTOM && pri < Priority::TOTAL);
     thread_pools_[pri].IncBackgroundThreadsIfNeeded(num);
   }
 
@@ -428,7 +428,7 @@ PosixEnv::PosixEnv()
 
 void PosixEnv::Schedule(void (*function)(void* arg1), void* arg, Priority pri,
                         void* tag, void (*unschedFunction)(void* arg)) {
-  assert(pri >= Priority::BOTTOM && pri <= Priority::HIGH);
+  assert(pri >= Priority::BOTTOM && pri < Priority::TOTAL);
   thread_pools_[pri].Schedule(function, arg, tag, unschedFunction);
 }
 
@@ -437,17 +437,17 @@ int PosixEnv::UnSchedule(void* arg, Priority pri) {
 }
 
 unsigned int PosixEnv::GetThreadPoolQueueLen(Priority pri) const {
-  assert(pri >= Priority::BOTTOM && pri <= Priority::HIGH);
+  assert(pri >= Priority::BOTTOM && pri < Priority::TOTAL);
   return thread_pools_[pri].GetQueueLen();
 }
 
 int PosixEnv::ReserveThreads(int threads_to_reserved, Priority pri) {
-  assert(pri >= Priority::BOTTOM && pri <= Priority::HIGH);
+  assert(pri >= Priority::BOTTOM && pri < Priority::TOTAL);
   return thread_pools_[pri].ReserveThreads(threads_to_reserved);
 }
 
 int PosixEnv::ReleaseThreads(int threads_to_released, Priority pri) {
-  assert(pri >= Priority::BOTTOM && pri <= Priority::HIGH);
+  assert(pri >= Priority::BOTTOM && pri < Priority::TOTAL);
   return thread_pools_[pri].ReleaseThreads(threads_to_released);
 }
 
@@ -1733,6 +1733,117 @@ TEST_F(EnvPosixTest, MultiReadIOUringError2) {
   SyncPoint::GetInstance()->DisableProcessing();
   SyncPoint::GetInstance()->ClearAllCallBacks();
 }
+
+// Runs `fn` on a new thread, so that it gets a new io_uring with
+// `num_fixed_files` registered file slots and `num_fixed_buffers` registered
+// buffers.
+void RunWithIOUringFixedTables(unsigned int num_fixed_files,
+                               unsigned int num_fixed_buffers,
+                               const std::function<void()>& fn) {
+  SyncPoint::GetInstance()->SetCallBack("IOUringNumFixedFiles", [&](void* arg) {
+    *static_cast<unsigned int*>(arg) = num_fixed_files;
+  });
+  SyncPoint::GetInstance()->SetCallBack(
+      "IOUringNumFixedBuffers", [&](void* arg) {
+        *static_cast<unsigned int*>(arg) = num_fixed_buffers;
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+  port::Thread thread(fn);
+  thread.join();
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
+TEST_F(EnvPosixTest, MultiReadIOUringFixedFiles) {
+  EnvOptions soptions;
+  // More files than registered file slots
+  const int kNumFiles = 10;
+  std::vector<std::string> fnames;
+  std::vector<std::vector<std::string>> scratches(kNumFiles);
+  std::vector<std::vector<ReadRequest>> reqs(kNumFiles);
+  for (int i = 0; i < kNumFiles; ++i) {
+    fnames.push_back(
+        test::PerThreadDBPath(env_, "testfile" + std::to_string(i)));
+    GenerateFilesAndRequest(env_, fnames.back(), &reqs[i], &scratches[i]);
+  }
+
+  Random rnd(301);
+  std::string expected = rnd.RandomString(81920);
+  auto read_files = [&]() {
+    for (int round = 0; round < 3; ++round) {
+      // Reopen the files every round so that closed files have to be dropped
+      // from the table
+      std::vector<std::unique_ptr<RandomAccessFile>> files(kNumFiles);
+      for (int i = 0; i < kNumFiles; ++i) {
+        ASSERT_OK(env_->NewRandomAccessFile(fnames[i], &files[i], soptions));
+      }
+      for (int pass = 0; pass < 2; ++pass) {
+        for (int i = 0; i < kNumFiles; ++i) {
+          ASSERT_OK(files[i]->MultiRead(reqs[i].data(), reqs[i].size()));
+          for (const ReadRequest& req : reqs[i]) {
+            ASSERT_OK(req.status);
+            ASSERT_EQ(req.result.ToString(),
+                      expected.substr(req.offset, req.len));
+          }
+        }
+      }
+    }
+  };
+  RunWithIOUringFixedTables(/*num_fixed_files=*/4, /*num_fixed_buffers=*/0,
+                            read_files);
+  for (const std::string& fname : fnames) {
+    ASSERT_OK(env_->DeleteFile(fname));
+  }
+}
+
+TEST_F(EnvPosixTest, MultiReadIOUringFixedBuffers) {
+  const size_t kSectorSize = 4096;
+  // More requests than registered buffers
+  const size_t kNumReqs = 5;
+  std::string fname = test::PerThreadDBPath(env_, "testfile");
+  Random rnd(301);
+  std::string expected = rnd.RandomString(2 * kNumReqs * kSectorSize);
+  {
+    std::unique_ptr<WritableFile> wfile;
+    ASSERT_OK(env_->NewWritableFile(fname, &wfile, EnvOptions()));
+    ASSERT_OK(wfile->Append(expected));
+    ASSERT_OK(wfile->Close());
+  }
+
+  EnvOptions soptions;
+  soptions.use_direct_reads = true;
+  std::unique_ptr<RandomAccessFile> file;
+  Status s = env_->NewRandomAccessFile(fname, &file, soptions);
+  if (!s.ok()) {
+    ROCKSDB_GTEST_BYPASS("Direct I/O is not supported");
+    ASSERT_OK(env_->DeleteFile(fname));
+    return;
+  }
+  file.reset();
+
+  auto read_file = [&]() {
+    ASSERT_OK(env_->NewRandomAccessFile(fname, &file, soptions));
+    for (int pass = 0; pass < 2; ++pass) {
+      std::vector<ReadRequest> reqs(kNumReqs);
+      std::vector<std::unique_ptr<char, Deleter>> data;
+      for (size_t i = 0; i < kNumReqs; ++i) {
+        reqs[i].offset = (2 * i + pass) * kSectorSize;
+        reqs[i].len = kSectorSize;
+        data.emplace_back(NewAligned(kSectorSize, 0));
+        reqs[i].scratch = data.back().get();
+      }
+      ASSERT_OK(file->MultiRead(reqs.data(), reqs.size()));
+      for (const ReadRequest& req : reqs) {
+        ASSERT_OK(req.status);
+        ASSERT_EQ(req.result.ToString(), expected.substr(req.offset, req.len));
+      }
+    }
+    file.reset();
+  };
+  RunWithIOUringFixedTables(/*num_fixed_files=*/0, /*num_fixed_buffers=*/2,
+                            read_file);
+  ASSERT_OK(env_->DeleteFile(fname));
+}
 #endif  // ROCKSDB_IOURING_PRESENT
 
 // Only works in linux platforms
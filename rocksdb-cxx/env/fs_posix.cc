@@ -1011,7 +1011,10 @@ class PosixFileSystem : public FileSystem {
     // io_uring_queue_init.
     struct io_uring* iu = nullptr;
     if (thread_local_io_urings_) {
-      iu = static_cast<struct io_uring*>(thread_local_io_urings_->Get());
+      auto piu = static_cast<PosixIOUring*>(thread_local_io_urings_->Get());
+      if (piu != nullptr) {
+        iu = &piu->ring;
+      }
     }
 
     // Init failed, platform doesn't support io_uring.
@@ -1083,7 +1086,10 @@ class PosixFileSystem : public FileSystem {
     // io_uring_queue_init.
     struct io_uring* iu = nullptr;
     if (thread_local_io_urings_) {
-      iu = static_cast<struct io_uring*>(thread_local_io_urings_->Get());
+      auto piu = static_cast<PosixIOUring*>(thread_local_io_urings_->Get());
+      if (piu != nullptr) {
+        iu = &piu->ring;
+      }
     }
 
     // Init failed, platform doesn't support io_uring.
@@ -1251,7 +1257,7 @@ PosixFileSystem::PosixFileSystem()
   // Test whether IOUring is supported, and if it does, create a managing
   // object for thread local point so that in the future thread-local
   // io_uring can be created.
-  struct io_uring* new_io_uring = CreateIOUring();
+  PosixIOUring* new_io_uring = CreateIOUring();
   if (new_io_uring != nullptr) {
     thread_local_io_urings_.reset(new ThreadLocalPtr(DeleteIOUring));
     delete new_io_uring;
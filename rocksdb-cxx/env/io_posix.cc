@@ -14,6 +14,7 @@
 #include <fcntl.h>
 
 #include <algorithm>
+#include <unordered_set>
 #if defined(OS_LINUX)
 #include <linux/fs.h>
 #ifndef FALLOC_FL_KEEP_SIZE
@@ -45,6 +46,24 @@
 #define F_SET_RW_HINT (F_LINUX_SPECIFIC_BASE + 12)
 #endif
 
+#if defined(ROCKSDB_IOURING_PRESENT)
+// Optional io_uring features, enabled like RocksDbIOUringEnable() by
+// defining these functions in the application. Each returns 0 to disable
+// the feature.
+//
+// If non-zero, rings are created with a kernel submission queue polling
+// thread (IORING_SETUP_SQPOLL) that goes to sleep after this many
+// milliseconds without submissions. Note that every thread doing async or
+// multi reads has its own ring, and so its own polling thread.
+extern "C" unsigned int RocksDbIOUringSqPollIdleMs() __attribute__((__weak__));
+// Number of registered file slots per ring
+extern "C" unsigned int RocksDbIOUringNumFixedFiles() __attribute__((__weak__));
+// Number of registered kIoUringFixedBufferSize read buffers per ring, used
+// for direct I/O MultiRead
+extern "C" unsigned int RocksDbIOUringNumFixedBuffers()
+    __attribute__((__weak__));
+#endif
+
 namespace ROCKSDB_NAMESPACE {
 
 std::string IOErrorMsg(const std::string& context,
@@ -318,6 +337,188 @@ IOStatus PosixSequentialFile::InvalidateCache(size_t offset, size_t length) {
 #endif
 }
 
+#if defined(ROCKSDB_IOURING_PRESENT)
+namespace {
+// Bumped whenever a file that may be in a registered file table is closed,
+// so that rings can drop the closed files before reusing their slots.
+std::atomic<uint64_t> io_uring_file_closes{0};
+std::atomic<uint64_t> next_io_uring_file_id{1};
+
+// Ids of the open PosixRandomAccessFiles
+port::Mutex open_file_ids_mutex;
+std::unordered_set<uint64_t> open_file_ids;
+
+unsigned int GetIOUringHookValue(unsigned int (*hook)()) {
+  return hook ? hook() : 0;
+}
+
+// Tests can override the table sizes through these sync points, for the
+// rings created while the callbacks are set.
+unsigned int IOUringNumFixedFiles() {
+  unsigned int num = GetIOUringHookValue(RocksDbIOUringNumFixedFiles);
+  TEST_SYNC_POINT_CALLBACK("IOUringNumFixedFiles", &num);
+  return num;
+}
+
+unsigned int IOUringNumFixedBuffers() {
+  unsigned int num = GetIOUringHookValue(RocksDbIOUringNumFixedBuffers);
+  TEST_SYNC_POINT_CALLBACK("IOUringNumFixedBuffers", &num);
+  return num;
+}
+}  // namespace
+
+PosixIOUring* CreateIOUring() {
+  std::unique_ptr<PosixIOUring> iu(new PosixIOUring);
+  int ret = -1;
+  unsigned int sq_poll_idle_ms =
+      GetIOUringHookValue(RocksDbIOUringSqPollIdleMs);
+  if (sq_poll_idle_ms > 0) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_SQPOLL;
+    params.sq_thread_idle = sq_poll_idle_ms;
+    ret = io_uring_queue_init_params(kIoUringDepth, &iu->ring, &params);
+    // Fall back to a regular ring, e.g. if lacking the privileges
+  }
+  if (ret) {
+    ret = io_uring_queue_init(kIoUringDepth, &iu->ring, 0);
+  }
+  if (ret) {
+    // Nothing to clean up in the destructor
+    iu->ring.ring_fd = -1;
+    return nullptr;
+  }
+
+  unsigned int num_fixed_files = IOUringNumFixedFiles();
+  if (num_fixed_files > 0) {
+    // Start with a sparse table
+    std::vector<int> fds(num_fixed_files, -1);
+    if (io_uring_register_files(&iu->ring, fds.data(), num_fixed_files) ==
+        0) {
+      iu->fixed_file_ids.resize(num_fixed_files, 0);
+      iu->fixed_file_referenced.resize(num_fixed_files, false);
+      iu->seen_file_closes =
+          io_uring_file_closes.load(std::memory_order_acquire);
+    }
+  }
+
+  unsigned int num_fixed_buffers = IOUringNumFixedBuffers();
+  if (num_fixed_buffers > 0) {
+    std::vector<struct iovec> iovs;
+    for (unsigned int i = 0; i < num_fixed_buffers; ++i) {
+      void* buf = nullptr;
+      if (posix_memalign(&buf, kDefaultPageSize, kIoUringFixedBufferSize)) {
+        break;
+      }
+      iu->fixed_buffers.push_back(static_cast<char*>(buf));
+      iovs.push_back({buf, kIoUringFixedBufferSize});
+    }
+    if (iovs.empty() ||
+        io_uring_register_buffers(&iu->ring, iovs.data(),
+                                  static_cast<unsigned>(iovs.size())) != 0) {
+      for (char* buf : iu->fixed_buffers) {
+        free(buf);
+      }
+      iu->fixed_buffers.clear();
+    }
+    for (size_t i = 0; i < iu->fixed_buffers.size(); ++i) {
+      iu->free_buffers.push_back(static_cast<int>(i));
+    }
+  }
+  return iu.release();
+}
+
+PosixIOUring::~PosixIOUring() {
+  if (ring.ring_fd >= 0) {
+    // Also unregisters files and buffers
+    io_uring_queue_exit(&ring);
+  }
+  for (char* buf : fixed_buffers) {
+    free(buf);
+  }
+}
+
+int PosixIOUring::GetFixedFileSlot(uint64_t file_id, int fd) {
+  if (fixed_file_ids.empty()) {
+    return -1;
+  }
+  auto it = fixed_file_slots.find(file_id);
+  if (it != fixed_file_slots.end()) {
+    fixed_file_referenced[it->second] = true;
+    return it->second;
+  }
+
+  // Free up the slots of files closed since the last check
+  uint64_t file_closes = io_uring_file_closes.load(std::memory_order_acquire);
+  if (file_closes != seen_file_closes) {
+    seen_file_closes = file_closes;
+    std::vector<uint64_t> closed;
+    {
+      MutexLock l(&open_file_ids_mutex);
+      for (const auto& slot : fixed_file_slots) {
+        if (open_file_ids.count(slot.first) == 0) {
+          closed.push_back(slot.first);
+        }
+      }
+    }
+    for (uint64_t id : closed) {
+      ReleaseFixedFile(id);
+    }
+  }
+
+  // Clock: take the first empty slot, or the first one not referenced since
+  // the hand last passed it
+  const size_t num_slots = fixed_file_ids.size();
+  size_t slot = num_slots;
+  for (size_t i = 0; i < 2 * num_slots; ++i) {
+    size_t candidate = clock_hand;
+    clock_hand = (clock_hand + 1) % num_slots;
+    if (fixed_file_ids[candidate] == 0 || !fixed_file_referenced[candidate]) {
+      slot = candidate;
+      break;
+    }
+    fixed_file_referenced[candidate] = false;
+  }
+  assert(slot < num_slots);
+  if (io_uring_register_files_update(&ring, static_cast<unsigned>(slot), &fd,
+                                     1) != 1) {
+    return -1;
+  }
+  if (fixed_file_ids[slot] != 0) {
+    fixed_file_slots.erase(fixed_file_ids[slot]);
+  }
+  fixed_file_ids[slot] = file_id;
+  fixed_file_referenced[slot] = true;
+  fixed_file_slots[file_id] = static_cast<int>(slot);
+  return static_cast<int>(slot);
+}
+
+void PosixIOUring::ReleaseFixedFile(uint64_t file_id) {
+  auto it = fixed_file_slots.find(file_id);
+  if (it == fixed_file_slots.end()) {
+    return;
+  }
+  int slot = it->second;
+  int empty = -1;
+  // Drops the kernel's reference to the file. Failure only delays closing
+  // the file until the slot is reused.
+  io_uring_register_files_update(&ring, static_cast<unsigned>(slot), &empty,
+                                 1);
+  fixed_file_ids[slot] = 0;
+  fixed_file_referenced[slot] = false;
+  fixed_file_slots.erase(it);
+}
+
+int PosixIOUring::AllocateFixedBuffer(size_t len) {
+  if (free_buffers.empty() || len > kIoUringFixedBufferSize) {
+    return -1;
+  }
+  int index = free_buffers.back();
+  free_buffers.pop_back();
+  return index;
+}
+#endif  // defined(ROCKSDB_IOURING_PRESENT)
+
 /*
  * PosixRandomAccessFile
  */
@@ -553,14 +754,68 @@ PosixRandomAccessFile::PosixRandomAccessFile(
       logical_sector_size_(logical_block_size)
 #if defined(ROCKSDB_IOURING_PRESENT)
       ,
-      thread_local_io_urings_(thread_local_io_urings)
+      thread_local_io_urings_(thread_local_io_urings),
+      file_id_(next_io_uring_file_id.fetch_add(1, std::memory_order_relaxed)),
+      fixed_file_tracked_(thread_local_io_urings_ != nullptr &&
+                          IOUringNumFixedFiles() > 0)
 #endif
 {
   assert(!options.use_direct_reads || !options.use_mmap_reads);
   assert(!options.use_mmap_reads);
+#if defined(ROCKSDB_IOURING_PRESENT)
+  if (fixed_file_tracked_) {
+    MutexLock l(&open_file_ids_mutex);
+    open_file_ids.insert(file_id_);
+  }
+#endif
 }
 
-PosixRandomAccessFile::~PosixRandomAccessFile() { close(fd_); }
+PosixRandomAccessFile::~PosixRandomAccessFile() {
+#if defined(ROCKSDB_IOURING_PRESENT)
+  if (fixed_file_tracked_) {
+    {
+      MutexLock l(&open_file_ids_mutex);
+      open_file_ids.erase(file_id_);
+    }
+    // This thread's ring can let go right away. Other rings notice on their
+    // next registration.
+    auto iu = static_cast<PosixIOUring*>(thread_local_io_urings_->Get());
+    if (iu != nullptr) {
+      iu->ReleaseFixedFile(file_id_);
+    }
+    io_uring_file_closes.fetch_add(1, std::memory_order_release);
+  }
+#endif
+  close(fd_);
+}
+
+#if defined(ROCKSDB_IOURING_PRESENT)
+PosixIOUring* PosixRandomAccessFile::GetIOUring() {
+  PosixIOUring* iu = nullptr;
+  if (thread_local_io_urings_) {
+    iu = static_cast<PosixIOUring*>(thread_local_io_urings_->Get());
+    if (iu == nullptr) {
+      iu = CreateIOUring();
+      if (iu != nullptr) {
+        thread_local_io_urings_->Reset(iu);
+      }
+    }
+  }
+  return iu;
+}
+
+void PosixRandomAccessFile::PrepareFixedFile(PosixIOUring* iu,
+                                             struct io_uring_sqe* sqe) {
+  if (!fixed_file_tracked_) {
+    return;
+  }
+  int slot = iu->GetFixedFileSlot(file_id_, fd_);
+  if (slot >= 0) {
+    sqe->fd = slot;
+    sqe->flags |= IOSQE_FIXED_FILE;
+  }
+}
+#endif
 
 IOStatus PosixRandomAccessFile::Read(uint64_t offset, size_t n,
                                      const IOOptions& /*opts*/, Slice* result,
@@ -615,22 +870,14 @@ IOStatus PosixRandomAccessFile::MultiRead(FSReadRequest* reqs, size_t num_reqs,
   }
 
 #if defined(ROCKSDB_IOURING_PRESENT)
-  struct io_uring* iu = nullptr;
-  if (thread_local_io_urings_) {
-    iu = static_cast<struct io_uring*>(thread_local_io_urings_->Get());
-    if (iu == nullptr) {
-      iu = CreateIOUring();
-      if (iu != nullptr) {
-        thread_local_io_urings_->Reset(iu);
-      }
-    }
-  }
+  PosixIOUring* piu = GetIOUring();
 
   // Init failed, platform doesn't support io_uring. Fall back to
   // serialized reads
-  if (iu == nullptr) {
+  if (piu == nullptr) {
     return FSRandomAccessFile::MultiRead(reqs, num_reqs, options, dbg);
   }
+  struct io_uring* iu = &piu->ring;
 
   IOStatus ios = IOStatus::OK();
 
@@ -638,7 +885,10 @@ IOStatus PosixRandomAccessFile::MultiRead(FSReadRequest* reqs, size_t num_reqs,
     FSReadRequest* req;
     struct iovec iov;
     size_t finished_len;
-    explicit WrappedReadRequest(FSReadRequest* r) : req(r), finished_len(0) {}
+    // Registered buffer the request is being read into, if any
+    int fixed_buffer;
+    explicit WrappedReadRequest(FSReadRequest* r)
+        : req(r), finished_len(0), fixed_buffer(-1) {}
   };
 
   autovector<WrappedReadRequest, 32> req_wraps;
@@ -672,9 +922,24 @@ IOStatus PosixRandomAccessFile::MultiRead(FSReadRequest* reqs, size_t num_reqs,
 
       struct io_uring_sqe* sqe;
       sqe = io_uring_get_sqe(iu);
-      io_uring_prep_readv(
-          sqe, fd_, &rep_to_submit->iov, 1,
-          rep_to_submit->req->offset + rep_to_submit->finished_len);
+      // Registered buffers pay off for direct I/O, which otherwise pins the
+      // destination pages for every request
+      if (use_direct_io()) {
+        rep_to_submit->fixed_buffer =
+            piu->AllocateFixedBuffer(rep_to_submit->iov.iov_len);
+      }
+      if (rep_to_submit->fixed_buffer >= 0) {
+        io_uring_prep_read_fixed(
+            sqe, fd_, piu->fixed_buffers[rep_to_submit->fixed_buffer],
+            static_cast<unsigned>(rep_to_submit->iov.iov_len),
+            rep_to_submit->req->offset + rep_to_submit->finished_len,
+            rep_to_submit->fixed_buffer);
+      } else {
+        io_uring_prep_readv(
+            sqe, fd_, &rep_to_submit->iov, 1,
+            rep_to_submit->req->offset + rep_to_submit->finished_len);
+      }
+      PrepareFixedFile(piu, sqe);
       io_uring_sqe_set_data(sqe, rep_to_submit);
       wrap_cache.emplace(rep_to_submit);
     }
@@ -701,6 +966,12 @@ IOStatus PosixRandomAccessFile::MultiRead(FSReadRequest* reqs, size_t num_reqs,
           io_uring_cqe_seen(iu, cqe);
         }
       }
+      for (WrappedReadRequest* req_wrap : wrap_cache) {
+        if (req_wrap->fixed_buffer >= 0) {
+          piu->ReleaseFixedBuffer(req_wrap->fixed_buffer);
+          req_wrap->fixed_buffer = -1;
+        }
+      }
       return IOStatus::IOError("io_uring_submit_and_wait() requested " +
                                std::to_string(this_reqs) + " but returned " +
                                std::to_string(ret));
@@ -742,6 +1013,16 @@ IOStatus PosixRandomAccessFile::MultiRead(FSReadRequest* reqs, size_t num_reqs,
       }
       wrap_cache.erase(wrap_check);
 
+      if (req_wrap->fixed_buffer >= 0) {
+        if (cqe->res > 0) {
+          memcpy(req_wrap->iov.iov_base,
+                 piu->fixed_buffers[req_wrap->fixed_buffer],
+                 static_cast<size_t>(cqe->res));
+        }
+        piu->ReleaseFixedBuffer(req_wrap->fixed_buffer);
+        req_wrap->fixed_buffer = -1;
+      }
+
       FSReadRequest* req = req_wrap->req;
       size_t bytes_read = 0;
       bool read_again = false;
@@ -864,21 +1145,13 @@ IOStatus PosixRandomAccessFile::ReadAsync(
 
 #if defined(ROCKSDB_IOURING_PRESENT)
   // io_uring_queue_init.
-  struct io_uring* iu = nullptr;
-  if (thread_local_io_urings_) {
-    iu = static_cast<struct io_uring*>(thread_local_io_urings_->Get());
-    if (iu == nullptr) {
-      iu = CreateIOUring();
-      if (iu != nullptr) {
-        thread_local_io_urings_->Reset(iu);
-      }
-    }
-  }
+  PosixIOUring* piu = GetIOUring();
 
   // Init failed, platform doesn't support io_uring.
-  if (iu == nullptr) {
+  if (piu == nullptr) {
     return IOStatus::NotSupported("ReadAsync");
   }
+  struct io_uring* iu = &piu->ring;
 
   // Allocate io_handle.
   IOHandleDeleter deletefn = [](void* args) -> void {
@@ -902,6 +1175,7 @@ IOStatus PosixRandomAccessFile::ReadAsync(
 
   io_uring_prep_readv(sqe, fd_, /*sqe->addr=*/&posix_handle->iov,
                       /*sqe->len=*/1, /*sqe->offset=*/posix_handle->offset);
+  PrepareFixedFile(piu, sqe);
 
   // Sets sqe->user_data to posix_handle.
   io_uring_sqe_set_data(sqe, posix_handle);
@@ -18,6 +18,8 @@
 #include <functional>
 #include <map>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "port/port.h"
 #include "rocksdb/env.h"
@@ -262,20 +264,59 @@ class PosixSequentialFile : public FSSequentialFile {
 // io_uring instance queue depth
 const unsigned int kIoUringDepth = 256;
 
+// Size of each registered read buffer (see RocksDbIOUringNumFixedBuffers())
+const size_t kIoUringFixedBufferSize = 64 << 10;
+
+// A thread-local io_uring, plus the files and buffers registered with it.
+//
+// Registered ("fixed") files save the kernel an fd table lookup and file
+// reference count update per request. The table has a fixed number of slots
+// per ring. Slots are handed out to files on first use and replaced with a
+// clock (second chance) policy, so files that keep being read stay
+// registered. Slots are keyed by PosixRandomAccessFile::file_id_ rather than
+// by fd, because fd numbers are reused once a file is closed.
+//
+// Registered buffers save pinning and unpinning the destination pages on
+// every request. Direct I/O reads that fit in one of them are read into it
+// and copied out to the caller's buffer on completion.
+struct PosixIOUring {
+  ~PosixIOUring();
+
+  // Returns the slot of the registered file table holding `file_id`,
+  // registering `fd` in a free or cold slot if needed. Returns -1 if files
+  // are not registered with this ring or registration fails.
+  int GetFixedFileSlot(uint64_t file_id, int fd);
+
+  // Drops a closed file from the table, if it is registered.
+  void ReleaseFixedFile(uint64_t file_id);
+
+  // Returns the index of an unused registered buffer of at least `len`
+  // bytes, or -1 if there is none.
+  int AllocateFixedBuffer(size_t len);
+  void ReleaseFixedBuffer(int index) { free_buffers.push_back(index); }
+
+  struct io_uring ring;
+
+  std::vector<uint64_t> fixed_file_ids;  // by slot, 0 if empty
+  std::vector<bool> fixed_file_referenced;
+  std::unordered_map<uint64_t, int> fixed_file_slots;
+  size_t clock_hand = 0;
+  // Value of the global closed file counter when this table was last
+  // checked for closed files
+  uint64_t seen_file_closes = 0;
+
+  std::vector<char*> fixed_buffers;
+  std::vector<int> free_buffers;
+};
+
 inline void DeleteIOUring(void* p) {
-  struct io_uring* iu = static_cast<struct io_uring*>(p);
+  PosixIOUring* iu = static_cast<PosixIOUring*>(p);
   delete iu;
 }
 
-inline struct io_uring* CreateIOUring() {
-  struct io_uring* new_io_uring = new struct io_uring;
-  int ret = io_uring_queue_init(kIoUringDepth, new_io_uring, 0);
-  if (ret) {
-    delete new_io_uring;
-    new_io_uring = nullptr;
-  }
-  return new_io_uring;
-}
+// Creates an io_uring with the optional features enabled by the
+// RocksDbIOUring* hooks, or returns nullptr if io_uring is not supported.
+PosixIOUring* CreateIOUring();
 #endif  // defined(ROCKSDB_IOURING_PRESENT)
 
 class PosixRandomAccessFile : public FSRandomAccessFile {
@@ -286,6 +327,19 @@ class PosixRandomAccessFile : public FSRandomAccessFile {
   size_t logical_sector_size_;
 #if defined(ROCKSDB_IOURING_PRESENT)
   ThreadLocalPtr* thread_local_io_urings_;
+  // Process-wide unique id, identifying the file in registered file tables
+  uint64_t file_id_;
+  // Whether rings may register the file, i.e. file_id_ is in the set of open
+  // file ids
+  bool fixed_file_tracked_;
+
+  // Returns the calling thread's io_uring, creating it if needed, or nullptr
+  // if io_uring is not available.
+  PosixIOUring* GetIOUring();
+
+  // Switch `sqe`, already prepared to read fd_, to the registered file
+  // table if the file is (or can be) registered with `iu`.
+  void PrepareFixedFile(PosixIOUring* iu, struct io_uring_sqe* sqe);
 #endif
 
  public:
@@ -676,6 +676,19 @@ struct AdvancedColumnFamilyOptions {
   // Default: true
   bool level_compaction_dynamic_file_size = true;
 
+  // If true, an automatic compaction moves input files whose key range no
+  // other input file overlaps to the output level as they are, like a
+  // trivial move, instead of reading and rewriting them. Output files are cut
+  // so that they do not overlap the moved files. This can save most of the
+  // CPU and I/O of compacting append-mostly key ranges, where many input
+  // files are disjoint, at the cost of keeping obsolete versions inside the
+  // moved files. Files are not moved if a compaction filter is configured,
+  // for manual compactions, when the compression of their level differs from
+  // the output's, or when another input file has range deletions.
+  //
+  // Default: false
+  bool compaction_move_non_overlapping_files = false;
+
   // Default: 10.
   //
   // Dynamically changeable through SetOptions() API
@@ -14,6 +14,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "rocksdb/compression_type.h"
 #include "rocksdb/data_structure.h"
@@ -23,7 +24,9 @@ namespace ROCKSDB_NAMESPACE {
 
 class Cache;  // defined in advanced_cache.h
 struct ConfigOptions;
+class FileSystem;
 class SecondaryCache;
+class Status;
 
 // Classifications of block cache entries.
 //
@@ -253,6 +256,11 @@ struct CompressedSecondaryCacheOptions : LRUCacheOptions {
   // (Filter blocks are essentially non-compressible but others usually are.)
   CacheEntryRoleSet do_not_compress_roles = {CacheEntryRole::kFilterBlock};
 
+  // Number of background threads that help decompress a batch of
+  // asynchronous lookups (as issued by MultiGet) in parallel with the thread
+  // waiting on them. 0 means all decompression happens on the waiting thread.
+  int num_decompression_threads = 0;
+
   CompressedSecondaryCacheOptions() {}
   CompressedSecondaryCacheOptions(
       size_t _capacity, int _num_shard_bits, bool _strict_capacity_limit,
@@ -311,6 +319,117 @@ inline std::shared_ptr<SecondaryCache> NewCompressedSecondaryCache(
   return opts.MakeSharedSecondaryCache();
 }
 
+// EXPERIMENTAL
+// Options structure for configuring a SecondaryCache instance backed by
+// log-structured files on a local (typically NVMe) device. Entries are
+// appended to fixed-size segment files and located through an in-memory
+// index, so the cache contents do not survive a restart: any segment files
+// left in `dir` from a previous instance are deleted on open.
+struct FileSecondaryCacheOptions {
+  // Directory holding the segment files. Must be set, and should not be
+  // shared with anything else.
+  std::string dir;
+
+  // Maximum number of bytes kept on disk, including space held by erased or
+  // overwritten records that has not been reclaimed yet.
+  size_t capacity = size_t{1} << 30;
+
+  // Size at which the active segment file is closed and a new one started.
+  // Space is reclaimed a whole segment at a time, so smaller segments give
+  // finer-grained eviction at the cost of more files.
+  size_t segment_size = size_t{64} << 20;
+
+  // Number of background threads serving asynchronous lookups (Lookup with
+  // wait=false) and the space reclaim job.
+  int num_threads = 2;
+
+  // The file system used for the segment files. nullptr means
+  // FileSystem::Default().
+  std::shared_ptr<FileSystem> fs;
+};
+
+// Create a SecondaryCache backed by files in `opts.dir`. Fails if the
+// directory cannot be created or cleaned up.
+Status NewFileSecondaryCache(const FileSecondaryCacheOptions& opts,
+                             std::shared_ptr<SecondaryCache>* result);
+
+// EXPERIMENTAL
+// Counters kept by a tiered secondary cache (see TieredSecondaryCacheOptions),
+// broken down by tier and by CacheEntryRole. Tiers are numbered in the order
+// they were configured, starting from 0. Hits in the primary cache itself
+// are already reported per role through the BLOCK_CACHE_*_HIT tickers. All
+// functions are thread-safe; counters read as zero until the object has been
+// passed to NewTieredSecondaryCache().
+class TieredSecondaryCacheStats {
+ public:
+  TieredSecondaryCacheStats();
+  ~TieredSecondaryCacheStats();
+
+  // Number of entries stored in `tier` on eviction from the primary cache
+  uint64_t GetAdmissions(size_t tier, CacheEntryRole role) const;
+  // Number of lookups served by `tier`
+  uint64_t GetHits(size_t tier, CacheEntryRole role) const;
+  // Number of evicted entries not admitted to any tier
+  uint64_t GetRejections(CacheEntryRole role) const;
+  // Number of lookups not found in any tier
+  uint64_t GetMisses(CacheEntryRole role) const;
+
+  void Reset();
+
+  // Human-readable dump of the non-zero counters
+  std::string ToString() const;
+
+ private:
+  friend class TieredSecondaryCache;
+  struct Counters;
+  std::unique_ptr<Counters> counters_;
+};
+
+// EXPERIMENTAL
+// Options for a SecondaryCache that spreads evicted entries over several
+// other secondary caches ("tiers"), such as a CompressedSecondaryCache in
+// memory followed by a FileSecondaryCache on local flash.
+//
+// Instead of spilling every evicted entry into the secondary cache, the
+// tiered cache remembers how many times each key has been evicted from the
+// primary cache and admits an entry to the deepest tier it qualifies for.
+// An entry lives in at most one tier. A lookup tries the tiers in order and
+// passes the primary cache's erase advice on to the tier holding the entry;
+// whether the entry was kept is reported by that tier. An entry given up by
+// its tier counts as another eviction when it next leaves the primary cache,
+// while a kept entry is not spilled again.
+struct TieredSecondaryCacheOptions {
+  struct Tier {
+    std::shared_ptr<SecondaryCache> cache;
+    // Entries are admitted to this tier once they have been evicted from the
+    // primary cache at least this many times.
+    uint32_t min_evictions = 1;
+    // Only entries with these roles are admitted to this tier. Entries of
+    // other roles fall back to the next shallower tier that accepts them,
+    // which allows e.g. keeping filter and index blocks in memory while data
+    // blocks go to flash.
+    CacheEntryRoleSet roles = CacheEntryRoleSet::All();
+  };
+
+  // Ordered from the fastest (looked up first) to the slowest. The typical
+  // setup admits to a compressed tier on the second eviction and to a flash
+  // tier on the third:
+  //   {{compressed_sec_cache, 2}, {file_sec_cache, 3}}
+  std::vector<Tier> tiers;
+
+  // Approximate number of keys whose eviction count is remembered. Keys
+  // evicted less recently than that start over at zero.
+  size_t eviction_history_size = size_t{1} << 20;
+
+  // Optional. Receives per-tier, per-role counters.
+  std::shared_ptr<TieredSecondaryCacheStats> stats;
+};
+
+// Create a tiered SecondaryCache. Fails if no tiers are configured, or if
+// the tiers' min_evictions are not non-decreasing.
+Status NewTieredSecondaryCache(const TieredSecondaryCacheOptions& opts,
+                               std::shared_ptr<SecondaryCache>* result);
+
 // HyperClockCache - A lock-free Cache alternative for RocksDB block cache
 // that offers much improved CPU efficiency vs. LRUCache under high parallel
 // load or high contention, with some caveats:
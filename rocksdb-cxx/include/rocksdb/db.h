@@ -167,6 +167,25 @@ struct DBResult {
 
 DBResult DB_Open(const Options& options, const std::string& name);
 
+// Iterators over consecutive, disjoint parts of a key range, created by
+// DB::NewParallelScan(). They all read the same snapshot, and each one can be
+// used from a different thread. Must be destroyed before the DB.
+class ParallelScan {
+ public:
+  virtual ~ParallelScan() {}
+
+  // The number of parts, at least 1.
+  virtual size_t NumPartitions() const = 0;
+
+  // The bounds of part i, which are also its iterator's iterate_lower_bound
+  // and iterate_upper_bound. nullptr where the range is unbounded.
+  virtual const Slice* LowerBound(size_t i) const = 0;
+  virtual const Slice* UpperBound(size_t i) const = 0;
+
+  // The iterator over part i, not yet positioned. Owned by this object.
+  virtual Iterator* GetIterator(size_t i) = 0;
+};
+
 // A DB is a persistent, versioned ordered map from keys to values.
 // A DB is safe for concurrent access from multiple threads without
 // any external synchronization.
@@ -935,6 +954,21 @@ class DB {
       const std::vector<ColumnFamilyHandle*>& column_families,
       std::vector<Iterator*>* iterators) = 0;
 
+  // EXPERIMENTAL
+  // Splits the range [options.iterate_lower_bound, options.iterate_upper_bound)
+  // of `column_family` (unbounded where they are nullptr) into at most
+  // `num_partitions` consecutive parts holding about the same amount of data,
+  // and returns an iterator over each in `*scan`. The split is estimated from
+  // the SST files' index blocks; data still in memtables is not weighed. All
+  // iterators read options.snapshot, or else a snapshot taken here and held
+  // by `*scan`. Tailing iterators are not supported.
+  virtual Status NewParallelScan(const ReadOptions& /*options*/,
+                                 ColumnFamilyHandle* /*column_family*/,
+                                 size_t /*num_partitions*/,
+                                 std::unique_ptr<ParallelScan>* /*scan*/) {
+    return Status::NotSupported("NewParallelScan() is not supported");
+  }
+
   // Return a handle to the current DB state.  Iterators created with
   // this handle will all observe a stable snapshot of the current DB
   // state.  The caller must call ReleaseSnapshot(result) when the
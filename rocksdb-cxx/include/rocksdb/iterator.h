@@ -19,6 +19,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "rocksdb/cleanable.h"
 #include "rocksdb/slice.h"
@@ -27,6 +28,53 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+// Entries returned by Iterator::NextBatch(). Keys and values are copied into
+// two contiguous buffers, so they stay valid after the iterator moves, until
+// the batch is cleared or reused. Reusing a batch reuses its memory.
+class IteratorBatch {
+ public:
+  size_t size() const { return key_ends_.size(); }
+  bool empty() const { return key_ends_.empty(); }
+
+  // REQUIRES: i < size()
+  Slice key(size_t i) const {
+    const size_t begin = i == 0 ? 0 : key_ends_[i - 1];
+    return Slice(keys_.data() + begin, key_ends_[i] - begin);
+  }
+  // REQUIRES: i < size()
+  Slice value(size_t i) const {
+    const size_t begin = i == 0 ? 0 : value_ends_[i - 1];
+    return Slice(values_.data() + begin, value_ends_[i] - begin);
+  }
+
+  // All keys and all values, back to back. Entry i ends at key_ends()[i] and
+  // value_ends()[i].
+  const std::string& keys() const { return keys_; }
+  const std::string& values() const { return values_; }
+  const std::vector<size_t>& key_ends() const { return key_ends_; }
+  const std::vector<size_t>& value_ends() const { return value_ends_; }
+
+  void Add(const Slice& key, const Slice& value) {
+    keys_.append(key.data(), key.size());
+    key_ends_.push_back(keys_.size());
+    values_.append(value.data(), value.size());
+    value_ends_.push_back(values_.size());
+  }
+
+  void Clear() {
+    keys_.clear();
+    values_.clear();
+    key_ends_.clear();
+    value_ends_.clear();
+  }
+
+ private:
+  std::string keys_;
+  std::string values_;
+  std::vector<size_t> key_ends_;
+  std::vector<size_t> value_ends_;
+};
+
 class Iterator : public Cleanable {
  public:
   Iterator() {}
@@ -74,6 +122,16 @@ class Iterator : public Cleanable {
   // REQUIRES: Valid()
   virtual void Prev() = 0;
 
+  // Replaces the contents of `batch` with up to `max_entries` entries,
+  // starting with the current one, and moves past them. Afterwards the
+  // iterator is positioned at the entry following the last one returned, or
+  // is not Valid() if there are none left. Returns no entries if the iterator
+  // is not Valid(). Returns status().
+  // Same as calling key(), value() and Next() for each entry, which is what
+  // the default implementation does, but the DB iterator does it without the
+  // per-entry virtual calls. Wide-column entities are returned as value() is.
+  virtual Status NextBatch(size_t max_entries, IteratorBatch* batch);
+
   // Return the key for the current entry.  The underlying storage for
   // the returned slice is valid only until the next modification of the
   // iterator (i.e. the next SeekToFirst/SeekToLast/Seek/SeekForPrev/Next/Prev
@@ -1619,6 +1619,19 @@ struct ReadOptions {
   // Default: empty (every table will be scanned)
   std::function<bool(const TableProperties&)> table_filter;
 
+  // EXPERIMENTAL
+  // A predicate pushed down into iterators. Keys for which it returns false
+  // are skipped inside the iterator, as if they were deleted, instead of
+  // being returned to the caller. It is called with the user key and the
+  // value (as returned by Iterator::value()) of the newest version of each key
+  // visible to the iterator, i.e. after snapshots, deletions and merges are
+  // resolved, so skipping a key never exposes an older version. Plain values
+  // are passed in place, without being copied out of their block. It must be
+  // cheap, must not use the iterator, and is not applied when iter_start_ts
+  // is set. Only affects iterators.
+  // Default: empty (no key is skipped)
+  std::function<bool(const Slice& key, const Slice& value)> scan_filter;
+
   // Timestamp of operation. Read should return the latest data visible to the
   // specified timestamp. All timestamps of the same database must be of the
   // same length and format. The user is responsible for providing a customized
@@ -1690,7 +1703,10 @@ struct ReadOptions {
   //
   // If async_io is enabled, RocksDB will prefetch some of data asynchronously.
   // RocksDB apply it if reads are sequential and its internal automatic
-  // prefetching.
+  // prefetching. Forward scans also open the next SST file of each level,
+  // and read its first data block, before reaching it. This runs on the
+  // Env's USER thread pool, which is shared by all iterators and gets at
+  // least one thread (see Env::SetBackgroundThreads()).
   //
   // Default: false
   bool async_io;
@@ -1706,6 +1722,34 @@ struct ReadOptions {
   // Default: true
   bool optimize_multiget_for_io;
 
+  // Experimental
+  //
+  // If greater than 1, Get() reads the older L0 files that may contain the
+  // key in the background, on up to this many - 1 threads of the Env's USER
+  // thread pool (grown to that many threads if needed), while it reads the
+  // newest one itself. It then looks the key up newest file first as usual,
+  // finding their blocks in the block cache. Once a file is known to answer
+  // the key, older files are no longer read. With many L0 files, this
+  // bounds the latency of Get() to about one read instead of one per L0
+  // file. Only applies with fill_cache and without a row cache.
+  //
+  // Default: 0
+  size_t concurrent_l0_probes;
+
+  // Experimental
+  //
+  // If true, iterators return an empty value() for every key, and columns()
+  // with just an empty default column, skipping the work of getting the
+  // values: values are not read from blob files, merge operands are not
+  // merged, and data blocks with separated values (see
+  // BlockBasedTableOptions::data_block_separate_values) are read without
+  // decompressing their values. Useful for existence checks and key-only
+  // scans. A scan_filter is also passed the empty values. Get() and
+  // MultiGet() ignore this option.
+  //
+  // Default: false
+  bool key_only;
+
   Env::IOActivity io_activity;
 
   ReadOptions();
@@ -148,6 +148,10 @@ struct PerfContextBase {
   // after or before a range of keys covered by a range deletion in a newer LSM
   // component.
   uint64_t internal_range_del_reseek_count;
+  // How many keys iterators skipped because ReadOptions::scan_filter rejected
+  // their newest visible version.
+  //
+  uint64_t internal_scan_filter_skipped_count;
 
   uint64_t get_snapshot_time;        // total nanos spent on getting snapshot
   uint64_t get_from_memtable_time;   // total nanos spent on querying memtables
@@ -81,6 +81,16 @@ class SecondaryCache : public Customizable {
   virtual Status Insert(const Slice& key, Cache::ObjectPtr obj,
                         const Cache::CacheItemHelper* helper) = 0;
 
+  // Like Insert(), but for when the caller has already decided that the
+  // entry should be admitted, so the cache should skip any admission policy
+  // of its own (such as CompressedSecondaryCache only storing an entry on its
+  // second insertion). Used when composing several secondary caches under
+  // one admission policy. The default implementation is Insert().
+  virtual Status InsertAdmitted(const Slice& key, Cache::ObjectPtr obj,
+                                const Cache::CacheItemHelper* helper) {
+    return Insert(key, obj, helper);
+  }
+
   // Insert a value from its saved/persistable data (typically uncompressed
   // block), as if generated by SaveToCallback/SizeCallback. This can be used
   // in "warming up" the cache from some auxiliary source, and like Insert()
@@ -466,6 +466,12 @@ enum Tickers : uint32_t {
   // compressed SST blocks from storage.
   BYTES_DECOMPRESSED_TO,
 
+  // Number of times a table iterator checked the range filter
+  // (BlockBasedTableOptions::range_filter_bits_per_key) for a seek.
+  RANGE_FILTER_CHECKED,
+  // Number of times the range filter let a table iterator skip a seek.
+  RANGE_FILTER_USEFUL,
+
   TICKER_ENUM_MAX
 };
 
@@ -196,6 +196,22 @@ struct BlockBasedTableOptions {
   // freed. This is not limited to l0 in LSM tree.
   bool pin_top_level_index_and_filter = true;
 
+  // If true, when a version of the LSM tree is installed, the whole key
+  // filters of the new files whose table readers are kept open with the file
+  // metadata (all files with max_open_files = -1) are copied into memory
+  // next to the file metadata. Point lookups in levels other than L0 then
+  // check that copy before looking up the file in the table cache and its
+  // filter in the block cache, so a level that does not have the key costs one
+  // in-memory filter probe. With partitioned filters, each partition is
+  // copied along with its key range.
+  //
+  // The copies are in addition to any filter blocks in the block cache and
+  // are not charged to it. Only applies to files with whole_key_filtering,
+  // without range deletions and without user-defined timestamps.
+  //
+  // Default: false
+  bool pin_filters_in_file_metadata = false;
+
   // The desired block cache pinning behavior for the different categories of
   // metadata blocks. While pinning can reduce block cache contention, users
   // must take care not to pin excessive amounts of data, which risks
@@ -229,10 +245,29 @@ struct BlockBasedTableOptions {
     // Makes the index significantly bigger (2x or more), especially when keys
     // are long.
     kBinarySearchWithFirstKey = 0x03,
+
+    // Like kBinarySearch, plus a piecewise linear model (in the spirit of the
+    // PGM-index) that predicts where a key falls among the index block's
+    // restart points, within `learned_index_max_error`. Index seeks then
+    // only binary search the predicted window, which takes fewer key
+    // comparisons and cache misses than searching all restart points. Keys
+    // are modeled by their first 8 bytes, so this works best with the
+    // bytewise comparator and integer-like keys that are spread evenly. With
+    // other comparators it behaves like kBinarySearch.
+    // The model is stored in addition to the regular index block, which
+    // still holds the separators and block handles that seeks return, so
+    // this makes tables slightly bigger rather than smaller.
+    // Tables using it cannot be read by RocksDB versions without it.
+    kLearnedIndexSearch = 0x04,
   };
 
   IndexType index_type = kBinarySearch;
 
+  // The maximum error, in restart points, of the model built for
+  // kLearnedIndexSearch. Smaller values make index seeks compare fewer keys
+  // but need more model segments (20 bytes each).
+  uint32_t learned_index_max_error = 8;
+
   // The index type that will be used for the data block.
   enum DataBlockIndexType : char {
     kDataBlockBinarySearch = 0,   // traditional block type
@@ -245,6 +280,64 @@ struct BlockBasedTableOptions {
   // kDataBlockBinaryAndHash.
   double data_block_hash_table_util_ratio = 0.75;
 
+  // If true, data blocks of at most 64KiB also store the first 8 bytes of
+  // each restart key in a fixed-width array. Seeks within the block then
+  // locate the restart interval by comparing the target against that array
+  // (with SIMD where available) and only decode and compare restart keys
+  // sharing the target's 8-byte prefix, instead of binary searching over
+  // decoded restart keys. This costs 8 bytes per restart point.
+  //
+  // Only takes effect with the bytewise comparator without timestamps.
+  // Blocks written with this option cannot be read by RocksDB versions that
+  // don't support it.
+  bool data_block_restart_key_prefixes = false;
+
+  // If true, each data block stores the keys and the values of its entries
+  // in two sections that are compressed separately, and the values section
+  // is only decompressed when a value is read. Iterators with
+  // ReadOptions::key_only then never decompress values, which makes
+  // existence checks and key-only scans over tables with large values much
+  // cheaper, and each section usually compresses better on its own.
+  //
+  // The compression dictionary and adaptive_compression do not apply to
+  // such data blocks. Tables written with this option have format_version 6
+  // or later, and cannot be read by RocksDB versions that don't support it.
+  bool data_block_separate_values = false;
+
+  // If non-zero, the entries of each data block are cut into mini-blocks of
+  // this many restart intervals, which are compressed separately, with an
+  // index of the first key of each mini-block at the end of the block.
+  // Point lookups and seeks then only decompress the mini-block holding
+  // their key, and scans decompress the following mini-blocks as they reach
+  // them. This allows larger data blocks, which make for a smaller index and
+  // often better compression, without more decompression per point lookup.
+  //
+  // Does not apply together with data_block_separate_values. The compression
+  // dictionary and adaptive_compression do not apply to such data blocks.
+  // With block_protection_bytes_per_key, all mini-blocks are decompressed as
+  // soon as a block is read. Tables written with this option have
+  // format_version 6 or later, and cannot be read by RocksDB versions that
+  // don't support it.
+  uint32_t data_block_mini_block_restarts = 0;
+
+  // If true, the user keys of data blocks are assumed to end with an 8-byte
+  // big-endian integer, such as a timestamp, and the entries of each data
+  // block are stored in runs of consecutive keys that only differ in that
+  // integer. A run stores its first key whole, then the deltas of deltas
+  // of the integers, bit-packed with the width of the largest one, so that
+  // keys at regular intervals take no space beyond their sequence numbers.
+  // Readers decode data blocks back into the regular format when they read
+  // them from the file, so that blocks in the block cache are searched and
+  // scanned as usual. Keys that do not fit are stored whole, which makes it
+  // safe to use with any key.
+  //
+  // Does not apply together with data_block_separate_values,
+  // data_block_mini_block_restarts or use_delta_encoding=false. block_size
+  // applies to the data blocks before they are encoded. Tables written with
+  // this option have format_version 6 or later, and cannot be read by RocksDB
+  // versions that don't support it.
+  bool data_block_delta_of_delta_keys = false;
+
   // Option hash_index_allow_collision is now deleted.
   // It will behave as if hash_index_allow_collision=true.
 
@@ -395,6 +488,21 @@ struct BlockBasedTableOptions {
   // block cache even when cache_index_and_filter_blocks=false.
   bool partition_filters = false;
 
+  // With partition_filters, the number of filter partitions each table
+  // builder may hand to the Env's USER thread pool to be finished while it
+  // keeps adding keys to the next partition. The pool is grown to at least
+  // this many threads and is shared by all table builders. This is mostly
+  // useful with Ribbon filters, whose construction (banding and back
+  // substitution) is much more CPU-intensive than hashing the keys. Peak
+  // memory for filter construction is bounded by holding the hashes of at
+  // most this many finished partitions (plus the one being built), and is
+  // charged to the block cache until the table is finished, like any other
+  // filter construction if so configured in cache_usage_options. Filters are
+  // the same as built without threads.
+  //
+  // Default: 0 (finish each partition in the table builder's thread)
+  int filter_construction_threads = 0;
+
   // Option to generate Bloom/Ribbon filters that minimize memory
   // internal fragmentation.
   //
@@ -445,6 +553,22 @@ struct BlockBasedTableOptions {
   // This must generally be true for gets to be efficient.
   bool whole_key_filtering = true;
 
+  // If positive, each SST file gets a range filter of about this many bits
+  // per distinct key. Like SuRF, a range filter stores truncated keys rather
+  // than hashes, so it can tell that a file has no keys at all in a range of
+  // keys. Iterators with both `ReadOptions::iterate_lower_bound` and
+  // `ReadOptions::iterate_upper_bound` (or a Seek() target and an upper bound)
+  // use it to skip files that overlap the range but have no keys in it,
+  // without reading their index or data blocks. This helps short range scans
+  // over sparse or clustered keys most.
+  //
+  // Only built with the bytewise comparator and no user-defined timestamps.
+  // The filter is kept in memory for as long as the table reader is open.
+  // Older versions ignore it.
+  //
+  // Default: 0 (disabled)
+  double range_filter_bits_per_key = 0;
+
   // If true, detect corruption during Bloom Filter (format_version >= 5)
   // and Ribbon Filter construction.
   //
@@ -464,6 +588,19 @@ struct BlockBasedTableOptions {
   // algorithms.
   bool verify_compression = false;
 
+  // If true, the compression of each data block is chosen from an estimate
+  // of the block's byte entropy and from how well the configured compression
+  // did on recent blocks with similar entropy. Blocks that look already
+  // compressed or encrypted are stored without compression, and blocks that
+  // the configured compression would not shrink enough (see
+  // CompressionOptions::max_compressed_bytes_per_kb) use a faster
+  // compression (LZ4 or Snappy, if available) or none. Each block records its
+  // compression type, so files remain readable by older versions as long as
+  // they support the compression types used.
+  //
+  // Default: false
+  bool adaptive_compression = false;
+
   // If used, For every data block we load into memory, we will create a bitmap
   // of size ((block_size / `read_amp_bytes_per_bit`) / 8) bytes. This bitmap
   // will be used to figure out the percentage we actually read of the blocks.
@@ -512,6 +649,11 @@ struct BlockBasedTableOptions {
   // 5 -- Can be read by RocksDB's versions since 6.6.0. Full and partitioned
   // filters use a generally faster and more accurate Bloom filter
   // implementation, with a different schema.
+  // 6 -- Allows data blocks with separated values, mini-blocks or
+  // delta-of-delta encoded keys. It is written instead of an older version
+  // for tables with data_block_separate_values,
+  // data_block_mini_block_restarts or data_block_delta_of_delta_keys, so that
+  // RocksDB versions that cannot read such data blocks refuse the tables.
   uint32_t format_version = 5;
 
   // Store index blocks on disk in compressed format. Changing this option to
@@ -665,6 +807,12 @@ struct BlockBasedTablePropertyNames {
   static const std::string kWholeKeyFiltering;
   // value is "1" for true and "0" for false.
   static const std::string kPrefixFiltering;
+  // value is "1" for true and "0" for false.
+  static const std::string kDataBlockSeparateValues;
+  // value is "1" for true and "0" for false.
+  static const std::string kDataBlockMiniBlocks;
+  // value is "1" for true and "0" for false.
+  static const std::string kDataBlockDeltaOfDeltaKeys;
 };
 
 // Create default block based table factory.
@@ -827,6 +975,43 @@ struct CuckooTableOptions {
 extern TableFactory* NewCuckooTableFactory(
     const CuckooTableOptions& table_options = CuckooTableOptions());
 
+struct FixedWidthTablePropertyNames {
+  // Fixed length of value.
+  static const std::string kValueSize;
+  // Number of records in each group, but the last one.
+  static const std::string kRecordsPerGroup;
+};
+
+struct FixedWidthTableOptions {
+  static const char* kName() { return "FixedWidthTableOptions"; };
+
+  // The size of every user key (including the timestamp, if any). Must be
+  // set: writes of a key of any other size fail with InvalidArgument.
+  uint32_t key_size = 0;
+  // The size of every value of a Put or Merge. Writes of such a value of any
+  // other size fail with InvalidArgument. Deletions have no value. The merge
+  // operator must also produce values of this size, or flushes and
+  // compactions of its results fail.
+  uint32_t value_size = 0;
+  // The records of a table are stored in groups of this many records, with
+  // the keys, the sequence numbers and types, and the values of a group each
+  // packed in an array of its own. An iterator reads one group at a time, and
+  // a group is the unit of checksums. The index holds the first key of each
+  // group.
+  uint32_t records_per_group = 128;
+};
+
+// Table Factory for an SST table format for fixed-size keys and values.
+// Records are stored without any per-record header, so that the position of
+// any record in the file is computed from its index. Unlike the plain and
+// cuckoo tables, this format supports deletions, range deletions, merges and
+// several versions of a key (and thus snapshots and any compaction style), and
+// reads with or without mmap. Seeks binary search the
+// index, and use interpolation search on it when the keys are ordered by the
+// bytewise comparator, before binary searching the records of one group.
+extern TableFactory* NewFixedWidthTableFactory(
+    const FixedWidthTableOptions& table_options = FixedWidthTableOptions());
+
 
 class RandomAccessFileReader;
 
@@ -839,6 +1024,7 @@ class TableFactory : public Customizable {
   static const char* kBlockBasedTableName() { return "BlockBasedTable"; };
   static const char* kPlainTableName() { return "PlainTable"; }
   static const char* kCuckooTableName() { return "CuckooTable"; };
+  static const char* kFixedWidthTableName() { return "FixedWidthTable"; };
 
   // Creates and configures a new TableFactory from the input options and id.
   static Status CreateFromString(const ConfigOptions& config_options,
@@ -255,6 +255,13 @@ class StackableDB : public DB {
     return db_->NewIterators(options, column_families, iterators);
   }
 
+  virtual Status NewParallelScan(const ReadOptions& options,
+                                 ColumnFamilyHandle* column_family,
+                                 size_t num_partitions,
+                                 std::unique_ptr<ParallelScan>* scan) override {
+    return db_->NewParallelScan(options, column_family, num_partitions, scan);
+  }
+
   virtual const Snapshot* GetSnapshot() override { return db_->GetSnapshot(); }
 
   virtual void ReleaseSnapshot(const Snapshot* snapshot) override {
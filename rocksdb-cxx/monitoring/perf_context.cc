@@ -84,6 +84,7 @@ struct PerfContextByLevelInt {
   defCmd(internal_merge_count)                     \
   defCmd(internal_merge_point_lookup_count)        \
   defCmd(internal_range_del_reseek_count)          \
+  defCmd(internal_scan_filter_skipped_count)       \
   defCmd(get_snapshot_time)                        \
   defCmd(get_from_memtable_time)                   \
   defCmd(get_from_memtable_count)                  \
@@ -232,6 +232,8 @@ const std::vector<std::pair<Tickers, std::string>> TickersNameMap = {
      "rocksdb.number.block_compression_rejected"},
     {BYTES_DECOMPRESSED_FROM, "rocksdb.bytes.decompressed.from"},
     {BYTES_DECOMPRESSED_TO, "rocksdb.bytes.decompressed.to"},
+    {RANGE_FILTER_CHECKED, "rocksdb.range.filter.checked"},
+    {RANGE_FILTER_USEFUL, "rocksdb.range.filter.useful"},
 };
 
 const std::vector<std::pair<Histograms, std::string>> HistogramsNameMap = {
@@ -568,6 +568,11 @@ static std::unordered_map<std::string, OptionTypeInfo>
                    level_compaction_dynamic_file_size),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"compaction_move_non_overlapping_files",
+         {offsetof(struct ImmutableCFOptions,
+                   compaction_move_non_overlapping_files),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"optimize_filters_for_hits",
          {offsetof(struct ImmutableCFOptions, optimize_filters_for_hits),
           OptionType::kBoolean, OptionVerificationType::kNormal,
@@ -919,6 +924,8 @@ ImmutableCFOptions::ImmutableCFOptions(const ColumnFamilyOptions& cf_options)
           cf_options.level_compaction_dynamic_level_bytes),
       level_compaction_dynamic_file_size(
           cf_options.level_compaction_dynamic_file_size),
+      compaction_move_non_overlapping_files(
+          cf_options.compaction_move_non_overlapping_files),
       num_levels(cf_options.num_levels),
       optimize_filters_for_hits(cf_options.optimize_filters_for_hits),
       force_consistency_checks(cf_options.force_consistency_checks),
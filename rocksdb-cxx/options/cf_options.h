@@ -66,6 +66,8 @@ struct ImmutableCFOptions {
 
   bool level_compaction_dynamic_file_size;
 
+  bool compaction_move_non_overlapping_files;
+
   int num_levels;
 
   bool optimize_filters_for_hits;
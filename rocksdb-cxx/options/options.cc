@@ -67,6 +67,8 @@ AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions(const Options& options)
       target_file_size_multiplier(options.target_file_size_multiplier),
       level_compaction_dynamic_level_bytes(
           options.level_compaction_dynamic_level_bytes),
+      compaction_move_non_overlapping_files(
+          options.compaction_move_non_overlapping_files),
       max_bytes_for_level_multiplier(options.max_bytes_for_level_multiplier),
       max_bytes_for_level_multiplier_additional(
           options.max_bytes_for_level_multiplier_additional),
@@ -274,6 +276,8 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
         max_bytes_for_level_base);
     ROCKS_LOG_HEADER(log, "Options.level_compaction_dynamic_level_bytes: %d",
                      level_compaction_dynamic_level_bytes);
+    ROCKS_LOG_HEADER(log, "Options.compaction_move_non_overlapping_files: %d",
+                     compaction_move_non_overlapping_files);
     ROCKS_LOG_HEADER(log, "         Options.max_bytes_for_level_multiplier: %f",
                      max_bytes_for_level_multiplier);
     for (size_t i = 0; i < max_bytes_for_level_multiplier_additional.size();
@@ -712,6 +716,8 @@ ReadOptions::ReadOptions()
       adaptive_readahead(false),
       async_io(false),
       optimize_multiget_for_io(true),
+      concurrent_l0_probes(0),
+      key_only(false),
       io_activity(Env::IOActivity::kUnknown) {}
 
 ReadOptions::ReadOptions(bool cksum, bool cache)
@@ -739,6 +745,8 @@ ReadOptions::ReadOptions(bool cksum, bool cache)
       adaptive_readahead(false),
       async_io(false),
       optimize_multiget_for_io(true),
+      concurrent_l0_probes(0),
+      key_only(false),
       io_activity(Env::IOActivity::kUnknown) {}
 
 ReadOptions::ReadOptions(Env::IOActivity _io_activity)
@@ -766,6 +774,8 @@ ReadOptions::ReadOptions(Env::IOActivity _io_activity)
       adaptive_readahead(false),
       async_io(false),
       optimize_multiget_for_io(true),
+      concurrent_l0_probes(0),
+      key_only(false),
       io_activity(_io_activity) {}
 
 }  // namespace ROCKSDB_NAMESPACE
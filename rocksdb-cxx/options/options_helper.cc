@@ -297,6 +297,8 @@ void UpdateColumnFamilyOptions(const ImmutableCFOptions& ioptions,
       ioptions.level_compaction_dynamic_level_bytes;
   cf_opts->level_compaction_dynamic_file_size =
       ioptions.level_compaction_dynamic_file_size;
+  cf_opts->compaction_move_non_overlapping_files =
+      ioptions.compaction_move_non_overlapping_files;
   cf_opts->num_levels = ioptions.num_levels;
   cf_opts->optimize_filters_for_hits = ioptions.optimize_filters_for_hits;
   cf_opts->force_consistency_checks = ioptions.force_consistency_checks;
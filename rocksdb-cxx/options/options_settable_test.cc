@@ -181,21 +181,30 @@ TEST_F(OptionsSettableTest, BlockBasedTableOptionsAllFieldsSettable) {
       "unpartitioned_pinning=kFlushedAndSimilar;};"
       "pin_l0_filter_and_index_blocks_in_cache=1;"
       "pin_top_level_index_and_filter=1;"
+      "pin_filters_in_file_metadata=1;"
       "index_type=kHashSearch;"
+      "learned_index_max_error=8;"
       "data_block_index_type=kDataBlockBinaryAndHash;"
       "index_shortening=kNoShortening;"
       "data_block_hash_table_util_ratio=0.75;"
+      "data_block_restart_key_prefixes=false;"
+      "data_block_separate_values=false;"
+      "data_block_mini_block_restarts=0;"
+      "data_block_delta_of_delta_keys=false;"
       "checksum=kxxHash;no_block_cache=1;"
       "block_cache=1M;block_cache_compressed=1k;block_size=1024;"
       "block_size_deviation=8;block_restart_interval=4; "
       "metadata_block_size=1024;"
       "partition_filters=false;"
+      "filter_construction_threads=0;"
       "optimize_filters_for_memory=true;"
       "index_block_restart_interval=4;"
-      "filter_policy=bloomfilter:4:true;whole_key_filtering=1;detect_filter_"
+      "filter_policy=bloomfilter:4:true;whole_key_filtering=1;"
+      "range_filter_bits_per_key=0;detect_filter_"
       "construct_corruption=false;"
       "format_version=1;"
-      "verify_compression=true;read_amp_bytes_per_bit=0;"
+      "verify_compression=true;adaptive_compression=true;"
+      "read_amp_bytes_per_bit=0;"
       "enable_index_compression=false;"
       "block_align=true;"
       "max_auto_readahead_size=0;"
@@ -525,6 +534,7 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       "optimize_filters_for_hits=false;"
       "level_compaction_dynamic_level_bytes=false;"
       "level_compaction_dynamic_file_size=true;"
+      "compaction_move_non_overlapping_files=true;"
       "inplace_update_support=false;"
       "compaction_style=kCompactionStyleFIFO;"
       "compaction_pri=kMinOverlappingRatio;"
@@ -9,9 +9,11 @@ LIB_SOURCES =                                                   \
   cache/clock_cache.cc                                          \
   cache/lru_cache.cc                                            \
   cache/compressed_secondary_cache.cc                           \
+  cache/file_secondary_cache.cc                                 \
   cache/secondary_cache.cc                                      \
   cache/secondary_cache_adapter.cc                              \
   cache/sharded_cache.cc                                        \
+  cache/tiered_secondary_cache.cc                               \
   db/arena_wrapped_db_iter.cc                                   \
   db/blob/blob_contents.cc                                      \
   db/blob/blob_fetcher.cc                                       \
@@ -178,6 +180,7 @@ LIB_SOURCES =                                                   \
   table/block_based/block_prefetcher.cc                         \
   table/block_based/block_prefix_index.cc                       \
   table/block_based/data_block_hash_index.cc                    \
+  table/block_based/delta_of_delta_keys.cc                      \
   table/block_based/data_block_footer.cc                        \
   table/block_based/filter_block_reader_common.cc               \
   table/block_based/filter_policy.cc                            \
@@ -186,16 +189,24 @@ LIB_SOURCES =                                                   \
   table/block_based/hash_index_reader.cc                        \
   table/block_based/index_builder.cc                            \
   table/block_based/index_reader_common.cc                      \
+  table/block_based/learned_index.cc                            \
+  table/block_based/mini_blocks.cc                              \
+  table/block_based/learned_index_reader.cc                     \
   table/block_based/parsed_full_filter_block.cc                 \
   table/block_based/partitioned_filter_block.cc                 \
   table/block_based/partitioned_index_iterator.cc               \
   table/block_based/partitioned_index_reader.cc                 \
+  table/block_based/range_filter.cc                             \
   table/block_based/reader_common.cc                            \
+  table/block_based/separated_values.cc                         \
   table/block_based/uncompression_dict_reader.cc                \
   table/block_fetcher.cc                                        \
   table/cuckoo/cuckoo_table_builder.cc                          \
   table/cuckoo/cuckoo_table_factory.cc                          \
   table/cuckoo/cuckoo_table_reader.cc                           \
+  table/fixed_width/fixed_width_table_builder.cc                \
+  table/fixed_width/fixed_width_table_factory.cc                \
+  table/fixed_width/fixed_width_table_reader.cc                 \
   table/format.cc                                               \
   table/get_context.cc                                          \
   table/iterator.cc                                             \
@@ -430,6 +441,8 @@ TEST_MAIN_SOURCES =                                                     \
   cache/cache_reservation_manager_test.cc                               \
   cache/lru_cache_test.cc                                               \
   cache/compressed_secondary_cache_test.cc                              \
+  cache/file_secondary_cache_test.cc                                    \
+  cache/tiered_secondary_cache_test.cc                                  \
   db/blob/blob_counting_iterator_test.cc                                \
   db/blob/blob_file_addition_test.cc                                    \
   db/blob/blob_file_builder_test.cc                                     \
@@ -499,6 +512,7 @@ TEST_MAIN_SOURCES =                                                     \
   db/external_sst_file_test.cc                                          \
   db/fault_injection_test.cc                                            \
   db/file_indexer_test.cc                                               \
+  db/fixed_width_table_db_test.cc                                       \
   db/filename_test.cc                                                   \
   db/flush_job_test.cc                                                  \
   db/listener_test.cc                                                   \
@@ -554,7 +568,9 @@ TEST_MAIN_SOURCES =                                                     \
   table/block_based/block_test.cc                                       \
   table/block_based/data_block_hash_index_test.cc                       \
   table/block_based/full_filter_block_test.cc                           \
+  table/block_based/learned_index_test.cc                               \
   table/block_based/partitioned_filter_block_test.cc                    \
+  table/block_based/range_filter_test.cc                                \
   table/cleanable_test.cc                                               \
   table/cuckoo/cuckoo_table_builder_test.cc                             \
   table/cuckoo/cuckoo_table_reader_test.cc                              \
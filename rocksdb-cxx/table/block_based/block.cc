@@ -22,6 +22,11 @@
 #include "rocksdb/comparator.h"
 #include "table/block_based/block_prefix_index.h"
 #include "table/block_based/data_block_footer.h"
+#include "table/block_based/delta_of_delta_keys.h"
+#include "table/block_based/learned_index.h"
+#include "table/block_based/mini_blocks.h"
+#include "table/block_based/restart_key_prefixes.h"
+#include "table/block_based/separated_values.h"
 #include "table/format.h"
 #include "util/coding.h"
 
@@ -142,6 +147,9 @@ void DataBlockIter::NextImpl() {
 #ifndef NDEBUG
   if (TEST_Corrupt_Callback("DataBlockIter::NextImpl")) return;
 #endif
+  if (!DecompressMiniBlockAt(NextEntryOffset())) {
+    return;
+  }
   bool is_shared = false;
   ParseNextDataKey(&is_shared);
   ++cur_entry_idx_;
@@ -256,6 +264,10 @@ void DataBlockIter::PrevImpl() {
     }
     restart_index_--;
   }
+  // The restart interval is within a single mini-block
+  if (!DecompressMiniBlockAt(GetRestartPoint(restart_index_))) {
+    return;
+  }
 
   SeekToRestartPoint(restart_index_);
 
@@ -265,24 +277,96 @@ void DataBlockIter::PrevImpl() {
       break;
     }
     Slice current_key = raw_key_.GetKey();
+    // Separated values are cached as their handles, which value() decodes
+    Slice current_value = values_separated_ ? value_ : value();
 
     if (raw_key_.IsKeyPinned()) {
       // The key is not delta encoded
       prev_entries_.emplace_back(current_, current_key.data(), 0,
-                                 current_key.size(), value());
+                                 current_key.size(), current_value);
     } else {
       // The key is delta encoded, cache decoded key in buffer
       size_t new_key_offset = prev_entries_keys_buff_.size();
       prev_entries_keys_buff_.append(current_key.data(), current_key.size());
 
       prev_entries_.emplace_back(current_, nullptr, new_key_offset,
-                                 current_key.size(), value());
+                                 current_key.size(), current_value);
     }
     // Loop until end of current entry hits the start of original entry
   } while (NextEntryOffset() < original);
   prev_entries_idx_ = static_cast<int32_t>(prev_entries_.size()) - 1;
 }
 
+// Narrows down the restart interval holding `target` using the restart key
+// prefixes, without decoding any key. On return, the restart keys up to
+// `*left` are less than `target` and those after `*right` are greater, as
+// `BinarySeek()` expects. Only restart keys with the same prefix as `target`
+// are left for it to compare.
+void DataBlockIter::SearchRestartKeyPrefixes(const Slice& target,
+                                             int64_t* left, int64_t* right) {
+  assert(restart_key_prefixes_ != nullptr);
+  int64_t prefix = RestartKeyPrefix(ExtractUserKey(target));
+  uint32_t num_below = CountRestartKeyPrefixesBelow(restart_key_prefixes_,
+                                                    num_restarts_, prefix);
+  uint32_t num_not_above = CountRestartKeyPrefixesNotAbove(
+      restart_key_prefixes_, num_restarts_, prefix, num_below);
+  *left = static_cast<int64_t>(num_below) - 1;
+  *right = static_cast<int64_t>(num_not_above) - 1;
+}
+
+// Narrows down the restart interval holding `target` to the restart points
+// of the last mini-block whose first key is not greater than `target` (or the
+// first mini-block), as the restart keys before it are less than its first
+// key and those after it are greater than `target`.
+bool DataBlockIter::SearchMiniBlocks(const Slice& target, int64_t* left,
+                                     int64_t* right) {
+  assert(mini_blocks_ != nullptr);
+  size_t n = mini_blocks_->num_mini_blocks();
+  if (n == 0) {
+    return true;
+  }
+  // Find the first mini-block whose first key is greater than `target`
+  size_t lo = 0;
+  size_t hi = n;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    raw_key_.SetKey(mini_blocks_->first_key(mid), false /* copy */);
+    if (CompareCurrentKey(target) <= 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  size_t i = lo == 0 ? 0 : lo - 1;
+  if (!DecompressMiniBlockAt(mini_blocks_->offset(i))) {
+    return false;
+  }
+  *left = std::max(*left,
+                   static_cast<int64_t>(mini_blocks_->first_restart(i)) - 1);
+  if (i + 1 < n) {
+    *right = std::min(
+        *right, static_cast<int64_t>(mini_blocks_->first_restart(i + 1)) - 1);
+  }
+  assert(*left <= *right);
+  return true;
+}
+
+bool DataBlockIter::DecompressMiniBlock(uint32_t offset) {
+  size_t i = mini_blocks_->Find(offset);
+  Status s = mini_blocks_->Decompress(i);
+  if (!s.ok()) {
+    current_ = restarts_;
+    restart_index_ = num_restarts_;
+    status_ = s;
+    raw_key_.Clear();
+    value_.clear();
+    return false;
+  }
+  mini_block_offset_ = mini_blocks_->offset(i);
+  mini_block_limit_ = mini_blocks_->limit(i);
+  return true;
+}
+
 void DataBlockIter::SeekImpl(const Slice& target) {
   Slice seek_key = target;
   PERF_TIMER_GUARD(block_seek_nanos);
@@ -291,7 +375,16 @@ void DataBlockIter::SeekImpl(const Slice& target) {
   }
   uint32_t index = 0;
   bool skip_linear_scan = false;
-  bool ok = BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan);
+  int64_t left = -1;
+  int64_t right = static_cast<int64_t>(num_restarts_) - 1;
+  if (restart_key_prefixes_ != nullptr) {
+    SearchRestartKeyPrefixes(seek_key, &left, &right);
+  }
+  if (mini_blocks_ != nullptr && !SearchMiniBlocks(seek_key, &left, &right)) {
+    return;
+  }
+  bool ok = BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan, left,
+                                  right);
 
   if (!ok) {
     return;
@@ -342,6 +435,10 @@ void MetaBlockIter::SeekImpl(const Slice& target) {
 bool DataBlockIter::SeekForGetImpl(const Slice& target) {
   Slice target_user_key = ExtractUserKey(target);
   uint32_t map_offset = restarts_ + num_restarts_ * sizeof(uint32_t);
+  if (restart_key_prefixes_ != nullptr) {
+    // Restart key prefixes sit between the restart array and the hash index
+    map_offset += num_restarts_ * static_cast<uint32_t>(kRestartKeyPrefixSize);
+  }
   uint8_t entry =
       data_block_hash_index_->Lookup(data_, map_offset, target_user_key);
 
@@ -374,6 +471,9 @@ bool DataBlockIter::SeekForGetImpl(const Slice& target) {
 
   // check if the key is in the restart_interval
   assert(restart_index < num_restarts_);
+  if (!DecompressMiniBlockAt(GetRestartPoint(restart_index))) {
+    return true;
+  }
   SeekToRestartPoint(restart_index);
   current_ = GetRestartPoint(restart_index);
   cur_entry_idx_ =
@@ -392,6 +492,12 @@ bool DataBlockIter::SeekForGetImpl(const Slice& target) {
     //
     // TODO(fwu): check the left and right boundary of the restart interval
     // to avoid linear seek a target key that is out of range.
+    //
+    // The first key of the next restart interval may be in the next
+    // mini-block.
+    if (!DecompressMiniBlockAt(NextEntryOffset())) {
+      return true;
+    }
     if (!ParseNextDataKey(&shared) || CompareCurrentKey(target) >= 0) {
       // we stop at the first potential matching user key.
       break;
@@ -423,8 +529,7 @@ bool DataBlockIter::SeekForGetImpl(const Slice& target) {
     return true;
   }
 
-  if (icmp_->user_comparator()->Compare(raw_key_.GetUserKey(),
-                                        target_user_key) != 0) {
+  if (icmp_->CompareUserKey(raw_key_.GetUserKey(), target_user_key) != 0) {
     // the key is not in this block and cannot be at the next block either.
     return false;
   }
@@ -474,6 +579,13 @@ void IndexBlockIter::SeekImpl(const Slice& target) {
     // restart interval must be one when hash search is enabled so the binary
     // search simply lands at the right place.
     skip_linear_scan = true;
+  } else if (learned_model_ && learned_model_->num_keys() == num_restarts_) {
+    if (value_delta_encoded_) {
+      ok = LearnedSeek<DecodeKeyV4>(target, seek_key, &index,
+                                    &skip_linear_scan);
+    } else {
+      ok = LearnedSeek<DecodeKey>(target, seek_key, &index, &skip_linear_scan);
+    }
   } else if (value_delta_encoded_) {
     ok = BinarySeek<DecodeKeyV4>(seek_key, &index, &skip_linear_scan);
   } else {
@@ -494,7 +606,16 @@ void DataBlockIter::SeekForPrevImpl(const Slice& target) {
   }
   uint32_t index = 0;
   bool skip_linear_scan = false;
-  bool ok = BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan);
+  int64_t left = -1;
+  int64_t right = static_cast<int64_t>(num_restarts_) - 1;
+  if (restart_key_prefixes_ != nullptr) {
+    SearchRestartKeyPrefixes(seek_key, &left, &right);
+  }
+  if (mini_blocks_ != nullptr && !SearchMiniBlocks(seek_key, &left, &right)) {
+    return;
+  }
+  bool ok = BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan, left,
+                                  right);
 
   if (!ok) {
     return;
@@ -542,6 +663,9 @@ void DataBlockIter::SeekToFirstImpl() {
   if (data_ == nullptr) {  // Not init yet
     return;
   }
+  if (!DecompressMiniBlockAt(0)) {
+    return;
+  }
   SeekToRestartPoint(0);
   bool is_shared = false;
   ParseNextDataKey(&is_shared);
@@ -575,6 +699,9 @@ void DataBlockIter::SeekToLastImpl() {
   if (data_ == nullptr) {  // Not init yet
     return;
   }
+  if (!DecompressMiniBlockAt(GetRestartPoint(num_restarts_ - 1))) {
+    return;
+  }
   SeekToRestartPoint(num_restarts_ - 1);
   bool is_shared = false;
   cur_entry_idx_ = (num_restarts_ - 1) * block_restart_interval_;
@@ -675,6 +802,11 @@ bool DataBlockIter::ParseNextDataKey(bool* is_shared) {
       assert(seqno == 0);
     }
 #endif  // NDEBUG
+    Slice value;
+    if (values_separated_ && !key_only_ && !DecodeSeparatedValue(&value)) {
+      CorruptionError("bad value handle in block");
+      return false;
+    }
     return true;
   } else {
     return false;
@@ -787,6 +919,17 @@ template <class TValue>
 template <typename DecodeKeyFunc>
 bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t* index,
                                    bool* skip_linear_scan) {
+  return BinarySeek<DecodeKeyFunc>(target, index, skip_linear_scan, -1,
+                                   static_cast<int64_t>(num_restarts_) - 1);
+}
+
+// Same as above, but with the search already narrowed down to restart keys
+// (`left`, `right`]. See the loop invariants below.
+template <class TValue>
+template <typename DecodeKeyFunc>
+bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t* index,
+                                   bool* skip_linear_scan, int64_t left,
+                                   int64_t right) {
   if (restarts_ == 0) {
     // SST files dedicated to range tombstones are written with index blocks
     // that have no keys while also having `num_restarts_ == 1`. This would
@@ -804,7 +947,8 @@ bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t* index,
   //   keys.
   // - Any restart keys after index `right` are strictly greater than the target
   //   key.
-  int64_t left = -1, right = num_restarts_ - 1;
+  assert(left >= -1 && left <= right);
+  assert(right < static_cast<int64_t>(num_restarts_));
   while (left != right) {
     // The `mid` is computed by rounding up so it lands in (`left`, `right`].
     int64_t mid = left + (right - left + 1) / 2;
@@ -864,6 +1008,56 @@ int IndexBlockIter::CompareBlockKey(uint32_t block_index, const Slice& target) {
   return CompareCurrentKey(target);
 }
 
+template <typename DecodeKeyFunc>
+bool IndexBlockIter::LearnedSeek(const Slice& target, const Slice& seek_key,
+                                 uint32_t* index, bool* skip_linear_scan) {
+  if (restarts_ == 0) {
+    // See BinarySeek()
+    return false;
+  }
+  uint32_t lo, hi;
+  learned_model_->Predict(LearnedIndexKey(ExtractUserKey(target)), &lo, &hi);
+  // The window is (left, right] in BinarySeek() terms
+  int64_t left = static_cast<int64_t>(lo) - 1;
+  int64_t right = hi;
+  // Both are confirmed by comparing the restart keys just outside the window.
+  // As in BinarySeek(), an exact match ends the search.
+  bool mispredicted_left = false;
+  if (lo > 0) {
+    int cmp = CompareBlockKey(lo - 1, seek_key);
+    if (!status_.ok()) {
+      return false;
+    }
+    if (cmp == 0) {
+      *index = lo - 1;
+      *skip_linear_scan = true;
+      return true;
+    } else if (cmp > 0) {
+      // The result is further left
+      right = left - 1;
+      left = -1;
+      mispredicted_left = true;
+    }
+  }
+  if (!mispredicted_left && hi + 1 < num_restarts_) {
+    int cmp = CompareBlockKey(hi + 1, seek_key);
+    if (!status_.ok()) {
+      return false;
+    }
+    if (cmp == 0) {
+      *index = hi + 1;
+      *skip_linear_scan = true;
+      return true;
+    } else if (cmp < 0) {
+      // The result is further right
+      left = hi + 1;
+      right = num_restarts_ - 1;
+    }
+  }
+  return BinarySeek<DecodeKeyFunc>(seek_key, index, skip_linear_scan, left,
+                                   right);
+}
+
 // Binary search in block_ids to find the first block
 // with a key >= target
 bool IndexBlockIter::BinaryBlockIndexSeek(const Slice& target,
@@ -1007,6 +1201,19 @@ BlockBasedTableOptions::DataBlockIndexType Block::IndexType() const {
   return index_type;
 }
 
+bool Block::HasRestartKeyPrefixes() const {
+  assert(size_ >= 2 * sizeof(uint32_t));
+  if (size_ > kMaxBlockSizeSupportedByHashIndex) {
+    // The check is for the same reason as that in NumRestarts()
+    return false;
+  }
+  uint32_t block_footer = DecodeFixed32(data_ + size_ - sizeof(uint32_t));
+  bool has_restart_key_prefixes = false;
+  UnPackIndexTypeAndNumRestarts(block_footer, nullptr, nullptr,
+                                &has_restart_key_prefixes);
+  return has_restart_key_prefixes;
+}
+
 Block::~Block() {
   // This sync point can be re-enabled if RocksDB can control the
   // initialization order of any/all static options created by the user.
@@ -1015,21 +1222,36 @@ Block::~Block() {
 }
 
 Block::Block(BlockContents&& contents, size_t read_amp_bytes_per_bit,
-             Statistics* statistics)
+             Statistics* statistics, bool values_separated,
+             bool mini_blocks, bool delta_of_delta_keys)
     : contents_(std::move(contents)),
       data_(contents_.data.data()),
       size_(contents_.data.size()),
       restart_offset_(0),
       num_restarts_(0) {
   TEST_SYNC_POINT("Block::Block:0");
+  if (values_separated) {
+    InitializeSeparatedValues();
+  } else if (mini_blocks) {
+    InitializeMiniBlocks();
+  } else if (delta_of_delta_keys) {
+    InitializeDeltaOfDeltaKeys();
+  }
   if (size_ < sizeof(uint32_t)) {
     size_ = 0;  // Error marker
   } else {
     // Should only decode restart points for uncompressed blocks
     num_restarts_ = NumRestarts();
+    // Restart key prefixes sit between the restart array and the hash index
+    size_t prefixes_size =
+        HasRestartKeyPrefixes() ? num_restarts_ * kRestartKeyPrefixSize : 0;
     switch (IndexType()) {
       case BlockBasedTableOptions::kDataBlockBinarySearch:
-        restart_offset_ = static_cast<uint32_t>(size_) -
+        if (prefixes_size > size_ - sizeof(uint32_t)) {
+          size_ = 0;
+          break;
+        }
+        restart_offset_ = static_cast<uint32_t>(size_ - prefixes_size) -
                           (1 + num_restarts_) * sizeof(uint32_t);
         if (restart_offset_ > size_ - sizeof(uint32_t)) {
           // The size is too small for NumRestarts() and therefore
@@ -1046,13 +1268,17 @@ Block::Block(BlockContents&& contents, size_t read_amp_bytes_per_bit,
 
         uint16_t map_offset;
         data_block_hash_index_.Initialize(
-            contents.data.data(),
-            static_cast<uint16_t>(contents.data.size() -
-                                  sizeof(uint32_t)), /*chop off
+            data_,
+            static_cast<uint16_t>(size_ - sizeof(uint32_t)), /*chop off
                                                  NUM_RESTARTS*/
             &map_offset);
 
-        restart_offset_ = map_offset - num_restarts_ * sizeof(uint32_t);
+        if (prefixes_size > map_offset) {
+          size_ = 0;
+          break;
+        }
+        restart_offset_ = static_cast<uint32_t>(map_offset - prefixes_size) -
+                          num_restarts_ * sizeof(uint32_t);
 
         if (restart_offset_ > map_offset) {
           // map_offset is too small for NumRestarts() and
@@ -1064,6 +1290,13 @@ Block::Block(BlockContents&& contents, size_t read_amp_bytes_per_bit,
       default:
         size_ = 0;  // Error marker
     }
+    if (size_ != 0 && prefixes_size != 0) {
+      restart_key_prefixes_ =
+          data_ + restart_offset_ + num_restarts_ * sizeof(uint32_t);
+    }
+    if (size_ != 0 && mini_blocks_ != nullptr && !MiniBlocksMatchRestarts()) {
+      size_ = 0;
+    }
   }
   if (read_amp_bytes_per_bit != 0 && statistics && size_ != 0) {
     read_amp_bitmap_.reset(new BlockReadAmpBitmap(
@@ -1071,6 +1304,67 @@ Block::Block(BlockContents&& contents, size_t read_amp_bytes_per_bit,
   }
 }
 
+void Block::InitializeSeparatedValues() {
+  SeparatedDataBlock sections;
+  Status s = ParseSeparatedDataBlock(contents_.data, &sections);
+  if (s.ok() && sections.keys_compression_type != kNoCompression) {
+    size_t keys_size = 0;
+    s = UncompressSeparatedSection(sections.keys,
+                                   sections.keys_compression_type,
+                                   &uncompressed_keys_, &keys_size);
+    sections.keys = Slice(uncompressed_keys_.get(), keys_size);
+  }
+  if (!s.ok()) {
+    size_ = 0;  // Error marker
+    return;
+  }
+  data_ = sections.keys.data();
+  size_ = sections.keys.size();
+  separated_values_.reset(new SeparatedValues(
+      sections.values, sections.values_compression_type,
+      sections.values_uncompressed_size));
+}
+
+void Block::InitializeMiniBlocks() {
+  mini_blocks_.reset(new MiniBlocks);
+  Status s = mini_blocks_->Initialize(contents_.data);
+  if (!s.ok()) {
+    size_ = 0;  // Error marker
+    return;
+  }
+  data_ = mini_blocks_->data();
+  size_ = mini_blocks_->size();
+}
+
+void Block::InitializeDeltaOfDeltaKeys() {
+  size_t decoded_size = 0;
+  Status s =
+      DecodeDeltaOfDeltaKeys(contents_.data, &decoded_block_, &decoded_size);
+  if (!s.ok()) {
+    size_ = 0;  // Error marker
+    return;
+  }
+  data_ = decoded_block_.get();
+  size_ = decoded_size;
+}
+
+bool Block::MiniBlocksMatchRestarts() const {
+  size_t n = mini_blocks_->num_mini_blocks();
+  if (restart_offset_ != (n == 0 ? 0 : mini_blocks_->limit(n - 1))) {
+    return false;
+  }
+  for (size_t i = 0; i < n; ++i) {
+    uint32_t first_restart = mini_blocks_->first_restart(i);
+    if (first_restart >= num_restarts_ ||
+        DecodeFixed32(data_ + restart_offset_ +
+                      first_restart * sizeof(uint32_t)) !=
+            mini_blocks_->offset(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void Block::InitializeDataBlockProtectionInfo(uint8_t protection_bytes_per_key,
                                               const Comparator* raw_ucmp) {
   protection_bytes_per_key_ = 0;
@@ -1080,9 +1374,13 @@ void Block::InitializeDataBlockProtectionInfo(uint8_t protection_bytes_per_key,
     //
     // We do not know global_seqno yet, so checksum computation and
     // verification all assume global_seqno = 0.
-    std::unique_ptr<DataBlockIter> iter{NewDataIterator(
-        raw_ucmp, kDisableGlobalSequenceNumber, nullptr /* iter */,
-        nullptr /* stats */, true /* block_contents_pinned */)};
+    //
+    // With separated values, the checksums cover the value handles, so that
+    // they can be verified without the values.
+    std::unique_ptr<DataBlockIter> iter{new DataBlockIter};
+    iter->SetKeyOnly(true);
+    NewDataIterator(raw_ucmp, kDisableGlobalSequenceNumber, iter.get(),
+                    nullptr /* stats */, true /* block_contents_pinned */);
     if (iter->status().ok()) {
       block_restart_interval_ = iter->GetRestartInterval();
     }
@@ -1097,7 +1395,7 @@ void Block::InitializeDataBlockProtectionInfo(uint8_t protection_bytes_per_key,
       iter->SeekToFirst();
       while (iter->Valid()) {
         GenerateKVChecksum(kv_checksum_ + i, protection_bytes_per_key,
-                           iter->key(), iter->value());
+                           iter->key(), iter->raw_value());
         iter->Next();
         i += protection_bytes_per_key;
       }
@@ -1226,11 +1524,24 @@ DataBlockIter* Block::NewDataIterator(const Comparator* raw_ucmp,
     ret_iter->Invalidate(Status::OK());
     return ret_iter;
   } else {
+    Slice separated_values;
+    if (separated_values_ != nullptr && !ret_iter->key_only()) {
+      Status s = separated_values_->GetValues(&separated_values);
+      if (!s.ok()) {
+        ret_iter->Invalidate(s);
+        return ret_iter;
+      }
+    }
     ret_iter->Initialize(
         raw_ucmp, data_, restart_offset_, num_restarts_, global_seqno,
         read_amp_bitmap_.get(), block_contents_pinned,
         data_block_hash_index_.Valid() ? &data_block_hash_index_ : nullptr,
-        protection_bytes_per_key_, kv_checksum_, block_restart_interval_);
+        protection_bytes_per_key_, kv_checksum_, block_restart_interval_,
+        restart_key_prefixes_, separated_values_ != nullptr,
+        separated_values,
+        mini_blocks_ != nullptr && !mini_blocks_->all_decompressed()
+            ? mini_blocks_.get()
+            : nullptr);
     if (read_amp_bitmap_) {
       if (read_amp_bitmap_->GetStatistics() != stats) {
         // DB changed the Statistics pointer, we need to notify read_amp_bitmap_
@@ -1246,7 +1557,8 @@ IndexBlockIter* Block::NewIndexIterator(
     const Comparator* raw_ucmp, SequenceNumber global_seqno,
     IndexBlockIter* iter, Statistics* /*stats*/, bool total_order_seek,
     bool have_first_key, bool key_includes_seq, bool value_is_full,
-    bool block_contents_pinned, BlockPrefixIndex* prefix_index) {
+    bool block_contents_pinned, BlockPrefixIndex* prefix_index,
+    const LearnedIndexModel* learned_model) {
   IndexBlockIter* ret_iter;
   if (iter != nullptr) {
     ret_iter = iter;
@@ -1268,7 +1580,7 @@ IndexBlockIter* Block::NewIndexIterator(
                          global_seqno, prefix_index_ptr, have_first_key,
                          key_includes_seq, value_is_full, block_contents_pinned,
                          protection_bytes_per_key_, kv_checksum_,
-                         block_restart_interval_);
+                         block_restart_interval_, learned_model);
   }
 
   return ret_iter;
@@ -1285,6 +1597,19 @@ size_t Block::ApproximateMemoryUsage() const {
     usage += read_amp_bitmap_->ApproximateMemoryUsage();
   }
   usage += checksum_size_;
+  if (uncompressed_keys_) {
+    usage += size_;
+  }
+  if (separated_values_) {
+    usage += sizeof(SeparatedValues) +
+             separated_values_->ApproximateMemoryUsage();
+  }
+  if (mini_blocks_) {
+    usage += sizeof(MiniBlocks) + mini_blocks_->ApproximateMemoryUsage();
+  }
+  if (decoded_block_) {
+    usage += size_;
+  }
   return usage;
 }
 
@@ -27,6 +27,7 @@
 #include "table/format.h"
 #include "table/internal_iterator.h"
 #include "test_util/sync_point.h"
+#include "util/coding.h"
 #include "util/random.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -39,6 +40,9 @@ class DataBlockIter;
 class IndexBlockIter;
 class MetaBlockIter;
 class BlockPrefixIndex;
+class LearnedIndexModel;
+class SeparatedValues;
+class MiniBlocks;
 
 // BlockReadAmpBitmap is a bitmap that map the ROCKSDB_NAMESPACE::Block data
 // bytes to a bitmap with ratio bytes_per_bit. Whenever we access a range of
@@ -154,9 +158,17 @@ class BlockReadAmpBitmap {
 // TODO: Rename to ParsedKvBlock?
 class Block {
  public:
-  // Initialize the block with the specified contents.
+  // Initialize the block with the specified contents. If values_separated,
+  // the contents are a data block with separated values (see
+  // separated_values.h), whose values are only decompressed once needed. If
+  // mini_blocks, they are a data block made of mini-blocks (see
+  // mini_blocks.h), which are only decompressed once needed. If
+  // delta_of_delta_keys, they are a data block with delta-of-delta encoded
+  // keys (see delta_of_delta_keys.h), which is decoded right away.
   explicit Block(BlockContents&& contents, size_t read_amp_bytes_per_bit = 0,
-                 Statistics* statistics = nullptr);
+                 Statistics* statistics = nullptr,
+                 bool values_separated = false, bool mini_blocks = false,
+                 bool delta_of_delta_keys = false);
   // No copying allowed
   Block(const Block&) = delete;
   void operator=(const Block&) = delete;
@@ -168,10 +180,19 @@ class Block {
   // The additional memory space taken by the block data.
   size_t usable_size() const { return contents_.usable_size(); }
   uint32_t NumRestarts() const;
-  bool own_bytes() const { return contents_.own_bytes(); }
+  // Separated values and mini-blocks may be decompressed, and delta-of-delta
+  // keys decoded, into memory owned by the block
+  bool own_bytes() const {
+    return contents_.own_bytes() || separated_values_ != nullptr ||
+           mini_blocks_ != nullptr || decoded_block_ != nullptr;
+  }
 
   BlockBasedTableOptions::DataBlockIndexType IndexType() const;
 
+  // Whether this data block stores a prefix of each restart key (see
+  // BlockBasedTableOptions::data_block_restart_key_prefixes)
+  bool HasRestartKeyPrefixes() const;
+
   // raw_ucmp is a raw (i.e., not wrapped by `UserComparatorWrapper`) user key
   // comparator.
   //
@@ -191,6 +212,9 @@ class Block {
   // NOTE: for the hash based lookup, if a key prefix doesn't match any key,
   // the iterator will simply be set as "invalid", rather than returning
   // the key that is just pass the target key.
+  //
+  // If the values of the block are separated, they are decompressed here
+  // unless `iter` is set to key-only (see DataBlockIter::SetKeyOnly()).
   DataBlockIter* NewDataIterator(const Comparator* raw_ucmp,
                                  SequenceNumber global_seqno,
                                  DataBlockIter* iter = nullptr,
@@ -223,6 +247,9 @@ class Block {
   // If `prefix_index` is not nullptr this block will do hash lookup for the key
   // prefix. If total_order_seek is true, prefix_index_ is ignored.
   //
+  // If `learned_model` is not nullptr, seeks only binary search the restart
+  // points it predicts (see learned_index.h).
+  //
   // `have_first_key` controls whether IndexValue will contain
   // first_internal_key. It affects data serialization format, so the same value
   // have_first_key must be used when writing and reading index.
@@ -233,7 +260,9 @@ class Block {
                                    bool total_order_seek, bool have_first_key,
                                    bool key_includes_seq, bool value_is_full,
                                    bool block_contents_pinned = false,
-                                   BlockPrefixIndex* prefix_index = nullptr);
+                                   BlockPrefixIndex* prefix_index = nullptr,
+                                   const LearnedIndexModel* learned_model =
+                                       nullptr);
 
   // Report an approximation of how much memory has been used.
   size_t ApproximateMemoryUsage() const;
@@ -270,9 +299,21 @@ class Block {
   const char* TEST_GetKVChecksum() const { return kv_checksum_; }
 
  private:
+  // Points data_ at the keys section of a block with separated values,
+  // decompressing it if needed
+  void InitializeSeparatedValues();
+  // Points data_ at the regular data block rebuilt from a block made of
+  // mini-blocks
+  void InitializeMiniBlocks();
+  // Whether the mini-blocks start at the restart points they claim to
+  bool MiniBlocksMatchRestarts() const;
+  // Points data_ at the regular data block decoded from a block with
+  // delta-of-delta encoded keys
+  void InitializeDeltaOfDeltaKeys();
+
   BlockContents contents_;
-  const char* data_;         // contents_.data.data()
-  size_t size_;              // contents_.data.size()
+  const char* data_;  // contents_.data.data(), or the keys section
+  size_t size_;       // contents_.data.size(), or that of the keys section
   uint32_t restart_offset_;  // Offset in data_ of restart array
   uint32_t num_restarts_;
   std::unique_ptr<BlockReadAmpBitmap> read_amp_bitmap_;
@@ -282,6 +323,15 @@ class Block {
   uint32_t block_restart_interval_{0};
   uint8_t protection_bytes_per_key_{0};
   DataBlockHashIndex data_block_hash_index_;
+  const char* restart_key_prefixes_{nullptr};
+  // For data blocks with separated values, the decompressed keys section
+  // (if it was compressed) and the values section
+  CacheAllocationPtr uncompressed_keys_;
+  std::unique_ptr<SeparatedValues> separated_values_;
+  std::unique_ptr<MiniBlocks> mini_blocks_;
+  // The regular data block decoded from a block with delta-of-delta encoded
+  // keys. contents_ keeps the block as read, for the secondary cache.
+  CacheAllocationPtr decoded_block_;
 };
 
 // A `BlockIter` iterates over the entries in a `Block`'s data buffer. The
@@ -593,7 +643,7 @@ class BlockIter : public InternalIteratorBase<TValue> {
   int CompareCurrentKey(const Slice& other) {
     if (raw_key_.IsUserKey()) {
       assert(global_seqno_ == kDisableGlobalSequenceNumber);
-      return icmp_->user_comparator()->Compare(raw_key_.GetUserKey(), other);
+      return icmp_->CompareUserKey(raw_key_.GetUserKey(), other);
     } else if (global_seqno_ == kDisableGlobalSequenceNumber) {
       return icmp_->Compare(raw_key_.GetInternalKey(), other);
     }
@@ -636,6 +686,11 @@ class BlockIter : public InternalIteratorBase<TValue> {
   inline bool BinarySeek(const Slice& target, uint32_t* index,
                          bool* is_index_key_result);
 
+  template <typename DecodeKeyFunc>
+  inline bool BinarySeek(const Slice& target, uint32_t* index,
+                         bool* is_index_key_result, int64_t left,
+                         int64_t right);
+
   // Find the first key in restart interval `index` that is >= `target`.
   // If there is no such key, iterator is positioned at the first key in
   // restart interval `index + 1`.
@@ -660,7 +715,11 @@ class DataBlockIter final : public BlockIter<Slice> {
                   bool block_contents_pinned,
                   DataBlockHashIndex* data_block_hash_index,
                   uint8_t protection_bytes_per_key, const char* kv_checksum,
-                  uint32_t block_restart_interval) {
+                  uint32_t block_restart_interval,
+                  const char* restart_key_prefixes = nullptr,
+                  bool values_separated = false,
+                  const Slice& separated_values = Slice(),
+                  MiniBlocks* mini_blocks = nullptr) {
     InitializeBase(raw_ucmp, data, restarts, num_restarts, global_seqno,
                    block_contents_pinned, protection_bytes_per_key, kv_checksum,
                    block_restart_interval);
@@ -668,6 +727,12 @@ class DataBlockIter final : public BlockIter<Slice> {
     read_amp_bitmap_ = read_amp_bitmap;
     last_bitmap_offset_ = current_ + 1;
     data_block_hash_index_ = data_block_hash_index;
+    restart_key_prefixes_ = restart_key_prefixes;
+    values_separated_ = values_separated;
+    separated_values_ = separated_values;
+    mini_blocks_ = mini_blocks;
+    mini_block_offset_ = 0;
+    mini_block_limit_ = 0;
   }
 
   Slice value() const override {
@@ -678,9 +743,25 @@ class DataBlockIter final : public BlockIter<Slice> {
                              NextEntryOffset() - 1);
       last_bitmap_offset_ = current_;
     }
+    if (values_separated_) {
+      return SeparatedValue();
+    }
     return value_;
   }
 
+  // The value as stored in the entry, which is a value handle if the values
+  // of the block are separated.
+  Slice raw_value() const {
+    assert(Valid());
+    return value_;
+  }
+
+  // If key_only, value() returns an empty value in blocks with separated
+  // values, whose values section is then never decompressed. Applies to the
+  // blocks this iterator is initialized with from now on.
+  void SetKeyOnly(bool key_only) { key_only_ = key_only; }
+  bool key_only() const { return key_only_; }
+
   // Returns if `target` may exist.
   inline bool SeekForGet(const Slice& target) {
 #ifndef NDEBUG
@@ -744,7 +825,67 @@ class DataBlockIter final : public BlockIter<Slice> {
   int32_t prev_entries_idx_ = -1;
 
   DataBlockHashIndex* data_block_hash_index_;
+  // See restart_key_prefixes.h. nullptr if the block has none.
+  const char* restart_key_prefixes_ = nullptr;
+  // See separated_values.h. separated_values_ is the uncompressed values
+  // section, or empty if key_only_.
+  bool values_separated_ = false;
+  bool key_only_ = false;
+  Slice separated_values_;
+  // See mini_blocks.h. nullptr if the block has none, or all of them were
+  // decompressed before this iterator was initialized. Otherwise, entries
+  // are only read after making sure their mini-block is decompressed, and
+  // [mini_block_offset_, mini_block_limit_) is the last mini-block that was.
+  MiniBlocks* mini_blocks_ = nullptr;
+  uint32_t mini_block_offset_ = 0;
+  uint32_t mini_block_limit_ = 0;
+
+  // Makes sure that the mini-block holding the entry at `offset`, if any, is
+  // decompressed. Returns false, with the iterator invalidated, if it cannot
+  // be.
+  inline bool DecompressMiniBlockAt(uint32_t offset) {
+    if (mini_blocks_ == nullptr ||
+        (offset >= mini_block_offset_ && offset < mini_block_limit_) ||
+        offset >= restarts_) {
+      return true;
+    }
+    return DecompressMiniBlock(offset);
+  }
+  bool DecompressMiniBlock(uint32_t offset);
+  // Narrows down the restart interval holding `target` to the restart points
+  // of the mini-block holding it, which is decompressed. Same contract as
+  // SearchRestartKeyPrefixes(), but returns false, with the iterator
+  // invalidated, if the mini-block cannot be decompressed.
+  bool SearchMiniBlocks(const Slice& target, int64_t* left, int64_t* right);
+
+  // Decodes the value handle of the current entry into `*value`. Returns
+  // false if the handle does not point into the values section.
+  inline bool DecodeSeparatedValue(Slice* value) const {
+    Slice handle = value_;
+    uint32_t offset = 0;
+    uint32_t size = 0;
+    if (!GetVarint32(&handle, &offset) || !GetVarint32(&handle, &size) ||
+        offset > separated_values_.size() ||
+        size > separated_values_.size() - offset) {
+      return false;
+    }
+    *value = Slice(separated_values_.data() + offset, size);
+    return true;
+  }
+
+  // The handle was checked by ParseNextDataKey() unless key_only_.
+  inline Slice SeparatedValue() const {
+    Slice value;
+    if (!key_only_) {
+      bool ok = DecodeSeparatedValue(&value);
+      assert(ok);
+      (void)ok;
+    }
+    return value;
+  }
 
+  void SearchRestartKeyPrefixes(const Slice& target, int64_t* left,
+                                int64_t* right);
   bool SeekForGetImpl(const Slice& target);
 };
 
@@ -801,13 +942,15 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
                   bool have_first_key, bool key_includes_seq,
                   bool value_is_full, bool block_contents_pinned,
                   uint8_t protection_bytes_per_key, const char* kv_checksum,
-                  uint32_t block_restart_interval) {
+                  uint32_t block_restart_interval,
+                  const LearnedIndexModel* learned_model = nullptr) {
     InitializeBase(raw_ucmp, data, restarts, num_restarts,
                    kDisableGlobalSequenceNumber, block_contents_pinned,
                    protection_bytes_per_key, kv_checksum,
                    block_restart_interval);
     raw_key_.SetIsUserKey(!key_includes_seq);
     prefix_index_ = prefix_index;
+    learned_model_ = learned_model;
     value_delta_encoded_ = !value_is_full;
     have_first_key_ = have_first_key;
     if (have_first_key_ && global_seqno != kDisableGlobalSequenceNumber) {
@@ -876,6 +1019,7 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
   bool value_delta_encoded_;
   bool have_first_key_;  // value includes first_internal_key
   BlockPrefixIndex* prefix_index_;
+  const LearnedIndexModel* learned_model_ = nullptr;
   // Whether the value is delta encoded. In that case the value is assumed to be
   // BlockHandle. The first value in each restart interval is the full encoded
   // BlockHandle; the restart of encoded size part of the BlockHandle. The
@@ -910,6 +1054,13 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
                             uint32_t left, uint32_t right, uint32_t* index,
                             bool* prefix_may_exist);
   inline int CompareBlockKey(uint32_t block_index, const Slice& target);
+  // Like BinarySeek(), but only searches the restart points predicted by
+  // learned_model_ once the restart keys bordering them confirm the
+  // prediction. `target` is the internal key, `seek_key` what to compare
+  // restart keys with.
+  template <typename DecodeKeyFunc>
+  bool LearnedSeek(const Slice& target, const Slice& seek_key, uint32_t* index,
+                   bool* skip_linear_scan);
 
   inline bool ParseNextIndexKey();
 
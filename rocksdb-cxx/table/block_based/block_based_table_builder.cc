@@ -12,7 +12,9 @@
 #include <assert.h>
 #include <stdio.h>
 
+#include <array>
 #include <atomic>
+#include <cmath>
 #include <list>
 #include <map>
 #include <memory>
@@ -45,7 +47,10 @@
 #include "table/block_based/filter_block.h"
 #include "table/block_based/filter_policy_internal.h"
 #include "table/block_based/full_filter_block.h"
+#include "table/block_based/mini_blocks.h"
 #include "table/block_based/partitioned_filter_block.h"
+#include "table/block_based/range_filter.h"
+#include "table/block_based/separated_values.h"
 #include "table/format.h"
 #include "table/meta_blocks.h"
 #include "table/table_builder.h"
@@ -65,9 +70,15 @@ namespace {
 
 constexpr size_t kBlockTrailerSize = BlockBasedTable::kBlockTrailerSize;
 
+// For BlockBasedTableOptions::adaptive_compression, data blocks with at least
+// this estimated entropy in bits per byte are not compressed, and one in this
+// many data blocks tries the configured compression whatever its history.
+constexpr double kAdaptiveCompressionMaxEntropy = 7.5;
+constexpr uint32_t kAdaptiveCompressionProbeInterval = 16;
+
 // Create a filter block builder based on its type.
 FilterBlockBuilder* CreateFilterBlockBuilder(
-    const ImmutableCFOptions& /*opt*/, const MutableCFOptions& mopt,
+    const ImmutableOptions& opt, const MutableCFOptions& mopt,
     const FilterBuildingContext& context,
     const bool use_delta_encoding_for_index_values,
     PartitionedIndexBuilder* const p_index_builder) {
@@ -92,10 +103,16 @@ FilterBlockBuilder* CreateFilterBlockBuilder(
                                  99) /
                                 100);
       partition_size = std::max(partition_size, static_cast<uint32_t>(1));
+      // The context refers to the table builder's copy of the table options,
+      // which outlives the filter block builder
+      FilterBuildingContext context_copy = context;
       return new PartitionedFilterBlockBuilder(
           mopt.prefix_extractor.get(), table_opt.whole_key_filtering,
           filter_bits_builder, table_opt.index_block_restart_interval,
-          use_delta_encoding_for_index_values, p_index_builder, partition_size);
+          use_delta_encoding_for_index_values, p_index_builder, partition_size,
+          opt.env, table_opt.filter_construction_threads, [context_copy]() {
+            return BloomFilterPolicy::GetBuilderFromContext(context_copy);
+          });
     } else {
       return new FullFilterBlockBuilder(mopt.prefix_extractor.get(),
                                         table_opt.whole_key_filtering,
@@ -112,6 +129,64 @@ bool GoodCompressionRatio(size_t compressed_size, size_t uncomp_size,
          10;
 }
 
+// Estimates the Shannon entropy of the data in bits per byte, from a strided
+// sample of up to 4KB.
+double EstimateEntropy(const Slice& data) {
+  std::array<uint32_t, 256> counts{};
+  const size_t stride = data.size() / 4096 + 1;
+  size_t n = 0;
+  for (size_t i = 0; i < data.size(); i += stride) {
+    ++counts[static_cast<unsigned char>(data[i])];
+    ++n;
+  }
+  double entropy = 0;
+  for (uint32_t count : counts) {
+    if (count > 0) {
+      double p = static_cast<double>(count) / n;
+      entropy -= p * std::log2(p);
+    }
+  }
+  return entropy;
+}
+
+// The faster compression that BlockBasedTableOptions::adaptive_compression
+// falls back to for data blocks that `type` compresses poorly.
+CompressionType FastCompressionFor(CompressionType type) {
+  if (type == kNoCompression || type == kSnappyCompression ||
+      type == kLZ4Compression) {
+    return type;
+  } else if (LZ4_Supported()) {
+    return kLZ4Compression;
+  } else if (Snappy_Supported()) {
+    return kSnappyCompression;
+  }
+  return type;
+}
+
+// Restart key prefixes of data blocks are only ordered like the keys with
+// this comparator.
+bool IsBytewiseWithoutTimestamp(const Comparator* ucmp) {
+  return ucmp->timestamp_size() == 0 &&
+         Slice(ucmp->Name()) == Slice(BytewiseComparator()->Name());
+}
+
+// The number of restart intervals per mini-block of data blocks, or 0 if
+// they are not made of mini-blocks
+uint32_t DataBlockMiniBlockRestarts(
+    const BlockBasedTableOptions& table_options) {
+  return table_options.data_block_separate_values
+             ? 0
+             : table_options.data_block_mini_block_restarts;
+}
+
+// Whether the keys of data blocks are delta-of-delta encoded
+bool DataBlockDeltaOfDeltaKeys(const BlockBasedTableOptions& table_options) {
+  return table_options.data_block_delta_of_delta_keys &&
+         table_options.use_delta_encoding &&
+         !table_options.data_block_separate_values &&
+         DataBlockMiniBlockRestarts(table_options) == 0;
+}
+
 }  // namespace
 
 // format_version is the block format as defined in include/rocksdb/table.h
@@ -212,10 +287,14 @@ class BlockBasedTableBuilder::BlockBasedTablePropertiesCollector
  public:
   explicit BlockBasedTablePropertiesCollector(
       BlockBasedTableOptions::IndexType index_type, bool whole_key_filtering,
-      bool prefix_filtering)
+      bool prefix_filtering, bool data_block_separate_values,
+      bool data_block_mini_blocks, bool data_block_delta_of_delta_keys)
       : index_type_(index_type),
         whole_key_filtering_(whole_key_filtering),
-        prefix_filtering_(prefix_filtering) {}
+        prefix_filtering_(prefix_filtering),
+        data_block_separate_values_(data_block_separate_values),
+        data_block_mini_blocks_(data_block_mini_blocks),
+        data_block_delta_of_delta_keys_(data_block_delta_of_delta_keys) {}
 
   Status InternalAdd(const Slice& /*key*/, const Slice& /*value*/,
                      uint64_t /*file_size*/) override {
@@ -240,6 +319,20 @@ class BlockBasedTableBuilder::BlockBasedTablePropertiesCollector
                         whole_key_filtering_ ? kPropTrue : kPropFalse});
     properties->insert({BlockBasedTablePropertyNames::kPrefixFiltering,
                         prefix_filtering_ ? kPropTrue : kPropFalse});
+    if (data_block_separate_values_) {
+      // Only written when set, as files without it are read the old way
+      properties->insert(
+          {BlockBasedTablePropertyNames::kDataBlockSeparateValues, kPropTrue});
+    }
+    if (data_block_mini_blocks_) {
+      properties->insert(
+          {BlockBasedTablePropertyNames::kDataBlockMiniBlocks, kPropTrue});
+    }
+    if (data_block_delta_of_delta_keys_) {
+      properties->insert(
+          {BlockBasedTablePropertyNames::kDataBlockDeltaOfDeltaKeys,
+           kPropTrue});
+    }
     return Status::OK();
   }
 
@@ -257,6 +350,9 @@ class BlockBasedTableBuilder::BlockBasedTablePropertiesCollector
   BlockBasedTableOptions::IndexType index_type_;
   bool whole_key_filtering_;
   bool prefix_filtering_;
+  bool data_block_separate_values_;
+  bool data_block_mini_blocks_;
+  bool data_block_delta_of_delta_keys_;
 };
 
 struct BlockBasedTableBuilder::Rep {
@@ -282,6 +378,12 @@ struct BlockBasedTableBuilder::Rep {
   const Slice* first_key_in_next_block = nullptr;
   CompressionType compression_type;
   uint64_t sample_for_compression;
+  // For BlockBasedTableOptions::adaptive_compression: the running average
+  // size, in bytes per KB, of data blocks compressed with compression_type,
+  // by estimated entropy of the block (whole bits per byte), or 0 if none
+  // yet. Updated without synchronization by parallel compression threads.
+  std::array<std::atomic<uint32_t>, 8> adaptive_compressed_bytes_per_kb{};
+  std::atomic<uint32_t> adaptive_num_blocks{0};
   std::atomic<uint64_t> compressible_input_data_bytes;
   std::atomic<uint64_t> uncompressible_input_data_bytes;
   std::atomic<uint64_t> sampled_input_data_bytes;
@@ -328,6 +430,7 @@ struct BlockBasedTableBuilder::Rep {
       compression_dict_buffer_cache_res_mgr;
   const bool use_delta_encoding_for_index_values;
   std::unique_ptr<FilterBlockBuilder> filter_builder;
+  std::unique_ptr<RangeFilterBuilder> range_filter_builder;
   OffsetableCacheKey base_cache_key;
   const TableFileCreationReason reason;
 
@@ -380,6 +483,51 @@ struct BlockBasedTableBuilder::Rep {
     return io_status;
   }
 
+  // Chooses the compression of a data block for adaptive_compression, and
+  // the entropy bucket to record its result in
+  CompressionType SelectAdaptiveCompression(const Slice& block_data,
+                                            size_t* bucket) {
+    const double entropy = EstimateEntropy(block_data);
+    *bucket = std::min(static_cast<size_t>(entropy),
+                       adaptive_compressed_bytes_per_kb.size() - 1);
+    if (entropy >= kAdaptiveCompressionMaxEntropy) {
+      // Most likely already compressed or encrypted
+      return kNoCompression;
+    }
+    uint32_t history = adaptive_compressed_bytes_per_kb[*bucket].load(
+        std::memory_order_relaxed);
+    // Keep trying the configured compression now and then, in case the
+    // data changes
+    bool probe = adaptive_num_blocks.fetch_add(1, std::memory_order_relaxed) %
+                     kAdaptiveCompressionProbeInterval ==
+                 0;
+    if (history == 0 || probe ||
+        static_cast<int>(history) <=
+            compression_opts.max_compressed_bytes_per_kb) {
+      return compression_type;
+    }
+    // The configured compression does not pay off for such blocks. A
+    // dictionary is only trained for the configured compression.
+    if (compression_dict != nullptr &&
+        !compression_dict->GetRawDict().empty()) {
+      return kNoCompression;
+    }
+    CompressionType fast = FastCompressionFor(compression_type);
+    return fast == compression_type ? kNoCompression : fast;
+  }
+
+  void RecordAdaptiveCompression(size_t bucket, size_t uncompressed_size,
+                                 size_t compressed_size) {
+    uint32_t sample = static_cast<uint32_t>(
+        (static_cast<uint64_t>(compressed_size) << 10) /
+        std::max(uncompressed_size, size_t{1}));
+    sample = std::max(sample, uint32_t{1});
+    auto& history = adaptive_compressed_bytes_per_kb[bucket];
+    uint32_t old = history.load(std::memory_order_relaxed);
+    history.store(old == 0 ? sample : (old * 7 + sample) / 8,
+                  std::memory_order_relaxed);
+  }
+
   // Never erase an existing status that is not OK.
   void SetStatus(Status s) {
     if (!s.ok() && status_ok.load(std::memory_order_relaxed)) {
@@ -425,7 +573,13 @@ struct BlockBasedTableBuilder::Rep {
                            ->CanKeysWithDifferentByteContentsBeEqual()
                        ? BlockBasedTableOptions::kDataBlockBinarySearch
                        : table_options.data_block_index_type,
-                   table_options.data_block_hash_table_util_ratio),
+                   table_options.data_block_hash_table_util_ratio,
+                   table_options.data_block_restart_key_prefixes &&
+                       IsBytewiseWithoutTimestamp(
+                           tbo.internal_comparator.user_comparator()),
+                   table_options.data_block_separate_values,
+                   DataBlockMiniBlockRestarts(table_options),
+                   DataBlockDeltaOfDeltaKeys(table_options)),
         range_del_block(1 /* block_restart_interval */),
         internal_prefix_transform(tbo.moptions.prefix_extractor.get()),
         compression_type(tbo.compression_type),
@@ -455,7 +609,10 @@ struct BlockBasedTableBuilder::Rep {
                        tbo.internal_comparator.user_comparator(),
                        !use_delta_encoding_for_index_values,
                        table_opt.index_type ==
-                           BlockBasedTableOptions::kBinarySearchWithFirstKey),
+                           BlockBasedTableOptions::kBinarySearchWithFirstKey,
+                       table_opt.data_block_separate_values,
+                       DataBlockMiniBlockRestarts(table_opt) > 0,
+                       DataBlockDeltaOfDeltaKeys(table_opt)),
         status_ok(true),
         io_status_ok(true) {
     if (tbo.target_file_size == 0) {
@@ -531,6 +688,13 @@ struct BlockBasedTableBuilder::Rep {
           use_delta_encoding_for_index_values, p_index_builder_));
     }
 
+    if (table_options.range_filter_bits_per_key > 0 && !tbo.skip_filters &&
+        IsBytewiseWithoutTimestamp(
+            tbo.internal_comparator.user_comparator())) {
+      range_filter_builder.reset(
+          new RangeFilterBuilder(table_options.range_filter_bits_per_key));
+    }
+
     assert(tbo.int_tbl_prop_collector_factories);
     for (auto& factory : *tbo.int_tbl_prop_collector_factories) {
       assert(factory);
@@ -542,7 +706,10 @@ struct BlockBasedTableBuilder::Rep {
     table_properties_collectors.emplace_back(
         new BlockBasedTablePropertiesCollector(
             table_options.index_type, table_options.whole_key_filtering,
-            moptions.prefix_extractor != nullptr));
+            moptions.prefix_extractor != nullptr,
+            table_options.data_block_separate_values,
+            DataBlockMiniBlockRestarts(table_options) > 0,
+            DataBlockDeltaOfDeltaKeys(table_options)));
     const Comparator* ucmp = tbo.internal_comparator.user_comparator();
     assert(ucmp);
     if (ucmp->timestamp_size() > 0) {
@@ -905,6 +1072,17 @@ BlockBasedTableBuilder::BlockBasedTableBuilder(
     // behavior
     sanitized_table_options.format_version = 1;
   }
+  if ((sanitized_table_options.data_block_separate_values ||
+       DataBlockMiniBlockRestarts(sanitized_table_options) > 0 ||
+       DataBlockDeltaOfDeltaKeys(sanitized_table_options)) &&
+      !FormatVersionSupportsDataBlockLayouts(
+          sanitized_table_options.format_version)) {
+    ROCKS_LOG_WARN(tbo.ioptions.logger,
+                   "Silently converting format_version to 6 because of the "
+                   "data block layout");
+    // Versions that cannot read these data blocks refuse format_version 6
+    sanitized_table_options.format_version = 6;
+  }
 
   rep_ = new Rep(sanitized_table_options, tbo, file);
 
@@ -998,6 +1176,9 @@ void BlockBasedTableBuilder::Add(const Slice& key, const Slice& value) {
 
     r->data_block.AddWithLastKey(key, value, r->last_key);
     r->last_key.assign(key.data(), key.size());
+    if (r->range_filter_builder != nullptr) {
+      r->range_filter_builder->Add(ExtractUserKey(key));
+    }
     if (r->state == Rep::State::kBuffered) {
       // Buffered keys will be replayed from data_block_buffers during
       // `Finish()` once compression dictionary has been finalized.
@@ -1118,6 +1299,18 @@ void BlockBasedTableBuilder::CompressAndVerifyBlock(
     std::string* compressed_output, Slice* block_contents,
     CompressionType* type, Status* out_status) {
   Rep* r = rep_;
+  if (is_data_block && r->table_options.data_block_separate_values) {
+    CompressAndVerifySeparatedBlock(uncompressed_block_data, compression_ctx,
+                                    compressed_output, block_contents, type,
+                                    out_status);
+    return;
+  }
+  if (is_data_block && DataBlockMiniBlockRestarts(r->table_options) > 0) {
+    CompressAndVerifyMiniBlocks(uncompressed_block_data, compression_ctx,
+                                compressed_output, block_contents, type,
+                                out_status);
+    return;
+  }
   bool is_status_ok = ok();
   if (!r->IsParallelCompressionEnabled()) {
     assert(is_status_ok);
@@ -1132,15 +1325,26 @@ void BlockBasedTableBuilder::CompressAndVerifyBlock(
       r->compressible_input_data_bytes.fetch_add(uncompressed_block_data.size(),
                                                  std::memory_order_relaxed);
     }
+    CompressionType block_compression_type = r->compression_type;
+    size_t adaptive_bucket = 0;
+    const bool adaptive = is_data_block &&
+                          r->table_options.adaptive_compression &&
+                          r->compression_type != kNoCompression;
+    if (adaptive) {
+      block_compression_type =
+          r->SelectAdaptiveCompression(uncompressed_block_data,
+                                       &adaptive_bucket);
+    }
     const CompressionDict* compression_dict;
-    if (!is_data_block || r->compression_dict == nullptr) {
+    if (!is_data_block || r->compression_dict == nullptr ||
+        block_compression_type != r->compression_type) {
       compression_dict = &CompressionDict::GetEmptyDict();
     } else {
       compression_dict = r->compression_dict.get();
     }
     assert(compression_dict != nullptr);
     CompressionInfo compression_info(r->compression_opts, compression_ctx,
-                                     *compression_dict, r->compression_type,
+                                     *compression_dict, block_compression_type,
                                      r->sample_for_compression);
 
     std::string sampled_output_fast;
@@ -1149,6 +1353,13 @@ void BlockBasedTableBuilder::CompressAndVerifyBlock(
         uncompressed_block_data, compression_info, type,
         r->table_options.format_version, is_data_block /* allow_sample */,
         compressed_output, &sampled_output_fast, &sampled_output_slow);
+    if (adaptive && block_compression_type == r->compression_type) {
+      r->RecordAdaptiveCompression(adaptive_bucket,
+                                   uncompressed_block_data.size(),
+                                   compressed_output->empty()
+                                       ? uncompressed_block_data.size()
+                                       : compressed_output->size());
+    }
 
     if (sampled_output_slow.size() > 0 || sampled_output_fast.size() > 0) {
       // Currently compression sampling is only enabled for data block.
@@ -1171,15 +1382,15 @@ void BlockBasedTableBuilder::CompressAndVerifyBlock(
     if (*type != kNoCompression && r->table_options.verify_compression) {
       // Retrieve the uncompressed contents into a new buffer
       const UncompressionDict* verify_dict;
-      if (!is_data_block || r->verify_dict == nullptr) {
+      if (!is_data_block || r->verify_dict == nullptr ||
+          *type != r->compression_type) {
         verify_dict = &UncompressionDict::GetEmptyDict();
       } else {
         verify_dict = r->verify_dict.get();
       }
       assert(verify_dict != nullptr);
       BlockContents contents;
-      UncompressionInfo uncompression_info(*verify_ctx, *verify_dict,
-                                           r->compression_type);
+      UncompressionInfo uncompression_info(*verify_ctx, *verify_dict, *type);
       Status uncompress_status = UncompressBlockData(
           uncompression_info, block_contents->data(), block_contents->size(),
           &contents, r->table_options.format_version, r->ioptions);
@@ -1239,6 +1450,220 @@ void BlockBasedTableBuilder::CompressAndVerifyBlock(
   }
 }
 
+void BlockBasedTableBuilder::CompressAndVerifySeparatedBlock(
+    const Slice& uncompressed_block_data,
+    const CompressionContext& compression_ctx, std::string* compressed_output,
+    Slice* block_contents, CompressionType* type, Status* out_status) {
+  Rep* r = rep_;
+  // The block as a whole is never compressed, only its sections
+  *type = kNoCompression;
+  *block_contents = uncompressed_block_data;
+  if (!ok() || r->compression_type == kNoCompression ||
+      uncompressed_block_data.size() >= kCompressionSizeLimit) {
+    r->uncompressible_input_data_bytes.fetch_add(
+        uncompressed_block_data.size() + kBlockTrailerSize,
+        std::memory_order_relaxed);
+    RecordTick(r->ioptions.stats, NUMBER_BLOCK_COMPRESSION_BYPASSED);
+    RecordTick(r->ioptions.stats, BYTES_COMPRESSION_BYPASSED,
+               uncompressed_block_data.size());
+    return;
+  }
+  SeparatedDataBlock sections;
+  Status s = ParseSeparatedDataBlock(uncompressed_block_data, &sections);
+  if (!s.ok()) {
+    *out_status = s;
+    return;
+  }
+
+  StopWatchNano timer(
+      r->ioptions.clock,
+      ShouldReportDetailedTime(r->ioptions.env, r->ioptions.stats));
+  r->compressible_input_data_bytes.fetch_add(uncompressed_block_data.size(),
+                                             std::memory_order_relaxed);
+  r->uncompressible_input_data_bytes.fetch_add(kBlockTrailerSize,
+                                               std::memory_order_relaxed);
+  CompressionInfo compression_info(r->compression_opts, compression_ctx,
+                                   CompressionDict::GetEmptyDict(),
+                                   r->compression_type,
+                                   r->sample_for_compression);
+  std::string compressed_keys;
+  std::string compressed_values;
+  CompressionType keys_type;
+  CompressionType values_type;
+  Slice keys = CompressBlock(sections.keys, compression_info, &keys_type,
+                             kSeparatedValuesFormatVersion,
+                             false /* allow_sample */, &compressed_keys,
+                             nullptr, nullptr);
+  Slice values = CompressBlock(sections.values, compression_info, &values_type,
+                               kSeparatedValuesFormatVersion,
+                               false /* allow_sample */, &compressed_values,
+                               nullptr, nullptr);
+  NotifyCollectTableCollectorsOnBlockAdd(r->table_properties_collectors,
+                                         uncompressed_block_data.size(), 0, 0);
+
+  // Some of the compression algorithms are known to be unreliable. If
+  // the verify_compression flag is set then try to de-compress the
+  // compressed sections and compare them to the input.
+  auto verify_section = [&](CompressionType section_type,
+                            const Slice& compressed, const Slice& original) {
+    if (section_type == kNoCompression ||
+        !r->table_options.verify_compression) {
+      return true;
+    }
+    CacheAllocationPtr uncompressed;
+    size_t uncompressed_size = 0;
+    Status uncompress_status = UncompressSeparatedSection(
+        compressed, section_type, &uncompressed, &uncompressed_size);
+    if (!uncompress_status.ok()) {
+      // Decompression reported an error. abort.
+      *out_status = Status::Corruption(std::string("Could not decompress: ") +
+                                       uncompress_status.getState());
+      return false;
+    }
+    if (Slice(uncompressed.get(), uncompressed_size).compare(original) != 0) {
+      // The result of the compression was invalid. abort.
+      const char* const msg =
+          "Decompressed block did not match pre-compression block";
+      ROCKS_LOG_ERROR(r->ioptions.logger, "%s", msg);
+      *out_status = Status::Corruption(msg);
+      return false;
+    }
+    return true;
+  };
+  if (!verify_section(keys_type, keys, sections.keys) ||
+      !verify_section(values_type, values, sections.values)) {
+    return;
+  }
+
+  if (keys_type != kNoCompression || values_type != kNoCompression) {
+    compressed_output->assign(keys.data(), keys.size());
+    compressed_output->append(values.data(), values.size());
+    AppendSeparatedValuesFooter(compressed_output, keys.size(),
+                                sections.values_uncompressed_size, keys_type,
+                                values_type);
+    *block_contents = *compressed_output;
+    RecordTick(r->ioptions.stats, NUMBER_BLOCK_COMPRESSED);
+    RecordTick(r->ioptions.stats, BYTES_COMPRESSED_FROM,
+               uncompressed_block_data.size());
+    RecordTick(r->ioptions.stats, BYTES_COMPRESSED_TO,
+               compressed_output->size());
+  } else {
+    RecordTick(r->ioptions.stats, NUMBER_BLOCK_COMPRESSION_REJECTED);
+    RecordTick(r->ioptions.stats, BYTES_COMPRESSION_REJECTED,
+               uncompressed_block_data.size());
+  }
+  if (timer.IsStarted()) {
+    RecordTimeToHistogram(r->ioptions.stats, COMPRESSION_TIMES_NANOS,
+                          timer.ElapsedNanos());
+  }
+}
+
+void BlockBasedTableBuilder::CompressAndVerifyMiniBlocks(
+    const Slice& uncompressed_block_data,
+    const CompressionContext& compression_ctx, std::string* compressed_output,
+    Slice* block_contents, CompressionType* type, Status* out_status) {
+  Rep* r = rep_;
+  // The block as a whole is never compressed, only its mini-blocks
+  *type = kNoCompression;
+  *block_contents = uncompressed_block_data;
+  if (!ok() || r->compression_type == kNoCompression ||
+      uncompressed_block_data.size() >= kCompressionSizeLimit) {
+    r->uncompressible_input_data_bytes.fetch_add(
+        uncompressed_block_data.size() + kBlockTrailerSize,
+        std::memory_order_relaxed);
+    RecordTick(r->ioptions.stats, NUMBER_BLOCK_COMPRESSION_BYPASSED);
+    RecordTick(r->ioptions.stats, BYTES_COMPRESSION_BYPASSED,
+               uncompressed_block_data.size());
+    return;
+  }
+  std::vector<MiniBlockHandle> mini_blocks;
+  Slice tail;
+  Status s = ParseMiniBlocks(uncompressed_block_data, &mini_blocks, &tail);
+  if (!s.ok()) {
+    *out_status = s;
+    return;
+  }
+
+  StopWatchNano timer(
+      r->ioptions.clock,
+      ShouldReportDetailedTime(r->ioptions.env, r->ioptions.stats));
+  r->compressible_input_data_bytes.fetch_add(uncompressed_block_data.size(),
+                                             std::memory_order_relaxed);
+  r->uncompressible_input_data_bytes.fetch_add(kBlockTrailerSize,
+                                               std::memory_order_relaxed);
+  CompressionInfo compression_info(r->compression_opts, compression_ctx,
+                                   CompressionDict::GetEmptyDict(),
+                                   r->compression_type,
+                                   r->sample_for_compression);
+  std::string index;
+  std::string compressed;
+  bool any_compressed = false;
+  compressed_output->clear();
+  for (const MiniBlockHandle& mini_block : mini_blocks) {
+    CompressionType mini_block_type;
+    compressed.clear();
+    Slice stored = CompressBlock(mini_block.contents, compression_info,
+                                 &mini_block_type, kMiniBlockFormatVersion,
+                                 false /* allow_sample */, &compressed,
+                                 nullptr, nullptr);
+    // Some of the compression algorithms are known to be unreliable. If
+    // the verify_compression flag is set then try to de-compress the
+    // compressed mini-block and compare it to the input.
+    if (mini_block_type != kNoCompression &&
+        r->table_options.verify_compression) {
+      CacheAllocationPtr uncompressed;
+      size_t uncompressed_size = 0;
+      Status uncompress_status = UncompressMiniBlock(
+          stored, mini_block_type, &uncompressed, &uncompressed_size);
+      if (!uncompress_status.ok()) {
+        // Decompression reported an error. abort.
+        *out_status = Status::Corruption(
+            std::string("Could not decompress: ") +
+            uncompress_status.getState());
+        return;
+      }
+      if (Slice(uncompressed.get(), uncompressed_size)
+              .compare(mini_block.contents) != 0) {
+        // The result of the compression was invalid. abort.
+        const char* const msg =
+            "Decompressed block did not match pre-compression block";
+        ROCKS_LOG_ERROR(r->ioptions.logger, "%s", msg);
+        *out_status = Status::Corruption(msg);
+        return;
+      }
+    }
+    any_compressed |= mini_block_type != kNoCompression;
+    compressed_output->append(stored.data(), stored.size());
+    AppendMiniBlockHandle(&index, mini_block.first_restart, stored.size(),
+                          mini_block.uncompressed_size, mini_block_type,
+                          mini_block.first_key);
+  }
+  NotifyCollectTableCollectorsOnBlockAdd(r->table_properties_collectors,
+                                         uncompressed_block_data.size(), 0, 0);
+
+  if (any_compressed) {
+    compressed_output->append(tail.data(), tail.size());
+    compressed_output->append(index);
+    AppendMiniBlocksFooter(compressed_output, index.size(), tail.size(),
+                           mini_blocks.size());
+    *block_contents = *compressed_output;
+    RecordTick(r->ioptions.stats, NUMBER_BLOCK_COMPRESSED);
+    RecordTick(r->ioptions.stats, BYTES_COMPRESSED_FROM,
+               uncompressed_block_data.size());
+    RecordTick(r->ioptions.stats, BYTES_COMPRESSED_TO,
+               compressed_output->size());
+  } else {
+    compressed_output->clear();
+    RecordTick(r->ioptions.stats, NUMBER_BLOCK_COMPRESSION_REJECTED);
+    RecordTick(r->ioptions.stats, BYTES_COMPRESSION_REJECTED,
+               uncompressed_block_data.size());
+  }
+  if (timer.IsStarted()) {
+    RecordTimeToHistogram(r->ioptions.stats, COMPRESSION_TIMES_NANOS,
+                          timer.ElapsedNanos());
+  }
+}
+
 void BlockBasedTableBuilder::WriteMaybeCompressedBlock(
     const Slice& block_contents, CompressionType comp_type, BlockHandle* handle,
     BlockType block_type, const Slice* uncompressed_block_data) {
@@ -1709,6 +2134,18 @@ void BlockBasedTableBuilder::WriteRangeDelBlock(
   }
 }
 
+void BlockBasedTableBuilder::WriteRangeFilterBlock(
+    MetaIndexBuilder* meta_index_builder) {
+  if (ok() && rep_->range_filter_builder != nullptr &&
+      !rep_->range_filter_builder->IsEmpty()) {
+    BlockHandle range_filter_block_handle;
+    WriteMaybeCompressedBlock(rep_->range_filter_builder->Finish(),
+                              kNoCompression, &range_filter_block_handle,
+                              BlockType::kRangeFilter);
+    meta_index_builder->Add(kRangeFilterBlock, range_filter_block_handle);
+  }
+}
+
 void BlockBasedTableBuilder::WriteFooter(BlockHandle& metaindex_block_handle,
                                          BlockHandle& index_block_handle) {
   Rep* r = rep_;
@@ -1804,7 +2241,11 @@ void BlockBasedTableBuilder::EnterUnbuffered() {
     auto& data_block = r->data_block_buffers[i];
     assert(!data_block.empty());
 
-    Block reader{BlockContents{data_block}};
+    Block reader{BlockContents{data_block}, /*read_amp_bytes_per_bit=*/0,
+                 /*statistics=*/nullptr,
+                 r->table_options.data_block_separate_values,
+                 DataBlockMiniBlockRestarts(r->table_options) > 0,
+                 DataBlockDeltaOfDeltaKeys(r->table_options)};
     DataBlockIter* iter = reader.NewDataIterator(
         r->internal_comparator.user_comparator(), kDisableGlobalSequenceNumber);
 
@@ -1913,15 +2354,17 @@ Status BlockBasedTableBuilder::Finish() {
   //    2. [meta block: index]
   //    3. [meta block: compression dictionary]
   //    4. [meta block: range deletion tombstone]
-  //    5. [meta block: properties]
-  //    6. [metaindex block]
-  //    7. Footer
+  //    5. [meta block: range filter]
+  //    6. [meta block: properties]
+  //    7. [metaindex block]
+  //    8. Footer
   BlockHandle metaindex_block_handle, index_block_handle;
   MetaIndexBuilder meta_index_builder;
   WriteFilterBlock(&meta_index_builder);
   WriteIndexBlock(&meta_index_builder, &index_block_handle);
   WriteCompressionDictBlock(&meta_index_builder);
   WriteRangeDelBlock(&meta_index_builder);
+  WriteRangeFilterBlock(&meta_index_builder);
   WritePropertiesBlock(&meta_index_builder);
   if (ok()) {
     // flush the meta index block
@@ -148,6 +148,7 @@ class BlockBasedTableBuilder : public TableBuilder {
   void WritePropertiesBlock(MetaIndexBuilder* meta_index_builder);
   void WriteCompressionDictBlock(MetaIndexBuilder* meta_index_builder);
   void WriteRangeDelBlock(MetaIndexBuilder* meta_index_builder);
+  void WriteRangeFilterBlock(MetaIndexBuilder* meta_index_builder);
   void WriteFooter(BlockHandle& metaindex_block_handle,
                    BlockHandle& index_block_handle);
 
@@ -185,6 +186,25 @@ class BlockBasedTableBuilder : public TableBuilder {
                               CompressionType* result_compression_type,
                               Status* out_status);
 
+  // Like CompressAndVerifyBlock, for a data block with separated values (see
+  // separated_values.h), whose sections are compressed one by one into a
+  // block that is itself stored with kNoCompression.
+  void CompressAndVerifySeparatedBlock(
+      const Slice& uncompressed_block_data,
+      const CompressionContext& compression_ctx,
+      std::string* compressed_output, Slice* result_block_contents,
+      CompressionType* result_compression_type, Status* out_status);
+
+  // Like CompressAndVerifyBlock, for a data block made of mini-blocks (see
+  // mini_blocks.h), which are compressed one by one into a block that is
+  // itself stored with kNoCompression.
+  void CompressAndVerifyMiniBlocks(const Slice& uncompressed_block_data,
+                                   const CompressionContext& compression_ctx,
+                                   std::string* compressed_output,
+                                   Slice* result_block_contents,
+                                   CompressionType* result_compression_type,
+                                   Status* out_status);
+
   // Get compressed blocks from BGWorkCompression and write them into SST
   void BGWorkWriteMaybeCompressedBlock();
 
@@ -182,7 +182,9 @@ static std::unordered_map<std::string, BlockBasedTableOptions::IndexType>
         {"kTwoLevelIndexSearch",
          BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch},
         {"kBinarySearchWithFirstKey",
-         BlockBasedTableOptions::IndexType::kBinarySearchWithFirstKey}};
+         BlockBasedTableOptions::IndexType::kBinarySearchWithFirstKey},
+        {"kLearnedIndexSearch",
+         BlockBasedTableOptions::IndexType::kLearnedIndexSearch}};
 
 static std::unordered_map<std::string,
                           BlockBasedTableOptions::DataBlockIndexType>
@@ -255,6 +257,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
         {"index_type", OptionTypeInfo::Enum<BlockBasedTableOptions::IndexType>(
                            offsetof(struct BlockBasedTableOptions, index_type),
                            &block_base_table_index_type_string_map)},
+        {"learned_index_max_error",
+         {offsetof(struct BlockBasedTableOptions, learned_index_max_error),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"hash_index_allow_collision",
          {0, OptionType::kBoolean, OptionVerificationType::kDeprecated,
           OptionTypeFlags::kNone}},
@@ -271,6 +277,25 @@ static std::unordered_map<std::string, OptionTypeInfo>
                    data_block_hash_table_util_ratio),
           OptionType::kDouble, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"data_block_restart_key_prefixes",
+         {offsetof(struct BlockBasedTableOptions,
+                   data_block_restart_key_prefixes),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"data_block_separate_values",
+         {offsetof(struct BlockBasedTableOptions, data_block_separate_values),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"data_block_mini_block_restarts",
+         {offsetof(struct BlockBasedTableOptions,
+                   data_block_mini_block_restarts),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"data_block_delta_of_delta_keys",
+         {offsetof(struct BlockBasedTableOptions,
+                   data_block_delta_of_delta_keys),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"checksum",
          {offsetof(struct BlockBasedTableOptions, checksum),
           OptionType::kChecksumType, OptionVerificationType::kNormal,
@@ -306,6 +331,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct BlockBasedTableOptions, partition_filters),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"filter_construction_threads",
+         {offsetof(struct BlockBasedTableOptions, filter_construction_threads),
+          OptionType::kInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"optimize_filters_for_memory",
          {offsetof(struct BlockBasedTableOptions, optimize_filters_for_memory),
           OptionType::kBoolean, OptionVerificationType::kNormal,
@@ -319,6 +348,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct BlockBasedTableOptions, whole_key_filtering),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"range_filter_bits_per_key",
+         {offsetof(struct BlockBasedTableOptions, range_filter_bits_per_key),
+          OptionType::kDouble, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"detect_filter_construct_corruption",
          {offsetof(struct BlockBasedTableOptions,
                    detect_filter_construct_corruption),
@@ -341,6 +374,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct BlockBasedTableOptions, verify_compression),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"adaptive_compression",
+         {offsetof(struct BlockBasedTableOptions, adaptive_compression),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"read_amp_bytes_per_bit",
          {offsetof(struct BlockBasedTableOptions, read_amp_bytes_per_bit),
           OptionType::kUInt32T, OptionVerificationType::kNormal,
@@ -374,6 +411,11 @@ static std::unordered_map<std::string, OptionTypeInfo>
                    pin_top_level_index_and_filter),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"pin_filters_in_file_metadata",
+         {offsetof(struct BlockBasedTableOptions,
+                   pin_filters_in_file_metadata),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {kOptNameMetadataCacheOpts,
          OptionTypeInfo::Struct(
              kOptNameMetadataCacheOpts, &metadata_cache_options_type_info,
@@ -739,9 +781,15 @@ std::string BlockBasedTableFactory::GetPrintableOptions() const {
   snprintf(buffer, kBufferSize, "  pin_top_level_index_and_filter: %d\n",
            table_options_.pin_top_level_index_and_filter);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  pin_filters_in_file_metadata: %d\n",
+           table_options_.pin_filters_in_file_metadata);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  index_type: %d\n",
            table_options_.index_type);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  learned_index_max_error: %u\n",
+           table_options_.learned_index_max_error);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  data_block_index_type: %d\n",
            table_options_.data_block_index_type);
   ret.append(buffer);
@@ -751,6 +799,18 @@ std::string BlockBasedTableFactory::GetPrintableOptions() const {
   snprintf(buffer, kBufferSize, "  data_block_hash_table_util_ratio: %lf\n",
            table_options_.data_block_hash_table_util_ratio);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  data_block_restart_key_prefixes: %d\n",
+           table_options_.data_block_restart_key_prefixes);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  data_block_separate_values: %d\n",
+           table_options_.data_block_separate_values);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  data_block_mini_block_restarts: %u\n",
+           table_options_.data_block_mini_block_restarts);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  data_block_delta_of_delta_keys: %d\n",
+           table_options_.data_block_delta_of_delta_keys);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  checksum: %d\n", table_options_.checksum);
   ret.append(buffer);
   snprintf(buffer, kBufferSize, "  no_block_cache: %d\n",
@@ -795,6 +855,9 @@ std::string BlockBasedTableFactory::GetPrintableOptions() const {
   snprintf(buffer, kBufferSize, "  partition_filters: %d\n",
            table_options_.partition_filters);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  filter_construction_threads: %d\n",
+           table_options_.filter_construction_threads);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  use_delta_encoding: %d\n",
            table_options_.use_delta_encoding);
   ret.append(buffer);
@@ -806,9 +869,15 @@ std::string BlockBasedTableFactory::GetPrintableOptions() const {
   snprintf(buffer, kBufferSize, "  whole_key_filtering: %d\n",
            table_options_.whole_key_filtering);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  range_filter_bits_per_key: %lf\n",
+           table_options_.range_filter_bits_per_key);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  verify_compression: %d\n",
            table_options_.verify_compression);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  adaptive_compression: %d\n",
+           table_options_.adaptive_compression);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  read_amp_bytes_per_bit: %d\n",
            table_options_.read_amp_bytes_per_bit);
   ret.append(buffer);
@@ -953,9 +1022,17 @@ const std::string BlockBasedTablePropertyNames::kWholeKeyFiltering =
     "rocksdb.block.based.table.whole.key.filtering";
 const std::string BlockBasedTablePropertyNames::kPrefixFiltering =
     "rocksdb.block.based.table.prefix.filtering";
+const std::string BlockBasedTablePropertyNames::kDataBlockSeparateValues =
+    "rocksdb.block.based.table.data.block.separate.values";
+const std::string BlockBasedTablePropertyNames::kDataBlockMiniBlocks =
+    "rocksdb.block.based.table.data.block.mini.blocks";
+const std::string BlockBasedTablePropertyNames::kDataBlockDeltaOfDeltaKeys =
+    "rocksdb.block.based.table.data.block.delta.of.delta.keys";
 const std::string kHashIndexPrefixesBlock = "rocksdb.hashindex.prefixes";
 const std::string kHashIndexPrefixesMetadataBlock =
     "rocksdb.hashindex.metadata";
+const std::string kLearnedIndexModelBlock = "rocksdb.learnedindex.model";
+const std::string kRangeFilterBlock = "rocksdb.range_filter";
 const std::string kPropTrue = "1";
 const std::string kPropFalse = "0";
 
@@ -30,6 +30,17 @@ void BlockBasedTableIterator::SeekImpl(const Slice* target,
     ResetDataIter();
     return;
   }
+  // The bounds may change between seeks, so the range filter is checked for
+  // each one
+  Slice target_user_key;
+  if (target) {
+    target_user_key = ExtractUserKey(*target);
+  }
+  if (!CheckRangeFilterMayMatch(
+          target ? &target_user_key : read_options_.iterate_lower_bound,
+          read_options_.iterate_upper_bound)) {
+    return;
+  }
 
   bool need_seek_index = true;
   if (block_iter_points_to_real_block_ && block_iter_.Valid()) {
@@ -131,6 +142,11 @@ void BlockBasedTableIterator::SeekForPrev(const Slice& target) {
     ResetDataIter();
     return;
   }
+  const Slice target_user_key = ExtractUserKey(target);
+  if (!CheckRangeFilterMayMatch(read_options_.iterate_lower_bound,
+                                &target_user_key)) {
+    return;
+  }
 
   SavePrevIndexValue();
 
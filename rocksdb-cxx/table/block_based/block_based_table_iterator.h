@@ -23,7 +23,7 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
       const BlockBasedTable* table, const ReadOptions& read_options,
       const InternalKeyComparator& icomp,
       std::unique_ptr<InternalIteratorBase<IndexValue>>&& index_iter,
-      bool check_filter, bool need_upper_bound_check,
+      bool check_filter, bool check_range_filter, bool need_upper_bound_check,
       const SliceTransform* prefix_extractor, TableReaderCaller caller,
       size_t compaction_readahead_size = 0, bool allow_unprepared_value = false)
       : index_iter_(std::move(index_iter)),
@@ -40,8 +40,11 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
         allow_unprepared_value_(allow_unprepared_value),
         block_iter_points_to_real_block_(false),
         check_filter_(check_filter),
+        check_range_filter_(check_range_filter),
         need_upper_bound_check_(need_upper_bound_check),
-        async_read_in_progress_(false) {}
+        async_read_in_progress_(false) {
+    block_iter_.SetKeyOnly(read_options.key_only);
+  }
 
   ~BlockBasedTableIterator() {}
 
@@ -235,6 +238,7 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
   // that block yet. A call to PrepareValue() will trigger loading the block.
   bool is_at_first_key_from_index_ = false;
   bool check_filter_;
+  bool check_range_filter_;
   // TODO(Zhongyi): pick a better name
   bool need_upper_bound_check_;
 
@@ -276,5 +280,17 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
     }
     return true;
   }
+
+  // Checks the table's range filter for user keys in [*lower, *upper]. Only
+  // bounded ranges are checked, as the file's key range is already known
+  // to overlap the seek.
+  bool CheckRangeFilterMayMatch(const Slice* lower, const Slice* upper) {
+    if (check_range_filter_ && lower != nullptr && upper != nullptr &&
+        !table_->RangeFilterMayMatch(lower, upper)) {
+      ResetDataIter();
+      return false;
+    }
+    return true;
+  }
 };
 }  // namespace ROCKSDB_NAMESPACE
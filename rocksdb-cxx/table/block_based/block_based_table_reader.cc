@@ -56,6 +56,7 @@
 #include "table/block_based/filter_policy_internal.h"
 #include "table/block_based/full_filter_block.h"
 #include "table/block_based/hash_index_reader.h"
+#include "table/block_based/learned_index_reader.h"
 #include "table/block_based/partitioned_filter_block.h"
 #include "table/block_based/partitioned_index_reader.h"
 #include "table/block_fetcher.h"
@@ -66,6 +67,7 @@
 #include "table/multiget_context.h"
 #include "table/persistent_cache_helper.h"
 #include "table/persistent_cache_options.h"
+#include "table/pinned_filters.h"
 #include "table/sst_file_writer_collectors.h"
 #include "table/two_level_iterator.h"
 #include "test_util/sync_point.h"
@@ -124,6 +126,8 @@ namespace ROCKSDB_NAMESPACE {
 extern const uint64_t kBlockBasedTableMagicNumber;
 extern const std::string kHashIndexPrefixesBlock;
 extern const std::string kHashIndexPrefixesMetadataBlock;
+extern const std::string kLearnedIndexModelBlock;
+extern const std::string kRangeFilterBlock;
 
 BlockBasedTable::~BlockBasedTable() { delete rep_; }
 
@@ -677,7 +681,8 @@ Status BlockBasedTable::Open(
       &rep->table_options, rep->ioptions.stats,
       blocks_definitely_zstd_compressed, block_protection_bytes_per_key,
       rep->internal_comparator.user_comparator(), rep->index_value_is_full,
-      rep->index_has_first_key);
+      rep->index_has_first_key, rep->data_block_values_separated,
+      rep->data_block_mini_blocks, rep->data_block_delta_of_delta_keys);
 
   // Check expected unique id if provided
   if (expected_unique_id != kNullUniqueId64x2) {
@@ -768,6 +773,11 @@ Status BlockBasedTable::Open(
   if (!s.ok()) {
     return s;
   }
+  s = new_table->ReadRangeFilterBlock(ro, prefetch_buffer.get(),
+                                      metaindex_iter.get());
+  if (!s.ok()) {
+    return s;
+  }
   s = new_table->PrefetchIndexAndFilterBlocks(
       ro, prefetch_buffer.get(), metaindex_iter.get(), new_table.get(),
       prefetch_all, table_options, level, file_size,
@@ -938,6 +948,29 @@ Status BlockBasedTable::ReadPropertiesBlock(
     rep_->index_has_first_key =
         rep_->index_type == BlockBasedTableOptions::kBinarySearchWithFirstKey;
 
+    auto separate_values_pos =
+        props.find(BlockBasedTablePropertyNames::kDataBlockSeparateValues);
+    rep_->data_block_values_separated =
+        separate_values_pos != props.end() &&
+        separate_values_pos->second == kPropTrue;
+    auto mini_blocks_pos =
+        props.find(BlockBasedTablePropertyNames::kDataBlockMiniBlocks);
+    rep_->data_block_mini_blocks = mini_blocks_pos != props.end() &&
+                                   mini_blocks_pos->second == kPropTrue;
+    auto delta_of_delta_keys_pos =
+        props.find(BlockBasedTablePropertyNames::kDataBlockDeltaOfDeltaKeys);
+    rep_->data_block_delta_of_delta_keys =
+        delta_of_delta_keys_pos != props.end() &&
+        delta_of_delta_keys_pos->second == kPropTrue;
+    if ((rep_->data_block_values_separated || rep_->data_block_mini_blocks ||
+         rep_->data_block_delta_of_delta_keys) &&
+        !FormatVersionSupportsDataBlockLayouts(
+            rep_->footer.format_version())) {
+      return Status::Corruption(
+          "Data block layout requires format_version 6, found " +
+          std::to_string(rep_->footer.format_version()));
+    }
+
     s = GetGlobalSequenceNumber(*(rep_->table_properties), largest_seqno,
                                 &(rep_->global_seqno));
     if (!s.ok()) {
@@ -984,6 +1017,40 @@ Status BlockBasedTable::ReadRangeDelBlock(
   return s;
 }
 
+Status BlockBasedTable::ReadRangeFilterBlock(
+    const ReadOptions& ro, FilePrefetchBuffer* prefetch_buffer,
+    InternalIterator* meta_iter) {
+  BlockHandle range_filter_handle;
+  Status s =
+      FindOptionalMetaBlock(meta_iter, kRangeFilterBlock, &range_filter_handle);
+  if (!s.ok() || range_filter_handle.IsNull()) {
+    // Like other filters, the range filter is optional
+    if (!s.ok()) {
+      ROCKS_LOG_WARN(rep_->ioptions.logger,
+                     "Error when seeking to range filter block from file: %s",
+                     s.ToString().c_str());
+    }
+    return Status::OK();
+  }
+  BlockContents contents;
+  BlockFetcher block_fetcher(
+      rep_->file.get(), prefetch_buffer, rep_->footer, ro, range_filter_handle,
+      &contents, rep_->ioptions, true /* decompress */,
+      true /* maybe_compressed */, BlockType::kRangeFilter,
+      UncompressionDict::GetEmptyDict(), rep_->persistent_cache_options,
+      GetMemoryAllocator(rep_->table_options));
+  s = block_fetcher.ReadBlockContents();
+  if (s.ok()) {
+    s = RangeFilter::Create(std::move(contents), &rep_->range_filter);
+  }
+  if (!s.ok()) {
+    ROCKS_LOG_WARN(rep_->ioptions.logger,
+                   "Encountered error while reading range filter block: %s",
+                   s.ToString().c_str());
+  }
+  return Status::OK();
+}
+
 Status BlockBasedTable::PrefetchIndexAndFilterBlocks(
     const ReadOptions& ro, FilePrefetchBuffer* prefetch_buffer,
     InternalIterator* meta_iter, BlockBasedTable* new_table, bool prefetch_all,
@@ -1228,6 +1295,9 @@ size_t BlockBasedTable::ApproximateMemoryUsage() const {
   if (rep_->uncompression_dict_reader) {
     usage += rep_->uncompression_dict_reader->ApproximateMemoryUsage();
   }
+  if (rep_->range_filter) {
+    usage += rep_->range_filter->ApproximateMemoryUsage();
+  }
   if (rep_->table_properties) {
     usage += rep_->table_properties->ApproximateMemoryUsage();
   }
@@ -1844,6 +1914,20 @@ bool BlockBasedTable::PrefixRangeMayMatch(
   return may_match;
 }
 
+bool BlockBasedTable::RangeFilterMayMatch(const Slice* lower,
+                                          const Slice* upper) const {
+  if (rep_->range_filter == nullptr) {
+    return true;
+  }
+  Statistics* statistics = rep_->ioptions.stats;
+  RecordTick(statistics, RANGE_FILTER_CHECKED);
+  if (!rep_->range_filter->RangeMayMatch(lower, upper)) {
+    RecordTick(statistics, RANGE_FILTER_USEFUL);
+    return false;
+  }
+  return true;
+}
+
 bool BlockBasedTable::PrefixExtractorChanged(
     const SliceTransform* prefix_extractor) const {
   if (prefix_extractor == nullptr) {
@@ -1868,12 +1952,16 @@ InternalIterator* BlockBasedTable::NewIterator(
       /*disable_prefix_seek=*/need_upper_bound_check &&
           rep_->index_type == BlockBasedTableOptions::kHashSearch,
       /*input_iter=*/nullptr, /*get_context=*/nullptr, &lookup_context));
+  // Compactions read whole files, so the range filter would not help them
+  const bool check_range_filter = !skip_filters &&
+                                  rep_->range_filter != nullptr &&
+                                  caller != TableReaderCaller::kCompaction;
   if (arena == nullptr) {
     return new BlockBasedTableIterator(
         this, read_options, rep_->internal_comparator, std::move(index_iter),
         !skip_filters && !read_options.total_order_seek &&
             prefix_extractor != nullptr,
-        need_upper_bound_check, prefix_extractor, caller,
+        check_range_filter, need_upper_bound_check, prefix_extractor, caller,
         compaction_readahead_size, allow_unprepared_value);
   } else {
     auto* mem = arena->AllocateAligned(sizeof(BlockBasedTableIterator));
@@ -1881,7 +1969,7 @@ InternalIterator* BlockBasedTable::NewIterator(
         this, read_options, rep_->internal_comparator, std::move(index_iter),
         !skip_filters && !read_options.total_order_seek &&
             prefix_extractor != nullptr,
-        need_upper_bound_check, prefix_extractor, caller,
+        check_range_filter, need_upper_bound_check, prefix_extractor, caller,
         compaction_readahead_size, allow_unprepared_value);
   }
 }
@@ -1971,6 +2059,29 @@ void BlockBasedTable::FullFilterKeysMayMatch(
   }
 }
 
+Status BlockBasedTable::GetPinnedFilters(
+    const ReadOptions& read_options,
+    std::shared_ptr<const PinnedFilters>* filters) {
+  assert(filters);
+  if (!rep_->table_options.pin_filters_in_file_metadata ||
+      rep_->filter == nullptr || !rep_->whole_key_filtering ||
+      rep_->internal_comparator.user_comparator()->timestamp_size() > 0) {
+    return Status::NotSupported("No filter to pin");
+  }
+  // A lookup must still see the range tombstones of a file its filter rules
+  // out
+  if (rep_->table_properties == nullptr ||
+      rep_->table_properties->num_range_deletions > 0) {
+    return Status::NotSupported("Range deletions in table");
+  }
+  auto pinned = std::make_shared<PinnedFilters>();
+  Status s = rep_->filter->CopyFilters(read_options, pinned.get());
+  if (s.ok()) {
+    *filters = std::move(pinned);
+  }
+  return s;
+}
+
 Status BlockBasedTable::ApproximateKeyAnchors(const ReadOptions& read_options,
                                               std::vector<Anchor>& anchors) {
   // We iterator the whole index block here. More efficient implementation
@@ -2407,6 +2518,14 @@ BlockType BlockBasedTable::GetBlockTypeForMetaBlockByName(
     return BlockType::kHashIndexMetadata;
   }
 
+  if (meta_block_name == kLearnedIndexModelBlock) {
+    return BlockType::kLearnedIndexModel;
+  }
+
+  if (meta_block_name == kRangeFilterBlock) {
+    return BlockType::kRangeFilter;
+  }
+
   if (meta_block_name.starts_with(kObsoleteFilterBlockPrefix)) {
     // Obsolete but possible in old files
     return BlockType::kInvalid;
@@ -2522,6 +2641,11 @@ Status BlockBasedTable::CreateIndexReader(
                                        index_reader);
       }
     }
+    case BlockBasedTableOptions::kLearnedIndexSearch: {
+      return LearnedIndexReader::Create(this, ro, prefetch_buffer, meta_iter,
+                                        use_cache, prefetch, pin,
+                                        lookup_context, index_reader);
+    }
     default: {
       std::string error_message =
           "Unrecognized index type: " + std::to_string(rep_->index_type);
@@ -25,6 +25,7 @@
 #include "table/block_based/block_type.h"
 #include "table/block_based/cachable_entry.h"
 #include "table/block_based/filter_block.h"
+#include "table/block_based/range_filter.h"
 #include "table/block_based/uncompression_dict_reader.h"
 #include "table/format.h"
 #include "table/persistent_cache_options.h"
@@ -119,6 +120,10 @@ class BlockBasedTable : public TableReader {
                            const bool need_upper_bound_check,
                            BlockCacheLookupContext* lookup_context) const;
 
+  // Returns false if the table's range filter shows that it has no user key
+  // k with *lower <= k <= *upper. A null bound is unbounded.
+  bool RangeFilterMayMatch(const Slice* lower, const Slice* upper) const;
+
   // Returns a new iterator over the table contents.
   // The result of NewIterator() is initially invalid (caller must
   // call one of the Seek methods on the iterator before using it).
@@ -177,6 +182,10 @@ class BlockBasedTable : public TableReader {
   Status ApproximateKeyAnchors(const ReadOptions& read_options,
                                std::vector<Anchor>& anchors) override;
 
+  Status GetPinnedFilters(
+      const ReadOptions& read_options,
+      std::shared_ptr<const PinnedFilters>* filters) override;
+
   bool TEST_BlockInCache(const BlockHandle& handle) const;
 
   // Returns true if the block for the specified key is in cache.
@@ -472,6 +481,9 @@ class BlockBasedTable : public TableReader {
                            InternalIterator* meta_iter,
                            const InternalKeyComparator& internal_comparator,
                            BlockCacheLookupContext* lookup_context);
+  Status ReadRangeFilterBlock(const ReadOptions& ro,
+                              FilePrefetchBuffer* prefetch_buffer,
+                              InternalIterator* meta_iter);
   Status PrefetchIndexAndFilterBlocks(
       const ReadOptions& ro, FilePrefetchBuffer* prefetch_buffer,
       InternalIterator* meta_iter, BlockBasedTable* new_table,
@@ -592,6 +604,9 @@ struct BlockBasedTable::Rep {
 
   std::shared_ptr<FragmentedRangeTombstoneList> fragmented_range_dels;
 
+  // Only set if the table has a range filter and it could be read
+  std::unique_ptr<RangeFilter> range_filter;
+
   // FIXME
   // If true, data blocks in this file are definitely ZSTD compressed. If false
   // they might not be. When false we skip creating a ZSTD digested
@@ -627,6 +642,12 @@ struct BlockBasedTable::Rep {
   bool index_has_first_key = false;
   bool index_key_includes_seq = true;
   bool index_value_is_full = true;
+  // See BlockBasedTableOptions::data_block_separate_values
+  bool data_block_values_separated = false;
+  // See BlockBasedTableOptions::data_block_mini_block_restarts
+  bool data_block_mini_blocks = false;
+  // See BlockBasedTableOptions::data_block_delta_of_delta_keys
+  bool data_block_delta_of_delta_keys = false;
 
   const bool immortal_table;
 
@@ -299,7 +299,9 @@ DEFINE_SYNC_AND_ASYNC(void, BlockBasedTable::RetrieveMultipleBlocks)
       }
       if (s.ok()) {
         results[idx_in_batch].SetOwnedValue(std::make_unique<Block_kData>(
-            std::move(contents), read_amp_bytes_per_bit, ioptions.stats));
+            std::move(contents), read_amp_bytes_per_bit, ioptions.stats,
+            rep_->data_block_values_separated, rep_->data_block_mini_blocks,
+            rep_->data_block_delta_of_delta_keys));
       }
     }
     statuses[idx_in_batch] = s;
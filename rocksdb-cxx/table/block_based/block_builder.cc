@@ -30,6 +30,21 @@
 //     restarts: uint32[num_restarts]
 //     num_restarts: uint32
 // restarts[i] contains the offset within the block of the ith restart point.
+//
+// If use_restart_key_prefixes, the restart array of a data block is followed
+// by restart_key_prefixes: uint64[num_restarts] (see restart_key_prefixes.h)
+// and a bit in the footer says so. The data block hash index, if any, comes
+// after that.
+//
+// If separate_values, the values of a data block are kept apart from the
+// keys, see separated_values.h.
+//
+// If mini_block_restarts is non-zero, the entries of a data block are cut
+// into mini-blocks of that many restart intervals, see mini_blocks.h.
+//
+// If delta_of_delta_keys, the entries of a finished data block are
+// re-encoded with the trailing integers of their keys stored as bit-packed
+// deltas of deltas, see delta_of_delta_keys.h.
 
 #include "table/block_based/block_builder.h"
 
@@ -40,6 +55,10 @@
 #include "db/dbformat.h"
 #include "rocksdb/comparator.h"
 #include "table/block_based/data_block_footer.h"
+#include "table/block_based/delta_of_delta_keys.h"
+#include "table/block_based/mini_blocks.h"
+#include "table/block_based/restart_key_prefixes.h"
+#include "table/block_based/separated_values.h"
 #include "util/coding.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -48,10 +67,16 @@ BlockBuilder::BlockBuilder(
     int block_restart_interval, bool use_delta_encoding,
     bool use_value_delta_encoding,
     BlockBasedTableOptions::DataBlockIndexType index_type,
-    double data_block_hash_table_util_ratio)
+    double data_block_hash_table_util_ratio, bool use_restart_key_prefixes,
+    bool separate_values, uint32_t mini_block_restarts,
+    bool delta_of_delta_keys)
     : block_restart_interval_(block_restart_interval),
       use_delta_encoding_(use_delta_encoding),
       use_value_delta_encoding_(use_value_delta_encoding),
+      use_restart_key_prefixes_(use_restart_key_prefixes),
+      separate_values_(separate_values),
+      mini_block_restarts_(mini_block_restarts),
+      delta_of_delta_keys_(delta_of_delta_keys),
       restarts_(1, 0),  // First restart point is at offset 0
       counter_(0),
       finished_(false) {
@@ -73,10 +98,12 @@ void BlockBuilder::Reset() {
   buffer_.clear();
   restarts_.resize(1);  // First restart point is at offset 0
   assert(restarts_[0] == 0);
+  restart_key_prefixes_.clear();
   estimate_ = sizeof(uint32_t) + sizeof(uint32_t);
   counter_ = 0;
   finished_ = false;
   last_key_.clear();
+  values_.clear();
   if (data_block_hash_index_builder_.Valid()) {
     data_block_hash_index_builder_.Reset();
   }
@@ -119,28 +146,86 @@ size_t BlockBuilder::EstimateSizeAfterKV(const Slice& key,
 }
 
 Slice BlockBuilder::Finish() {
+  const size_t entries_size = buffer_.size();
   // Append restart array
   for (size_t i = 0; i < restarts_.size(); i++) {
     PutFixed32(&buffer_, restarts_[i]);
   }
 
   uint32_t num_restarts = static_cast<uint32_t>(restarts_.size());
+  // Separated values do not count towards the size limits below
+  size_t keys_size_estimate = CurrentSizeEstimate() - values_.size();
+
+  // Like the hash index, restart key prefixes are only flagged in blocks that
+  // are small enough to be told apart from legacy blocks with huge restart
+  // counts.
+  bool has_restart_key_prefixes =
+      use_restart_key_prefixes_ &&
+      restart_key_prefixes_.size() == restarts_.size() &&
+      keys_size_estimate <= kMaxBlockSizeSupportedByHashIndex;
+  if (has_restart_key_prefixes) {
+    for (int64_t prefix : restart_key_prefixes_) {
+      PutFixed64(&buffer_, static_cast<uint64_t>(prefix));
+    }
+  }
+
   BlockBasedTableOptions::DataBlockIndexType index_type =
       BlockBasedTableOptions::kDataBlockBinarySearch;
   if (data_block_hash_index_builder_.Valid() &&
-      CurrentSizeEstimate() <= kMaxBlockSizeSupportedByHashIndex) {
+      keys_size_estimate <= kMaxBlockSizeSupportedByHashIndex) {
     data_block_hash_index_builder_.Finish(buffer_);
     index_type = BlockBasedTableOptions::kDataBlockBinaryAndHash;
   }
 
   // footer is a packed format of data_block_index_type and num_restarts
-  uint32_t block_footer = PackIndexTypeAndNumRestarts(index_type, num_restarts);
+  uint32_t block_footer = PackIndexTypeAndNumRestarts(
+      index_type, num_restarts, has_restart_key_prefixes);
 
   PutFixed32(&buffer_, block_footer);
+  if (separate_values_) {
+    size_t keys_size = buffer_.size();
+    buffer_.append(values_);
+    AppendSeparatedValuesFooter(&buffer_, keys_size, values_.size(),
+                                kNoCompression, kNoCompression);
+  } else if (mini_block_restarts_ > 0) {
+    AppendMiniBlockIndex(entries_size);
+  } else if (delta_of_delta_keys_) {
+    EncodeDeltaOfDeltaKeys(buffer_, entries_size, num_restarts, &encoded_);
+    std::swap(buffer_, encoded_);
+  }
   finished_ = true;
   return Slice(buffer_);
 }
 
+void BlockBuilder::AppendMiniBlockIndex(size_t entries_size) {
+  const size_t tail_size = buffer_.size() - entries_size;
+  std::string index;
+  size_t num_mini_blocks = 0;
+  for (size_t i = 0; entries_size > 0 && i < restarts_.size();
+       i += mini_block_restarts_) {
+    size_t offset = restarts_[i];
+    size_t limit = i + mini_block_restarts_ < restarts_.size()
+                       ? restarts_[i + mini_block_restarts_]
+                       : entries_size;
+    // The first entry of a restart interval stores its whole key
+    uint32_t shared = 0;
+    uint32_t non_shared = 0;
+    uint32_t value_length = 0;
+    const char* p = buffer_.data() + offset;
+    const char* entries_limit = buffer_.data() + entries_size;
+    p = GetVarint32Ptr(p, entries_limit, &shared);
+    p = GetVarint32Ptr(p, entries_limit, &non_shared);
+    p = GetVarint32Ptr(p, entries_limit, &value_length);
+    assert(p != nullptr && shared == 0);
+    AppendMiniBlockHandle(&index, static_cast<uint32_t>(i), limit - offset,
+                          limit - offset, kNoCompression,
+                          Slice(p, non_shared));
+    ++num_mini_blocks;
+  }
+  buffer_.append(index);
+  AppendMiniBlocksFooter(&buffer_, index.size(), tail_size, num_mini_blocks);
+}
+
 void BlockBuilder::Add(const Slice& key, const Slice& value,
                        const Slice* const delta_value) {
   // Ensure no unsafe mixing of Add and AddWithLastKey
@@ -187,6 +272,16 @@ inline void BlockBuilder::AddWithLastKeyImpl(const Slice& key,
   assert(!finished_);
   assert(counter_ <= block_restart_interval_);
   assert(!use_value_delta_encoding_ || delta_value);
+  assert(!use_value_delta_encoding_ || !separate_values_);
+  size_t values_size = values_.size();
+  Slice entry_value = value;
+  if (separate_values_) {
+    value_handle_.clear();
+    PutVarint32Varint32(&value_handle_, static_cast<uint32_t>(values_size),
+                        static_cast<uint32_t>(value.size()));
+    values_.append(value.data(), value.size());
+    entry_value = value_handle_;
+  }
   size_t shared = 0;  // number of bytes shared with prev key
   if (counter_ >= block_restart_interval_) {
     // Restart compression
@@ -208,7 +303,7 @@ inline void BlockBuilder::AddWithLastKeyImpl(const Slice& key,
     // Add "<shared><non_shared><value_size>" to buffer_
     PutVarint32Varint32Varint32(&buffer_, static_cast<uint32_t>(shared),
                                 static_cast<uint32_t>(non_shared),
-                                static_cast<uint32_t>(value.size()));
+                                static_cast<uint32_t>(entry_value.size()));
   }
 
   // Add string delta to buffer_ followed by value
@@ -219,7 +314,7 @@ inline void BlockBuilder::AddWithLastKeyImpl(const Slice& key,
   if (shared != 0 && use_value_delta_encoding_) {
     buffer_.append(delta_value->data(), delta_value->size());
   } else {
-    buffer_.append(value.data(), value.size());
+    buffer_.append(entry_value.data(), entry_value.size());
   }
 
   if (data_block_hash_index_builder_.Valid()) {
@@ -227,8 +322,14 @@ inline void BlockBuilder::AddWithLastKeyImpl(const Slice& key,
                                        restarts_.size() - 1);
   }
 
+  if (use_restart_key_prefixes_ && counter_ == 0) {
+    // First key of a restart interval
+    restart_key_prefixes_.push_back(RestartKeyPrefix(ExtractUserKey(key)));
+    estimate_ += kRestartKeyPrefixSize;
+  }
+
   counter_++;
-  estimate_ += buffer_.size() - buffer_size;
+  estimate_ += buffer_.size() - buffer_size + values_.size() - values_size;
 }
 
 }  // namespace ROCKSDB_NAMESPACE
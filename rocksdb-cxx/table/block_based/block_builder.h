@@ -28,7 +28,11 @@ class BlockBuilder {
                         bool use_value_delta_encoding = false,
                         BlockBasedTableOptions::DataBlockIndexType index_type =
                             BlockBasedTableOptions::kDataBlockBinarySearch,
-                        double data_block_hash_table_util_ratio = 0.75);
+                        double data_block_hash_table_util_ratio = 0.75,
+                        bool use_restart_key_prefixes = false,
+                        bool separate_values = false,
+                        uint32_t mini_block_restarts = 0,
+                        bool delta_of_delta_keys = false);
 
   // Reset the contents as if the BlockBuilder was just constructed.
   void Reset();
@@ -82,19 +86,37 @@ class BlockBuilder {
                                  const Slice& last_key,
                                  const Slice* const delta_value,
                                  size_t buffer_size);
+  // Appends the mini-block index and footer to the finished block, whose
+  // entries take the first `entries_size` bytes
+  void AppendMiniBlockIndex(size_t entries_size);
 
   const int block_restart_interval_;
   // TODO(myabandeh): put it into a separate IndexBlockBuilder
   const bool use_delta_encoding_;
   // Refer to BlockIter::DecodeCurrentValue for format of delta encoded values
   const bool use_value_delta_encoding_;
+  // Only for data blocks (internal keys) with a bytewise user comparator
+  const bool use_restart_key_prefixes_;
+  // Only for data blocks. See separated_values.h for the layout
+  const bool separate_values_;
+  // Only for data blocks. If non-zero, the number of restart intervals per
+  // mini-block, see mini_blocks.h for the layout
+  const uint32_t mini_block_restarts_;
+  // Only for data blocks. See delta_of_delta_keys.h for the layout
+  const bool delta_of_delta_keys_;
 
   std::string buffer_;              // Destination buffer
   std::vector<uint32_t> restarts_;  // Restart points
+  std::vector<int64_t> restart_key_prefixes_;
   size_t estimate_;
   int counter_;    // Number of entries emitted since restart
   bool finished_;  // Has Finish() been called?
   std::string last_key_;
+  // The values, if separate_values_
+  std::string values_;
+  std::string value_handle_;
+  // The regular block, once re-encoded into buffer_ if delta_of_delta_keys_
+  std::string encoded_;
   DataBlockHashIndexBuilder data_block_hash_index_builder_;
 #ifndef NDEBUG
   bool add_with_last_key_called_ = false;
@@ -10,7 +10,9 @@ namespace ROCKSDB_NAMESPACE {
 void BlockCreateContext::Create(std::unique_ptr<Block_kData>* parsed_out,
                                 BlockContents&& block) {
   parsed_out->reset(new Block_kData(
-      std::move(block), table_options->read_amp_bytes_per_bit, statistics));
+      std::move(block), table_options->read_amp_bytes_per_bit, statistics,
+      data_block_values_separated, data_block_mini_blocks,
+      data_block_delta_of_delta_keys));
   parsed_out->get()->InitializeDataBlockProtectionInfo(protection_bytes_per_key,
                                                        raw_ucmp);
 }
@@ -73,6 +75,8 @@ const std::array<const Cache::CacheItemHelper*,
         nullptr,  // kHashIndexMetadata
         nullptr,  // kMetaIndex (not yet stored in block cache)
         BlockCacheInterface<Block_kIndex>::GetFullHelper(),
+        nullptr,  // kLearnedIndexModel
+        nullptr,  // kRangeFilter
         nullptr,  // kInvalid
     }};
 
@@ -90,6 +94,8 @@ const std::array<const Cache::CacheItemHelper*,
         nullptr,  // kHashIndexMetadata
         nullptr,  // kMetaIndex (not yet stored in block cache)
         BlockCacheInterface<Block_kIndex>::GetBasicHelper(),
+        nullptr,  // kLearnedIndexModel
+        nullptr,  // kRangeFilter
         nullptr,  // kInvalid
     }};
 }  // namespace
@@ -74,14 +74,20 @@ struct BlockCreateContext : public Cache::CreateContext {
                      uint8_t _protection_bytes_per_key,
                      const Comparator* _raw_ucmp,
                      bool _index_value_is_full = false,
-                     bool _index_has_first_key = false)
+                     bool _index_has_first_key = false,
+                     bool _data_block_values_separated = false,
+                     bool _data_block_mini_blocks = false,
+                     bool _data_block_delta_of_delta_keys = false)
       : table_options(_table_options),
         statistics(_statistics),
         using_zstd(_using_zstd),
         protection_bytes_per_key(_protection_bytes_per_key),
         raw_ucmp(_raw_ucmp),
         index_value_is_full(_index_value_is_full),
-        index_has_first_key(_index_has_first_key) {}
+        index_has_first_key(_index_has_first_key),
+        data_block_values_separated(_data_block_values_separated),
+        data_block_mini_blocks(_data_block_mini_blocks),
+        data_block_delta_of_delta_keys(_data_block_delta_of_delta_keys) {}
 
   const BlockBasedTableOptions* table_options = nullptr;
   Statistics* statistics = nullptr;
@@ -90,6 +96,12 @@ struct BlockCreateContext : public Cache::CreateContext {
   const Comparator* raw_ucmp = nullptr;
   bool index_value_is_full;
   bool index_has_first_key;
+  // Whether the data blocks of the table have separated values
+  bool data_block_values_separated = false;
+  // Whether the data blocks of the table are made of mini-blocks
+  bool data_block_mini_blocks = false;
+  // Whether the data blocks of the table have delta-of-delta encoded keys
+  bool data_block_delta_of_delta_keys = false;
 
   // For TypedCacheInterface
   template <typename TBlocklike>
@@ -26,6 +26,8 @@
 #include "rocksdb/table.h"
 #include "table/block_based/block_based_table_reader.h"
 #include "table/block_based/block_builder.h"
+#include "table/block_based/delta_of_delta_keys.h"
+#include "table/block_based/separated_values.h"
 #include "table/format.h"
 #include "test_util/testharness.h"
 #include "test_util/testutil.h"
@@ -218,6 +220,463 @@ TEST_F(BlockTest, IndexHashWithSharedPrefix) {
   CheckBlockContents(std::move(contents), kMaxKey, keys, values);
 }
 
+// Seeks in blocks with restart key prefixes must land where they do without.
+TEST_F(BlockTest, RestartKeyPrefixes) {
+  Random rnd(301);
+  std::vector<std::string> user_keys;
+  // Keys shorter than the prefix, and runs of keys sharing it
+  for (int i = 0; i < 300; ++i) {
+    std::string key = std::to_string(1000 + i / 7);
+    key += std::string(i % 7, 'a' + static_cast<char>(i % 3));
+    user_keys.push_back(key);
+  }
+  // Keys with the greatest prefix, and a long run sharing a prefix
+  for (int i = 0; i < 20; ++i) {
+    user_keys.push_back(std::string(8, '\xff') + std::to_string(i));
+    user_keys.push_back("samepref" + std::to_string(100 + i));
+  }
+  std::sort(user_keys.begin(), user_keys.end());
+  user_keys.erase(std::unique(user_keys.begin(), user_keys.end()),
+                  user_keys.end());
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  for (const std::string& user_key : user_keys) {
+    keys.emplace_back(user_key);
+    AppendInternalKeyFooter(&keys.back(), 0 /* seqno */, kTypeValue);
+    values.emplace_back(rnd.RandomString(10));
+  }
+  // Seek targets: all keys, and keys in between and around them
+  std::vector<std::string> targets = keys;
+  for (const std::string& user_key : user_keys) {
+    for (const std::string& target : {user_key + "0", user_key.substr(0, 3),
+                                      user_key + std::string(8, '\xff')}) {
+      targets.emplace_back(target);
+      AppendInternalKeyFooter(&targets.back(), 0 /* seqno */, kTypeValue);
+    }
+  }
+  targets.emplace_back(std::string(8, '\0'));
+  targets.emplace_back(std::string(8, '\xff') + std::string(8, '\0'));
+
+  for (auto index_type : {BlockBasedTableOptions::kDataBlockBinarySearch,
+                          BlockBasedTableOptions::kDataBlockBinaryAndHash}) {
+    for (int restart_interval : {1, 3, 16}) {
+      std::string raw_blocks[2];
+      for (int with_prefixes = 0; with_prefixes < 2; ++with_prefixes) {
+        BlockBuilder builder(restart_interval, true /* use_delta_encoding */,
+                             false /* use_value_delta_encoding */, index_type,
+                             0.75 /* data_block_hash_table_util_ratio */,
+                             with_prefixes != 0);
+        for (size_t i = 0; i < keys.size(); ++i) {
+          builder.Add(keys[i], values[i]);
+        }
+        raw_blocks[with_prefixes] = builder.Finish().ToString();
+      }
+      BlockContents contents;
+      contents.data = raw_blocks[0];
+      Block reader(std::move(contents));
+      BlockContents prefix_contents;
+      prefix_contents.data = raw_blocks[1];
+      Block prefix_reader(std::move(prefix_contents));
+      ASSERT_FALSE(reader.HasRestartKeyPrefixes());
+      ASSERT_TRUE(prefix_reader.HasRestartKeyPrefixes());
+      ASSERT_EQ(prefix_reader.NumRestarts(), reader.NumRestarts());
+      ASSERT_EQ(prefix_reader.IndexType(), reader.IndexType());
+
+      std::unique_ptr<InternalIterator> iter(reader.NewDataIterator(
+          BytewiseComparator(), kDisableGlobalSequenceNumber));
+      std::unique_ptr<DataBlockIter> prefix_iter(
+          prefix_reader.NewDataIterator(BytewiseComparator(),
+                                        kDisableGlobalSequenceNumber));
+      prefix_iter->SeekToFirst();
+      for (size_t i = 0; i < keys.size(); ++i, prefix_iter->Next()) {
+        ASSERT_TRUE(prefix_iter->Valid());
+        ASSERT_EQ(prefix_iter->key(), keys[i]);
+        ASSERT_EQ(prefix_iter->value(), values[i]);
+      }
+      ASSERT_FALSE(prefix_iter->Valid());
+      for (size_t i = 0; i < keys.size(); ++i) {
+        ASSERT_TRUE(prefix_iter->SeekForGet(keys[i]));
+        ASSERT_TRUE(prefix_iter->Valid());
+        ASSERT_EQ(prefix_iter->key(), keys[i]);
+      }
+
+      for (const std::string& target : targets) {
+        iter->Seek(target);
+        prefix_iter->Seek(target);
+        ASSERT_EQ(prefix_iter->Valid(), iter->Valid());
+        if (iter->Valid()) {
+          ASSERT_EQ(prefix_iter->key(), iter->key());
+        }
+        iter->SeekForPrev(target);
+        prefix_iter->SeekForPrev(target);
+        ASSERT_EQ(prefix_iter->Valid(), iter->Valid());
+        if (iter->Valid()) {
+          ASSERT_EQ(prefix_iter->key(), iter->key());
+        }
+        ASSERT_OK(prefix_iter->status());
+      }
+    }
+  }
+}
+
+TEST_F(BlockTest, SeparatedValues) {
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  GenerateRandomKVs(&keys, &values, 0, 200);
+  // Values of various sizes, including empty ones
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i].resize(i % 7 == 0 ? 0 : (i * 13) % values[i].size());
+  }
+
+  for (auto index_type : {BlockBasedTableOptions::kDataBlockBinarySearch,
+                          BlockBasedTableOptions::kDataBlockBinaryAndHash}) {
+    BlockBuilder builder(16 /* block_restart_interval */,
+                         true /* use_delta_encoding */,
+                         false /* use_value_delta_encoding */, index_type,
+                         0.75 /* data_block_hash_table_util_ratio */,
+                         false /* use_restart_key_prefixes */,
+                         true /* separate_values */);
+    for (size_t i = 0; i < keys.size(); ++i) {
+      builder.Add(keys[i], values[i]);
+    }
+    BlockContents contents;
+    contents.data = builder.Finish();
+    Block reader(std::move(contents), 0 /* read_amp_bytes_per_bit */,
+                 nullptr /* statistics */, true /* values_separated */);
+    ASSERT_EQ(reader.IndexType(), index_type);
+
+    std::unique_ptr<DataBlockIter> iter(reader.NewDataIterator(
+        BytewiseComparator(), kDisableGlobalSequenceNumber));
+    iter->SeekToFirst();
+    for (size_t i = 0; i < keys.size(); ++i, iter->Next()) {
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(iter->key(), keys[i]);
+      ASSERT_EQ(iter->value(), values[i]);
+    }
+    ASSERT_FALSE(iter->Valid());
+    iter->SeekToLast();
+    for (size_t i = keys.size(); i > 0; --i, iter->Prev()) {
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(iter->key(), keys[i - 1]);
+      ASSERT_EQ(iter->value(), values[i - 1]);
+    }
+    ASSERT_FALSE(iter->Valid());
+    for (size_t i = 0; i < keys.size(); i += 3) {
+      ASSERT_TRUE(iter->SeekForGet(keys[i]));
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(iter->value(), values[i]);
+    }
+    ASSERT_OK(iter->status());
+
+    // Key-only iterators see the same keys, with empty values
+    std::unique_ptr<DataBlockIter> key_only_iter(new DataBlockIter);
+    key_only_iter->SetKeyOnly(true);
+    reader.NewDataIterator(BytewiseComparator(), kDisableGlobalSequenceNumber,
+                           key_only_iter.get());
+    key_only_iter->SeekToFirst();
+    for (size_t i = 0; i < keys.size(); ++i, key_only_iter->Next()) {
+      ASSERT_TRUE(key_only_iter->Valid());
+      ASSERT_EQ(key_only_iter->key(), keys[i]);
+      ASSERT_TRUE(key_only_iter->value().empty());
+    }
+    ASSERT_FALSE(key_only_iter->Valid());
+    ASSERT_OK(key_only_iter->status());
+  }
+}
+
+TEST_F(BlockTest, SeparatedValuesCorruptHandle) {
+  BlockBuilder builder(4 /* block_restart_interval */,
+                       true /* use_delta_encoding */,
+                       false /* use_value_delta_encoding */,
+                       BlockBasedTableOptions::kDataBlockBinarySearch,
+                       0.75 /* data_block_hash_table_util_ratio */,
+                       false /* use_restart_key_prefixes */,
+                       true /* separate_values */);
+  const int kNumKeys = 20;
+  for (int i = 0; i < kNumKeys; ++i) {
+    builder.Add(test::KeyStr("k" + std::to_string(100 + i), 1, kTypeValue),
+                "v" + std::to_string(i));
+  }
+  Slice block = builder.Finish();
+
+  // Drop the last byte of the (uncompressed) values section, so that the
+  // handle of the last value points past its end
+  SeparatedDataBlock sections;
+  ASSERT_OK(ParseSeparatedDataBlock(block, &sections));
+  ASSERT_EQ(kNoCompression, sections.values_compression_type);
+  std::string corrupt = sections.keys.ToString();
+  corrupt.append(sections.values.data(), sections.values.size() - 1);
+  AppendSeparatedValuesFooter(&corrupt, sections.keys.size(),
+                              sections.values.size() - 1, kNoCompression,
+                              kNoCompression);
+  BlockContents contents;
+  contents.data = corrupt;
+  Block reader(std::move(contents), 0 /* read_amp_bytes_per_bit */,
+               nullptr /* statistics */, true /* values_separated */);
+
+  std::unique_ptr<DataBlockIter> iter(reader.NewDataIterator(
+      BytewiseComparator(), kDisableGlobalSequenceNumber));
+  int count = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    ASSERT_EQ("v" + std::to_string(count), iter->value());
+    ++count;
+  }
+  ASSERT_EQ(kNumKeys - 1, count);
+  ASSERT_TRUE(iter->status().IsCorruption());
+
+  iter.reset(reader.NewDataIterator(BytewiseComparator(),
+                                    kDisableGlobalSequenceNumber));
+  iter->SeekToLast();
+  ASSERT_FALSE(iter->Valid());
+  ASSERT_TRUE(iter->status().IsCorruption());
+
+  // Key-only iterators do not read the values
+  std::unique_ptr<DataBlockIter> key_only_iter(new DataBlockIter);
+  key_only_iter->SetKeyOnly(true);
+  reader.NewDataIterator(BytewiseComparator(), kDisableGlobalSequenceNumber,
+                         key_only_iter.get());
+  count = 0;
+  for (key_only_iter->SeekToFirst(); key_only_iter->Valid();
+       key_only_iter->Next()) {
+    ++count;
+  }
+  ASSERT_EQ(kNumKeys, count);
+  ASSERT_OK(key_only_iter->status());
+}
+
+TEST_F(BlockTest, MiniBlocks) {
+  Random rnd(301);
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  GenerateRandomKVs(&keys, &values, 0, 500);
+
+  for (auto index_type : {BlockBasedTableOptions::kDataBlockBinarySearch,
+                          BlockBasedTableOptions::kDataBlockBinaryAndHash}) {
+    for (uint32_t mini_block_restarts : {1, 3, 1000}) {
+      BlockBuilder builder(4 /* block_restart_interval */,
+                           true /* use_delta_encoding */,
+                           false /* use_value_delta_encoding */, index_type,
+                           0.75 /* data_block_hash_table_util_ratio */,
+                           false /* use_restart_key_prefixes */,
+                           false /* separate_values */, mini_block_restarts);
+      for (size_t i = 0; i < keys.size(); ++i) {
+        builder.Add(keys[i], values[i]);
+      }
+      const std::string raw_block = builder.Finish().ToString();
+      BlockContents contents;
+      contents.data = raw_block;
+      Block reader(std::move(contents), 0 /* read_amp_bytes_per_bit */,
+                   nullptr /* statistics */, false /* values_separated */,
+                   true /* mini_blocks */);
+      ASSERT_EQ(reader.IndexType(), index_type);
+
+      // Each iterator starts from a fresh block, so that it runs into
+      // mini-blocks that were not decompressed yet
+      auto new_reader_iter = [&](std::unique_ptr<Block>* block) {
+        BlockContents block_contents;
+        block_contents.data = raw_block;
+        block->reset(new Block(std::move(block_contents), 0, nullptr, false,
+                               true /* mini_blocks */));
+        return std::unique_ptr<DataBlockIter>((*block)->NewDataIterator(
+            BytewiseComparator(), kDisableGlobalSequenceNumber));
+      };
+
+      std::unique_ptr<Block> block;
+      std::unique_ptr<DataBlockIter> iter = new_reader_iter(&block);
+      iter->SeekToFirst();
+      for (size_t i = 0; i < keys.size(); ++i, iter->Next()) {
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_EQ(iter->key(), keys[i]);
+        ASSERT_EQ(iter->value(), values[i]);
+      }
+      ASSERT_FALSE(iter->Valid());
+      ASSERT_OK(iter->status());
+
+      iter = new_reader_iter(&block);
+      iter->SeekToLast();
+      for (size_t i = keys.size(); i > 0; --i, iter->Prev()) {
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_EQ(iter->key(), keys[i - 1]);
+        ASSERT_EQ(iter->value(), values[i - 1]);
+      }
+      ASSERT_FALSE(iter->Valid());
+      ASSERT_OK(iter->status());
+
+      for (int i = 0; i < 50; ++i) {
+        size_t k = rnd.Uniform(static_cast<int>(keys.size()));
+        iter = new_reader_iter(&block);
+        ASSERT_TRUE(iter->SeekForGet(keys[k]));
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_EQ(iter->key(), keys[k]);
+        ASSERT_EQ(iter->value(), values[k]);
+
+        // Moving on from there in either direction
+        iter = new_reader_iter(&block);
+        iter->Seek(keys[k]);
+        for (size_t j = k; j < std::min(k + 20, keys.size()); ++j) {
+          ASSERT_TRUE(iter->Valid());
+          ASSERT_EQ(iter->key(), keys[j]);
+          ASSERT_EQ(iter->value(), values[j]);
+          iter->Next();
+        }
+        iter = new_reader_iter(&block);
+        iter->SeekForPrev(keys[k]);
+        for (size_t j = k + 1; j > (k >= 20 ? k - 20 : 0); --j) {
+          ASSERT_TRUE(iter->Valid());
+          ASSERT_EQ(iter->key(), keys[j - 1]);
+          ASSERT_EQ(iter->value(), values[j - 1]);
+          iter->Prev();
+        }
+        ASSERT_OK(iter->status());
+      }
+
+      // Once a scan has decompressed all the mini-blocks of a block, later
+      // iterators read it like a regular block
+      iter.reset(reader.NewDataIterator(BytewiseComparator(),
+                                        kDisableGlobalSequenceNumber));
+      iter->SeekToFirst();
+      for (size_t i = 0; i < keys.size(); ++i, iter->Next()) {
+        ASSERT_TRUE(iter->Valid());
+      }
+      ASSERT_FALSE(iter->Valid());
+      iter.reset(reader.NewDataIterator(BytewiseComparator(),
+                                        kDisableGlobalSequenceNumber));
+      for (size_t i = 0; i < keys.size(); i += 7) {
+        iter->Seek(keys[i]);
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_EQ(iter->key(), keys[i]);
+        ASSERT_EQ(iter->value(), values[i]);
+      }
+      ASSERT_OK(iter->status());
+    }
+  }
+}
+
+TEST_F(BlockTest, DeltaOfDeltaKeys) {
+  Random rnd(301);
+  // Time series keys: a series id followed by a big-endian timestamp, at
+  // mostly regular intervals, with a few versions of some keys and a few
+  // keys that do not fit
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  for (int series = 0; series < 20; ++series) {
+    uint64_t ts = 1000000 * series + rnd.Uniform(1000);
+    for (int i = 0; i < 30; ++i) {
+      std::string user_key = "series" + std::to_string(100 + series);
+      PutFixed64(&user_key, EndianSwapValue(ts));
+      SequenceNumber seq = rnd.OneIn(2) ? 1 : rnd.Uniform(1 << 20) + 2;
+      std::string key = user_key;
+      AppendInternalKeyFooter(&key, seq, kTypeValue);
+      keys.push_back(key);
+      values.push_back(rnd.RandomString(rnd.Uniform(4) * 4));
+      if (rnd.OneIn(10)) {
+        key = user_key;
+        AppendInternalKeyFooter(&key, seq - 1, kTypeDeletion);
+        keys.push_back(key);
+        values.emplace_back();
+      }
+      ts += rnd.OneIn(5) ? rnd.Uniform(100000) : 60;
+    }
+    std::string short_key = "series" + std::to_string(100 + series) + "~";
+    AppendInternalKeyFooter(&short_key, 0, kTypeValue);
+    keys.push_back(short_key);
+    values.push_back(rnd.RandomString(10));
+  }
+
+  for (auto index_type : {BlockBasedTableOptions::kDataBlockBinarySearch,
+                          BlockBasedTableOptions::kDataBlockBinaryAndHash}) {
+    auto build = [&](bool delta_of_delta_keys) {
+      BlockBuilder builder(16 /* block_restart_interval */,
+                           true /* use_delta_encoding */,
+                           false /* use_value_delta_encoding */, index_type,
+                           0.75 /* data_block_hash_table_util_ratio */,
+                           true /* use_restart_key_prefixes */,
+                           false /* separate_values */,
+                           0 /* mini_block_restarts */, delta_of_delta_keys);
+      for (size_t i = 0; i < keys.size(); ++i) {
+        builder.Add(keys[i], values[i]);
+      }
+      return builder.Finish().ToString();
+    };
+    std::string regular = build(false);
+    std::string encoded = build(true);
+    ASSERT_LT(encoded.size(), regular.size() * 3 / 4);
+
+    // Readers rebuild exactly the regular block
+    CacheAllocationPtr decoded;
+    size_t decoded_size = 0;
+    ASSERT_OK(DecodeDeltaOfDeltaKeys(encoded, &decoded, &decoded_size));
+    ASSERT_EQ(regular, Slice(decoded.get(), decoded_size));
+
+    BlockContents contents;
+    contents.data = encoded;
+    Block reader(std::move(contents), 0 /* read_amp_bytes_per_bit */,
+                 nullptr /* statistics */, false /* values_separated */,
+                 false /* mini_blocks */, true /* delta_of_delta_keys */);
+    ASSERT_EQ(reader.IndexType(), index_type);
+    ASSERT_EQ(reader.ContentSlice(), encoded);
+    std::unique_ptr<DataBlockIter> iter(reader.NewDataIterator(
+        BytewiseComparator(), kDisableGlobalSequenceNumber));
+    iter->SeekToFirst();
+    for (size_t i = 0; i < keys.size(); ++i, iter->Next()) {
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(iter->key(), keys[i]);
+      ASSERT_EQ(iter->value(), values[i]);
+    }
+    ASSERT_FALSE(iter->Valid());
+    for (size_t i = 0; i < keys.size(); i += 7) {
+      iter->Seek(keys[i]);
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(iter->key(), keys[i]);
+      ASSERT_TRUE(iter->SeekForGet(keys[i]));
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(iter->value(), values[i]);
+    }
+    ASSERT_OK(iter->status());
+
+    // Damaged blocks are reported as corrupted
+    for (size_t size : {encoded.size() - 1, encoded.size() / 2, size_t{3}}) {
+      std::string damaged = encoded.substr(0, size);
+      ASSERT_TRUE(DecodeDeltaOfDeltaKeys(damaged, &decoded, &decoded_size)
+                      .IsCorruption());
+    }
+    std::string damaged = encoded;
+    damaged[1] = static_cast<char>(damaged[1] + 1);
+    ASSERT_TRUE(DecodeDeltaOfDeltaKeys(damaged, &decoded, &decoded_size)
+                    .IsCorruption());
+  }
+
+  // Keys at regular intervals take no bits
+  BlockBuilder builder(16 /* block_restart_interval */);
+  BlockBuilder dod_builder(16 /* block_restart_interval */,
+                           true /* use_delta_encoding */,
+                           false /* use_value_delta_encoding */,
+                           BlockBasedTableOptions::kDataBlockBinarySearch,
+                           0.75 /* data_block_hash_table_util_ratio */,
+                           false /* use_restart_key_prefixes */,
+                           false /* separate_values */,
+                           0 /* mini_block_restarts */,
+                           true /* delta_of_delta_keys */);
+  for (uint64_t ts = 1000; ts < 1000 + 60 * 100; ts += 60) {
+    std::string key = "series";
+    PutFixed64(&key, EndianSwapValue(ts));
+    AppendInternalKeyFooter(&key, 0 /* seqno */, kTypeValue);
+    builder.Add(key, "");
+    dod_builder.Add(key, "");
+  }
+  std::string regular = builder.Finish().ToString();
+  std::string encoded = dod_builder.Finish().ToString();
+  CacheAllocationPtr decoded;
+  size_t decoded_size = 0;
+  ASSERT_OK(DecodeDeltaOfDeltaKeys(encoded, &decoded, &decoded_size));
+  ASSERT_EQ(regular, Slice(decoded.get(), decoded_size));
+  // One run header with the first key, the first delta and 0 for the width
+  // of the deltas of deltas, then the sequence number and type and the value
+  // size of every entry, then the restart array and the footers
+  ASSERT_EQ(encoded.size(), (1 + 1 + 14 + 1 + 1) + 100 * 2 + (7 + 1) * 4 +
+                                kDeltaOfDeltaKeysFooterSize);
+}
+
 // A slow and accurate version of BlockReadAmpBitmap that simply store
 // all the marked ranges in a set.
 class BlockReadAmpBitmapSlowAndAccurate {
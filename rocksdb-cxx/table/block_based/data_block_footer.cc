@@ -15,15 +15,20 @@ namespace ROCKSDB_NAMESPACE {
 
 const int kDataBlockIndexTypeBitShift = 31;
 
-// 0x7FFFFFFF
-const uint32_t kMaxNumRestarts = (1u << kDataBlockIndexTypeBitShift) - 1u;
+// Like the index type bit, only set in blocks of at most
+// kMaxBlockSizeSupportedByHashIndex bytes, which could never have this many
+// restarts.
+const int kRestartKeyPrefixesBitShift = 30;
 
-// 0x7FFFFFFF
-const uint32_t kNumRestartsMask = (1u << kDataBlockIndexTypeBitShift) - 1u;
+// 0x3FFFFFFF
+const uint32_t kMaxNumRestarts = (1u << kRestartKeyPrefixesBitShift) - 1u;
+
+// 0x3FFFFFFF
+const uint32_t kNumRestartsMask = (1u << kRestartKeyPrefixesBitShift) - 1u;
 
 uint32_t PackIndexTypeAndNumRestarts(
     BlockBasedTableOptions::DataBlockIndexType index_type,
-    uint32_t num_restarts) {
+    uint32_t num_restarts, bool has_restart_key_prefixes) {
   if (num_restarts > kMaxNumRestarts) {
     assert(0);  // mute travis "unused" warning
   }
@@ -34,6 +39,9 @@ uint32_t PackIndexTypeAndNumRestarts(
   } else if (index_type != BlockBasedTableOptions::kDataBlockBinarySearch) {
     assert(0);
   }
+  if (has_restart_key_prefixes) {
+    block_footer |= 1u << kRestartKeyPrefixesBitShift;
+  }
 
   return block_footer;
 }
@@ -41,7 +49,7 @@ uint32_t PackIndexTypeAndNumRestarts(
 void UnPackIndexTypeAndNumRestarts(
     uint32_t block_footer,
     BlockBasedTableOptions::DataBlockIndexType* index_type,
-    uint32_t* num_restarts) {
+    uint32_t* num_restarts, bool* has_restart_key_prefixes) {
   if (index_type) {
     if (block_footer & 1u << kDataBlockIndexTypeBitShift) {
       *index_type = BlockBasedTableOptions::kDataBlockBinaryAndHash;
@@ -54,6 +62,11 @@ void UnPackIndexTypeAndNumRestarts(
     *num_restarts = block_footer & kNumRestartsMask;
     assert(*num_restarts <= kMaxNumRestarts);
   }
+
+  if (has_restart_key_prefixes) {
+    *has_restart_key_prefixes =
+        (block_footer & 1u << kRestartKeyPrefixesBitShift) != 0;
+  }
 }
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -13,13 +13,16 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+// The footer of a data block packs the data block index type, whether the
+// block has a restart key prefix array (see BlockBuilder) and the number of
+// restarts into 32 bits.
 uint32_t PackIndexTypeAndNumRestarts(
     BlockBasedTableOptions::DataBlockIndexType index_type,
-    uint32_t num_restarts);
+    uint32_t num_restarts, bool has_restart_key_prefixes = false);
 
 void UnPackIndexTypeAndNumRestarts(
     uint32_t block_footer,
     BlockBasedTableOptions::DataBlockIndexType* index_type,
-    uint32_t* num_restarts);
+    uint32_t* num_restarts, bool* has_restart_key_prefixes = nullptr);
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,305 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/delta_of_delta_keys.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <vector>
+
+#include "db/dbformat.h"
+#include "util/coding.h"
+#include "util/math.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+
+inline uint64_t ZigZagEncode(uint64_t v) {
+  return (v << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(v) >> 63);
+}
+
+inline uint64_t ZigZagDecode(uint64_t v) { return (v >> 1) ^ (0 - (v & 1)); }
+
+// The trailing integer of a user key of at least 8 bytes
+inline uint64_t KeyInteger(const char* user_key_end) {
+  return EndianSwapValue(
+      DecodeFixed64(user_key_end - kDeltaOfDeltaKeyIntegerSize));
+}
+
+inline void SetKeyInteger(char* user_key_end, uint64_t v) {
+  EncodeFixed64(user_key_end - kDeltaOfDeltaKeyIntegerSize,
+                EndianSwapValue(v));
+}
+
+inline int BitWidth(uint64_t v) {
+  return v == 0 ? 0 : FloorLog2(v) + 1;
+}
+
+inline uint64_t LowBits(uint64_t v, int bits) {
+  return bits >= 64 ? v : v & ((uint64_t{1} << bits) - 1);
+}
+
+// Appends `values`, of `bits` bits each, packed from the low bits of the
+// first byte
+void PutPackedBits(std::string* dst, const std::vector<uint64_t>& values,
+                   int bits) {
+  size_t start = dst->size();
+  dst->append((values.size() * bits + 7) / 8, '\0');
+  char* packed = &(*dst)[start];
+  uint64_t pos = 0;
+  for (uint64_t v : values) {
+    for (int done = 0; done < bits;) {
+      int shift = static_cast<int>(pos % 8);
+      int n = std::min(8 - shift, bits - done);
+      packed[pos / 8] |= static_cast<char>(LowBits(v >> done, n) << shift);
+      done += n;
+      pos += n;
+    }
+  }
+}
+
+// Returns the value of `bits` bits at bit `pos` of `packed`, which holds
+// `size` bytes
+inline uint64_t GetPackedBits(const char* packed, size_t size, uint64_t pos,
+                              int bits) {
+  size_t byte = static_cast<size_t>(pos / 8);
+  int shift = static_cast<int>(pos % 8);
+  if (shift + bits <= 64 && byte + sizeof(uint64_t) <= size) {
+    return LowBits(DecodeFixed64(packed + byte) >> shift, bits);
+  }
+  uint64_t v = 0;
+  for (int done = 0; done < bits; byte++) {
+    v |= (static_cast<uint64_t>(static_cast<unsigned char>(packed[byte])) >>
+          shift)
+         << done;
+    done += 8 - shift;
+    shift = 0;
+  }
+  return LowBits(v, bits);
+}
+
+struct EncodedEntry {
+  // Offset of the internal key in the reconstructed keys
+  size_t key_offset;
+  size_t key_size;
+  Slice value;
+};
+
+// Whether the entry with internal key `key` can follow the one with internal
+// key `prev` in a run
+inline bool SameRun(const Slice& prev, const Slice& key) {
+  size_t size = key.size();
+  return size == prev.size() &&
+         size >= kNumInternalBytes + kDeltaOfDeltaKeyIntegerSize &&
+         memcmp(key.data(), prev.data(),
+                size - kNumInternalBytes - kDeltaOfDeltaKeyIntegerSize) == 0;
+}
+
+}  // namespace
+
+void EncodeDeltaOfDeltaKeys(const Slice& block, size_t entries_size,
+                            uint32_t num_restarts, std::string* out) {
+  assert(entries_size <= block.size());
+  out->clear();
+
+  // Reconstruct the keys of the entries
+  std::vector<EncodedEntry> entries;
+  std::string keys;
+  const char* p = block.data();
+  const char* limit = block.data() + entries_size;
+  size_t last_key_offset = 0;
+  while (p < limit) {
+    uint32_t shared = 0;
+    uint32_t non_shared = 0;
+    uint32_t value_size = 0;
+    p = GetVarint32Ptr(p, limit, &shared);
+    p = GetVarint32Ptr(p, limit, &non_shared);
+    p = GetVarint32Ptr(p, limit, &value_size);
+    assert(p != nullptr);
+    size_t key_offset = keys.size();
+    keys.append(keys, last_key_offset, shared);
+    keys.append(p, non_shared);
+    p += non_shared;
+    entries.push_back({key_offset, keys.size() - key_offset,
+                       Slice(p, value_size)});
+    p += value_size;
+    last_key_offset = key_offset;
+  }
+  assert(p == limit);
+
+  auto key = [&](size_t i) {
+    return Slice(keys.data() + entries[i].key_offset, entries[i].key_size);
+  };
+  std::vector<uint64_t> dods;
+  for (size_t i = 0; i < entries.size();) {
+    size_t n = 1;
+    while (i + n < entries.size() && SameRun(key(i + n - 1), key(i + n))) {
+      n++;
+    }
+    Slice first_user_key = ExtractUserKey(key(i));
+    PutVarint32(out, static_cast<uint32_t>(n));
+    PutLengthPrefixedSlice(out, first_user_key);
+    if (n >= 2) {
+      uint64_t prev = KeyInteger(first_user_key.data() + first_user_key.size());
+      uint64_t prev_delta = 0;
+      uint64_t max_dod = 0;
+      dods.clear();
+      for (size_t k = 1; k < n; k++) {
+        Slice user_key = ExtractUserKey(key(i + k));
+        uint64_t v = KeyInteger(user_key.data() + user_key.size());
+        uint64_t delta = v - prev;
+        if (k == 1) {
+          PutVarint64(out, ZigZagEncode(delta));
+        } else {
+          dods.push_back(ZigZagEncode(delta - prev_delta));
+          max_dod |= dods.back();
+        }
+        prev = v;
+        prev_delta = delta;
+      }
+      if (n >= 3) {
+        int bits = BitWidth(max_dod);
+        out->push_back(static_cast<char>(bits));
+        PutPackedBits(out, dods, bits);
+      }
+    }
+    for (size_t k = 0; k < n; k++) {
+      Slice ikey = key(i + k);
+      PutVarint64(out, DecodeFixed64(ikey.data() + ikey.size() -
+                                     kNumInternalBytes));
+      PutLengthPrefixedSlice(out, entries[i + k].value);
+    }
+    i += n;
+  }
+
+  size_t tail_size = block.size() - entries_size;
+  out->append(block.data() + entries_size, tail_size);
+  PutFixed32(out, static_cast<uint32_t>(entries_size));
+  PutFixed32(out, num_restarts);
+  PutFixed32(out, static_cast<uint32_t>(tail_size));
+}
+
+Status DecodeDeltaOfDeltaKeys(const Slice& block, CacheAllocationPtr* out,
+                              size_t* out_size) {
+  if (block.size() < kDeltaOfDeltaKeysFooterSize) {
+    return Status::Corruption("Block with delta-of-delta keys too small");
+  }
+  const char* footer =
+      block.data() + block.size() - kDeltaOfDeltaKeysFooterSize;
+  uint32_t entries_size = DecodeFixed32(footer);
+  uint32_t num_restarts = DecodeFixed32(footer + sizeof(uint32_t));
+  uint32_t tail_size = DecodeFixed32(footer + 2 * sizeof(uint32_t));
+  size_t sections_size = block.size() - kDeltaOfDeltaKeysFooterSize;
+  if (tail_size > sections_size ||
+      num_restarts > tail_size / sizeof(uint32_t)) {
+    return Status::Corruption("Bad footer of block with delta-of-delta keys");
+  }
+  Slice input(block.data(), sections_size - tail_size);
+  const char* tail = input.data() + input.size();
+
+  const size_t size = size_t{entries_size} + tail_size;
+  CacheAllocationPtr decoded = AllocateBlock(size, nullptr);
+  char* dst = decoded.get();
+  memcpy(dst + entries_size, tail, tail_size);
+  uint32_t offset = 0;
+  uint32_t restart = 0;
+
+  const Status corruption =
+      Status::Corruption("Bad entries in block with delta-of-delta keys");
+  std::string ikey;
+  std::string last_ikey;
+  while (!input.empty()) {
+    uint32_t n = 0;
+    Slice first_user_key;
+    if (!GetVarint32(&input, &n) || n == 0 ||
+        !GetLengthPrefixedSlice(&input, &first_user_key) ||
+        (n >= 2 && first_user_key.size() < kDeltaOfDeltaKeyIntegerSize)) {
+      return corruption;
+    }
+    ikey.assign(first_user_key.data(), first_user_key.size());
+    ikey.append(kNumInternalBytes, '\0');
+    char* user_key_end = &ikey[first_user_key.size()];
+    uint64_t v = n >= 2 ? KeyInteger(user_key_end) : 0;
+    uint64_t delta = 0;
+    int bits = 0;
+    Slice dods;
+    if (n >= 2) {
+      if (!GetVarint64(&input, &delta)) {
+        return corruption;
+      }
+      delta = ZigZagDecode(delta);
+    }
+    if (n >= 3) {
+      if (input.empty() || static_cast<unsigned char>(input[0]) > 64) {
+        return corruption;
+      }
+      bits = static_cast<unsigned char>(input[0]);
+      input.remove_prefix(1);
+      uint64_t dods_size = (uint64_t{n - 2} * bits + 7) / 8;
+      if (dods_size > input.size()) {
+        return corruption;
+      }
+      dods = Slice(input.data(), static_cast<size_t>(dods_size));
+      input.remove_prefix(dods.size());
+    }
+
+    for (uint32_t k = 0; k < n; k++) {
+      if (k >= 2) {
+        delta += ZigZagDecode(GetPackedBits(dods.data(), dods.size(),
+                                            uint64_t{k - 2} * bits, bits));
+      }
+      if (k >= 1) {
+        v += delta;
+        SetKeyInteger(user_key_end, v);
+      }
+      uint64_t packed_seq_type = 0;
+      Slice value;
+      if (!GetVarint64(&input, &packed_seq_type) ||
+          !GetLengthPrefixedSlice(&input, &value)) {
+        return corruption;
+      }
+      EncodeFixed64(user_key_end, packed_seq_type);
+
+      // Prefix-compress the key again, like BlockBuilder
+      size_t shared = 0;
+      if (restart < num_restarts &&
+          offset == DecodeFixed32(tail + restart * sizeof(uint32_t))) {
+        restart++;
+      } else {
+        shared = Slice(ikey).difference_offset(last_ikey);
+      }
+      size_t non_shared = ikey.size() - shared;
+      size_t entry_size = VarintLength(shared) + VarintLength(non_shared) +
+                          VarintLength(value.size()) + non_shared +
+                          value.size();
+      // The first entry is a restart point
+      if (restart == 0 || entry_size > entries_size - offset) {
+        return corruption;
+      }
+      char* q = EncodeVarint32(dst + offset, static_cast<uint32_t>(shared));
+      q = EncodeVarint32(q, static_cast<uint32_t>(non_shared));
+      q = EncodeVarint32(q, static_cast<uint32_t>(value.size()));
+      memcpy(q, ikey.data() + shared, non_shared);
+      memcpy(q + non_shared, value.data(), value.size());
+      offset += static_cast<uint32_t>(entry_size);
+      last_ikey = ikey;
+    }
+  }
+  // An empty block still has its first restart point
+  if (offset != entries_size ||
+      (restart != num_restarts && entries_size != 0)) {
+    return corruption;
+  }
+  if (offset != entries_size || restart != num_restarts) {
+    return corruption;
+  }
+  *out = std::move(decoded);
+  *out_size = size;
+  return Status::OK();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,67 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+// Layout of data blocks with delta-of-delta encoded keys (see
+// BlockBasedTableOptions::data_block_delta_of_delta_keys).
+//
+// Such a block is a regular data block (see block_builder.cc) whose entries
+// are re-encoded in runs of consecutive entries whose user keys have the same
+// size and only differ in their last 8 bytes, read as a big-endian integer
+// such as a timestamp. A key that does not fit makes a run of its own.
+//
+//    runs: for each run of n entries:
+//      n: varint32
+//      user_key_size: varint32
+//      first_user_key: char[user_key_size]
+//      first_delta: varint64              (zigzag, if n >= 2)
+//      dod_bits: uint8                    (if n >= 3)
+//      dods: (n - 2) values of dod_bits   (zigzag, packed from the low bits)
+//      for each entry:
+//        packed_seq_type: varint64
+//        value_size: varint32
+//        value: char[value_size]
+//    tail: char[tail_size]
+//    entries_size: fixed32
+//    num_restarts: fixed32
+//    tail_size: fixed32
+//
+// The integer of the k-th key of a run is that of the previous key plus the
+// k-th delta, and the k-th delta is the previous delta plus the k-th
+// delta-of-delta (modulo 2^64). Keys at regular intervals thus take no bits
+// at all.
+//
+// The tail is the rest of the regular block after its entries (restart
+// array, ..., block footer). Readers rebuild the regular block once, when the
+// block is read, by prefix-compressing the decoded keys again: the entries at
+// the offsets of the restart array store their whole key, and the others the
+// bytes they do not share with the previous key, as BlockBuilder does.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "memory/memory_allocator.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+constexpr size_t kDeltaOfDeltaKeysFooterSize = 3 * sizeof(uint32_t);
+
+// Size of the trailing integer of the user keys
+constexpr size_t kDeltaOfDeltaKeyIntegerSize = sizeof(uint64_t);
+
+// Re-encodes `block`, a finished regular data block whose entries take the
+// first `entries_size` bytes, into `*out`.
+void EncodeDeltaOfDeltaKeys(const Slice& block, size_t entries_size,
+                            uint32_t num_restarts, std::string* out);
+
+// Rebuilds the regular data block from a block with delta-of-delta encoded
+// keys.
+Status DecodeDeltaOfDeltaKeys(const Slice& block, CacheAllocationPtr* out,
+                              size_t* out_size);
+
+}  // namespace ROCKSDB_NAMESPACE
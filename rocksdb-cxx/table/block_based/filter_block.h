@@ -35,6 +35,7 @@ const uint64_t kNotValid = ULLONG_MAX;
 class FilterPolicy;
 
 class GetContext;
+class PinnedFilters;
 using MultiGetRange = MultiGetContext::Range;
 
 // A FilterBlockBuilder is used to construct all of the filters for a
@@ -167,6 +168,12 @@ class FilterBlockReader {
     return Status::OK();
   }
 
+  // Adds copies of the whole key filters to *filters (see PinnedFilters)
+  virtual Status CopyFilters(const ReadOptions& /*ro*/,
+                             PinnedFilters* /*filters*/) {
+    return Status::NotSupported("CopyFilters() not supported");
+  }
+
   virtual bool RangeMayExist(const Slice* /*iterate_upper_bound*/,
                              const Slice& user_key_without_ts,
                              const SliceTransform* prefix_extractor,
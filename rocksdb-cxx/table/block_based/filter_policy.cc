@@ -985,8 +985,18 @@ class Standard128RibbonBitsReader : public BuiltinFilterBitsReader {
           GetSliceHash64(*keys[i]), hasher_, soln_, &saved[i].seeded_hash,
           &saved[i].segment_num, &saved[i].num_columns, &saved[i].start_bits);
     }
+#ifdef ROCKSDB_RIBBON_AVX2_QUERY
+    if (ribbon::CpuSupportsAvx2Query()) {
+      for (int i = 0; i < num_keys; ++i) {
+        may_match[i] = ribbon::InterleavedFilterQueryAllColumnsAvx2(
+            saved[i].seeded_hash, saved[i].segment_num, saved[i].num_columns,
+            saved[i].start_bits, hasher_, soln_);
+      }
+      return;
+    }
+#endif  // ROCKSDB_RIBBON_AVX2_QUERY
     for (int i = 0; i < num_keys; ++i) {
-      may_match[i] = ribbon::InterleavedFilterQuery(
+      may_match[i] = ribbon::InterleavedFilterQueryAllColumns(
           saved[i].seeded_hash, saved[i].segment_num, saved[i].num_columns,
           saved[i].start_bits, hasher_, soln_);
     }
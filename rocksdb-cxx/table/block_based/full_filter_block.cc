@@ -13,6 +13,7 @@
 #include "port/port.h"
 #include "rocksdb/filter_policy.h"
 #include "table/block_based/block_based_table_reader.h"
+#include "table/pinned_filters.h"
 #include "util/coding.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -287,4 +288,21 @@ size_t FullFilterBlockReader::ApproximateMemoryUsage() const {
   return usage;
 }
 
+Status FullFilterBlockReader::CopyFilters(const ReadOptions& ro,
+                                          PinnedFilters* filters) {
+  assert(filters);
+  BlockCacheLookupContext lookup_context{TableReaderCaller::kPrefetch};
+  CachableEntry<ParsedFullFilterBlock> filter_block;
+  Status s = GetOrReadFilterBlock(false /* no_io */, nullptr /* get_context */,
+                                  &lookup_context, &filter_block, ro);
+  if (!s.ok()) {
+    return s;
+  }
+  assert(filter_block.GetValue());
+  // The only filter covers all keys
+  filters->Add(Slice(), filter_block.GetValue()->ContentSlice(),
+               table()->get_rep()->filter_policy);
+  return Status::OK();
+}
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -134,6 +134,8 @@ class FullFilterBlockReader
                         const ReadOptions& read_options) override;
   size_t ApproximateMemoryUsage() const override;
 
+  Status CopyFilters(const ReadOptions& ro, PinnedFilters* filters) override;
+
  private:
   bool MayMatch(const Slice& entry, bool no_io, GetContext* get_context,
                 BlockCacheLookupContext* lookup_context,
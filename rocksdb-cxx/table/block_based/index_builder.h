@@ -19,6 +19,7 @@
 #include "rocksdb/comparator.h"
 #include "table/block_based/block_based_table_factory.h"
 #include "table/block_based/block_builder.h"
+#include "table/block_based/learned_index.h"
 #include "table/format.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -364,6 +365,72 @@ class HashIndexBuilder : public IndexBuilder {
   uint64_t current_restart_index_ = 0;
 };
 
+// LearnedIndexBuilder contains a binary-searchable primary index and a
+// piecewise linear model of the positions of its restart keys (see
+// learned_index.h), stored in a metablock. The model is only built for the
+// bytewise comparator; without it, readers fall back to binary search.
+class LearnedIndexBuilder : public IndexBuilder {
+ public:
+  explicit LearnedIndexBuilder(
+      const InternalKeyComparator* comparator,
+      int index_block_restart_interval, int format_version,
+      bool use_value_delta_encoding,
+      BlockBasedTableOptions::IndexShorteningMode shortening_mode,
+      uint32_t max_error)
+      : IndexBuilder(comparator),
+        primary_index_builder_(comparator, index_block_restart_interval,
+                               format_version, use_value_delta_encoding,
+                               shortening_mode, /* include_first_key */ false),
+        index_block_restart_interval_(index_block_restart_interval),
+        model_builder_(max_error) {
+    const Comparator* ucmp = comparator->user_comparator();
+    build_model_ = ucmp->timestamp_size() == 0 &&
+                   Slice(ucmp->Name()) == Slice(BytewiseComparator()->Name());
+  }
+
+  virtual void AddIndexEntry(std::string* last_key_in_current_block,
+                             const Slice* first_key_in_next_block,
+                             const BlockHandle& block_handle) override {
+    primary_index_builder_.AddIndexEntry(last_key_in_current_block,
+                                         first_key_in_next_block, block_handle);
+    // The separator is final now. Only restart keys are modeled.
+    if (build_model_ && num_entries_ % index_block_restart_interval_ == 0) {
+      model_builder_.Add(
+          LearnedIndexKey(ExtractUserKey(*last_key_in_current_block)));
+    }
+    ++num_entries_;
+  }
+
+  virtual Status Finish(
+      IndexBlocks* index_blocks,
+      const BlockHandle& last_partition_block_handle) override {
+    Status s = primary_index_builder_.Finish(index_blocks,
+                                             last_partition_block_handle);
+    if (build_model_) {
+      model_builder_.Finish(&model_block_);
+      index_blocks->meta_blocks.insert(
+          {kLearnedIndexModelBlock.c_str(), model_block_});
+    }
+    return s;
+  }
+
+  virtual size_t IndexSize() const override {
+    return primary_index_builder_.IndexSize() + model_block_.size();
+  }
+
+  virtual bool seperator_is_key_plus_seq() override {
+    return primary_index_builder_.seperator_is_key_plus_seq();
+  }
+
+ private:
+  ShortenedIndexBuilder primary_index_builder_;
+  const int index_block_restart_interval_;
+  bool build_model_;
+  uint64_t num_entries_ = 0;
+  LearnedIndexModelBuilder model_builder_;
+  std::string model_block_;
+};
+
 /**
  * IndexBuilder for two-level indexing. Internally it creates a new index for
  * each partition and Finish then in order when Finish is called on it
@@ -0,0 +1,169 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/learned_index.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#include "util/coding.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+constexpr size_t kModelHeaderSize = 3 * sizeof(uint32_t);
+constexpr size_t kSegmentSize =
+    sizeof(uint64_t) + sizeof(uint32_t) + sizeof(uint64_t);
+}  // namespace
+
+void LearnedIndexModelBuilder::StartSegment(uint64_t key) {
+  first_key_ = key;
+  first_pos_ = num_keys_;
+  slope_lo_ = 0;
+  slope_hi_ = std::numeric_limits<double>::infinity();
+}
+
+void LearnedIndexModelBuilder::CloseSegment() {
+  double slope =
+      std::isinf(slope_hi_) ? slope_lo_ : (slope_lo_ + slope_hi_) / 2;
+  segments_.push_back({first_key_, first_pos_, slope});
+}
+
+void LearnedIndexModelBuilder::Add(uint64_t key) {
+  if (num_keys_ == 0) {
+    StartSegment(key);
+  } else {
+    assert(key >= first_key_);
+    const double pos_delta = static_cast<double>(num_keys_ - first_pos_);
+    bool fits;
+    if (key == first_key_) {
+      // Predicted at first_pos_ whatever the slope
+      fits = pos_delta <= max_error_;
+    } else {
+      const double key_delta = static_cast<double>(key - first_key_);
+      double lo = std::max(slope_lo_, (pos_delta - max_error_) / key_delta);
+      double hi = std::min(slope_hi_, (pos_delta + max_error_) / key_delta);
+      fits = lo <= hi;
+      if (fits) {
+        slope_lo_ = lo;
+        slope_hi_ = hi;
+      }
+    }
+    if (!fits) {
+      CloseSegment();
+      StartSegment(key);
+    }
+  }
+  ++num_keys_;
+}
+
+void LearnedIndexModelBuilder::Finish(std::string* contents) {
+  if (num_keys_ > 0) {
+    CloseSegment();
+  }
+  contents->clear();
+  contents->reserve(kModelHeaderSize + segments_.size() * kSegmentSize);
+  PutFixed32(contents, max_error_);
+  PutFixed32(contents, num_keys_);
+  PutFixed32(contents, static_cast<uint32_t>(segments_.size()));
+  for (const Segment& segment : segments_) {
+    PutFixed64(contents, segment.first_key);
+    PutFixed32(contents, segment.first_pos);
+    uint64_t slope_bits;
+    static_assert(sizeof(slope_bits) == sizeof(segment.slope), "");
+    memcpy(&slope_bits, &segment.slope, sizeof(slope_bits));
+    PutFixed64(contents, slope_bits);
+  }
+}
+
+void LearnedIndexModelBuilder::Reset() {
+  num_keys_ = 0;
+  segments_.clear();
+}
+
+Status LearnedIndexModel::Create(const Slice& contents,
+                                 std::unique_ptr<LearnedIndexModel>* model) {
+  if (contents.size() < kModelHeaderSize) {
+    return Status::Corruption("Learned index model too short");
+  }
+  const char* p = contents.data();
+  std::unique_ptr<LearnedIndexModel> m(new LearnedIndexModel());
+  m->max_error_ = DecodeFixed32(p);
+  m->num_keys_ = DecodeFixed32(p + sizeof(uint32_t));
+  uint32_t num_segments = DecodeFixed32(p + 2 * sizeof(uint32_t));
+  if (contents.size() !=
+      kModelHeaderSize + static_cast<size_t>(num_segments) * kSegmentSize) {
+    return Status::Corruption("Learned index model has wrong size");
+  }
+  if ((num_segments == 0) != (m->num_keys_ == 0)) {
+    return Status::Corruption("Learned index model has no segments");
+  }
+  m->first_keys_.reserve(num_segments);
+  m->first_positions_.reserve(num_segments);
+  m->slopes_.reserve(num_segments);
+  p += kModelHeaderSize;
+  for (uint32_t i = 0; i < num_segments; ++i, p += kSegmentSize) {
+    uint64_t first_key = DecodeFixed64(p);
+    uint32_t first_pos = DecodeFixed32(p + sizeof(uint64_t));
+    uint64_t slope_bits =
+        DecodeFixed64(p + sizeof(uint64_t) + sizeof(uint32_t));
+    double slope;
+    memcpy(&slope, &slope_bits, sizeof(slope));
+    if (first_pos >= m->num_keys_ ||
+        (i == 0 ? first_pos != 0
+                : first_pos <= m->first_positions_.back() ||
+                      first_key < m->first_keys_.back()) ||
+        !(slope >= 0) || std::isinf(slope)) {
+      return Status::Corruption("Bad learned index model segment");
+    }
+    m->first_keys_.push_back(first_key);
+    m->first_positions_.push_back(first_pos);
+    m->slopes_.push_back(slope);
+  }
+  *model = std::move(m);
+  return Status::OK();
+}
+
+void LearnedIndexModel::Predict(uint64_t key, uint32_t* lo,
+                                uint32_t* hi) const {
+  assert(num_keys_ > 0);
+  // The last segment starting at or before `key`
+  size_t segment = static_cast<size_t>(
+      std::upper_bound(first_keys_.begin(), first_keys_.end(), key) -
+      first_keys_.begin());
+  if (segment == 0) {
+    // Before the first key
+    *lo = 0;
+    *hi = 0;
+    return;
+  }
+  --segment;
+  // Past its last point, a segment keeps predicting up to where the next one
+  // starts
+  const double max_pos = segment + 1 < first_positions_.size()
+                             ? first_positions_[segment + 1]
+                             : num_keys_ - 1;
+  double pos = first_positions_[segment] +
+               slopes_[segment] *
+                   static_cast<double>(key - first_keys_[segment]);
+  pos = std::min(pos, max_pos);
+  // A key between the keys of positions i and i + 1 is predicted within
+  // [i - max_error, i + 1 + max_error]
+  const double lo_pos = std::floor(pos) - max_error_ - 1;
+  const double hi_pos = std::ceil(pos) + max_error_;
+  *lo = lo_pos <= 0 ? 0 : static_cast<uint32_t>(lo_pos);
+  *hi = hi_pos >= num_keys_ - 1 ? num_keys_ - 1
+                                 : static_cast<uint32_t>(hi_pos);
+}
+
+size_t LearnedIndexModel::ApproximateMemoryUsage() const {
+  return sizeof(*this) + first_keys_.capacity() * sizeof(uint64_t) +
+         first_positions_.capacity() * sizeof(uint32_t) +
+         slopes_.capacity() * sizeof(double);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,122 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+#include "util/math.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A learned index (BlockBasedTableOptions::kLearnedIndexSearch) is a
+// piecewise linear model of the position of each restart key in the index
+// block, in the spirit of the PGM-index. The model is stored in its own meta
+// block next to a regular binary search index block. Index seeks use it to
+// predict a small window of restart points to binary search in, rather than
+// binary searching over all of them, which takes fewer key comparisons and
+// touches fewer cache lines. Predictions are verified against the restart
+// keys bordering the window, so a bad model (or an unusual key) only costs
+// extra comparisons, never a wrong result.
+//
+// The model treats the first 8 bytes of a user key, zero padded, as a
+// big-endian integer. That preserves order for the bytewise comparator and
+// works best for integer-like keys that are close to uniformly distributed.
+
+inline uint64_t LearnedIndexKey(const Slice& user_key) {
+  uint64_t v = 0;
+  memcpy(&v, user_key.data(),
+         user_key.size() < sizeof(v) ? user_key.size() : sizeof(v));
+  if (port::kLittleEndian) {
+    v = EndianSwapValue(v);
+  }
+  return v;
+}
+
+// Fits segments to (key, position) points with the greedy "shrinking cone"
+// algorithm: each segment grows until no line through its first point
+// predicts all of its points' positions within max_error.
+//
+// Serialized format:
+//   max_error: fixed32
+//   num_keys: fixed32
+//   num_segments: fixed32
+//   segments: (first_key: fixed64, first_pos: fixed32,
+//              slope: fixed64 (IEEE 754 double bits))[num_segments]
+class LearnedIndexModelBuilder {
+ public:
+  explicit LearnedIndexModelBuilder(uint32_t max_error)
+      : max_error_(max_error) {}
+
+  // Adds the key of the next position. Keys must be added in non-decreasing
+  // order.
+  void Add(uint64_t key);
+
+  // REQUIRES: Finish() has not been called since the last Reset().
+  void Finish(std::string* contents);
+
+  void Reset();
+
+  // The segments closed so far, which includes the last one once Finish()
+  // was called
+  size_t NumSegments() const { return segments_.size(); }
+
+ private:
+  struct Segment {
+    uint64_t first_key;
+    uint32_t first_pos;
+    double slope;
+  };
+
+  void StartSegment(uint64_t key);
+  void CloseSegment();
+
+  const uint32_t max_error_;
+  uint32_t num_keys_ = 0;
+  std::vector<Segment> segments_;
+  // State of the open segment, if num_keys_ > 0
+  uint64_t first_key_ = 0;
+  uint32_t first_pos_ = 0;
+  double slope_lo_ = 0;
+  double slope_hi_ = 0;
+};
+
+// The reader side of LearnedIndexModelBuilder.
+class LearnedIndexModel {
+ public:
+  static Status Create(const Slice& contents,
+                       std::unique_ptr<LearnedIndexModel>* model);
+
+  // Sets [*lo, *hi] to the positions within which the last position with a
+  // key less than or equal to `key` lies, if the model is accurate for `key`.
+  // The bounds are clamped to [0, num_keys() - 1].
+  void Predict(uint64_t key, uint32_t* lo, uint32_t* hi) const;
+
+  uint32_t num_keys() const { return num_keys_; }
+  uint32_t max_error() const { return max_error_; }
+  size_t NumSegments() const { return first_keys_.size(); }
+
+  size_t ApproximateMemoryUsage() const;
+
+ private:
+  LearnedIndexModel() = default;
+
+  uint32_t max_error_ = 0;
+  uint32_t num_keys_ = 0;
+  // One entry per segment, kept apart so that finding the segment only
+  // touches first_keys_
+  std::vector<uint64_t> first_keys_;
+  std::vector<uint32_t> first_positions_;
+  std::vector<double> slopes_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
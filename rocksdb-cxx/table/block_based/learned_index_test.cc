@@ -0,0 +1,243 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/learned_index.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "db/dbformat.h"
+#include "rocksdb/comparator.h"
+#include "table/block_based/block.h"
+#include "table/block_based/block_builder.h"
+#include "table/format.h"
+#include "test_util/testharness.h"
+#include "test_util/testutil.h"
+#include "util/coding.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+std::unique_ptr<LearnedIndexModel> BuildModel(
+    const std::vector<uint64_t>& keys, uint32_t max_error,
+    size_t* num_segments = nullptr) {
+  LearnedIndexModelBuilder builder(max_error);
+  for (uint64_t key : keys) {
+    builder.Add(key);
+  }
+  std::string contents;
+  builder.Finish(&contents);
+  if (num_segments) {
+    *num_segments = builder.NumSegments();
+  }
+  std::unique_ptr<LearnedIndexModel> model;
+  EXPECT_OK(LearnedIndexModel::Create(contents, &model));
+  return model;
+}
+
+// Checks that the last position with a key <= `key` (or 0 if there is none)
+// is within the predicted window
+void CheckPrediction(const LearnedIndexModel& model,
+                     const std::vector<uint64_t>& keys, uint64_t key) {
+  size_t expected =
+      std::upper_bound(keys.begin(), keys.end(), key) - keys.begin();
+  expected = expected == 0 ? 0 : expected - 1;
+  uint32_t lo, hi;
+  model.Predict(key, &lo, &hi);
+  ASSERT_LE(lo, expected) << key;
+  ASSERT_GE(hi, expected) << key;
+  ASSERT_LT(hi, keys.size());
+  // The window stays small
+  ASSERT_LE(hi - lo, 2 * model.max_error() + 2);
+}
+}  // namespace
+
+class LearnedIndexTest : public testing::Test {};
+
+TEST_F(LearnedIndexTest, LearnedIndexKey) {
+  ASSERT_EQ(0, LearnedIndexKey(""));
+  ASSERT_EQ(uint64_t{0x0100000000000000}, LearnedIndexKey("\x01"));
+  ASSERT_EQ(uint64_t{0x0102030405060708},
+            LearnedIndexKey("\x01\x02\x03\x04\x05\x06\x07\x08\x09"));
+  ASSERT_LT(LearnedIndexKey("abc"), LearnedIndexKey("abd"));
+  ASSERT_LT(LearnedIndexKey("ab"), LearnedIndexKey("ab\x01"));
+}
+
+TEST_F(LearnedIndexTest, LinearKeys) {
+  std::vector<uint64_t> keys;
+  for (uint64_t i = 0; i < 1000; ++i) {
+    keys.push_back(1000 + i * 37);
+  }
+  size_t num_segments = 0;
+  auto model = BuildModel(keys, 0, &num_segments);
+  ASSERT_EQ(1, num_segments);
+  ASSERT_EQ(1, model->NumSegments());
+  ASSERT_EQ(keys.size(), model->num_keys());
+  for (uint64_t key = 0; key < keys.back() + 100; ++key) {
+    CheckPrediction(*model, keys, key);
+  }
+}
+
+TEST_F(LearnedIndexTest, RandomKeys) {
+  Random64 rnd(301);
+  for (uint32_t max_error : {0, 1, 8, 64}) {
+    std::vector<uint64_t> keys;
+    for (int i = 0; i < 5000; ++i) {
+      // Skewed, with some duplicates
+      uint64_t key = rnd.Next() >> (rnd.Uniform(4) * 16);
+      keys.push_back(key);
+      if (rnd.OneIn(10)) {
+        keys.push_back(key);
+      }
+    }
+    keys.push_back(0);
+    keys.push_back(std::numeric_limits<uint64_t>::max());
+    std::sort(keys.begin(), keys.end());
+    size_t num_segments = 0;
+    auto model = BuildModel(keys, max_error, &num_segments);
+    ASSERT_EQ(num_segments, model->NumSegments());
+    if (max_error > 0) {
+      ASSERT_LT(num_segments, keys.size() / 2);
+    }
+    for (uint64_t key : keys) {
+      CheckPrediction(*model, keys, key);
+      CheckPrediction(*model, keys, key + 1);
+      CheckPrediction(*model, keys, key - 1);
+    }
+    for (int i = 0; i < 10000; ++i) {
+      CheckPrediction(*model, keys, rnd.Next());
+    }
+  }
+}
+
+TEST_F(LearnedIndexTest, Empty) {
+  LearnedIndexModelBuilder builder(8);
+  std::string contents;
+  builder.Finish(&contents);
+  std::unique_ptr<LearnedIndexModel> model;
+  ASSERT_OK(LearnedIndexModel::Create(contents, &model));
+  ASSERT_EQ(0, model->num_keys());
+  ASSERT_EQ(0, model->NumSegments());
+}
+
+TEST_F(LearnedIndexTest, Corruption) {
+  LearnedIndexModelBuilder builder(4);
+  for (uint64_t i = 0; i < 100; ++i) {
+    builder.Add(i * i * i);
+  }
+  std::string contents;
+  builder.Finish(&contents);
+  ASSERT_GT(builder.NumSegments(), 1);
+  std::unique_ptr<LearnedIndexModel> model;
+  ASSERT_OK(LearnedIndexModel::Create(contents, &model));
+
+  // Truncated
+  for (size_t len : {size_t{0}, size_t{5}, contents.size() - 1}) {
+    ASSERT_TRUE(LearnedIndexModel::Create(Slice(contents.data(), len), &model)
+                    .IsCorruption());
+  }
+  // Segment positions out of order
+  std::string bad = contents;
+  constexpr size_t kSecondSegmentPos = 12 + 20 + 8;
+  EncodeFixed32(&bad[kSecondSegmentPos], 0);
+  ASSERT_TRUE(LearnedIndexModel::Create(bad, &model).IsCorruption());
+  // Position out of range
+  bad = contents;
+  EncodeFixed32(&bad[kSecondSegmentPos], 100);
+  ASSERT_TRUE(LearnedIndexModel::Create(bad, &model).IsCorruption());
+  // Negative slope
+  bad = contents;
+  uint64_t slope_bits;
+  double slope = -1.0;
+  memcpy(&slope_bits, &slope, sizeof(slope));
+  EncodeFixed64(&bad[12 + 8 + 4], slope_bits);
+  ASSERT_TRUE(LearnedIndexModel::Create(bad, &model).IsCorruption());
+}
+
+// Seeks in an index block with a model must find the same entries as without
+// one, including when the model does not describe the block's keys at all.
+TEST_F(LearnedIndexTest, IndexBlockSeek) {
+  Random rnd(302);
+  std::set<std::string> user_keys;
+  while (user_keys.size() < 1000) {
+    std::string key = rnd.RandomString(rnd.Uniform(12));
+    if (rnd.OneIn(2)) {
+      // Bias towards a shared prefix so that some keys are not told apart by
+      // their first 8 bytes
+      key = "prefix" + key;
+    }
+    user_keys.insert(key);
+  }
+  std::vector<std::string> keys;
+  for (const std::string& user_key : user_keys) {
+    keys.push_back(InternalKey(user_key, 1, kTypeValue).Encode().ToString());
+  }
+
+  for (int restart_interval : {1, 4}) {
+    BlockBuilder builder(restart_interval);
+    std::vector<uint64_t> model_keys;
+    std::vector<uint64_t> wrong_keys;
+    for (size_t i = 0; i < keys.size(); ++i) {
+      std::string value;
+      BlockHandle(i * 100, 100).EncodeTo(&value);
+      builder.Add(keys[i], value);
+      if (i % restart_interval == 0) {
+        model_keys.push_back(LearnedIndexKey(ExtractUserKey(keys[i])));
+        wrong_keys.push_back(wrong_keys.size() * 1000);
+      }
+    }
+    BlockContents contents;
+    contents.data = builder.Finish();
+    Block block(std::move(contents));
+
+    std::vector<std::unique_ptr<LearnedIndexModel>> models;
+    models.push_back(BuildModel(model_keys, 0));
+    models.push_back(BuildModel(model_keys, 8));
+    models.push_back(BuildModel(wrong_keys, 2));
+
+    std::unique_ptr<IndexBlockIter> expected_iter(block.NewIndexIterator(
+        BytewiseComparator(), kDisableGlobalSequenceNumber, nullptr, nullptr,
+        true /* total_order_seek */, false /* have_first_key */,
+        true /* key_includes_seq */, true /* value_is_full */));
+    for (const auto& model : models) {
+      std::unique_ptr<IndexBlockIter> iter(block.NewIndexIterator(
+          BytewiseComparator(), kDisableGlobalSequenceNumber, nullptr, nullptr,
+          true /* total_order_seek */, false /* have_first_key */,
+          true /* key_includes_seq */, true /* value_is_full */,
+          false /* block_contents_pinned */, nullptr /* prefix_index */,
+          model.get()));
+      std::vector<std::string> targets(keys);
+      for (int i = 0; i < 1000; ++i) {
+        std::string user_key = rnd.RandomString(rnd.Uniform(14));
+        InternalKey ikey(user_key, rnd.Uniform(3), kTypeValue);
+        targets.push_back(ikey.Encode().ToString());
+      }
+      for (const std::string& target : targets) {
+        expected_iter->Seek(target);
+        iter->Seek(target);
+        ASSERT_OK(iter->status());
+        ASSERT_EQ(expected_iter->Valid(), iter->Valid());
+        if (iter->Valid()) {
+          ASSERT_EQ(expected_iter->key(), iter->key());
+          ASSERT_EQ(expected_iter->value().handle.offset(),
+                    iter->value().handle.offset());
+        }
+      }
+    }
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
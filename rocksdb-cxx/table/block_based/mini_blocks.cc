@@ -0,0 +1,141 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/mini_blocks.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "table/format.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+Status ParseMiniBlocks(const Slice& block,
+                       std::vector<MiniBlockHandle>* mini_blocks,
+                       Slice* tail) {
+  mini_blocks->clear();
+  if (block.size() < kMiniBlocksFooterSize) {
+    return Status::Corruption("Block with mini-blocks too small");
+  }
+  const char* footer = block.data() + block.size() - kMiniBlocksFooterSize;
+  uint32_t index_size = DecodeFixed32(footer);
+  uint32_t tail_size = DecodeFixed32(footer + sizeof(uint32_t));
+  uint32_t num_mini_blocks = DecodeFixed32(footer + 2 * sizeof(uint32_t));
+  size_t sections_size = block.size() - kMiniBlocksFooterSize;
+  if (index_size > sections_size ||
+      tail_size > sections_size - index_size) {
+    return Status::Corruption("Bad mini-block index in block");
+  }
+  size_t mini_blocks_size = sections_size - index_size - tail_size;
+  Slice index(block.data() + sections_size - index_size, index_size);
+  *tail = Slice(block.data() + mini_blocks_size, tail_size);
+
+  // Each handle takes at least 5 bytes
+  if (num_mini_blocks > index_size / 5) {
+    return Status::Corruption("Bad mini-block index in block");
+  }
+  mini_blocks->resize(num_mini_blocks);
+  size_t stored_offset = 0;
+  for (uint32_t i = 0; i < num_mini_blocks; ++i) {
+    MiniBlockHandle& handle = (*mini_blocks)[i];
+    uint32_t stored_size = 0;
+    if (!GetVarint32(&index, &handle.first_restart) ||
+        !GetVarint32(&index, &stored_size) ||
+        !GetVarint32(&index, &handle.uncompressed_size) || index.empty()) {
+      return Status::Corruption("Bad mini-block index in block");
+    }
+    handle.compression_type = static_cast<CompressionType>(index[0]);
+    index.remove_prefix(1);
+    // Mini-blocks start at increasing restart points, the first at the first
+    bool restart_ok =
+        i == 0 ? handle.first_restart == 0
+               : handle.first_restart > (*mini_blocks)[i - 1].first_restart;
+    if (!GetLengthPrefixedSlice(&index, &handle.first_key) || !restart_ok ||
+        stored_size > mini_blocks_size - stored_offset ||
+        (handle.compression_type == kNoCompression &&
+         handle.uncompressed_size != stored_size)) {
+      return Status::Corruption("Bad mini-block index in block");
+    }
+    handle.contents = Slice(block.data() + stored_offset, stored_size);
+    stored_offset += stored_size;
+  }
+  if (stored_offset != mini_blocks_size || !index.empty()) {
+    return Status::Corruption("Bad mini-block index in block");
+  }
+  return Status::OK();
+}
+
+Status UncompressMiniBlock(const Slice& contents, CompressionType type,
+                           CacheAllocationPtr* out, size_t* out_size) {
+  UncompressionContext context(type);
+  UncompressionInfo info(context, UncompressionDict::GetEmptyDict(), type);
+  *out = UncompressData(info, contents.data(), contents.size(), out_size,
+                        GetCompressFormatForVersion(kMiniBlockFormatVersion));
+  if (!*out) {
+    return Status::Corruption("Could not decompress mini-block: " +
+                              CompressionTypeToString(type));
+  }
+  return Status::OK();
+}
+
+Status MiniBlocks::Initialize(const Slice& block) {
+  Slice tail;
+  Status s = ParseMiniBlocks(block, &mini_blocks_, &tail);
+  if (!s.ok()) {
+    return s;
+  }
+  offsets_.resize(mini_blocks_.size() + 1);
+  uint64_t offset = 0;
+  for (size_t i = 0; i < mini_blocks_.size(); ++i) {
+    offsets_[i] = static_cast<uint32_t>(offset);
+    offset += mini_blocks_[i].uncompressed_size;
+    if (offset + tail.size() > std::numeric_limits<uint32_t>::max()) {
+      return Status::Corruption("Bad mini-block index in block");
+    }
+  }
+  offsets_[mini_blocks_.size()] = static_cast<uint32_t>(offset);
+  size_ = static_cast<size_t>(offset) + tail.size();
+  data_.reset(new char[size_]);
+  memcpy(data_.get() + offset, tail.data(), tail.size());
+  once_.reset(new std::once_flag[mini_blocks_.size()]);
+  status_.resize(mini_blocks_.size());
+  return Status::OK();
+}
+
+size_t MiniBlocks::Find(uint32_t offset) const {
+  assert(!mini_blocks_.empty());
+  assert(offset < offsets_.back());
+  // The last mini-block starting at or before `offset`
+  auto it = std::upper_bound(offsets_.begin(), offsets_.end() - 1, offset);
+  return static_cast<size_t>(it - offsets_.begin()) - 1;
+}
+
+Status MiniBlocks::Decompress(size_t i) {
+  assert(i < mini_blocks_.size());
+  std::call_once(once_[i], [this, i]() {
+    const MiniBlockHandle& handle = mini_blocks_[i];
+    char* dest = data_.get() + offsets_[i];
+    if (handle.compression_type == kNoCompression) {
+      memcpy(dest, handle.contents.data(), handle.contents.size());
+    } else {
+      CacheAllocationPtr uncompressed;
+      size_t size = 0;
+      status_[i] = UncompressMiniBlock(handle.contents, handle.compression_type,
+                                       &uncompressed, &size);
+      if (status_[i].ok() && size != handle.uncompressed_size) {
+        status_[i] = Status::Corruption("Bad mini-block size in block");
+      }
+      if (!status_[i].ok()) {
+        return;
+      }
+      memcpy(dest, uncompressed.get(), size);
+    }
+    num_decompressed_.fetch_add(1, std::memory_order_release);
+  });
+  return status_[i];
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,147 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+// Layout of data blocks made of mini-blocks (see
+// BlockBasedTableOptions::data_block_mini_block_restarts).
+//
+// Such a block is a regular data block (see block_builder.cc) whose entries
+// are cut into mini-blocks of a number of whole restart intervals, each
+// compressed on its own, followed by an index of the mini-blocks:
+//
+//    mini_blocks: char[...]
+//    tail: char[tail_size]
+//    index: for each mini-block:
+//      first_restart: varint32       (index of its first restart point)
+//      stored_size: varint32
+//      uncompressed_size: varint32
+//      compression_type: uint8
+//      first_key_size: varint32
+//      first_key: char[first_key_size]
+//    index_size: fixed32
+//    tail_size: fixed32
+//    num_mini_blocks: fixed32
+//
+// The tail is the rest of the regular block after its entries (restart
+// array, ..., block footer), and is never compressed. Uncompressed, the
+// mini-blocks followed by the tail are thus the regular block, which a reader
+// can rebuild one mini-block at a time: a point lookup only decompresses the
+// mini-block that holds its key. The block itself is always stored with
+// kNoCompression in its block trailer.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "rocksdb/compression_type.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+#include "util/coding.h"
+#include "util/compression.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+constexpr size_t kMiniBlocksFooterSize = 3 * sizeof(uint32_t);
+
+// Mini-blocks are compressed like blocks of format_version 2 and later,
+// regardless of the format_version of the table.
+constexpr uint32_t kMiniBlockFormatVersion = 2;
+
+struct MiniBlockHandle {
+  uint32_t first_restart = 0;
+  uint32_t uncompressed_size = 0;
+  CompressionType compression_type = kNoCompression;
+  Slice first_key;
+  // The mini-block as stored
+  Slice contents;
+};
+
+inline void AppendMiniBlockHandle(std::string* index, uint32_t first_restart,
+                                  size_t stored_size, size_t uncompressed_size,
+                                  CompressionType compression_type,
+                                  const Slice& first_key) {
+  PutVarint32Varint32Varint32(index, first_restart,
+                              static_cast<uint32_t>(stored_size),
+                              static_cast<uint32_t>(uncompressed_size));
+  index->push_back(static_cast<char>(compression_type));
+  PutLengthPrefixedSlice(index, first_key);
+}
+
+// Appends the footer to `block`, which ends with the tail of size `tail_size`
+// followed by the index of size `index_size`.
+inline void AppendMiniBlocksFooter(std::string* block, size_t index_size,
+                                   size_t tail_size, size_t num_mini_blocks) {
+  PutFixed32(block, static_cast<uint32_t>(index_size));
+  PutFixed32(block, static_cast<uint32_t>(tail_size));
+  PutFixed32(block, static_cast<uint32_t>(num_mini_blocks));
+}
+
+// Decodes the mini-block handles and the tail of `block`
+Status ParseMiniBlocks(const Slice& block,
+                       std::vector<MiniBlockHandle>* mini_blocks, Slice* tail);
+
+// Decompresses a mini-block into `*out`.
+Status UncompressMiniBlock(const Slice& contents, CompressionType type,
+                           CacheAllocationPtr* out, size_t* out_size);
+
+// The regular data block rebuilt from a block made of mini-blocks, whose
+// mini-blocks are only decompressed into place when first needed. The block
+// must outlive this object. Thread-safe.
+class MiniBlocks {
+ public:
+  Status Initialize(const Slice& block);
+
+  // The regular data block, of which only the tail and the decompressed
+  // mini-blocks can be read
+  const char* data() const { return data_.get(); }
+  size_t size() const { return size_; }
+
+  size_t num_mini_blocks() const { return mini_blocks_.size(); }
+  // The first key and the index of the first restart point of a mini-block
+  const Slice& first_key(size_t i) const { return mini_blocks_[i].first_key; }
+  uint32_t first_restart(size_t i) const {
+    return mini_blocks_[i].first_restart;
+  }
+  // The range of offsets in data() of a mini-block
+  uint32_t offset(size_t i) const { return offsets_[i]; }
+  uint32_t limit(size_t i) const { return offsets_[i + 1]; }
+
+  // Returns the mini-block holding the entry at `offset`, which must be
+  // less than the offset of the tail
+  size_t Find(uint32_t offset) const;
+
+  // Makes sure mini-block `i` is decompressed into data()
+  Status Decompress(size_t i);
+
+  bool all_decompressed() const {
+    return num_decompressed_.load(std::memory_order_acquire) ==
+           mini_blocks_.size();
+  }
+
+  // All of data(), whether or not the mini-blocks have been decompressed yet,
+  // so that the charge of the block stays the same
+  size_t ApproximateMemoryUsage() const {
+    return size_ + mini_blocks_.size() * (sizeof(MiniBlockHandle) +
+                                          sizeof(uint32_t) +
+                                          sizeof(std::once_flag));
+  }
+
+ private:
+  std::vector<MiniBlockHandle> mini_blocks_;
+  // offsets_[i] is the offset of mini-block i in data_, and
+  // offsets_[num_mini_blocks()] that of the tail
+  std::vector<uint32_t> offsets_;
+  std::unique_ptr<char[]> data_;
+  size_t size_ = 0;
+  std::unique_ptr<std::once_flag[]> once_;
+  std::vector<Status> status_;
+  std::atomic<size_t> num_decompressed_{0};
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -17,6 +17,7 @@
 #include "rocksdb/filter_policy.h"
 #include "table/block_based/block.h"
 #include "table/block_based/block_based_table_reader.h"
+#include "table/pinned_filters.h"
 #include "util/coding.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -26,7 +27,8 @@ PartitionedFilterBlockBuilder::PartitionedFilterBlockBuilder(
     FilterBitsBuilder* filter_bits_builder, int index_block_restart_interval,
     const bool use_value_delta_encoding,
     PartitionedIndexBuilder* const p_index_builder,
-    const uint32_t partition_size)
+    const uint32_t partition_size, Env* env, int num_threads,
+    std::function<FilterBitsBuilder*()> new_filter_bits_builder)
     : FullFilterBlockBuilder(_prefix_extractor, whole_key_filtering,
                              filter_bits_builder),
       index_on_filter_block_builder_(index_block_restart_interval,
@@ -37,7 +39,13 @@ PartitionedFilterBlockBuilder::PartitionedFilterBlockBuilder(
                                                  use_value_delta_encoding),
       p_index_builder_(p_index_builder),
       keys_added_to_partition_(0),
-      total_added_in_built_(0) {
+      total_added_in_built_(0),
+      new_filter_bits_builder_(std::move(new_filter_bits_builder)),
+      env_(env),
+      max_unfinished_filters_(
+          new_filter_bits_builder_ && env_ != nullptr && num_threads > 0
+              ? static_cast<size_t>(num_threads)
+              : 0) {
   keys_per_partition_ = static_cast<uint32_t>(
       filter_bits_builder_->ApproximateNumEntries(partition_size));
   if (keys_per_partition_ < 1) {
@@ -60,12 +68,61 @@ PartitionedFilterBlockBuilder::PartitionedFilterBlockBuilder(
       }
     }
   }
+  if (max_unfinished_filters_ > 0) {
+    env_->IncBackgroundThreadsIfNeeded(num_threads, Env::Priority::USER);
+  }
 }
 
 PartitionedFilterBlockBuilder::~PartitionedFilterBlockBuilder() {
+  WaitForFilters();
+  for (auto& entry : filters) {
+    entry.status.PermitUncheckedError();
+  }
   partitioned_filters_construction_status_.PermitUncheckedError();
 }
 
+void PartitionedFilterBlockBuilder::FinishFilterJob(void* arg) {
+  static_cast<PartitionedFilterBlockBuilder*>(arg)->FinishFilter();
+}
+
+void PartitionedFilterBlockBuilder::FinishFilter() {
+  FilterEntry* entry;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    assert(!pending_filters_.empty());
+    entry = pending_filters_.front();
+    pending_filters_.pop_front();
+  }
+  // `filters` only grows at the back until all filters are finished, so
+  // the entry stays valid and is not accessed by the table builder thread.
+  // The entry keeps the builder, which holds the cache reservation for the
+  // filter, until the builder of the table is done with it.
+  Status s;
+  entry->filter = entry->builder->Finish(&entry->filter_data, &s);
+  if (s.ok()) {
+    s = entry->builder->MaybePostVerify(entry->filter);
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entry->status = s;
+    --num_unfinished_filters_;
+  }
+  cv_.notify_all();
+}
+
+void PartitionedFilterBlockBuilder::WaitForFilters() {
+  if (max_unfinished_filters_ == 0) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [this]() { return num_unfinished_filters_ == 0; });
+  for (auto& entry : filters) {
+    if (!entry.status.ok() && partitioned_filters_construction_status_.ok()) {
+      partitioned_filters_construction_status_ = entry.status;
+    }
+  }
+}
+
 void PartitionedFilterBlockBuilder::MaybeCutAFilterBlock(
     const Slice* next_key) {
   // Use == to send the request only once
@@ -91,6 +148,30 @@ void PartitionedFilterBlockBuilder::MaybeCutAFilterBlock(
   }
 
   total_added_in_built_ += filter_bits_builder_->EstimateEntriesAdded();
+  std::string& index_key = p_index_builder_->GetPartitionKey();
+  if (max_unfinished_filters_ > 0) {
+    // Hand the partition over to the Env's USER pool and continue with a new
+    // builder. Wait first if enough partitions are unfinished, so that the
+    // memory held by them is bounded.
+    std::unique_ptr<FilterBitsBuilder> next(new_filter_bits_builder_());
+    assert(next != nullptr);
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() {
+        return num_unfinished_filters_ < max_unfinished_filters_;
+      });
+      filters.push_back({index_key, nullptr, Slice(),
+                         std::move(filter_bits_builder_), Status::OK()});
+      pending_filters_.push_back(&filters.back());
+      ++num_unfinished_filters_;
+    }
+    env_->Schedule(&PartitionedFilterBlockBuilder::FinishFilterJob, this,
+                   Env::Priority::USER);
+    filter_bits_builder_ = std::move(next);
+    keys_added_to_partition_ = 0;
+    Reset();
+    return;
+  }
   std::unique_ptr<const char[]> filter_data;
   Status filter_construction_status = Status::OK();
   Slice filter =
@@ -98,8 +179,8 @@ void PartitionedFilterBlockBuilder::MaybeCutAFilterBlock(
   if (filter_construction_status.ok()) {
     filter_construction_status = filter_bits_builder_->MaybePostVerify(filter);
   }
-  std::string& index_key = p_index_builder_->GetPartitionKey();
-  filters.push_back({index_key, std::move(filter_data), filter});
+  filters.push_back({index_key, std::move(filter_data), filter, nullptr,
+                     Status::OK()});
   if (!filter_construction_status.ok() &&
       partitioned_filters_construction_status_.ok()) {
     partitioned_filters_construction_status_ = filter_construction_status;
@@ -144,6 +225,7 @@ Slice PartitionedFilterBlockBuilder::Finish(
     }
   } else {
     MaybeCutAFilterBlock(nullptr);
+    WaitForFilters();
   }
 
   if (!partitioned_filters_construction_status_.ok()) {
@@ -180,6 +262,13 @@ Slice PartitionedFilterBlockBuilder::Finish(
     if (filter_data != nullptr) {
       *filter_data = std::move(last_filter_data);
     }
+    filters.front().status.PermitUncheckedError();
+    if (filters.front().builder) {
+      // Keep the cache reservation of the filter until the table is finished,
+      // like a single filter builder does for all partitions
+      finished_filter_bits_builders_.push_back(
+          std::move(filters.front().builder));
+    }
     filters.pop_front();
     return filter;
   }
@@ -526,6 +615,70 @@ Status PartitionedFilterBlockReader::CacheDependencies(const ReadOptions& ro,
   return biter.status();
 }
 
+Status PartitionedFilterBlockReader::CopyFilters(const ReadOptions& ro,
+                                                 PinnedFilters* filters) {
+  assert(table());
+  assert(filters);
+
+  BlockCacheLookupContext lookup_context{TableReaderCaller::kPrefetch};
+
+  CachableEntry<Block_kFilterPartitionIndex> filter_block;
+  Status s = GetOrReadFilterBlock(false /* no_io */, nullptr /* get_context */,
+                                  &lookup_context, &filter_block, ro);
+  if (!s.ok()) {
+    return s;
+  }
+  assert(filter_block.GetValue());
+
+  const BlockBasedTable::Rep* const rep = table()->get_rep();
+  IndexBlockIter biter;
+  Statistics* kNullStats = nullptr;
+  filter_block.GetValue()->NewIndexIterator(
+      internal_comparator()->user_comparator(),
+      rep->get_global_seqno(BlockType::kFilterPartitionIndex), &biter,
+      kNullStats, true /* total_order_seek */, false /* have_first_key */,
+      index_key_includes_seq(), index_value_is_full());
+  // The partitions are consecutive, so read them all at once like
+  // CacheDependencies()
+  std::unique_ptr<FilePrefetchBuffer> prefetch_buffer;
+  biter.SeekToFirst();
+  if (biter.Valid()) {
+    uint64_t prefetch_off = biter.value().handle.offset();
+    biter.SeekToLast();
+    BlockHandle handle = biter.value().handle;
+    uint64_t last_off =
+        handle.offset() + handle.size() + BlockBasedTable::kBlockTrailerSize;
+    rep->CreateFilePrefetchBuffer(
+        0, 0, &prefetch_buffer, false /* Implicit autoreadahead */,
+        0 /*num_reads_*/, 0 /*num_file_reads_for_auto_readahead*/);
+    uint64_t prefetch_len = last_off - prefetch_off;
+    IOOptions opts;
+    s = rep->file->PrepareIOOptions(ro, opts);
+    if (s.ok()) {
+      s = prefetch_buffer->Prefetch(opts, rep->file.get(), prefetch_off,
+                                    static_cast<size_t>(prefetch_len),
+                                    ro.rate_limiter_priority);
+    }
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
+  for (biter.SeekToFirst(); biter.Valid(); biter.Next()) {
+    CachableEntry<ParsedFullFilterBlock> partition;
+    s = GetFilterPartitionBlock(prefetch_buffer.get(), biter.value().handle,
+                                false /* no_io */, nullptr /* get_context */,
+                                &lookup_context, ro, &partition);
+    if (!s.ok()) {
+      return s;
+    }
+    assert(partition.GetValue());
+    filters->Add(biter.user_key(), partition.GetValue()->ContentSlice(),
+                 rep->filter_policy);
+  }
+  return biter.status();
+}
+
 const InternalKeyComparator* PartitionedFilterBlockReader::internal_comparator()
     const {
   assert(table());
@@ -5,12 +5,17 @@
 
 #pragma once
 
+#include <condition_variable>
 #include <deque>
+#include <functional>
 #include <list>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "block_cache.h"
+#include "rocksdb/env.h"
 #include "rocksdb/options.h"
 #include "rocksdb/slice.h"
 #include "rocksdb/slice_transform.h"
@@ -26,12 +31,18 @@ class InternalKeyComparator;
 
 class PartitionedFilterBlockBuilder : public FullFilterBlockBuilder {
  public:
+  // If env != nullptr and num_threads > 0, filter partitions are finished
+  // (e.g. Ribbon banding and back substitution) on the env's USER thread
+  // pool, with builders for the following partitions from
+  // new_filter_bits_builder. To bound memory, at most num_threads partitions
+  // wait to be finished at a time.
   explicit PartitionedFilterBlockBuilder(
       const SliceTransform* prefix_extractor, bool whole_key_filtering,
       FilterBitsBuilder* filter_bits_builder, int index_block_restart_interval,
       const bool use_value_delta_encoding,
       PartitionedIndexBuilder* const p_index_builder,
-      const uint32_t partition_size);
+      const uint32_t partition_size, Env* env = nullptr, int num_threads = 0,
+      std::function<FilterBitsBuilder*()> new_filter_bits_builder = nullptr);
 
   virtual ~PartitionedFilterBlockBuilder();
 
@@ -47,7 +58,12 @@ class PartitionedFilterBlockBuilder : public FullFilterBlockBuilder {
     // Previously constructed partitioned filters by
     // this to-be-reset FiterBitsBuilder can also be
     // cleared
+    WaitForFilters();
+    for (auto& entry : filters) {
+      entry.status.PermitUncheckedError();
+    }
     filters.clear();
+    finished_filter_bits_builders_.clear();
     FullFilterBlockBuilder::ResetFilterBitsBuilder();
   }
 
@@ -69,6 +85,10 @@ class PartitionedFilterBlockBuilder : public FullFilterBlockBuilder {
     std::string key;
     std::unique_ptr<const char[]> filter_data;
     Slice filter;
+    // Set if the filter is finished in the background. Holds the cache
+    // reservation for the filter.
+    std::unique_ptr<FilterBitsBuilder> builder;
+    Status status;
   };
   std::deque<FilterEntry> filters;  // list of partitioned filters and keys used
                                     // in building the index
@@ -98,6 +118,26 @@ class PartitionedFilterBlockBuilder : public FullFilterBlockBuilder {
   // in all the filters we have fully built
   uint64_t total_added_in_built_;
   BlockHandle last_encoded_handle_;
+
+  // Finishing filter partitions in the background
+  static void FinishFilterJob(void* arg);
+  void FinishFilter();
+  // Waits for the background jobs to finish all pending filters, and records
+  // their status
+  void WaitForFilters();
+  std::function<FilterBitsBuilder*()> new_filter_bits_builder_;
+  Env* env_;
+  // 0 if filters are finished in the table builder's thread
+  const size_t max_unfinished_filters_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  // Entries of `filters` not yet picked up by a job
+  std::deque<FilterEntry*> pending_filters_;
+  // Number of filters waiting for or being finished by a job
+  size_t num_unfinished_filters_ = 0;
+  // Builders of the filters already returned by Finish()
+  std::vector<std::unique_ptr<FilterBitsBuilder>>
+      finished_filter_bits_builders_;
 };
 
 class PartitionedFilterBlockReader
@@ -133,6 +173,8 @@ class PartitionedFilterBlockReader
 
   size_t ApproximateMemoryUsage() const override;
 
+  Status CopyFilters(const ReadOptions& ro, PinnedFilters* filters) override;
+
  private:
   BlockHandle GetFilterPartitionHandle(
       const CachableEntry<Block_kFilterPartitionIndex>& filter_block,
@@ -8,6 +8,7 @@
 #include <map>
 
 #include "block_cache.h"
+#include "cache/cache_reservation_manager.h"
 #include "index_builder.h"
 #include "rocksdb/filter_policy.h"
 #include "table/block_based/block_based_table_reader.h"
@@ -126,12 +127,17 @@ class PartitionedFilterBlockTest
                               100);
     partition_size = std::max(partition_size, static_cast<uint32_t>(1));
     const bool kValueDeltaEncoded = true;
+    const BlockBasedTableOptions& table_options = table_options_;
     return new PartitionedFilterBlockBuilder(
         prefix_extractor, table_options_.whole_key_filtering,
         BloomFilterPolicy::GetBuilderFromContext(
             FilterBuildingContext(table_options_)),
         table_options_.index_block_restart_interval, !kValueDeltaEncoded,
-        p_index_builder, partition_size);
+        p_index_builder, partition_size, Env::Default(),
+        table_options_.filter_construction_threads, [&table_options]() {
+          return BloomFilterPolicy::GetBuilderFromContext(
+              FilterBuildingContext(table_options));
+        });
   }
 
   PartitionedFilterBlockReader* NewReader(
@@ -327,6 +333,69 @@ TEST_P(PartitionedFilterBlockTest, TwoBlocksPerKey) {
   }
 }
 
+TEST_P(PartitionedFilterBlockTest, FilterConstructionThreads) {
+  for (bool ribbon : {false, true}) {
+    if (ribbon) {
+      table_options_.filter_policy.reset(NewRibbonFilterPolicy(bits_per_key_));
+    }
+    for (int threads : {1, 3}) {
+      table_options_.filter_construction_threads = threads;
+      uint64_t max_index_size = MaxIndexSize();
+      for (uint64_t i = 1; i < max_index_size + 1; i++) {
+        table_options_.metadata_block_size = i;
+        TestBlockPerKey();
+        TestBlockPerTwoKeys();
+        TestBlockPerAllKeys();
+      }
+    }
+  }
+}
+
+TEST_P(PartitionedFilterBlockTest, FilterConstructionThreadsChargeCache) {
+  if (GetParam() < 5) {
+    ROCKSDB_GTEST_BYPASS("Legacy Bloom filters are not charged");
+    return;
+  }
+  std::shared_ptr<Cache> cache = NewLRUCache(64 << 20);
+  table_options_.block_cache = cache;
+  table_options_.cache_usage_options.options_overrides.insert(
+      {CacheEntryRole::kFilterConstruction,
+       {/*.charged = */ CacheEntryRoleOptions::Decision::kEnabled}});
+  table_options_.filter_construction_threads = 2;
+  table_options_.metadata_block_size = 1;
+  {
+    std::unique_ptr<PartitionedIndexBuilder> pib(NewIndexBuilder());
+    std::unique_ptr<PartitionedFilterBlockBuilder> builder(
+        NewBuilder(pib.get()));
+    for (int i = 0; i < 4; ++i) {
+      builder->Add(keys[i]);
+      if (i < 3) {
+        CutABlock(pib.get(), keys[i], keys[i + 1]);
+      } else {
+        CutABlock(pib.get(), keys[i]);
+      }
+    }
+    // Each partition returned by Finish() is still charged to the cache by at
+    // least one dummy entry until the builder is gone
+    size_t num_partitions = 0;
+    BlockHandle bh;
+    Status status;
+    do {
+      std::unique_ptr<const char[]> filter_data;
+      bh = Write(builder->Finish(bh, &status, &filter_data));
+      if (status.IsIncomplete()) {
+        ++num_partitions;
+      }
+    } while (status.IsIncomplete());
+    ASSERT_OK(status);
+    ASSERT_GT(num_partitions, 1);
+    const size_t dummy_entry_size = CacheReservationManagerImpl<
+        CacheEntryRole::kFilterConstruction>::GetDummyEntrySize();
+    ASSERT_GE(cache->GetUsage(), num_partitions * dummy_entry_size);
+  }
+  ASSERT_EQ(cache->GetUsage(), 0);
+}
+
 // This reproduces the bug that a prefix is the same among multiple consecutive
 // blocks but the bug would add it only to the first block.
 TEST_P(PartitionedFilterBlockTest, SamePrefixInMultipleBlocks) {
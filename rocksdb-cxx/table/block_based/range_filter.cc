@@ -0,0 +1,262 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/range_filter.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+#include "port/port.h"
+#include "util/coding.h"
+#include "util/math.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// The 8 bytes of `key` from `offset` as a big-endian integer, zero padded
+uint64_t LoadValue(const Slice& key, size_t offset) {
+  uint64_t v = 0;
+  if (offset < key.size()) {
+    memcpy(&v, key.data() + offset,
+           std::min(key.size() - offset, sizeof(v)));
+  }
+  if (port::kLittleEndian) {
+    v = EndianSwapValue(v);
+  }
+  return v;
+}
+
+constexpr uint64_t kMaxRangeFilterValue = std::numeric_limits<uint64_t>::max();
+}  // namespace
+
+void RangeFilterBuilder::Add(const Slice& user_key) {
+  if (num_keys_ == 0) {
+    first_key_.assign(user_key.data(), user_key.size());
+    common_prefix_len_ = user_key.size();
+  } else {
+    if (user_key == Slice(last_key_)) {
+      return;
+    }
+    assert(user_key.compare(Slice(last_key_)) > 0);
+    const size_t limit = std::min(common_prefix_len_, user_key.size());
+    size_t len = 0;
+    while (len < limit && first_key_[len] == user_key[len]) {
+      ++len;
+    }
+    if (len < common_prefix_len_) {
+      Rebase(len);
+    }
+  }
+  last_key_.assign(user_key.data(), user_key.size());
+  ++num_keys_;
+  const uint64_t value = LoadValue(user_key, common_prefix_len_);
+  if (values_.empty() || values_.back() != value) {
+    assert(values_.empty() || values_.back() < value);
+    values_.push_back(value);
+  }
+}
+
+void RangeFilterBuilder::Rebase(size_t common_prefix_len) {
+  assert(common_prefix_len < common_prefix_len_);
+  // The bytes between the two prefix lengths are the same in all keys so
+  // far, so they are taken from the first key.
+  const size_t shift_bytes = common_prefix_len_ - common_prefix_len;
+  const uint64_t head = LoadValue(first_key_, common_prefix_len);
+  if (shift_bytes >= sizeof(uint64_t)) {
+    values_.assign(1, head);
+  } else {
+    const uint64_t head_mask = ~uint64_t{0} << (64 - 8 * shift_bytes);
+    for (uint64_t& value : values_) {
+      value = (head & head_mask) | (value >> (8 * shift_bytes));
+    }
+    values_.erase(std::unique(values_.begin(), values_.end()), values_.end());
+  }
+  common_prefix_len_ = common_prefix_len;
+}
+
+size_t RangeFilterBuilder::EncodedSize(int shift) const {
+  size_t size = 0;
+  size_t count = 0;
+  uint64_t prev = 0;
+  for (uint64_t value : values_) {
+    value >>= shift;
+    if (count > 0 && value == prev) {
+      continue;
+    }
+    if (count % RangeFilter::kGroupSize == 0) {
+      size += sizeof(uint64_t) + sizeof(uint32_t);
+    } else {
+      size += VarintLength(value - prev);
+    }
+    prev = value;
+    ++count;
+  }
+  return size;
+}
+
+Slice RangeFilterBuilder::Finish() {
+  assert(!IsEmpty());
+  // Use the finest truncation that fits the budget. The size only shrinks as
+  // the shift grows.
+  const size_t budget =
+      static_cast<size_t>(bits_per_key_ * static_cast<double>(num_keys_) / 8);
+  int shift_lo = 0;
+  int shift_hi = 63;
+  while (shift_lo < shift_hi) {
+    int mid = (shift_lo + shift_hi) / 2;
+    if (EncodedSize(mid) <= budget) {
+      shift_hi = mid;
+    } else {
+      shift_lo = mid + 1;
+    }
+  }
+  const int shift = shift_lo;
+
+  contents_.clear();
+  PutLengthPrefixedSlice(&contents_, Slice(first_key_.data(),
+                                           common_prefix_len_));
+  contents_.push_back(static_cast<char>(shift));
+  std::vector<uint32_t> group_offsets;
+  std::string groups;
+  uint64_t prev = 0;
+  uint32_t count = 0;
+  for (uint64_t value : values_) {
+    value >>= shift;
+    if (count > 0 && value == prev) {
+      continue;
+    }
+    if (count % RangeFilter::kGroupSize == 0) {
+      group_offsets.push_back(static_cast<uint32_t>(groups.size()));
+      PutFixed64(&groups, value);
+    } else {
+      PutVarint64(&groups, value - prev);
+    }
+    prev = value;
+    ++count;
+  }
+  PutVarint32(&contents_, count);
+  contents_.append(groups);
+  for (uint32_t offset : group_offsets) {
+    PutFixed32(&contents_, offset);
+  }
+  return contents_;
+}
+
+Status RangeFilter::Create(BlockContents&& contents,
+                           std::unique_ptr<RangeFilter>* filter) {
+  if (!contents.own_bytes()) {
+    // Kept for the lifetime of the table reader
+    std::unique_ptr<char[]> buf(new char[contents.data.size()]);
+    memcpy(buf.get(), contents.data.data(), contents.data.size());
+    contents = BlockContents(std::move(buf), contents.data.size());
+  }
+  std::unique_ptr<RangeFilter> f(new RangeFilter(std::move(contents)));
+  Slice input = f->contents_.data;
+  uint32_t num_values = 0;
+  if (!GetLengthPrefixedSlice(&input, &f->common_prefix_) || input.empty()) {
+    return Status::Corruption("Range filter too short");
+  }
+  f->shift_ = static_cast<unsigned char>(input[0]);
+  input.remove_prefix(1);
+  if (f->shift_ >= 64 || !GetVarint32(&input, &num_values)) {
+    return Status::Corruption("Bad range filter header");
+  }
+  f->num_values_ = num_values;
+  f->num_groups_ = (num_values + kGroupSize - 1) / kGroupSize;
+  const size_t offsets_size =
+      static_cast<size_t>(f->num_groups_) * sizeof(uint32_t);
+  if (input.size() < offsets_size) {
+    return Status::Corruption("Range filter truncated");
+  }
+  f->groups_ = input.data();
+  f->groups_size_ = input.size() - offsets_size;
+  f->group_offsets_ = f->groups_ + f->groups_size_;
+  for (uint32_t i = 0; i < f->num_groups_; ++i) {
+    uint32_t offset = DecodeFixed32(f->group_offsets_ + i * sizeof(uint32_t));
+    if ((i == 0 && offset != 0) ||
+        offset + sizeof(uint64_t) > f->groups_size_ ||
+        (i > 0 && offset <= f->GroupOffset(i - 1))) {
+      return Status::Corruption("Bad range filter group offset");
+    }
+  }
+  *filter = std::move(f);
+  return Status::OK();
+}
+
+uint32_t RangeFilter::GroupOffset(uint32_t group) const {
+  return DecodeFixed32(group_offsets_ + group * sizeof(uint32_t));
+}
+
+bool RangeFilter::RangeMayMatch(const Slice* lower, const Slice* upper) const {
+  if (num_values_ == 0) {
+    return false;
+  }
+  // All keys start with common_prefix_. A bound that does not is either
+  // before or after all of them.
+  uint64_t lo = 0;
+  uint64_t hi = kMaxRangeFilterValue;
+  if (lower != nullptr) {
+    if (lower->starts_with(common_prefix_)) {
+      lo = LoadValue(*lower, common_prefix_.size()) >> shift_;
+    } else if (lower->compare(common_prefix_) > 0) {
+      return false;
+    }
+  }
+  if (upper != nullptr) {
+    if (upper->starts_with(common_prefix_)) {
+      hi = LoadValue(*upper, common_prefix_.size()) >> shift_;
+    } else if (upper->compare(common_prefix_) < 0) {
+      return false;
+    }
+  }
+  if (lo > hi) {
+    return false;
+  }
+
+  // Find the largest value <= hi, which is in the last group starting at or
+  // before hi
+  uint32_t left = 0;
+  uint32_t right = num_groups_;
+  while (left < right) {
+    uint32_t mid = left + (right - left) / 2;
+    if (DecodeFixed64(groups_ + GroupOffset(mid)) <= hi) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
+  }
+  if (left == 0) {
+    return false;
+  }
+  const uint32_t group = left - 1;
+  const char* p = groups_ + GroupOffset(group);
+  const char* limit = group + 1 < num_groups_ ? groups_ + GroupOffset(group + 1)
+                                              : groups_ + groups_size_;
+  uint64_t value = DecodeFixed64(p);
+  p += sizeof(uint64_t);
+  uint64_t best = value;
+  while (p < limit) {
+    uint64_t delta;
+    p = GetVarint64Ptr(p, limit, &delta);
+    if (p == nullptr) {
+      // Corrupt; can't rule anything out
+      return true;
+    }
+    value += delta;
+    if (value > hi) {
+      break;
+    }
+    best = value;
+  }
+  return best >= lo;
+}
+
+size_t RangeFilter::ApproximateMemoryUsage() const {
+  return sizeof(*this) + contents_.ApproximateMemoryUsage();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,101 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+#include "table/format.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A range filter (BlockBasedTableOptions::range_filter_bits_per_key) tells
+// whether an SST file may have a user key within a range of user keys. In the
+// spirit of SuRF, it stores truncated keys instead of hashes, which keeps
+// their order:
+//
+// * All keys of a file share their longest common prefix. It is stored once.
+// * The next 8 bytes of each key after that prefix, zero padded, are read as
+//   a big-endian integer, and shifted right so that the sorted distinct values
+//   fit the space budget. Dropping low bits merges nearby keys into one value,
+//   which only adds false positives.
+//
+// A range matches if any value lies between the values of its bounds, so
+// there are no false negatives. Keys must be ordered bytewise.
+//
+// Serialized format:
+//   common_prefix: varint32 length + bytes
+//   shift: 1 byte
+//   num_values: varint32
+//   groups: (first value: fixed64, then varint64 deltas of up to
+//            kGroupSize - 1 more values)[num_groups]
+//   group_offsets: fixed32[num_groups], from the start of `groups`
+class RangeFilterBuilder {
+ public:
+  explicit RangeFilterBuilder(double bits_per_key)
+      : bits_per_key_(bits_per_key) {}
+
+  // Keys must be added in bytewise order. Repeats of the last key are
+  // ignored.
+  void Add(const Slice& user_key);
+
+  bool IsEmpty() const { return num_keys_ == 0; }
+
+  // Returns the serialized filter, valid until the builder is destroyed.
+  // REQUIRES: !IsEmpty()
+  Slice Finish();
+
+ private:
+  // Re-truncates the values after the common prefix shrinks to
+  // `common_prefix_len`
+  void Rebase(size_t common_prefix_len);
+  size_t EncodedSize(int shift) const;
+
+  const double bits_per_key_;
+  uint64_t num_keys_ = 0;
+  std::string first_key_;
+  std::string last_key_;
+  // Length of the prefix shared by all keys so far. Only shrinks.
+  size_t common_prefix_len_ = 0;
+  // The distinct values of the keys so far, relative to common_prefix_len_
+  std::vector<uint64_t> values_;
+  std::string contents_;
+};
+
+class RangeFilter {
+ public:
+  static constexpr uint32_t kGroupSize = 16;
+
+  static Status Create(BlockContents&& contents,
+                       std::unique_ptr<RangeFilter>* filter);
+
+  // Returns false if the file has no key k with *lower <= k <= *upper. A null
+  // bound is unbounded.
+  bool RangeMayMatch(const Slice* lower, const Slice* upper) const;
+
+  size_t ApproximateMemoryUsage() const;
+
+ private:
+  explicit RangeFilter(BlockContents&& contents)
+      : contents_(std::move(contents)) {}
+
+  uint32_t GroupOffset(uint32_t group) const;
+
+  BlockContents contents_;
+  Slice common_prefix_;
+  int shift_ = 0;
+  uint32_t num_values_ = 0;
+  uint32_t num_groups_ = 0;
+  const char* groups_ = nullptr;
+  size_t groups_size_ = 0;
+  const char* group_offsets_ = nullptr;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
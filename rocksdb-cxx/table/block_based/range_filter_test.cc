@@ -0,0 +1,189 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/range_filter.h"
+
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "test_util/testharness.h"
+#include "test_util/testutil.h"
+#include "util/coding.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+std::string NumberKey(uint32_t n) {
+  char buf[16];
+  snprintf(buf, sizeof(buf), "%08u", n);
+  return buf;
+}
+}  // namespace
+
+class RangeFilterTest : public testing::Test {
+ protected:
+  std::unique_ptr<RangeFilter> Build(const std::set<std::string>& keys,
+                                     double bits_per_key) {
+    RangeFilterBuilder builder(bits_per_key);
+    for (const std::string& key : keys) {
+      builder.Add(key);
+      // Repeats, as for several versions of a key, are ignored
+      builder.Add(key);
+    }
+    EXPECT_FALSE(builder.IsEmpty());
+    contents_ = builder.Finish().ToString();
+    std::unique_ptr<RangeFilter> filter;
+    EXPECT_OK(RangeFilter::Create(BlockContents(contents_), &filter));
+    return filter;
+  }
+
+  static bool HasKeyInRange(const std::set<std::string>& keys,
+                            const std::string& lower,
+                            const std::string& upper) {
+    auto it = keys.lower_bound(lower);
+    return it != keys.end() && *it <= upper;
+  }
+
+  // Checks there are no false negatives for random ranges, and returns the
+  // false positive rate
+  double Check(const RangeFilter& filter, const std::set<std::string>& keys,
+               const std::function<std::string()>& gen) {
+    size_t negatives = 0;
+    size_t false_positives = 0;
+    for (int i = 0; i < 10000; ++i) {
+      std::string lower = gen();
+      std::string upper = gen();
+      if (upper < lower) {
+        std::swap(lower, upper);
+      }
+      const Slice lower_slice(lower);
+      const Slice upper_slice(upper);
+      bool may_match = filter.RangeMayMatch(&lower_slice, &upper_slice);
+      if (HasKeyInRange(keys, lower, upper)) {
+        EXPECT_TRUE(may_match) << lower << " " << upper;
+      } else {
+        ++negatives;
+        if (may_match) {
+          ++false_positives;
+        }
+      }
+      // Half-bounded ranges
+      if (keys.lower_bound(lower) != keys.end()) {
+        EXPECT_TRUE(filter.RangeMayMatch(&lower_slice, nullptr));
+      }
+      if (!keys.empty() && *keys.begin() <= upper) {
+        EXPECT_TRUE(filter.RangeMayMatch(nullptr, &upper_slice));
+      }
+    }
+    return negatives == 0 ? 0.0
+                          : static_cast<double>(false_positives) / negatives;
+  }
+
+  std::string contents_;
+};
+
+TEST_F(RangeFilterTest, Basic) {
+  std::set<std::string> keys = {"key0100", "key0200", "key0300"};
+  auto filter = Build(keys, 64);
+  auto may_match = [&](const std::string& lower, const std::string& upper) {
+    Slice lower_slice(lower);
+    Slice upper_slice(upper);
+    return filter->RangeMayMatch(&lower_slice, &upper_slice);
+  };
+  ASSERT_TRUE(may_match("key0100", "key0100"));
+  ASSERT_TRUE(may_match("key0050", "key0150"));
+  ASSERT_TRUE(may_match("key0250", "key0300"));
+  ASSERT_TRUE(may_match("a", "z"));
+  ASSERT_FALSE(may_match("key0101", "key0199"));
+  ASSERT_FALSE(may_match("key0301", "key0999"));
+  ASSERT_FALSE(may_match("key00", "key0099"));
+  // Bounds outside the common prefix "key0"
+  ASSERT_FALSE(may_match("a", "b"));
+  ASSERT_FALSE(may_match("key1", "z"));
+  ASSERT_FALSE(may_match("a", "key"));
+  ASSERT_TRUE(may_match("a", "key1"));
+  ASSERT_TRUE(filter->RangeMayMatch(nullptr, nullptr));
+}
+
+TEST_F(RangeFilterTest, RandomKeys) {
+  Random rnd(301);
+  for (double bits_per_key : {2.0, 10.0, 64.0}) {
+    std::set<std::string> keys;
+    // Clustered keys with a long common prefix, so truncation and the
+    // common prefix are both exercised
+    while (keys.size() < 5000) {
+      uint32_t cluster = rnd.Uniform(20) * 1000;
+      keys.insert("common/prefix/" + NumberKey(cluster + rnd.Uniform(100)) +
+                  rnd.RandomString(rnd.Uniform(6)));
+    }
+    auto filter = Build(keys, bits_per_key);
+    ASSERT_LE(contents_.size(), bits_per_key * keys.size() / 8 + 64);
+    double fp_rate = Check(*filter, keys, [&]() {
+      uint32_t cluster = rnd.Uniform(25) * 1000;
+      return "common/prefix/" + NumberKey(cluster + rnd.Uniform(1000));
+    });
+    if (bits_per_key >= 64) {
+      ASSERT_LT(fp_rate, 0.01);
+    }
+    Check(*filter, keys, [&]() { return rnd.RandomString(rnd.Uniform(20)); });
+  }
+}
+
+TEST_F(RangeFilterTest, BinaryKeys) {
+  Random rnd(302);
+  std::set<std::string> keys;
+  while (keys.size() < 2000) {
+    std::string key;
+    PutFixed64(&key, rnd.Uniform(1000000));
+    keys.insert(key + rnd.RandomString(rnd.Uniform(3)));
+  }
+  auto filter = Build(keys, 20);
+  Check(*filter, keys, [&]() {
+    std::string key;
+    PutFixed64(&key, rnd.Uniform(1000000));
+    return key;
+  });
+}
+
+TEST_F(RangeFilterTest, SingleKey) {
+  std::set<std::string> keys = {"only"};
+  auto filter = Build(keys, 10);
+  Random rnd(303);
+  Check(*filter, keys, [&]() {
+    return std::string("onl") + rnd.RandomString(rnd.Uniform(3));
+  });
+}
+
+TEST_F(RangeFilterTest, Corruption) {
+  std::set<std::string> keys;
+  for (int i = 0; i < 100; ++i) {
+    keys.insert("key" + std::to_string(i * 7));
+  }
+  Build(keys, 64);
+  std::unique_ptr<RangeFilter> filter;
+  for (size_t len : {size_t{0}, size_t{2}, contents_.size() - 1}) {
+    std::string truncated = contents_.substr(0, len);
+    Status s = RangeFilter::Create(BlockContents(truncated), &filter);
+    ASSERT_TRUE(s.IsCorruption()) << len;
+  }
+  // Shift out of range
+  std::string bad = contents_;
+  // common_prefix is "key", so the shift follows a 1-byte length and 3 bytes
+  bad[4] = 64;
+  ASSERT_TRUE(RangeFilter::Create(BlockContents(bad), &filter).IsCorruption());
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,108 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+// Helpers for the optional restart key prefix array of data blocks (see
+// BlockBasedTableOptions::data_block_restart_key_prefixes).
+//
+// For each restart point, the array holds the first 8 bytes of the restart
+// key's user key (zero padded) as a big-endian integer with the top bit
+// flipped, stored with EncodeFixed64(). With a bytewise comparator, comparing
+// these as signed 64-bit integers gives the order of the user keys, except
+// that keys sharing the first 8 bytes compare equal. Signed integers are
+// used because that is what x86 SIMD compares.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include "rocksdb/slice.h"
+#include "util/coding.h"
+#include "util/math.h"
+
+#ifdef HAVE_AVX2
+#include <immintrin.h>
+#elif defined(HAVE_SSE42)
+#include <nmmintrin.h>
+#endif
+
+namespace ROCKSDB_NAMESPACE {
+
+constexpr size_t kRestartKeyPrefixSize = sizeof(uint64_t);
+
+inline int64_t RestartKeyPrefix(const Slice& user_key) {
+  uint64_t v = 0;
+  memcpy(&v, user_key.data(),
+         user_key.size() < sizeof(v) ? user_key.size() : sizeof(v));
+  if (port::kLittleEndian) {
+    v = EndianSwapValue(v);
+  }
+  return static_cast<int64_t>(v ^ (uint64_t{1} << 63));
+}
+
+inline int64_t DecodeRestartKeyPrefix(const char* prefixes, uint32_t i) {
+  return static_cast<int64_t>(
+      DecodeFixed64(prefixes + static_cast<size_t>(i) * kRestartKeyPrefixSize));
+}
+
+// Returns the number of the `n` sorted prefixes that are less than `target`.
+// A binary search narrows it down to a few cache lines, which are then
+// compared all at once.
+inline uint32_t CountRestartKeyPrefixesBelow(const char* prefixes, uint32_t n,
+                                             int64_t target) {
+  constexpr uint32_t kScanWidth = 16;
+  uint32_t lo = 0;
+  uint32_t hi = n;
+  while (hi - lo > kScanWidth) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (DecodeRestartKeyPrefix(prefixes, mid) < target) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  // All of [0, lo) are below target, and none of [hi, n) are
+  uint32_t count = lo;
+  uint32_t i = lo;
+#ifdef HAVE_AVX2
+  const __m256i t = _mm256_set1_epi64x(target);
+  for (; i + 4 <= hi; i += 4) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+        prefixes + static_cast<size_t>(i) * kRestartKeyPrefixSize));
+    int mask =
+        _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(t, v)));
+    count += static_cast<uint32_t>(BitsSetToOne(static_cast<uint32_t>(mask)));
+  }
+#elif defined(HAVE_SSE42)
+  const __m128i t = _mm_set1_epi64x(target);
+  for (; i + 2 <= hi; i += 2) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+        prefixes + static_cast<size_t>(i) * kRestartKeyPrefixSize));
+    int mask = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(t, v)));
+    count += static_cast<uint32_t>(BitsSetToOne(static_cast<uint32_t>(mask)));
+  }
+#endif
+  for (; i < hi; ++i) {
+    count += DecodeRestartKeyPrefix(prefixes, i) < target ? 1 : 0;
+  }
+  return count;
+}
+
+// Returns the number of the `n` sorted prefixes that are not greater than
+// `target`, given `num_below` from CountRestartKeyPrefixesBelow().
+inline uint32_t CountRestartKeyPrefixesNotAbove(const char* prefixes,
+                                                uint32_t n, int64_t target,
+                                                uint32_t num_below) {
+  if (target == std::numeric_limits<int64_t>::max()) {
+    return n;
+  }
+  return num_below + CountRestartKeyPrefixesBelow(
+                         prefixes + static_cast<size_t>(num_below) *
+                                        kRestartKeyPrefixSize,
+                         n - num_below, target + 1);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,69 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/separated_values.h"
+
+#include "table/format.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+Status ParseSeparatedDataBlock(const Slice& block, SeparatedDataBlock* out) {
+  if (block.size() < kSeparatedValuesFooterSize) {
+    return Status::Corruption("Block with separated values too small");
+  }
+  const char* footer = block.data() + block.size() - kSeparatedValuesFooterSize;
+  uint32_t keys_size = DecodeFixed32(footer);
+  size_t sections_size = block.size() - kSeparatedValuesFooterSize;
+  if (keys_size > sections_size) {
+    return Status::Corruption("Bad keys section size in block");
+  }
+  out->keys = Slice(block.data(), keys_size);
+  out->values = Slice(block.data() + keys_size, sections_size - keys_size);
+  out->values_uncompressed_size = DecodeFixed32(footer + sizeof(uint32_t));
+  out->keys_compression_type =
+      static_cast<CompressionType>(footer[2 * sizeof(uint32_t)]);
+  out->values_compression_type =
+      static_cast<CompressionType>(footer[2 * sizeof(uint32_t) + 1]);
+  if (out->values_compression_type == kNoCompression &&
+      out->values_uncompressed_size != out->values.size()) {
+    return Status::Corruption("Bad values section size in block");
+  }
+  return Status::OK();
+}
+
+Status UncompressSeparatedSection(const Slice& section, CompressionType type,
+                                  CacheAllocationPtr* out, size_t* out_size) {
+  UncompressionContext context(type);
+  UncompressionInfo info(context, UncompressionDict::GetEmptyDict(), type);
+  *out = UncompressData(
+      info, section.data(), section.size(), out_size,
+      GetCompressFormatForVersion(kSeparatedValuesFormatVersion));
+  if (!*out) {
+    return Status::Corruption(
+        "Could not decompress section of block with separated values: " +
+        CompressionTypeToString(type));
+  }
+  return Status::OK();
+}
+
+Status SeparatedValues::GetValues(Slice* values) {
+  if (compression_type_ == kNoCompression) {
+    *values = values_;
+    return Status::OK();
+  }
+  std::call_once(once_, [this]() {
+    size_t size = 0;
+    status_ =
+        UncompressSeparatedSection(values_, compression_type_, &uncompressed_,
+                                   &size);
+    if (status_.ok() && size != uncompressed_size_) {
+      status_ = Status::Corruption("Bad values section size in block");
+    }
+  });
+  *values = Slice(uncompressed_.get(), uncompressed_size_);
+  return status_;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,103 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+// Layout of data blocks with separated values (see
+// BlockBasedTableOptions::data_block_separate_values).
+//
+// Such a block stores the keys and the values of its entries in two
+// sections, each compressed on its own, followed by a fixed-size footer:
+//
+//    keys: char[keys_size]
+//    values: char[...]
+//    keys_size: fixed32                  (as stored)
+//    values_uncompressed_size: fixed32
+//    keys_compression_type: uint8
+//    values_compression_type: uint8
+//
+// Uncompressed, the keys section is a regular data block (see
+// block_builder.cc) in which the value of each entry is a value handle,
+// varint32 offset and varint32 size, into the uncompressed values section.
+// The values section is the values of the entries, concatenated. The block
+// itself is always stored with kNoCompression in its block trailer, so that
+// the sections can be decompressed independently, the values only when they
+// are needed.
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "rocksdb/compression_type.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+#include "util/coding.h"
+#include "util/compression.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+constexpr size_t kSeparatedValuesFooterSize =
+    2 * sizeof(uint32_t) + 2 * sizeof(uint8_t);
+
+// The sections are compressed like blocks of format_version 2 and later,
+// regardless of the format_version of the table.
+constexpr uint32_t kSeparatedValuesFormatVersion = 2;
+
+struct SeparatedDataBlock {
+  Slice keys;
+  CompressionType keys_compression_type = kNoCompression;
+  Slice values;
+  CompressionType values_compression_type = kNoCompression;
+  uint32_t values_uncompressed_size = 0;
+};
+
+// Appends the footer to `block`, which holds the keys section of (stored)
+// size `keys_size` followed by the values section.
+inline void AppendSeparatedValuesFooter(
+    std::string* block, size_t keys_size, size_t values_uncompressed_size,
+    CompressionType keys_compression_type,
+    CompressionType values_compression_type) {
+  PutFixed32(block, static_cast<uint32_t>(keys_size));
+  PutFixed32(block, static_cast<uint32_t>(values_uncompressed_size));
+  block->push_back(static_cast<char>(keys_compression_type));
+  block->push_back(static_cast<char>(values_compression_type));
+}
+
+Status ParseSeparatedDataBlock(const Slice& block, SeparatedDataBlock* out);
+
+// Decompresses a section of a block with separated values into `*out`.
+Status UncompressSeparatedSection(const Slice& section, CompressionType type,
+                                  CacheAllocationPtr* out, size_t* out_size);
+
+// The values section of a data block with separated values, which is only
+// decompressed when first needed. The section must outlive this object.
+// Thread-safe.
+class SeparatedValues {
+ public:
+  SeparatedValues(const Slice& values, CompressionType compression_type,
+                  uint32_t uncompressed_size)
+      : values_(values),
+        compression_type_(compression_type),
+        uncompressed_size_(uncompressed_size) {}
+
+  // Sets `*values` to the uncompressed values section.
+  Status GetValues(Slice* values);
+
+  // The memory used by the uncompressed values, whether or not they have
+  // been decompressed yet, so that the charge of the block stays the same.
+  size_t ApproximateMemoryUsage() const {
+    return compression_type_ == kNoCompression ? 0 : uncompressed_size_;
+  }
+
+ private:
+  const Slice values_;
+  const CompressionType compression_type_;
+  const uint32_t uncompressed_size_;
+  std::once_flag once_;
+  Status status_;
+  CacheAllocationPtr uncompressed_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
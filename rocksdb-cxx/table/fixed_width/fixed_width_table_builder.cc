@@ -0,0 +1,293 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/fixed_width/fixed_width_table_builder.h"
+
+#include <assert.h>
+
+#include "db/dbformat.h"
+#include "file/writable_file_writer.h"
+#include "logging/logging.h"
+#include "options/cf_options.h"
+#include "rocksdb/comparator.h"
+#include "rocksdb/merge_operator.h"
+#include "table/format.h"
+#include "table/meta_blocks.h"
+#include "util/coding.h"
+#include "util/crc32c.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// kFixedWidthTableMagicNumber was picked by running
+//    echo rocksdb.table.fixed_width | sha1sum
+// and taking the leading 64 bits.
+extern const uint64_t kFixedWidthTableMagicNumber = 0x6ae0a47b600623c5ull;
+
+const std::string kFixedWidthTableIndexBlock =
+    "rocksdb.fixed_width.table.index";
+
+FixedWidthTableBuilder::FixedWidthTableBuilder(
+    const TableBuilderOptions& tbo,
+    const FixedWidthTableOptions& table_options, WritableFileWriter* file)
+    : ioptions_(tbo.ioptions),
+      file_(file),
+      layout_{table_options.key_size, table_options.value_size,
+              table_options.records_per_group},
+      zero_value_(table_options.value_size, '\0'),
+      range_del_block_(1 /* block_restart_interval */) {
+  if (layout_.key_size == 0 || layout_.records_per_group == 0) {
+    status_ = Status::InvalidArgument(
+        "Fixed-width table requires key_size and records_per_group");
+  }
+  properties_.fixed_key_len = layout_.key_size;
+  PutFixed32(&properties_.user_collected_properties
+                  [FixedWidthTablePropertyNames::kValueSize],
+             layout_.value_size);
+  PutFixed32(&properties_.user_collected_properties
+                  [FixedWidthTablePropertyNames::kRecordsPerGroup],
+             layout_.records_per_group);
+  properties_.column_family_id = tbo.column_family_id;
+  properties_.column_family_name = tbo.column_family_name;
+  properties_.oldest_key_time = tbo.oldest_key_time;
+  properties_.file_creation_time = tbo.file_creation_time;
+  properties_.orig_file_number = tbo.cur_file_num;
+  properties_.db_id = tbo.db_id;
+  properties_.db_session_id = tbo.db_session_id;
+  properties_.db_host_id = ioptions_.db_host_id;
+  if (!ReifyDbHostIdProperty(ioptions_.env, &properties_.db_host_id).ok()) {
+    ROCKS_LOG_INFO(ioptions_.logger, "db_host_id property will not be set");
+  }
+  properties_.comparator_name = ioptions_.user_comparator != nullptr
+                                    ? ioptions_.user_comparator->Name()
+                                    : "nullptr";
+  properties_.merge_operator_name = ioptions_.merge_operator != nullptr
+                                        ? ioptions_.merge_operator->Name()
+                                        : "nullptr";
+  properties_.prefix_extractor_name = "nullptr";
+
+  group_keys_.reserve(layout_.records_per_group * layout_.key_size);
+  group_trailers_.reserve(layout_.records_per_group * sizeof(uint64_t));
+  group_values_.reserve(layout_.records_per_group * layout_.value_size);
+
+  assert(tbo.int_tbl_prop_collector_factories);
+  for (auto& factory : *tbo.int_tbl_prop_collector_factories) {
+    assert(factory);
+
+    table_properties_collectors_.emplace_back(
+        factory->CreateIntTblPropCollector(tbo.column_family_id,
+                                           tbo.level_at_creation));
+  }
+}
+
+FixedWidthTableBuilder::~FixedWidthTableBuilder() {
+  // They are supposed to have been passed to users through Finish()
+  // if the file succeeds.
+  status_.PermitUncheckedError();
+  io_status_.PermitUncheckedError();
+}
+
+void FixedWidthTableBuilder::Add(const Slice& key, const Slice& value) {
+  assert(!closed_);
+  if (!ok()) {
+    return;
+  }
+  ParsedInternalKey ikey;
+  status_ = ParseInternalKey(key, &ikey, false /* log_err_key */);
+  if (!ok()) {
+    return;
+  }
+
+  if (ikey.type == kTypeRangeDeletion) {
+    range_del_block_.Add(key, value);
+    properties_.num_range_deletions++;
+  } else {
+    if (ikey.user_key.size() != layout_.key_size) {
+      status_ = Status::InvalidArgument(
+          "Fixed-width table expects keys of size " +
+          std::to_string(layout_.key_size) + ", got " +
+          std::to_string(ikey.user_key.size()));
+      return;
+    }
+    bool is_deletion = ikey.type == kTypeDeletion ||
+                       ikey.type == kTypeSingleDeletion ||
+                       ikey.type == kTypeDeletionWithTimestamp;
+    if (is_deletion ? !value.empty() : value.size() != layout_.value_size) {
+      status_ = Status::InvalidArgument(
+          "Fixed-width table expects values of size " +
+          std::to_string(layout_.value_size) + ", got " +
+          std::to_string(value.size()));
+      return;
+    }
+    group_keys_.append(ikey.user_key.data(), ikey.user_key.size());
+    group_trailers_.append(key.data() + ikey.user_key.size(),
+                           kNumInternalBytes);
+    if (is_deletion) {
+      group_values_.append(zero_value_);
+    } else {
+      group_values_.append(value.data(), value.size());
+    }
+    if (num_group_records_++ == 0) {
+      index_keys_.append(ikey.user_key.data(), ikey.user_key.size());
+    }
+    if (num_group_records_ == layout_.records_per_group) {
+      FlushGroup();
+    }
+  }
+
+  properties_.num_entries++;
+  properties_.raw_key_size += key.size();
+  properties_.raw_value_size += value.size();
+  if (ikey.type == kTypeDeletion || ikey.type == kTypeSingleDeletion ||
+      ikey.type == kTypeDeletionWithTimestamp ||
+      ikey.type == kTypeRangeDeletion) {
+    properties_.num_deletions++;
+  } else if (ikey.type == kTypeMerge) {
+    properties_.num_merge_operands++;
+  }
+
+  // notify property collectors
+  NotifyCollectTableCollectorsOnAdd(
+      key, value, offset_, table_properties_collectors_, ioptions_.logger);
+}
+
+void FixedWidthTableBuilder::FlushGroup() {
+  assert(num_group_records_ > 0);
+  uint32_t crc = crc32c::Value(group_keys_.data(), group_keys_.size());
+  crc = crc32c::Extend(crc, group_trailers_.data(), group_trailers_.size());
+  crc = crc32c::Extend(crc, group_values_.data(), group_values_.size());
+  PutFixed32(&index_checksums_, crc32c::Mask(crc));
+
+  io_status_ = file_->Append(group_keys_);
+  if (io_status_.ok()) {
+    io_status_ = file_->Append(group_trailers_);
+  }
+  if (io_status_.ok()) {
+    io_status_ = file_->Append(group_values_);
+  }
+  if (io_status_.ok()) {
+    offset_ += num_group_records_ * layout_.record_size();
+    properties_.num_data_blocks++;
+  }
+  status_ = io_status_;
+  num_group_records_ = 0;
+  group_keys_.clear();
+  group_trailers_.clear();
+  group_values_.clear();
+}
+
+Status FixedWidthTableBuilder::WriteMetaBlock(const Slice& contents,
+                                              BlockHandle* handle) {
+  handle->set_offset(offset_);
+  handle->set_size(contents.size());
+  io_status_ = file_->Append(contents);
+  if (io_status_.ok()) {
+    offset_ += contents.size();
+  }
+  status_ = io_status_;
+  return status_;
+}
+
+Status FixedWidthTableBuilder::Finish() {
+  assert(!closed_);
+  closed_ = true;
+  if (!ok()) {
+    return status_;
+  }
+  if (num_group_records_ > 0) {
+    FlushGroup();
+    if (!ok()) {
+      return status_;
+    }
+  }
+  properties_.data_size = offset_;
+
+  //  Write the following blocks
+  //  1. [meta block: index]
+  //  2. [meta block: range deletions] - optional
+  //  3. [meta block: properties]
+  //  4. [metaindex block]
+  //  5. [footer]
+  MetaIndexBuilder meta_index_builder;
+
+  BlockHandle index_block_handle;
+  std::string index = index_keys_ + index_checksums_;
+  properties_.index_size = index.size();
+  if (!WriteMetaBlock(index, &index_block_handle).ok()) {
+    return status_;
+  }
+  meta_index_builder.Add(kFixedWidthTableIndexBlock, index_block_handle);
+
+  if (!range_del_block_.empty()) {
+    BlockHandle range_del_block_handle;
+    if (!WriteMetaBlock(range_del_block_.Finish(), &range_del_block_handle)
+             .ok()) {
+      return status_;
+    }
+    meta_index_builder.Add(kRangeDelBlockName, range_del_block_handle);
+  }
+
+  PropertyBlockBuilder property_block_builder;
+  // -- Add basic properties
+  property_block_builder.AddTableProperty(properties_);
+
+  property_block_builder.Add(properties_.user_collected_properties);
+
+  // -- Add user collected properties
+  NotifyCollectTableCollectorsOnFinish(
+      table_properties_collectors_, ioptions_.logger, &property_block_builder);
+
+  BlockHandle property_block_handle;
+  if (!WriteMetaBlock(property_block_builder.Finish(), &property_block_handle)
+           .ok()) {
+    return status_;
+  }
+  meta_index_builder.Add(kPropertiesBlockName, property_block_handle);
+
+  BlockHandle metaindex_block_handle;
+  if (!WriteMetaBlock(meta_index_builder.Finish(), &metaindex_block_handle)
+           .ok()) {
+    return status_;
+  }
+
+  FooterBuilder footer;
+  footer.Build(kFixedWidthTableMagicNumber, /* format_version */ 1, offset_,
+               kNoChecksum, metaindex_block_handle);
+  io_status_ = file_->Append(footer.GetSlice());
+  if (io_status_.ok()) {
+    offset_ += footer.GetSlice().size();
+  }
+  status_ = io_status_;
+  return status_;
+}
+
+void FixedWidthTableBuilder::Abandon() { closed_ = true; }
+
+uint64_t FixedWidthTableBuilder::NumEntries() const {
+  return properties_.num_entries;
+}
+
+uint64_t FixedWidthTableBuilder::FileSize() const { return offset_; }
+
+uint64_t FixedWidthTableBuilder::EstimatedFileSize() const {
+  return offset_ + num_group_records_ * layout_.record_size();
+}
+
+std::string FixedWidthTableBuilder::GetFileChecksum() const {
+  if (file_ != nullptr) {
+    return file_->GetFileChecksum();
+  } else {
+    return kUnknownFileChecksum;
+  }
+}
+
+const char* FixedWidthTableBuilder::GetFileChecksumFuncName() const {
+  if (file_ != nullptr) {
+    return file_->GetFileChecksumFuncName();
+  } else {
+    return kUnknownFileChecksumFuncName;
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,111 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "db/table_properties_collector.h"
+#include "rocksdb/status.h"
+#include "rocksdb/table.h"
+#include "rocksdb/table_properties.h"
+#include "table/block_based/block_builder.h"
+#include "table/fixed_width/fixed_width_table_factory.h"
+#include "table/table_builder.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class WritableFileWriter;
+
+// Builds a fixed-width table (see fixed_width_table_factory.h), writing each
+// group to the file as soon as it is full.
+class FixedWidthTableBuilder : public TableBuilder {
+ public:
+  FixedWidthTableBuilder(const TableBuilderOptions& tbo,
+                         const FixedWidthTableOptions& table_options,
+                         WritableFileWriter* file);
+  // No copying allowed
+  FixedWidthTableBuilder(const FixedWidthTableBuilder&) = delete;
+  void operator=(const FixedWidthTableBuilder&) = delete;
+
+  ~FixedWidthTableBuilder() override;
+
+  // Add key,value to the table being constructed.
+  // REQUIRES: key is after any previously added key according to comparator.
+  // REQUIRES: Finish(), Abandon() have not been called
+  void Add(const Slice& key, const Slice& value) override;
+
+  // Return non-ok iff some error has been detected.
+  Status status() const override { return status_; }
+
+  // Return non-ok iff some error happens during IO.
+  IOStatus io_status() const override { return io_status_; }
+
+  // Finish building the table.  Stops using the file passed to the
+  // constructor after this function returns.
+  // REQUIRES: Finish(), Abandon() have not been called
+  Status Finish() override;
+
+  // Indicate that the contents of this builder should be abandoned.  Stops
+  // using the file passed to the constructor after this function returns.
+  // If the caller is not going to call Finish(), it must call Abandon()
+  // before destroying this builder.
+  // REQUIRES: Finish(), Abandon() have not been called
+  void Abandon() override;
+
+  // Number of calls to Add() so far.
+  uint64_t NumEntries() const override;
+
+  // Size of the file generated so far.  If invoked after a successful
+  // Finish() call, returns the size of the final generated file.
+  uint64_t FileSize() const override;
+
+  // Size of the file generated so far, and of the group being built
+  uint64_t EstimatedFileSize() const override;
+
+  TableProperties GetTableProperties() const override { return properties_; }
+
+  // Get file checksum
+  std::string GetFileChecksum() const override;
+
+  // Get file checksum function name
+  const char* GetFileChecksumFuncName() const override;
+
+ private:
+  bool ok() const { return status_.ok(); }
+
+  // Writes the group being built to the file
+  void FlushGroup();
+
+  Status WriteMetaBlock(const Slice& contents, BlockHandle* handle);
+
+  const ImmutableOptions& ioptions_;
+  WritableFileWriter* file_;
+  const FixedWidthTableLayout layout_;
+  uint64_t offset_ = 0;
+  // The columns of the group being built
+  uint32_t num_group_records_ = 0;
+  std::string group_keys_;
+  std::string group_trailers_;
+  std::string group_values_;
+  // The index: first user keys, then checksums of the groups
+  std::string index_keys_;
+  std::string index_checksums_;
+  std::string zero_value_;
+  BlockBuilder range_del_block_;
+  Status status_;
+  IOStatus io_status_;
+  TableProperties properties_;
+  std::vector<std::unique_ptr<IntTblPropCollector>>
+      table_properties_collectors_;
+
+  bool closed_ = false;  // Either Finish() or Abandon() has been called.
+};
+
+}  // namespace ROCKSDB_NAMESPACE
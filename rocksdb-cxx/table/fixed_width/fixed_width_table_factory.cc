@@ -0,0 +1,101 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/fixed_width/fixed_width_table_factory.h"
+
+#include "db/dbformat.h"
+#include "options/configurable_helper.h"
+#include "rocksdb/utilities/options_type.h"
+#include "table/fixed_width/fixed_width_table_builder.h"
+#include "table/fixed_width/fixed_width_table_reader.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+const std::string FixedWidthTablePropertyNames::kValueSize =
+    "rocksdb.fixed_width.value.size";
+const std::string FixedWidthTablePropertyNames::kRecordsPerGroup =
+    "rocksdb.fixed_width.records.per.group";
+
+Status FixedWidthTableFactory::NewTableReader(
+    const ReadOptions& /*ro*/, const TableReaderOptions& table_reader_options,
+    std::unique_ptr<RandomAccessFileReader>&& file, uint64_t file_size,
+    std::unique_ptr<TableReader>* table,
+    bool /*prefetch_index_and_filter_in_cache*/) const {
+  std::unique_ptr<FixedWidthTableReader> new_reader(new FixedWidthTableReader(
+      table_reader_options.ioptions, table_reader_options.internal_comparator,
+      std::move(file), file_size));
+  Status s = new_reader->status();
+  if (s.ok()) {
+    *table = std::move(new_reader);
+  }
+  return s;
+}
+
+TableBuilder* FixedWidthTableFactory::NewTableBuilder(
+    const TableBuilderOptions& table_builder_options,
+    WritableFileWriter* file) const {
+  return new FixedWidthTableBuilder(table_builder_options, table_options_,
+                                    file);
+}
+
+Status FixedWidthTableFactory::ValidateOptions(
+    const DBOptions& /*db_opts*/,
+    const ColumnFamilyOptions& /*cf_opts*/) const {
+  if (table_options_.key_size == 0) {
+    return Status::InvalidArgument(
+        "Fixed-width table requires key_size to be set");
+  }
+  if (table_options_.records_per_group == 0) {
+    return Status::InvalidArgument(
+        "Fixed-width table requires records_per_group > 0");
+  }
+  return Status::OK();
+}
+
+std::string FixedWidthTableFactory::GetPrintableOptions() const {
+  std::string ret;
+  ret.reserve(2000);
+  const int kBufferSize = 200;
+  char buffer[kBufferSize];
+
+  snprintf(buffer, kBufferSize, "  key_size: %u\n", table_options_.key_size);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  value_size: %u\n",
+           table_options_.value_size);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  records_per_group: %u\n",
+           table_options_.records_per_group);
+  ret.append(buffer);
+  return ret;
+}
+
+static std::unordered_map<std::string, OptionTypeInfo>
+    fixed_width_table_type_info = {
+        {"key_size",
+         {offsetof(struct FixedWidthTableOptions, key_size),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"value_size",
+         {offsetof(struct FixedWidthTableOptions, value_size),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"records_per_group",
+         {offsetof(struct FixedWidthTableOptions, records_per_group),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+};
+
+FixedWidthTableFactory::FixedWidthTableFactory(
+    const FixedWidthTableOptions& table_options)
+    : table_options_(table_options) {
+  RegisterOptions(&table_options_, &fixed_width_table_type_info);
+}
+
+TableFactory* NewFixedWidthTableFactory(
+    const FixedWidthTableOptions& table_options) {
+  return new FixedWidthTableFactory(table_options);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
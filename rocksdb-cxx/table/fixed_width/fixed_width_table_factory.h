@@ -0,0 +1,93 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <string>
+
+#include "rocksdb/options.h"
+#include "rocksdb/table.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Fixed-width table is designed for keys and values of a fixed size, such as
+// counters, and stores them without any per-record overhead:
+//
+//    [group 0]
+//    ...
+//    [group N-1]
+//    [meta block: index]
+//    [meta block: range deletions]  (if any)
+//    [meta block: properties]
+//    [metaindex block]
+//    [footer]
+//
+// A group of n records is made of three packed arrays:
+//
+//    user_keys: char[n * key_size]
+//    trailers: fixed64[n]               (packed sequence number and type)
+//    values: char[n * value_size]
+//
+// Every group but the last has records_per_group records, so the position of
+// a record in the file follows from its index. The index is the first user
+// key of every group, followed by a masked crc32c of every group as fixed32.
+// Deletions are stored with a value of zeros, which readers do not return.
+extern const uint64_t kFixedWidthTableMagicNumber;
+// Name of the index meta block
+extern const std::string kFixedWidthTableIndexBlock;
+
+struct FixedWidthTableLayout {
+  uint32_t key_size = 0;
+  uint32_t value_size = 0;
+  uint32_t records_per_group = 0;
+
+  uint64_t record_size() const {
+    return uint64_t{key_size} + sizeof(uint64_t) + value_size;
+  }
+  uint64_t group_size() const { return records_per_group * record_size(); }
+
+  // Within a group of `n` records
+  uint64_t key_offset(uint64_t i) const { return i * key_size; }
+  uint64_t trailer_offset(uint64_t n, uint64_t i) const {
+    return n * key_size + i * sizeof(uint64_t);
+  }
+  uint64_t value_offset(uint64_t n, uint64_t i) const {
+    return n * (key_size + sizeof(uint64_t)) + i * value_size;
+  }
+};
+
+class FixedWidthTableFactory : public TableFactory {
+ public:
+  explicit FixedWidthTableFactory(
+      const FixedWidthTableOptions& table_options = FixedWidthTableOptions());
+  ~FixedWidthTableFactory() {}
+
+  // Method to allow CheckedCast to work for this class
+  static const char* kClassName() { return kFixedWidthTableName(); }
+  const char* Name() const override { return kFixedWidthTableName(); }
+
+  using TableFactory::NewTableReader;
+  Status NewTableReader(
+      const ReadOptions& ro, const TableReaderOptions& table_reader_options,
+      std::unique_ptr<RandomAccessFileReader>&& file, uint64_t file_size,
+      std::unique_ptr<TableReader>* table,
+      bool prefetch_index_and_filter_in_cache = true) const override;
+
+  TableBuilder* NewTableBuilder(
+      const TableBuilderOptions& table_builder_options,
+      WritableFileWriter* file) const override;
+
+  Status ValidateOptions(const DBOptions& db_opts,
+                         const ColumnFamilyOptions& cf_opts) const override;
+
+  bool IsDeleteRangeSupported() const override { return true; }
+
+  std::string GetPrintableOptions() const override;
+
+ private:
+  FixedWidthTableOptions table_options_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,524 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/fixed_width/fixed_width_table_reader.h"
+
+#include <algorithm>
+
+#include "db/pinned_iterators_manager.h"
+#include "file/file_util.h"
+#include "memory/arena.h"
+#include "monitoring/perf_context_imp.h"
+#include "options/cf_options.h"
+#include "rocksdb/comparator.h"
+#include "table/block_based/block.h"
+#include "table/get_context.h"
+#include "table/internal_iterator.h"
+#include "table/meta_blocks.h"
+#include "util/coding.h"
+#include "util/crc32c.h"
+
+namespace ROCKSDB_NAMESPACE {
+namespace {
+
+// Interpolation search on the index gives up after this many probes, or once
+// the range left is this small, to binary search the rest of the range
+constexpr int kMaxInterpolationProbes = 4;
+constexpr uint64_t kMinInterpolationRange = 16;
+
+// The first 8 bytes of a key as a big-endian integer, so that keys ordered by
+// the bytewise comparator have non-decreasing prefixes
+uint64_t KeyPrefix(const Slice& key) {
+  uint64_t prefix = 0;
+  for (size_t i = 0; i < sizeof(uint64_t); ++i) {
+    prefix <<= 8;
+    if (i < key.size()) {
+      prefix |= static_cast<uint8_t>(key[i]);
+    }
+  }
+  return prefix;
+}
+
+bool IsDeletion(ValueType type) {
+  return type == kTypeDeletion || type == kTypeSingleDeletion ||
+         type == kTypeDeletionWithTimestamp;
+}
+
+void DeleteRangeDelBlock(void* arg1, void* /*arg2*/) {
+  delete static_cast<Block*>(arg1);
+}
+
+}  // namespace
+
+FixedWidthTableReader::FixedWidthTableReader(
+    const ImmutableOptions& ioptions, const InternalKeyComparator& icomp,
+    std::unique_ptr<RandomAccessFileReader>&& file, uint64_t file_size)
+    : ioptions_(ioptions), icomp_(icomp), file_(std::move(file)) {
+  // TODO: plumb Env::IOActivity
+  const ReadOptions read_options;
+  {
+    std::unique_ptr<TableProperties> props;
+    status_ = ReadTableProperties(file_.get(), file_size,
+                                  kFixedWidthTableMagicNumber, ioptions,
+                                  read_options, &props);
+    if (!status_.ok()) {
+      return;
+    }
+    table_props_ = std::move(props);
+  }
+  auto& user_props = table_props_->user_collected_properties;
+  auto value_size = user_props.find(FixedWidthTablePropertyNames::kValueSize);
+  auto records_per_group =
+      user_props.find(FixedWidthTablePropertyNames::kRecordsPerGroup);
+  if (value_size == user_props.end() ||
+      value_size->second.size() != sizeof(uint32_t) ||
+      records_per_group == user_props.end() ||
+      records_per_group->second.size() != sizeof(uint32_t)) {
+    status_ = Status::Corruption("Fixed-width table properties not found");
+    return;
+  }
+  layout_.key_size = static_cast<uint32_t>(table_props_->fixed_key_len);
+  layout_.value_size = DecodeFixed32(value_size->second.data());
+  layout_.records_per_group = DecodeFixed32(records_per_group->second.data());
+  if (layout_.key_size == 0 || layout_.records_per_group == 0 ||
+      table_props_->num_range_deletions > table_props_->num_entries) {
+    status_ = Status::Corruption("Bad fixed-width table properties");
+    return;
+  }
+  num_records_ =
+      table_props_->num_entries - table_props_->num_range_deletions;
+  num_groups_ = (num_records_ + layout_.records_per_group - 1) /
+                layout_.records_per_group;
+  if (table_props_->data_size != num_records_ * layout_.record_size() ||
+      table_props_->num_data_blocks != num_groups_) {
+    status_ = Status::Corruption("Bad fixed-width table properties");
+    return;
+  }
+  interpolate_ = icomp_.user_comparator() == BytewiseComparator();
+
+  status_ = ReadIndex(read_options, file_size);
+  if (status_.ok() && table_props_->num_range_deletions > 0) {
+    status_ = ReadRangeDels(read_options, file_size);
+  }
+}
+
+Status FixedWidthTableReader::ReadIndex(const ReadOptions& read_options,
+                                        uint64_t file_size) {
+  Status s = ReadMetaBlock(file_.get(), nullptr /* prefetch_buffer */,
+                           file_size, kFixedWidthTableMagicNumber, ioptions_,
+                           read_options, kFixedWidthTableIndexBlock,
+                           BlockType::kIndex, &index_contents_);
+  if (!s.ok()) {
+    return s;
+  }
+  index_ = index_contents_.data;
+  if (index_.size() != num_groups_ * (layout_.key_size + sizeof(uint32_t))) {
+    return Status::Corruption("Bad fixed-width table index size");
+  }
+  return Status::OK();
+}
+
+Status FixedWidthTableReader::ReadRangeDels(const ReadOptions& read_options,
+                                            uint64_t file_size) {
+  BlockContents contents;
+  Status s = ReadMetaBlock(file_.get(), nullptr /* prefetch_buffer */,
+                           file_size, kFixedWidthTableMagicNumber, ioptions_,
+                           read_options, kRangeDelBlockName,
+                           BlockType::kRangeDeletion, &contents);
+  if (!s.ok()) {
+    return s;
+  }
+  Block* block = new Block(std::move(contents));
+  std::unique_ptr<InternalIterator> iter(block->NewDataIterator(
+      icomp_.user_comparator(), kDisableGlobalSequenceNumber));
+  // The fragmented list may keep the iterator, which then owns the block
+  iter->RegisterCleanup(&DeleteRangeDelBlock, block, nullptr);
+  s = iter->status();
+  if (s.ok()) {
+    fragmented_range_dels_ =
+        std::make_shared<FragmentedRangeTombstoneList>(std::move(iter), icomp_);
+  }
+  return s;
+}
+
+uint64_t FixedWidthTableReader::CountGroupsBefore(const Slice& user_key,
+                                                  bool or_equal) const {
+  const Comparator* ucmp = icomp_.user_comparator();
+  auto before = [&](uint64_t g) {
+    int cmp = ucmp->Compare(IndexKey(g), user_key);
+    return or_equal ? cmp <= 0 : cmp < 0;
+  };
+  // The count is in [lo, hi]
+  uint64_t lo = 0;
+  uint64_t hi = num_groups_;
+  if (interpolate_) {
+    uint64_t target = KeyPrefix(user_key);
+    for (int probes = 0;
+         probes < kMaxInterpolationProbes && hi - lo > kMinInterpolationRange;
+         ++probes) {
+      uint64_t first = KeyPrefix(IndexKey(lo));
+      uint64_t last = KeyPrefix(IndexKey(hi - 1));
+      if (target <= first || target > last) {
+        break;
+      }
+      // In [lo, hi - 1], as 0 < target - first <= last - first
+      uint64_t probe =
+          lo + static_cast<uint64_t>(static_cast<double>(target - first) /
+                                     static_cast<double>(last - first) *
+                                     static_cast<double>(hi - 1 - lo));
+      if (before(probe)) {
+        lo = probe + 1;
+      } else {
+        hi = probe;
+      }
+    }
+  }
+  while (lo < hi) {
+    uint64_t mid = lo + (hi - lo) / 2;
+    if (before(mid)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+Status FixedWidthTableReader::ReadGroup(const ReadOptions& read_options,
+                                        uint64_t g,
+                                        FixedWidthGroup* group) const {
+  assert(g < num_groups_);
+  if (group->layout_ == &layout_ && group->index_ == g) {
+    return Status::OK();
+  }
+  group->layout_ = nullptr;
+  uint64_t first_record = g * layout_.records_per_group;
+  uint64_t num_records = std::min(uint64_t{layout_.records_per_group},
+                                  num_records_ - first_record);
+  size_t size = static_cast<size_t>(num_records * layout_.record_size());
+  if (group->buf_size_ < size) {
+    group->buf_.reset(new char[size]);
+    group->buf_size_ = size;
+  }
+
+  IOOptions opts;
+  IOStatus io_s = PrepareIOFromReadOptions(read_options, ioptions_.clock, opts);
+  Slice data;
+  if (io_s.ok()) {
+    io_s = file_->Read(opts, first_record * layout_.record_size(), size, &data,
+                       group->buf_.get(), nullptr /* aligned_buf */,
+                       read_options.rate_limiter_priority);
+  }
+  if (!io_s.ok()) {
+    return io_s;
+  }
+  PERF_COUNTER_ADD(block_read_count, 1);
+  PERF_COUNTER_ADD(block_read_byte, size);
+  if (data.size() != size) {
+    return Status::Corruption("Truncated fixed-width table group");
+  }
+  if (read_options.verify_checksums &&
+      crc32c::Value(data.data(), size) != crc32c::Unmask(IndexChecksum(g))) {
+    return Status::Corruption("Fixed-width table group checksum mismatch");
+  }
+  group->layout_ = &layout_;
+  group->index_ = g;
+  group->first_record_ = first_record;
+  group->num_records_ = num_records;
+  group->data_ = data;
+  return Status::OK();
+}
+
+int FixedWidthTableReader::CompareRecord(const FixedWidthGroup& group,
+                                         uint64_t i,
+                                         const Slice& target) const {
+  // As InternalKeyComparator::Compare
+  int cmp = icomp_.user_comparator()->Compare(group.user_key(i),
+                                              ExtractUserKey(target));
+  if (cmp == 0) {
+    uint64_t footer = DecodeFixed64(group.trailer(i).data());
+    uint64_t target_footer = ExtractInternalKeyFooter(target);
+    if (footer > target_footer) {
+      cmp = -1;
+    } else if (footer < target_footer) {
+      cmp = 1;
+    }
+  }
+  return cmp;
+}
+
+Status FixedWidthTableReader::Seek(const ReadOptions& read_options,
+                                   const Slice& target, FixedWidthGroup* group,
+                                   uint64_t* record) const {
+  // Records before the group before the first group starting at or after the
+  // user key of target, and those from the first group starting after it,
+  // can be skipped
+  Slice user_key = ExtractUserKey(target);
+  uint64_t groups_before = CountGroupsBefore(user_key, false /* or_equal */);
+  uint64_t lo = groups_before == 0
+                    ? 0
+                    : (groups_before - 1) * layout_.records_per_group;
+  uint64_t hi =
+      std::min(CountGroupsBefore(user_key, true /* or_equal */) *
+                   layout_.records_per_group,
+               num_records_);
+  while (lo < hi) {
+    uint64_t mid = lo + (hi - lo) / 2;
+    Status s =
+        ReadGroup(read_options, mid / layout_.records_per_group, group);
+    if (!s.ok()) {
+      return s;
+    }
+    if (CompareRecord(*group, mid - group->first_record(), target) < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  *record = lo;
+  if (lo < num_records_) {
+    return ReadGroup(read_options, lo / layout_.records_per_group, group);
+  }
+  return Status::OK();
+}
+
+Status FixedWidthTableReader::Get(const ReadOptions& read_options,
+                                  const Slice& key, GetContext* get_context,
+                                  const SliceTransform* /*prefix_extractor*/,
+                                  bool /*skip_filters*/) {
+  FixedWidthGroup group;
+  uint64_t record = 0;
+  Status s = Seek(read_options, key, &group, &record);
+  for (; s.ok() && record < num_records_; ++record) {
+    if (record == group.first_record() + group.num_records()) {
+      s = ReadGroup(read_options, group.index() + 1, &group);
+      if (!s.ok()) {
+        break;
+      }
+    }
+    uint64_t i = record - group.first_record();
+    ParsedInternalKey found_key;
+    found_key.user_key = group.user_key(i);
+    UnPackSequenceAndType(DecodeFixed64(group.trailer(i).data()),
+                          &found_key.sequence, &found_key.type);
+    Slice value = IsDeletion(found_key.type) ? Slice() : group.value(i);
+    bool matched = false;
+    if (!get_context->SaveValue(found_key, value, &matched)) {
+      break;
+    }
+  }
+  return s;
+}
+
+class FixedWidthTableIterator : public InternalIterator {
+ public:
+  FixedWidthTableIterator(const FixedWidthTableReader* reader,
+                          const ReadOptions& read_options)
+      : reader_(reader),
+        read_options_(read_options),
+        record_(reader->num_records()) {}
+  // No copying allowed
+  FixedWidthTableIterator(const FixedWidthTableIterator&) = delete;
+  void operator=(const Iterator&) = delete;
+  ~FixedWidthTableIterator() override {}
+
+  bool Valid() const override { return record_ < reader_->num_records(); }
+
+  void SeekToFirst() override { SeekToRecord(0); }
+
+  void SeekToLast() override {
+    if (reader_->num_records() == 0) {
+      Invalidate(Status::OK());
+      return;
+    }
+    SeekToRecord(reader_->num_records() - 1);
+  }
+
+  void Seek(const Slice& target) override {
+    PinGroup();
+    uint64_t record = 0;
+    Status s = reader_->Seek(read_options_, target, &group_, &record);
+    if (!s.ok()) {
+      Invalidate(s);
+      return;
+    }
+    SeekToRecord(record);
+  }
+
+  void SeekForPrev(const Slice& target) override {
+    Seek(target);
+    if (!status_.ok()) {
+      return;
+    }
+    // The last record at or before target is the one before the first record
+    // after it
+    if (!Valid() || reader_->CompareRecord(group_, record_in_group(),
+                                           target) > 0) {
+      Prev();
+    }
+  }
+
+  void Next() override {
+    assert(Valid());
+    SeekToRecord(record_ + 1);
+  }
+
+  void Prev() override {
+    if (record_ == 0) {
+      Invalidate(Status::OK());
+      return;
+    }
+    SeekToRecord(record_ - 1);
+  }
+
+  Slice key() const override {
+    assert(Valid());
+    return key_.GetInternalKey();
+  }
+
+  Slice value() const override {
+    assert(Valid());
+    return value_;
+  }
+
+  Status status() const override { return status_; }
+
+  void SetPinnedItersMgr(PinnedIteratorsManager* pinned_iters_mgr) override {
+    pinned_iters_mgr_ = pinned_iters_mgr;
+  }
+  // Values point into the buffer of their group, which PinGroup() keeps
+  // alive while pinning is enabled
+  bool IsValuePinned() const override {
+    return pinned_iters_mgr_ && pinned_iters_mgr_->PinningEnabled();
+  }
+
+ private:
+  static void DeleteBuffer(void* buf) { delete[] static_cast<char*>(buf); }
+
+  // Called before group_ may be read again, so that the values read from it
+  // stay valid while pinning is enabled
+  void PinGroup() {
+    if (pinned_iters_mgr_ && pinned_iters_mgr_->PinningEnabled()) {
+      pinned_iters_mgr_->PinPtr(group_.ReleaseBuffer(), &DeleteBuffer);
+    }
+  }
+
+  uint64_t record_in_group() const { return record_ - group_.first_record(); }
+
+  void Invalidate(const Status& s) {
+    status_ = s;
+    record_ = reader_->num_records();
+  }
+
+  // Moves to a record, which is past the last one if it is num_records()
+  void SeekToRecord(uint64_t record) {
+    status_ = Status::OK();
+    if (record >= reader_->num_records()) {
+      Invalidate(Status::OK());
+      return;
+    }
+    uint64_t g = record / reader_->records_per_group();
+    if (g != group_.index()) {
+      PinGroup();
+    }
+    Status s = reader_->ReadGroup(read_options_, g, &group_);
+    if (!s.ok()) {
+      Invalidate(s);
+      return;
+    }
+    record_ = record;
+    uint64_t i = record_in_group();
+    uint64_t packed = DecodeFixed64(group_.trailer(i).data());
+    SequenceNumber seq;
+    ValueType type;
+    UnPackSequenceAndType(packed, &seq, &type);
+    key_.SetInternalKey(group_.user_key(i), seq, type);
+    value_ = IsDeletion(type) ? Slice() : group_.value(i);
+  }
+
+  const FixedWidthTableReader* reader_;
+  const ReadOptions& read_options_;
+  PinnedIteratorsManager* pinned_iters_mgr_ = nullptr;
+  FixedWidthGroup group_;
+  // The current record, or num_records() if the iterator is not valid
+  uint64_t record_;
+  IterKey key_;
+  Slice value_;
+  Status status_;
+};
+
+InternalIterator* FixedWidthTableReader::NewIterator(
+    const ReadOptions& read_options,
+    const SliceTransform* /* prefix_extractor */, Arena* arena,
+    bool /*skip_filters*/, TableReaderCaller /*caller*/,
+    size_t /*compaction_readahead_size*/, bool /* allow_unprepared_value */) {
+  if (!status_.ok()) {
+    return NewErrorInternalIterator<Slice>(status_, arena);
+  }
+  FixedWidthTableIterator* iter;
+  if (arena == nullptr) {
+    iter = new FixedWidthTableIterator(this, read_options);
+  } else {
+    auto iter_mem = arena->AllocateAligned(sizeof(FixedWidthTableIterator));
+    iter = new (iter_mem) FixedWidthTableIterator(this, read_options);
+  }
+  return iter;
+}
+
+FragmentedRangeTombstoneIterator*
+FixedWidthTableReader::NewRangeTombstoneIterator(
+    const ReadOptions& read_options) {
+  if (fragmented_range_dels_ == nullptr) {
+    return nullptr;
+  }
+  SequenceNumber snapshot = kMaxSequenceNumber;
+  if (read_options.snapshot != nullptr) {
+    snapshot = read_options.snapshot->GetSequenceNumber();
+  }
+  return new FragmentedRangeTombstoneIterator(
+      fragmented_range_dels_, icomp_, snapshot, read_options.timestamp);
+}
+
+uint64_t FixedWidthTableReader::ApproximateOffsetOf(
+    const ReadOptions& /*read_options*/, const Slice& key,
+    TableReaderCaller /*caller*/) {
+  // The start of the group the key would be in
+  uint64_t groups_before =
+      CountGroupsBefore(ExtractUserKey(key), false /* or_equal */);
+  if (groups_before == 0) {
+    return 0;
+  }
+  return std::min((groups_before - 1) * layout_.group_size(),
+                  table_props_->data_size);
+}
+
+uint64_t FixedWidthTableReader::ApproximateSize(
+    const ReadOptions& read_options, const Slice& start, const Slice& end,
+    TableReaderCaller caller) {
+  assert(icomp_.Compare(start, end) <= 0);
+  uint64_t start_offset = ApproximateOffsetOf(read_options, start, caller);
+  uint64_t end_offset = ApproximateOffsetOf(read_options, end, caller);
+  return end_offset - start_offset;
+}
+
+size_t FixedWidthTableReader::ApproximateMemoryUsage() const {
+  return index_contents_.ApproximateMemoryUsage();
+}
+
+Status FixedWidthTableReader::VerifyChecksum(const ReadOptions& read_options,
+                                             TableReaderCaller /*caller*/) {
+  ReadOptions ro = read_options;
+  ro.verify_checksums = true;
+  FixedWidthGroup group;
+  for (uint64_t g = 0; g < num_groups_; ++g) {
+    Status s = ReadGroup(ro, g, &group);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  return Status::OK();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
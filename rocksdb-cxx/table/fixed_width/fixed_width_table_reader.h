@@ -0,0 +1,164 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "db/dbformat.h"
+#include "db/range_tombstone_fragmenter.h"
+#include "file/random_access_file_reader.h"
+#include "rocksdb/options.h"
+#include "table/fixed_width/fixed_width_table_factory.h"
+#include "table/format.h"
+#include "table/table_reader.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+struct ImmutableOptions;
+
+// A group of records of a fixed-width table, as read from the file
+class FixedWidthGroup {
+ public:
+  // The index of the group in the table
+  uint64_t index() const { return index_; }
+  // The index of the first record of the group in the table
+  uint64_t first_record() const { return first_record_; }
+  uint64_t num_records() const { return num_records_; }
+
+  // Accessors of the i-th record of the group
+  Slice user_key(uint64_t i) const {
+    return Slice(data_.data() + layout_->key_offset(i), layout_->key_size);
+  }
+  Slice trailer(uint64_t i) const {
+    return Slice(data_.data() + layout_->trailer_offset(num_records_, i),
+                 kNumInternalBytes);
+  }
+  Slice value(uint64_t i) const {
+    return Slice(data_.data() + layout_->value_offset(num_records_, i),
+                 layout_->value_size);
+  }
+
+  // Hands the buffer holding the group over to the caller, so that reading
+  // another group does not overwrite it. The group is then read again when
+  // needed.
+  char* ReleaseBuffer() {
+    layout_ = nullptr;
+    buf_size_ = 0;
+    return buf_.release();
+  }
+
+ private:
+  friend class FixedWidthTableReader;
+
+  const FixedWidthTableLayout* layout_ = nullptr;
+  uint64_t index_ = 0;
+  uint64_t first_record_ = 0;
+  uint64_t num_records_ = 0;
+  Slice data_;
+  // Holds data_ unless the file is mmapped
+  std::unique_ptr<char[]> buf_;
+  size_t buf_size_ = 0;
+};
+
+// Reads a fixed-width table (see fixed_width_table_factory.h). The index is
+// read in memory when the table is opened; groups are read from the file
+// when needed, without going through the block cache.
+class FixedWidthTableReader : public TableReader {
+ public:
+  FixedWidthTableReader(const ImmutableOptions& ioptions,
+                        const InternalKeyComparator& icomp,
+                        std::unique_ptr<RandomAccessFileReader>&& file,
+                        uint64_t file_size);
+  ~FixedWidthTableReader() {}
+
+  std::shared_ptr<const TableProperties> GetTableProperties() const override {
+    return table_props_;
+  }
+
+  Status status() const { return status_; }
+
+  Status Get(const ReadOptions& read_options, const Slice& key,
+             GetContext* get_context, const SliceTransform* prefix_extractor,
+             bool skip_filters = false) override;
+
+  // Returns a new iterator over table contents
+  // compaction_readahead_size: its value will only be used if for_compaction =
+  // true
+  InternalIterator* NewIterator(const ReadOptions&,
+                                const SliceTransform* prefix_extractor,
+                                Arena* arena, bool skip_filters,
+                                TableReaderCaller caller,
+                                size_t compaction_readahead_size = 0,
+                                bool allow_unprepared_value = false) override;
+
+  FragmentedRangeTombstoneIterator* NewRangeTombstoneIterator(
+      const ReadOptions& read_options) override;
+
+  uint64_t ApproximateOffsetOf(const ReadOptions& read_options,
+                               const Slice& key,
+                               TableReaderCaller caller) override;
+
+  uint64_t ApproximateSize(const ReadOptions& read_options, const Slice& start,
+                           const Slice& end, TableReaderCaller caller) override;
+
+  // Report an approximation of how much memory has been used.
+  size_t ApproximateMemoryUsage() const override;
+
+  void SetupForCompaction() override {}
+
+  Status VerifyChecksum(const ReadOptions& read_options,
+                        TableReaderCaller caller) override;
+
+  uint64_t num_records() const { return num_records_; }
+  uint64_t num_groups() const { return num_groups_; }
+  uint32_t records_per_group() const { return layout_.records_per_group; }
+
+  // Reads group `g` into `*group`, unless it already holds it
+  Status ReadGroup(const ReadOptions& read_options, uint64_t g,
+                   FixedWidthGroup* group) const;
+
+  // Returns the index of the first record at or after `target`, an internal
+  // key, or num_records() if there is none. `*group` is left holding the
+  // group of that record, if any.
+  Status Seek(const ReadOptions& read_options, const Slice& target,
+              FixedWidthGroup* group, uint64_t* record) const;
+
+  // Compares the internal key of record `i` of `group` with `target`
+  int CompareRecord(const FixedWidthGroup& group, uint64_t i,
+                    const Slice& target) const;
+
+ private:
+  Status ReadIndex(const ReadOptions& read_options, uint64_t file_size);
+  Status ReadRangeDels(const ReadOptions& read_options, uint64_t file_size);
+
+  Slice IndexKey(uint64_t g) const {
+    return Slice(index_.data() + g * layout_.key_size, layout_.key_size);
+  }
+  uint32_t IndexChecksum(uint64_t g) const {
+    return DecodeFixed32(index_.data() + num_groups_ * layout_.key_size +
+                         g * sizeof(uint32_t));
+  }
+  // Number of groups whose first user key is less than `user_key`, or at
+  // most `user_key` if `or_equal`
+  uint64_t CountGroupsBefore(const Slice& user_key, bool or_equal) const;
+
+  const ImmutableOptions& ioptions_;
+  const InternalKeyComparator icomp_;
+  std::unique_ptr<RandomAccessFileReader> file_;
+  std::shared_ptr<const TableProperties> table_props_;
+  Status status_;
+  FixedWidthTableLayout layout_;
+  uint64_t num_records_ = 0;
+  uint64_t num_groups_ = 0;
+  // The keys are ordered as their first 8 bytes, as big-endian integers
+  bool interpolate_ = false;
+  Slice index_;
+  BlockContents index_contents_;
+  std::shared_ptr<FragmentedRangeTombstoneList> fragmented_range_dels_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -118,7 +118,16 @@ inline uint32_t GetCompressFormatForVersion(uint32_t format_version) {
   return format_version >= 2 ? 2 : 1;
 }
 
-constexpr uint32_t kLatestFormatVersion = 5;
+constexpr uint32_t kLatestFormatVersion = 6;
+
+// As of format_version 6, data blocks can have separated values, be made of
+// mini-blocks or have delta-of-delta encoded keys (see
+// BlockBasedTableOptions::data_block_separate_values,
+// data_block_mini_block_restarts and data_block_delta_of_delta_keys), which
+// older versions cannot read.
+inline bool FormatVersionSupportsDataBlockLayouts(uint32_t format_version) {
+  return format_version >= 6;
+}
 
 inline bool IsSupportedFormatVersion(uint32_t version) {
   return version <= kLatestFormatVersion;
@@ -26,6 +26,16 @@ Status Iterator::GetProperty(std::string prop_name, std::string* prop) {
   return Status::InvalidArgument("Unidentified property.");
 }
 
+Status Iterator::NextBatch(size_t max_entries, IteratorBatch* batch) {
+  assert(batch != nullptr);
+  batch->Clear();
+  while (batch->size() < max_entries && Valid()) {
+    batch->Add(key(), value());
+    Next();
+  }
+  return status();
+}
+
 namespace {
 class EmptyIterator : public Iterator {
  public:
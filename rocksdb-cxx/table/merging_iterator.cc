@@ -60,7 +60,7 @@ class MergingIterator : public InternalIterator {
         direction_(kForward),
         comparator_(comparator),
         current_(nullptr),
-        minHeap_(MinHeapItemComparator(comparator_)),
+        minHeap_(MinHeapItemComparator(comparator_), HeapItemSlot()),
         pinned_iters_mgr_(nullptr),
         iterate_upper_bound_(iterate_upper_bound) {
     children_.resize(n);
@@ -544,8 +544,18 @@ class MergingIterator : public InternalIterator {
     const InternalKeyComparator* comparator_;
   };
 
-  using MergerMinIterHeap = BinaryHeap<HeapItem*, MinHeapItemComparator>;
-  using MergerMaxIterHeap = BinaryHeap<HeapItem*, MaxHeapItemComparator>;
+  // The point iterator and the range tombstone of each level have their own
+  // slots in the tournament trees
+  struct HeapItemSlot {
+    size_t operator()(HeapItem* item) const {
+      return 2 * item->level + (item->type == HeapItem::Type::ITERATOR ? 0 : 1);
+    }
+  };
+
+  using MergerMinIterHeap =
+      TournamentTree<HeapItem*, MinHeapItemComparator, HeapItemSlot>;
+  using MergerMaxIterHeap =
+      TournamentTree<HeapItem*, MaxHeapItemComparator, HeapItemSlot>;
 
   friend class MergeIteratorBuilder;
   // Clears heaps for both directions, used when changing direction or seeking
@@ -1417,7 +1427,8 @@ void MergingIterator::ClearHeaps(bool clear_active) {
 void MergingIterator::InitMaxHeap() {
   if (!maxHeap_) {
     maxHeap_ =
-        std::make_unique<MergerMaxIterHeap>(MaxHeapItemComparator(comparator_));
+        std::make_unique<MergerMaxIterHeap>(MaxHeapItemComparator(comparator_),
+                                            HeapItemSlot());
   }
 }
 
@@ -0,0 +1,90 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/comparator.h"
+#include "rocksdb/filter_policy.h"
+#include "rocksdb/slice.h"
+#include "table/block_based/filter_policy_internal.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// In-memory copies of the whole key filters of a table file, kept with its
+// FileMetaData so that point lookups can rule out the file without going
+// through the table cache and the block cache. A full filter is kept as a
+// single filter; a partitioned filter as one filter per partition, each
+// covering the user keys up to and including the separator of its partition.
+class PinnedFilters {
+ public:
+  // Adds a copy of the filter for the user keys after those of the previous
+  // filter, up to and including `largest_user_key`. The last filter added
+  // also covers all keys after it.
+  void Add(const Slice& largest_user_key, const Slice& contents,
+           const FilterPolicy* filter_policy) {
+    filters_.emplace_back();
+    Filter& filter = filters_.back();
+    filter.largest_user_key = largest_user_key.ToString();
+    filter.data.reset(new char[contents.size()]);
+    memcpy(filter.data.get(), contents.data(), contents.size());
+    filter.size = contents.size();
+    filter.reader.reset(filter_policy->GetFilterBitsReader(
+        Slice(filter.data.get(), filter.size)));
+    memory_usage_ += sizeof(Filter) + filter.largest_user_key.size() +
+                     filter.size;
+  }
+
+  bool empty() const { return filters_.empty(); }
+
+  // Returns false if the user key is definitely not in the table
+  bool KeyMayMatch(const Comparator* ucmp, const Slice& user_key) const {
+    if (filters_.empty()) {
+      return true;
+    }
+    // Find the first filter whose range may include the key
+    size_t left = 0;
+    size_t right = filters_.size() - 1;
+    while (left < right) {
+      size_t mid = left + (right - left) / 2;
+      if (ucmp->Compare(filters_[mid].largest_user_key, user_key) < 0) {
+        left = mid + 1;
+      } else {
+        right = mid;
+      }
+    }
+    // With separators that include sequence numbers, the versions of a user
+    // key can span partitions, so also check the following ones.
+    for (size_t i = left; i < filters_.size(); ++i) {
+      const Filter& filter = filters_[i];
+      if (filter.reader == nullptr || filter.reader->MayMatch(user_key)) {
+        return true;
+      }
+      if (ucmp->Compare(filter.largest_user_key, user_key) != 0) {
+        break;
+      }
+    }
+    return false;
+  }
+
+  size_t ApproximateMemoryUsage() const { return memory_usage_; }
+
+ private:
+  struct Filter {
+    std::string largest_user_key;
+    std::unique_ptr<char[]> data;
+    size_t size = 0;
+    // References data
+    std::unique_ptr<FilterBitsReader> reader;
+  };
+  std::vector<Filter> filters_;
+  size_t memory_usage_ = 0;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
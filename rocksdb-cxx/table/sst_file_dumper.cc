@@ -30,6 +30,7 @@
 #include "table/block_based/block_based_table_builder.h"
 #include "table/block_based/block_based_table_factory.h"
 #include "table/block_based/block_builder.h"
+#include "table/fixed_width/fixed_width_table_factory.h"
 #include "table/format.h"
 #include "table/meta_blocks.h"
 #include "table/plain/plain_table_factory.h"
@@ -414,6 +415,12 @@ Status SstFileDumper::SetTableOptionsByMagicNumber(
     if (!silent_) {
       fprintf(stdout, "Sst file format: plain table\n");
     }
+  } else if (table_magic_number == kFixedWidthTableMagicNumber) {
+    // The table reader takes the sizes of records from the file
+    options_.table_factory.reset(NewFixedWidthTableFactory());
+    if (!silent_) {
+      fprintf(stdout, "Sst file format: fixed-width table\n");
+    }
   } else {
     char error_msg_buffer[80];
     snprintf(error_msg_buffer, sizeof(error_msg_buffer) - 1,
@@ -12,8 +12,7 @@
 
 #include "db/range_tombstone_fragmenter.h"
 #if USE_COROUTINES
-#include "folly/experimental/coro/Coroutine.h"
-#include "folly/experimental/coro/Task.h"
+#include "util/coro_task.h"
 #endif
 #include "rocksdb/slice_transform.h"
 #include "rocksdb/table_reader_caller.h"
@@ -31,6 +30,7 @@ struct ReadOptions;
 struct TableProperties;
 class GetContext;
 class MultiGetContext;
+class PinnedFilters;
 
 // A Table (also referred to as SST) is a sorted map from strings to strings.
 // Tables are immutable and persistent.  A Table may be safely accessed from
@@ -103,6 +103,16 @@ class TableReader {
     return Status::NotSupported("ApproximateKeyAnchors() not supported.");
   }
 
+  // Returns in *filters in-memory copies of the table's whole key filters,
+  // which can be kept with the file metadata to check user keys without the
+  // table reader. Returns NotSupported if the table has no such filters or is
+  // not configured to copy them.
+  virtual Status GetPinnedFilters(
+      const ReadOptions& /*read_options*/,
+      std::shared_ptr<const PinnedFilters>* /*filters*/) {
+    return Status::NotSupported("GetPinnedFilters() not supported.");
+  }
+
   // Set up the table for Compaction. Might change some parameters with
   // posix_fadvise
   virtual void SetupForCompaction() = 0;
@@ -151,7 +161,7 @@ class TableReader {
   }
 
 #if USE_COROUTINES
-  virtual folly::coro::Task<void> MultiGetCoroutine(
+  virtual CoroTask<void> MultiGetCoroutine(
       const ReadOptions& readOptions, const MultiGetContext::Range* mget_range,
       const SliceTransform* prefix_extractor, bool skip_filters = false) {
     MultiGet(readOptions, mget_range, prefix_extractor, skip_filters);
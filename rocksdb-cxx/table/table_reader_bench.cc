@@ -276,6 +276,10 @@ DEFINE_bool(mmap_read, true, "Whether use mmap read");
 DEFINE_string(table_factory, "block_based",
               "Table factory to use: `block_based` (default), `plain_table` or "
               "`cuckoo_hash`.");
+DEFINE_int32(block_size, 4096, "Data block size of `block_based` tables");
+DEFINE_bool(data_block_restart_key_prefixes, false,
+            "Store restart key prefixes in data blocks of `block_based` "
+            "tables.");
 DEFINE_string(time_unit, "microsecond",
               "The time unit used for measuring performance. User can specify "
               "`microsecond` (default) or `nanosecond`");
@@ -315,7 +319,11 @@ int main(int argc, char** argv) {
     options.prefix_extractor.reset(
         ROCKSDB_NAMESPACE::NewFixedPrefixTransform(FLAGS_prefix_len));
   } else if (FLAGS_table_factory == "block_based") {
-    tf.reset(new ROCKSDB_NAMESPACE::BlockBasedTableFactory());
+    ROCKSDB_NAMESPACE::BlockBasedTableOptions table_options;
+    table_options.block_size = FLAGS_block_size;
+    table_options.data_block_restart_key_prefixes =
+        FLAGS_data_block_restart_key_prefixes;
+    tf.reset(new ROCKSDB_NAMESPACE::BlockBasedTableFactory(table_options));
   } else {
     fprintf(stderr, "Invalid table type %s\n", FLAGS_table_factory.c_str());
   }
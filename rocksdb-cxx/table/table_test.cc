@@ -5136,6 +5136,58 @@ TEST_P(BlockBasedTableTest, CompressionRatioThreshold) {
   }
 }
 
+TEST_P(BlockBasedTableTest, DataBlockLayoutsFormatVersion) {
+  // Tables whose data blocks older versions cannot read are written with a
+  // format_version those versions refuse. Layouts: 0 is the regular one, 1
+  // separated values, 2 mini-blocks, 3 delta-of-delta keys.
+  for (int layout = 0; layout < 4; ++layout) {
+    TableConstructor c(BytewiseComparator(),
+                       true /* convert_to_internal_key_ */);
+    c.Add("a1", "val1");
+    c.Add("b2", "val2");
+    c.Add("c3", "val3");
+
+    Options options;
+    BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+    table_options.data_block_separate_values = layout == 1;
+    table_options.data_block_mini_block_restarts = layout == 2 ? 1 : 0;
+    table_options.data_block_delta_of_delta_keys = layout == 3;
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    ImmutableOptions ioptions(options);
+    MutableCFOptions moptions(options);
+    std::vector<std::string> keys;
+    stl_wrappers::KVMap kvmap;
+    c.Finish(options, ioptions, moptions, table_options,
+             GetPlainInternalComparator(options.comparator), &keys, &kvmap);
+
+    test::StringSink* table_sink = c.TEST_GetSink();
+    std::unique_ptr<FSRandomAccessFile> source(new test::StringSource(
+        table_sink->contents(), 0 /* unique_id */,
+        false /* allow_mmap_reads */));
+    std::unique_ptr<RandomAccessFileReader> table_reader(
+        new RandomAccessFileReader(std::move(source), "test"));
+    Footer footer;
+    ASSERT_OK(ReadFooterFromFile(IOOptions(), table_reader.get(),
+                                 *FileSystem::Default(),
+                                 nullptr /* prefetch_buffer */,
+                                 table_sink->contents().size(), &footer,
+                                 kBlockBasedTableMagicNumber));
+    if (layout > 0) {
+      ASSERT_EQ(std::max(table_options.format_version, 6U),
+                footer.format_version());
+    } else {
+      ASSERT_EQ(table_options.format_version, footer.format_version());
+    }
+
+    std::unique_ptr<InternalIterator> iter(
+        c.NewIterator(moptions.prefix_extractor.get()));
+    iter->SeekToFirst();
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ("val1", iter->value().ToString());
+    ASSERT_OK(iter->status());
+  }
+}
+
 TEST_P(BlockBasedTableTest, PropertiesMetaBlockLast) {
   // The properties meta-block should come at the end since we always need to
   // read it when opening a file, unlike index/filter/other meta-blocks, which
@@ -226,9 +226,10 @@ BlockBasedTableOptions RandomBlockBasedTableOptions(Random* rnd) {
   opt.pin_l0_filter_and_index_blocks_in_cache = rnd->Uniform(2);
   opt.pin_top_level_index_and_filter = rnd->Uniform(2);
   using IndexType = BlockBasedTableOptions::IndexType;
-  const std::array<IndexType, 4> index_types = {
+  const std::array<IndexType, 5> index_types = {
       {IndexType::kBinarySearch, IndexType::kHashSearch,
-       IndexType::kTwoLevelIndexSearch, IndexType::kBinarySearchWithFirstKey}};
+       IndexType::kTwoLevelIndexSearch, IndexType::kBinarySearchWithFirstKey,
+       IndexType::kLearnedIndexSearch}};
   opt.index_type =
       index_types[rnd->Uniform(static_cast<int>(index_types.size()))];
   opt.checksum = static_cast<ChecksumType>(rnd->Uniform(3));
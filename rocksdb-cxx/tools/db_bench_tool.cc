@@ -601,6 +601,10 @@ DEFINE_uint32(
     "compress_format_version == 2 -- decompressed size is included"
     " in the block header in varint32 format.");
 
+DEFINE_int32(compressed_secondary_cache_num_decompression_threads, 0,
+             "Number of background threads helping to decompress batches of "
+             "CompressedSecondaryCache hits, e.g. from MultiGet.");
+
 DEFINE_int64(simcache_size, -1,
              "Number of bytes to use as a simcache of "
              "uncompressed data. Nagative value disables simcache.");
@@ -621,11 +625,25 @@ DEFINE_bool(partition_index, false, "Partition index blocks");
 
 DEFINE_bool(index_with_first_key, false, "Include first key in the index");
 
+DEFINE_bool(learned_index, false,
+            "Use a learned (piecewise linear) index, kLearnedIndexSearch");
+
+DEFINE_uint32(learned_index_max_error,
+              ROCKSDB_NAMESPACE::BlockBasedTableOptions()
+                  .learned_index_max_error,
+              "Maximum error in restart points of the learned index model");
+
 DEFINE_bool(
     optimize_filters_for_memory,
     ROCKSDB_NAMESPACE::BlockBasedTableOptions().optimize_filters_for_memory,
     "Minimize memory footprint of filters");
 
+DEFINE_int32(filter_construction_threads,
+             ROCKSDB_NAMESPACE::BlockBasedTableOptions()
+                 .filter_construction_threads,
+             "Background threads per table builder for finishing filter "
+             "partitions, with partitioned filters");
+
 DEFINE_int64(
     index_shortening_mode, 2,
     "mode to shorten index: 0 for no shortening; 1 for only shortening "
@@ -677,6 +695,11 @@ DEFINE_bool(
     ROCKSDB_NAMESPACE::BlockBasedTableOptions().enable_index_compression,
     "Compress the index block");
 
+DEFINE_bool(adaptive_compression,
+            ROCKSDB_NAMESPACE::BlockBasedTableOptions().adaptive_compression,
+            "Choose the compression of each data block from its entropy and "
+            "the compression ratio of recent blocks");
+
 DEFINE_bool(block_align,
             ROCKSDB_NAMESPACE::BlockBasedTableOptions().block_align,
             "Align data blocks on page size");
@@ -695,6 +718,41 @@ DEFINE_double(data_block_hash_table_util_ratio, 0.75,
               "This is only valid if use_data_block_hash_index is "
               "set to true");
 
+DEFINE_bool(data_block_restart_key_prefixes,
+            ROCKSDB_NAMESPACE::BlockBasedTableOptions()
+                .data_block_restart_key_prefixes,
+            "Store a fixed-width prefix of each restart key in data blocks "
+            "to speed up seeks within blocks");
+
+DEFINE_bool(data_block_separate_values,
+            ROCKSDB_NAMESPACE::BlockBasedTableOptions()
+                .data_block_separate_values,
+            "Store the keys and the values of data blocks in separately "
+            "compressed sections");
+
+DEFINE_uint32(data_block_mini_block_restarts,
+              ROCKSDB_NAMESPACE::BlockBasedTableOptions()
+                  .data_block_mini_block_restarts,
+              "If non-zero, compress data blocks in mini-blocks of this many "
+              "restart intervals, so that point lookups only decompress one");
+
+DEFINE_bool(data_block_delta_of_delta_keys,
+            ROCKSDB_NAMESPACE::BlockBasedTableOptions()
+                .data_block_delta_of_delta_keys,
+            "Store the trailing 8-byte integers of the keys of data blocks "
+            "as bit-packed deltas of deltas");
+
+DEFINE_bool(key_only, false,
+            "Set ReadOptions::key_only for iterators, which then skip "
+            "reading values where possible");
+
+DEFINE_double(range_filter_bits_per_key,
+              ROCKSDB_NAMESPACE::BlockBasedTableOptions()
+                  .range_filter_bits_per_key,
+              "If positive, build SST range filters with this many bits per "
+              "key. Bounded seeks (e.g. seekrandom with --max_scan_distance) "
+              "use them to skip files without keys in the range");
+
 DEFINE_int64(compressed_cache_size, -1,
              "Number of bytes to use as a cache of compressed data.");
 
@@ -1147,11 +1205,34 @@ DEFINE_int32(trace_replay_threads, 1,
 DEFINE_bool(io_uring_enabled, true,
             "If true, enable the use of IO uring if the platform supports it");
 extern "C" bool RocksDbIOUringEnable() { return FLAGS_io_uring_enabled; }
+DEFINE_uint32(io_uring_sqpoll_idle_ms, 0,
+              "If non-zero, create io_uring instances with a kernel submission "
+              "queue polling thread that sleeps after this many idle "
+              "milliseconds");
+extern "C" unsigned int RocksDbIOUringSqPollIdleMs() {
+  return FLAGS_io_uring_sqpoll_idle_ms;
+}
+DEFINE_uint32(io_uring_fixed_files, 0,
+              "Number of SST files to keep registered with each io_uring "
+              "instance");
+extern "C" unsigned int RocksDbIOUringNumFixedFiles() {
+  return FLAGS_io_uring_fixed_files;
+}
+DEFINE_uint32(io_uring_fixed_buffers, 0,
+              "Number of 64KB read buffers registered with each io_uring "
+              "instance, used by direct I/O MultiRead");
+extern "C" unsigned int RocksDbIOUringNumFixedBuffers() {
+  return FLAGS_io_uring_fixed_buffers;
+}
 
 DEFINE_bool(adaptive_readahead, false,
             "carry forward internal auto readahead size from one file to next "
             "file at each level during iteration");
 
+DEFINE_uint64(iterator_batch_size, 0,
+              "If positive, readseq reads this many entries per call to "
+              "Iterator::NextBatch() instead of calling Next()");
+
 DEFINE_bool(rate_limit_user_ops, false,
             "When true use Env::IO_USER priority level to charge internal rate "
             "limiter for reads associated with user operations.");
@@ -1664,6 +1745,12 @@ DEFINE_bool(use_plain_table, false,
             "if use plain table instead of block-based table format");
 DEFINE_bool(use_cuckoo_table, false, "if use cuckoo table format");
 DEFINE_double(cuckoo_hash_ratio, 0.9, "Hash ratio for Cuckoo SST table.");
+DEFINE_bool(use_fixed_width_table, false,
+            "if use fixed-width table format, for --key_size (plus "
+            "--user_timestamp_size) and fixed --value_size");
+DEFINE_uint32(fixed_width_records_per_group,
+              ROCKSDB_NAMESPACE::FixedWidthTableOptions().records_per_group,
+              "Number of records per group of fixed-width SST table.");
 DEFINE_bool(use_hash_search, false,
             "if use kHashSearch instead of kBinarySearch. "
             "This is valid if only we use BlockTable");
@@ -3047,6 +3134,8 @@ class Benchmark {
             FLAGS_compressed_secondary_cache_compression_type_e;
         secondary_cache_opts.compress_format_version =
             FLAGS_compressed_secondary_cache_compress_format_version;
+        secondary_cache_opts.num_decompression_threads =
+            FLAGS_compressed_secondary_cache_num_decompression_threads;
         opts.secondary_cache =
             NewCompressedSecondaryCache(secondary_cache_opts);
       }
@@ -3324,6 +3413,7 @@ class Benchmark {
       read_options_.adaptive_readahead = FLAGS_adaptive_readahead;
       read_options_.async_io = FLAGS_async_io;
       read_options_.optimize_multiget_for_io = FLAGS_optimize_multiget_for_io;
+      read_options_.key_only = FLAGS_key_only;
 
       void (Benchmark::*method)(ThreadState*) = nullptr;
       void (Benchmark::*post_process_method)() = nullptr;
@@ -4189,6 +4279,18 @@ class Benchmark {
       table_options.identity_as_first_hash = FLAGS_identity_as_first_hash;
       options.table_factory =
           std::shared_ptr<TableFactory>(NewCuckooTableFactory(table_options));
+    } else if (FLAGS_use_fixed_width_table) {
+      if (FLAGS_value_size_distribution_type_e != kFixed) {
+        fprintf(stderr, "fixed-width table format requires fixed values\n");
+        exit(1);
+      }
+
+      ROCKSDB_NAMESPACE::FixedWidthTableOptions table_options;
+      table_options.key_size = FLAGS_key_size + FLAGS_user_timestamp_size;
+      table_options.value_size = FLAGS_value_size;
+      table_options.records_per_group = FLAGS_fixed_width_records_per_group;
+      options.table_factory = std::shared_ptr<TableFactory>(
+          NewFixedWidthTableFactory(table_options));
     } else {
       BlockBasedTableOptions block_based_options;
       block_based_options.checksum =
@@ -4223,7 +4325,12 @@ class Benchmark {
       } else if (FLAGS_index_with_first_key) {
         block_based_options.index_type =
             BlockBasedTableOptions::kBinarySearchWithFirstKey;
+      } else if (FLAGS_learned_index) {
+        block_based_options.index_type =
+            BlockBasedTableOptions::kLearnedIndexSearch;
       }
+      block_based_options.learned_index_max_error =
+          FLAGS_learned_index_max_error;
       BlockBasedTableOptions::IndexShorteningMode index_shortening =
           block_based_options.index_shortening;
       switch (FLAGS_index_shortening_mode) {
@@ -4244,6 +4351,8 @@ class Benchmark {
       }
       block_based_options.optimize_filters_for_memory =
           FLAGS_optimize_filters_for_memory;
+      block_based_options.filter_construction_threads =
+          FLAGS_filter_construction_threads;
       block_based_options.index_shortening = index_shortening;
       if (cache_ == nullptr) {
         block_based_options.no_block_cache = true;
@@ -4299,6 +4408,7 @@ class Benchmark {
       block_based_options.read_amp_bytes_per_bit = FLAGS_read_amp_bytes_per_bit;
       block_based_options.enable_index_compression =
           FLAGS_enable_index_compression;
+      block_based_options.adaptive_compression = FLAGS_adaptive_compression;
       block_based_options.block_align = FLAGS_block_align;
       block_based_options.whole_key_filtering = FLAGS_whole_key_filtering;
       block_based_options.max_auto_readahead_size =
@@ -4331,6 +4441,16 @@ class Benchmark {
       }
       block_based_options.data_block_hash_table_util_ratio =
           FLAGS_data_block_hash_table_util_ratio;
+      block_based_options.data_block_restart_key_prefixes =
+          FLAGS_data_block_restart_key_prefixes;
+      block_based_options.data_block_separate_values =
+          FLAGS_data_block_separate_values;
+      block_based_options.data_block_mini_block_restarts =
+          FLAGS_data_block_mini_block_restarts;
+      block_based_options.data_block_delta_of_delta_keys =
+          FLAGS_data_block_delta_of_delta_keys;
+      block_based_options.range_filter_bits_per_key =
+          FLAGS_range_filter_bits_per_key;
       if (FLAGS_read_cache_path != "") {
         Status rc_status;
 
@@ -5711,6 +5831,30 @@ class Benchmark {
     Iterator* iter = db->NewIterator(options);
     int64_t i = 0;
     int64_t bytes = 0;
+    if (FLAGS_iterator_batch_size > 0) {
+      IteratorBatch batch;
+      for (iter->SeekToFirst(); i < reads_ && iter->Valid();) {
+        size_t batch_size = static_cast<size_t>(
+            std::min<uint64_t>(FLAGS_iterator_batch_size, reads_ - i));
+        Status s = iter->NextBatch(batch_size, &batch);
+        if (!s.ok()) {
+          fprintf(stderr, "NextBatch failed: %s\n", s.ToString().c_str());
+          ErrorExit();
+        }
+        bytes += batch.keys().size() + batch.values().size();
+        thread->stats.FinishedOps(nullptr, db, batch.size(), kRead);
+        i += batch.size();
+
+        if (thread->shared->read_rate_limiter.get() != nullptr) {
+          thread->shared->read_rate_limiter->Request(
+              batch.size(), Env::IO_HIGH, nullptr /* stats */,
+              RateLimiter::OpType::kRead);
+        }
+      }
+      delete iter;
+      thread->stats.AddBytes(bytes);
+      return;
+    }
     for (iter->SeekToFirst(); i < reads_ && iter->Valid(); iter->Next()) {
       bytes += iter->key().size() + iter->value().size();
       thread->stats.FinishedOps(nullptr, db, 1, kRead);
@@ -42,25 +42,34 @@ void AsyncFileReader::Wait() {
   if (!head_) {
     return;
   }
+  // Detach the current queue. Resumed coroutines may issue more reads, which
+  // are queued afresh and waited for by the next call.
+  ReadAwaiter* const head = head_;
+  ReadAwaiter* const tail = tail_;
+  const size_t num_reqs = num_reqs_;
+  head_ = tail_ = nullptr;
+  num_reqs_ = 0;
+
   ReadAwaiter* waiter;
   std::vector<void*> io_handles;
   IOStatus s;
-  io_handles.reserve(num_reqs_);
-  waiter = head_;
+  io_handles.reserve(num_reqs);
+  waiter = head;
   do {
     for (size_t i = 0; i < waiter->num_reqs_; ++i) {
       if (waiter->io_handle_[i]) {
         io_handles.push_back(waiter->io_handle_[i]);
       }
     }
-  } while (waiter != tail_ && (waiter = waiter->next_));
+  } while (waiter != tail && (waiter = waiter->next_));
   if (io_handles.size() > 0) {
     StopWatch sw(SystemClock::Default().get(), stats_, POLL_WAIT_MICROS);
     s = fs_->Poll(io_handles, io_handles.size());
   }
-  do {
-    waiter = head_;
-    head_ = waiter->next_;
+  for (ReadAwaiter* next = head; next != nullptr;) {
+    waiter = next;
+    // Resuming may destroy the awaiter, so step ahead first
+    next = waiter == tail ? nullptr : waiter->next_;
 
     for (size_t i = 0; i < waiter->num_reqs_; ++i) {
       if (waiter->io_handle_[i] && waiter->del_fn_[i]) {
@@ -72,10 +81,8 @@ void AsyncFileReader::Wait() {
       }
     }
     waiter->awaiting_coro_.resume();
-  } while (waiter != tail_);
-  head_ = tail_ = nullptr;
-  RecordInHistogram(stats_, MULTIGET_IO_BATCH_SIZE, num_reqs_);
-  num_reqs_ = 0;
+  }
+  RecordInHistogram(stats_, MULTIGET_IO_BATCH_SIZE, num_reqs);
 }
 }  // namespace ROCKSDB_NAMESPACE
 #endif  // USE_COROUTINES
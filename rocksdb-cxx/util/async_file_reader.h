@@ -6,8 +6,9 @@
 #pragma once
 
 #if USE_COROUTINES
+#include <coroutine>
+
 #include "file/random_access_file_reader.h"
-#include "folly/experimental/coro/ViaIfAsync.h"
 #include "port/port.h"
 #include "rocksdb/file_system.h"
 #include "rocksdb/statistics.h"
@@ -24,21 +25,17 @@ class SingleThreadExecutor;
 // awaiting coroutine. The suspended awaiter is later resumed by Wait().
 class AsyncFileReader {
   class ReadAwaiter;
-  template <typename Awaiter>
-  class ReadOperation;
 
  public:
   AsyncFileReader(FileSystem* fs, Statistics* stats) : fs_(fs), stats_(stats) {}
 
   ~AsyncFileReader() {}
 
-  ReadOperation<ReadAwaiter> MultiReadAsync(RandomAccessFileReader* file,
-                                            const IOOptions& opts,
-                                            FSReadRequest* read_reqs,
-                                            size_t num_reqs,
-                                            AlignedBuf* aligned_buf) noexcept {
-    return ReadOperation<ReadAwaiter>{*this,     file,     opts,
-                                      read_reqs, num_reqs, aligned_buf};
+  ReadAwaiter MultiReadAsync(RandomAccessFileReader* file,
+                             const IOOptions& opts, FSReadRequest* read_reqs,
+                             size_t num_reqs,
+                             AlignedBuf* aligned_buf) noexcept {
+    return ReadAwaiter{*this, file, opts, read_reqs, num_reqs, aligned_buf};
   }
 
  private:
@@ -62,8 +59,7 @@ class AsyncFileReader {
     // A return value of true means suspend the awaiter (calling coroutine). The
     // awaiting_coro parameter is the handle of the awaiter. The handle can be
     // resumed later, so we cache it here.
-    bool await_suspend(
-        folly::coro::impl::coroutine_handle<> awaiting_coro) noexcept {
+    bool await_suspend(std::coroutine_handle<> awaiting_coro) noexcept {
       awaiting_coro_ = awaiting_coro;
       // MultiReadAsyncImpl always returns true, so caller will be suspended
       return reader_.MultiReadAsyncImpl(this);
@@ -84,51 +80,24 @@ class AsyncFileReader {
     size_t num_reqs_;
     autovector<void*, 32> io_handle_;
     autovector<IOHandleDeleter, 32> del_fn_;
-    folly::coro::impl::coroutine_handle<> awaiting_coro_;
+    std::coroutine_handle<> awaiting_coro_;
     // Use this to link to the next ReadAwaiter in the suspended coroutine
     // list. The head and tail of the list are tracked by AsyncFileReader.
     // We use this approach rather than an STL container in order to avoid
-    // extra memory allocations. The coroutine call already allocates a
+    // extra memory allocations. The coroutine frame already holds the
     // ReadAwaiter object.
     ReadAwaiter* next_;
   };
 
-  // An instance of ReadOperation is returned to the caller of MultiGetAsync.
-  // This represents an awaitable that can be started later.
-  template <typename Awaiter>
-  class ReadOperation {
-   public:
-    explicit ReadOperation(AsyncFileReader& reader,
-                           RandomAccessFileReader* file, const IOOptions& opts,
-                           FSReadRequest* read_reqs, size_t num_reqs,
-                           AlignedBuf* aligned_buf) noexcept
-        : reader_(reader),
-          file_(file),
-          opts_(opts),
-          read_reqs_(read_reqs),
-          num_reqs_(num_reqs),
-          aligned_buf_(aligned_buf) {}
-
-    auto viaIfAsync(folly::Executor::KeepAlive<> executor) const {
-      return folly::coro::co_viaIfAsync(
-          std::move(executor),
-          Awaiter{reader_, file_, opts_, read_reqs_, num_reqs_, aligned_buf_});
-    }
-
-   private:
-    AsyncFileReader& reader_;
-    RandomAccessFileReader* file_;
-    const IOOptions& opts_;
-    FSReadRequest* read_reqs_;
-    size_t num_reqs_;
-    AlignedBuf* aligned_buf_;
-  };
-
   // This function does the actual work when this awaitable starts execution
   bool MultiReadAsyncImpl(ReadAwaiter* awaiter);
 
+  // Whether any awaiter is suspended waiting for IO
+  bool HasPending() const { return head_ != nullptr; }
+
   // Called by the SingleThreadExecutor to poll for async IO completion.
-  // This also resumes the awaiting coroutines.
+  // This also resumes the awaiting coroutines. Reads issued by the resumed
+  // coroutines are collected for the next call.
   void Wait();
 
   // Head of the queue of awaiters waiting for async IO completion
@@ -0,0 +1,168 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+#pragma once
+
+#if USE_COROUTINES
+#include <cassert>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+#include "rocksdb/rocksdb_namespace.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+template <typename T>
+class CoroTask;
+
+namespace coro_detail {
+
+// Common part of the promise types of CoroTask<T> and CoroTask<void>. The
+// coroutine body does not start until the task is awaited or started by an
+// executor, and on completion control transfers straight back to the
+// awaiting coroutine, if any, without growing the stack.
+class PromiseBase {
+ public:
+  struct FinalAwaiter {
+    bool await_ready() noexcept { return false; }
+
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(
+        std::coroutine_handle<Promise> h) noexcept {
+      std::coroutine_handle<> continuation = h.promise().continuation_;
+      if (continuation) {
+        return continuation;
+      }
+      // Started by an executor, which checks done() on the handle
+      return std::noop_coroutine();
+    }
+
+    void await_resume() noexcept {}
+  };
+
+  std::suspend_always initial_suspend() noexcept { return {}; }
+
+  FinalAwaiter final_suspend() noexcept { return {}; }
+
+  // RocksDB does not use exceptions for error handling
+  void unhandled_exception() noexcept { std::terminate(); }
+
+  void set_continuation(std::coroutine_handle<> continuation) {
+    continuation_ = continuation;
+  }
+
+ private:
+  std::coroutine_handle<> continuation_;
+};
+
+template <typename T>
+class Promise : public PromiseBase {
+ public:
+  CoroTask<T> get_return_object() noexcept;
+
+  void return_value(T value) { value_.emplace(std::move(value)); }
+
+  T TakeResult() {
+    assert(value_.has_value());
+    return std::move(*value_);
+  }
+
+ private:
+  std::optional<T> value_;
+};
+
+template <>
+class Promise<void> : public PromiseBase {
+ public:
+  CoroTask<void> get_return_object() noexcept;
+
+  void return_void() noexcept {}
+
+  void TakeResult() {}
+};
+
+}  // namespace coro_detail
+
+// CoroTask<T> is a lazily started, single-owner C++20 coroutine returning T.
+// `co_await task` runs it to completion (suspending the awaiting coroutine
+// whenever the task suspends on IO) and yields its result. Top-level tasks
+// are driven by SingleThreadExecutor::CollectAll().
+template <typename T>
+class CoroTask {
+ public:
+  using promise_type = coro_detail::Promise<T>;
+  using Handle = std::coroutine_handle<promise_type>;
+
+  explicit CoroTask(Handle handle) noexcept : handle_(handle) {}
+
+  CoroTask(CoroTask&& other) noexcept
+      : handle_(std::exchange(other.handle_, nullptr)) {}
+
+  CoroTask& operator=(CoroTask&& other) noexcept {
+    if (this != &other) {
+      Destroy();
+      handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+  }
+
+  CoroTask(const CoroTask&) = delete;
+  CoroTask& operator=(const CoroTask&) = delete;
+
+  ~CoroTask() { Destroy(); }
+
+  bool await_ready() const noexcept { return false; }
+
+  std::coroutine_handle<> await_suspend(
+      std::coroutine_handle<> awaiting) noexcept {
+    handle_.promise().set_continuation(awaiting);
+    return handle_;
+  }
+
+  T await_resume() { return handle_.promise().TakeResult(); }
+
+  // Run the task until it first suspends or completes. Used by executors for
+  // top-level tasks only.
+  void Start() {
+    assert(handle_ && !handle_.done());
+    handle_.resume();
+  }
+
+  bool IsDone() const { return handle_.done(); }
+
+  T TakeResult() {
+    assert(IsDone());
+    return handle_.promise().TakeResult();
+  }
+
+ private:
+  void Destroy() {
+    if (handle_) {
+      handle_.destroy();
+      handle_ = nullptr;
+    }
+  }
+
+  Handle handle_;
+};
+
+namespace coro_detail {
+
+template <typename T>
+CoroTask<T> Promise<T>::get_return_object() noexcept {
+  return CoroTask<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline CoroTask<void> Promise<void>::get_return_object() noexcept {
+  return CoroTask<void>(
+      std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+
+}  // namespace coro_detail
+}  // namespace ROCKSDB_NAMESPACE
+#endif  // USE_COROUTINES
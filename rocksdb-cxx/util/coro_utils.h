@@ -5,8 +5,7 @@
 //  (found in the LICENSE.Apache file in the root directory).
 
 #if defined(USE_COROUTINES)
-#include "folly/experimental/coro/Coroutine.h"
-#include "folly/experimental/coro/Task.h"
+#include "util/coro_task.h"
 #endif
 #include "rocksdb/rocksdb_namespace.h"
 
@@ -24,16 +23,15 @@ namespace ROCKSDB_NAMESPACE {
 // declarations for a given function
 #define DECLARE_SYNC_AND_ASYNC(__ret_type__, __func_name__, ...) \
   __ret_type__ __func_name__(__VA_ARGS__);                       \
-  folly::coro::Task<__ret_type__> __func_name__##Coroutine(__VA_ARGS__);
+  CoroTask<__ret_type__> __func_name__##Coroutine(__VA_ARGS__);
 
 #define DECLARE_SYNC_AND_ASYNC_OVERRIDE(__ret_type__, __func_name__, ...) \
   __ret_type__ __func_name__(__VA_ARGS__) override;                       \
-  folly::coro::Task<__ret_type__> __func_name__##Coroutine(__VA_ARGS__)   \
-      override;
+  CoroTask<__ret_type__> __func_name__##Coroutine(__VA_ARGS__) override;
 
 #define DECLARE_SYNC_AND_ASYNC_CONST(__ret_type__, __func_name__, ...) \
   __ret_type__ __func_name__(__VA_ARGS__) const;                       \
-  folly::coro::Task<__ret_type__> __func_name__##Coroutine(__VA_ARGS__) const;
+  CoroTask<__ret_type__> __func_name__##Coroutine(__VA_ARGS__) const;
 
 constexpr bool using_coroutines() { return true; }
 #else  // !USE_COROUTINES
@@ -68,9 +66,9 @@ constexpr bool using_coroutines() { return false; }
 // the function name with the Coroutine suffix. For example -
 // DEFINE_SYNC_AND_ASYNC(int, foo)(bool bar) {}
 // would expand to -
-// folly::coro::Task<int> fooCoroutine(bool bar) {}
+// CoroTask<int> fooCoroutine(bool bar) {}
 #define DEFINE_SYNC_AND_ASYNC(__ret_type__, __func_name__) \
-  folly::coro::Task<__ret_type__> __func_name__##Coroutine
+  CoroTask<__ret_type__> __func_name__##Coroutine
 
 // This macro should be used to call a function that might be a
 // coroutine. It expands to the correct function name and prefixes
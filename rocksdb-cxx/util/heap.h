@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <functional>
+#include <vector>
 
 #include "port/port.h"
 #include "util/autovector.h"
@@ -171,4 +172,154 @@ class BinaryHeap {
   size_t root_cmp_cache_ = std::numeric_limits<size_t>::max();
 };
 
+// Tournament tree over a fixed set of slots, as an alternative to BinaryHeap
+// for multi-way merging with few inputs that each keep their own slot. T must
+// be a pointer type; `get_slot(v)` gives the slot of element v, and at most
+// one element per slot can be in the tree. Same interface and ordering as
+// BinaryHeap, except that replace_top() must keep the slot of top().
+//
+// Each internal node holds the winner of its two subtrees, so an element whose
+// key changes, wherever it is, is replayed against the winners of the sibling
+// subtrees on its path to the root: at most log2(slots) comparisons, where
+// BinaryHeap needs up to 2logN to sift down. (A loser tree also does logN per
+// replacement of the top, but cannot insert at an arbitrary slot without a
+// rebuild, which the range tombstone elements of MergingIterator need.)
+//
+// The common case in a merge is that the top stays the top after its key is
+// replaced. For that, the runner-up, the best element outside the top's slot,
+// is cached once the top has kept its place, and then replace_top() costs one
+// comparison until the top changes or another slot is updated.
+template <typename T, typename Compare, typename GetSlot>
+class TournamentTree {
+ public:
+  TournamentTree(Compare cmp, GetSlot get_slot)
+      : cmp_(std::move(cmp)), get_slot_(std::move(get_slot)) {}
+
+  void push(T value) {
+    assert(value != nullptr);
+    const size_t slot = get_slot_(value);
+    if (slot >= num_leaves_) {
+      Grow(slot + 1);
+    }
+    assert(nodes_[num_leaves_ + slot] == nullptr);
+    nodes_[num_leaves_ + slot] = value;
+    ++size_;
+    Replay(slot, value);
+  }
+
+  const T& top() const {
+    assert(!empty());
+    return nodes_[1];
+  }
+
+  void replace_top(T value) {
+    assert(!empty());
+    assert(get_slot_(value) == get_slot_(top()));
+    const size_t slot = get_slot_(value);
+    nodes_[num_leaves_ + slot] = value;
+    T old_top = nodes_[1];
+    if (runner_up_ != nullptr && cmp_(runner_up_, value)) {
+      // Still beats the best of the other slots, so every node on its path
+      // keeps it as the winner
+      if (value != old_top) {
+        UpdatePath(slot, value);
+      }
+      return;
+    }
+    Replay(slot, value);
+    if (nodes_[1] == value && value == old_top) {
+      // Likely to stay on top for a while
+      runner_up_ = FindRunnerUp(slot);
+    }
+  }
+
+  void pop() {
+    assert(!empty());
+    const size_t slot = get_slot_(top());
+    nodes_[num_leaves_ + slot] = nullptr;
+    --size_;
+    Replay(slot, nullptr);
+  }
+
+  void clear() {
+    std::fill(nodes_.begin(), nodes_.end(), nullptr);
+    size_ = 0;
+    runner_up_ = nullptr;
+  }
+
+  bool empty() const { return size_ == 0; }
+
+  size_t size() const { return size_; }
+
+ private:
+  // The better of two elements, either of which may be missing
+  T Winner(T a, T b) const {
+    if (a == nullptr) {
+      return b;
+    }
+    if (b == nullptr) {
+      return a;
+    }
+    return cmp_(a, b) ? b : a;
+  }
+
+  // Recomputes the winners on the path from `slot`, whose element is now
+  // `value` (or nullptr), to the root.
+  void Replay(size_t slot, T value) {
+    runner_up_ = nullptr;
+    for (size_t node = (num_leaves_ + slot) / 2; node > 0; node /= 2) {
+      T winner = Winner(nodes_[2 * node], nodes_[2 * node + 1]);
+      if (winner == nodes_[node] && winner != value) {
+        // An unchanged element still wins here, so nothing above changes
+        return;
+      }
+      nodes_[node] = winner;
+    }
+  }
+
+  // Sets `value`, the winner on the path from `slot`, on that path
+  void UpdatePath(size_t slot, T value) {
+    for (size_t node = (num_leaves_ + slot) / 2; node > 0; node /= 2) {
+      nodes_[node] = value;
+    }
+  }
+
+  // The best element outside `slot`, which is the best winner of the sibling
+  // subtrees on its path
+  T FindRunnerUp(size_t slot) const {
+    T best = nullptr;
+    for (size_t node = num_leaves_ + slot; node > 1; node /= 2) {
+      best = Winner(best, nodes_[node ^ 1]);
+    }
+    return best;
+  }
+
+  void Grow(size_t min_leaves) {
+    size_t num_leaves = std::max<size_t>(num_leaves_, 1);
+    while (num_leaves < min_leaves) {
+      num_leaves *= 2;
+    }
+    std::vector<T> nodes(2 * num_leaves, nullptr);
+    for (size_t slot = 0; slot < num_leaves_; ++slot) {
+      nodes[num_leaves + slot] = nodes_[num_leaves_ + slot];
+    }
+    for (size_t node = num_leaves - 1; node > 0; --node) {
+      nodes[node] = Winner(nodes[2 * node], nodes[2 * node + 1]);
+    }
+    nodes_.swap(nodes);
+    num_leaves_ = num_leaves;
+    runner_up_ = nullptr;
+  }
+
+  Compare cmp_;
+  GetSlot get_slot_;
+  // nodes_[1] is the root, nodes_[i] has children 2i and 2i + 1, and the
+  // leaves start at num_leaves_. nullptr where a slot or subtree is empty.
+  std::vector<T> nodes_;
+  size_t num_leaves_ = 0;
+  size_t size_ = 0;
+  // If not nullptr, the best element outside the slot of top()
+  T runner_up_ = nullptr;
+};
+
 }  // namespace ROCKSDB_NAMESPACE
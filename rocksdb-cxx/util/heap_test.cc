@@ -10,7 +10,9 @@
 #include <climits>
 #include <queue>
 #include <random>
+#include <set>
 #include <utility>
+#include <vector>
 
 #include "port/stack_trace.h"
 
@@ -101,6 +103,95 @@ TEST_P(HeapTest, Test) {
   ASSERT_TRUE(heap.empty());
 }
 
+TEST_P(HeapTest, TournamentTree) {
+  // Same as above for TournamentTree, where elements have their own slots
+  // and, like the children of a merging iterator, change their values in
+  // place before replace_top().
+  const auto MAX_HEAP_SIZE = std::get<0>(GetParam());
+  const auto MAX_VALUE = std::get<1>(GetParam());
+  const auto RNG_SEED = std::get<2>(GetParam());
+
+  struct Element {
+    size_t slot;
+    HeapTestValue value;
+  };
+  struct ElementLess {
+    bool operator()(const Element* a, const Element* b) const {
+      return a->value < b->value;
+    }
+  };
+  struct ElementSlot {
+    size_t operator()(const Element* e) const { return e->slot; }
+  };
+  // Slots of inputs that come and go, more than can be in the tree at once
+  std::vector<Element> elements(MAX_HEAP_SIZE * 2);
+  for (size_t i = 0; i < elements.size(); ++i) {
+    elements[i].slot = i;
+  }
+  std::vector<size_t> free_slots;
+  for (size_t i = 0; i < elements.size(); ++i) {
+    free_slots.push_back(i);
+  }
+
+  TournamentTree<Element*, ElementLess, ElementSlot> tree{ElementLess(),
+                                                          ElementSlot()};
+  std::multiset<HeapTestValue> ref;
+
+  std::mt19937 rng(static_cast<unsigned int>(RNG_SEED));
+  std::uniform_int_distribution<HeapTestValue> value_dist(0, MAX_VALUE);
+  int ndrains = 0;
+  bool draining = false;
+  for (int64_t i = 0; i < FLAGS_iters; ++i) {
+    if (ref.empty()) {
+      draining = false;
+    }
+
+    if (!draining && (ref.empty() || std::bernoulli_distribution(0.4)(rng))) {
+      // insert into a random free slot
+      std::uniform_int_distribution<size_t> slot_dist(0,
+                                                      free_slots.size() - 1);
+      size_t pos = slot_dist(rng);
+      Element* e = &elements[free_slots[pos]];
+      free_slots[pos] = free_slots.back();
+      free_slots.pop_back();
+      e->value = value_dist(rng);
+      tree.push(e);
+      ref.insert(e->value);
+      if (ref.size() == MAX_HEAP_SIZE) {
+        draining = true;
+        ++ndrains;
+      }
+    } else if (std::bernoulli_distribution(0.5)(rng)) {
+      // replace top, often with a value that keeps it on top
+      Element* e = tree.top();
+      ref.erase(ref.find(e->value));
+      if (std::bernoulli_distribution(0.5)(rng)) {
+        e->value = value_dist(rng);
+      } else {
+        e->value += std::min<HeapTestValue>(1, MAX_VALUE - e->value);
+      }
+      tree.replace_top(e);
+      ref.insert(e->value);
+    } else {
+      // pop
+      Element* e = tree.top();
+      tree.pop();
+      ref.erase(ref.find(e->value));
+      free_slots.push_back(e->slot);
+    }
+
+    ASSERT_EQ(ref.size(), tree.size());
+    ASSERT_EQ(ref.empty(), tree.empty());
+    if (!ref.empty()) {
+      ASSERT_EQ(*ref.rbegin(), tree.top()->value);
+    }
+  }
+  assert(ndrains > 0);
+
+  tree.clear();
+  ASSERT_TRUE(tree.empty());
+}
+
 // Basic test, MAX_VALUE = 3*MAX_HEAP_SIZE (occasional duplicates)
 INSTANTIATE_TEST_CASE_P(Basic, HeapTest,
                         ::testing::Values(Params(1000, 3000,
@@ -11,6 +11,13 @@
 #include "rocksdb/rocksdb_namespace.h"
 #include "util/math128.h"
 
+// InterleavedFilterQueryAllColumnsAvx2() is compiled for AVX2 even in
+// portable builds, and callers check CpuSupportsAvx2Query() at runtime.
+#if defined(__GNUC__) && defined(__x86_64__) && !defined(_MSC_VER)
+#define ROCKSDB_RIBBON_AVX2_QUERY
+#include <immintrin.h>
+#endif
+
 namespace ROCKSDB_NAMESPACE {
 
 namespace ribbon {
@@ -1216,9 +1223,165 @@ inline bool InterleavedFilterQuery(
   return true;
 }
 
-// TODO: refactor Interleaved*Query so that queries can be "prepared" by
-// prefetching memory, to hide memory latency for multiple queries in a
-// single thread.
+// Same result as InterleavedFilterQuery, for batches of queries that have
+// all been through InterleavedPrepareQuery first. Rather than stopping at
+// the first mismatching column, this computes all of the result bits and
+// compares them at once. A batch thus avoids a hard to predict branch per
+// column (about half of the columns mismatch for keys not in the filter),
+// and the fixed loop over columns is simple enough for the compiler to
+// vectorize (e.g. with AVX2).
+template <typename InterleavedSolutionStorage, typename FilterQueryHasher>
+inline bool InterleavedFilterQueryAllColumns(
+    typename FilterQueryHasher::Hash hash,
+    typename InterleavedSolutionStorage::Index segment_num,
+    typename InterleavedSolutionStorage::Index num_columns,
+    typename InterleavedSolutionStorage::Index start_bit,
+    const FilterQueryHasher &hasher, const InterleavedSolutionStorage &iss) {
+  using CoeffRow = typename InterleavedSolutionStorage::CoeffRow;
+  using Index = typename InterleavedSolutionStorage::Index;
+  using ResultRow = typename InterleavedSolutionStorage::ResultRow;
+
+  static_assert(sizeof(Index) == sizeof(typename FilterQueryHasher::Index),
+                "must be same");
+  static_assert(
+      sizeof(CoeffRow) == sizeof(typename FilterQueryHasher::CoeffRow),
+      "must be same");
+  static_assert(
+      sizeof(ResultRow) == sizeof(typename FilterQueryHasher::ResultRow),
+      "must be same");
+
+  constexpr auto kCoeffBits = static_cast<Index>(sizeof(CoeffRow) * 8U);
+  constexpr auto kResultBits = static_cast<Index>(sizeof(ResultRow) * 8U);
+
+  const CoeffRow cr = hasher.GetCoeffRow(hash);
+  const ResultRow expected = hasher.GetResultRowFromHash(hash);
+
+  const CoeffRow cr_left = cr << static_cast<unsigned>(start_bit);
+  // With start_bit == 0 there is no right part. Masking the left segments
+  // out again keeps the loads in bounds without a branch.
+  const CoeffRow cr_right =
+      start_bit == 0 ? CoeffRow{0}
+                     : cr >> static_cast<unsigned>(kCoeffBits - start_bit);
+  const Index right_segment_num =
+      segment_num + (start_bit == 0 ? 0 : num_columns);
+
+  ResultRow sr = 0;
+  for (Index i = 0; i < num_columns; ++i) {
+    CoeffRow soln_data = (iss.LoadSegment(segment_num + i) & cr_left) ^
+                         (iss.LoadSegment(right_segment_num + i) & cr_right);
+    sr ^= BitParity(soln_data) << i;
+  }
+  const ResultRow mask =
+      num_columns >= kResultBits
+          ? static_cast<ResultRow>(~ResultRow{0})
+          : static_cast<ResultRow>((ResultRow{1} << num_columns) - 1);
+  return ((sr ^ expected) & mask) == 0;
+}
+
+
+#ifdef ROCKSDB_RIBBON_AVX2_QUERY
+// Whether the CPU supports InterleavedFilterQueryAllColumnsAvx2()
+inline bool CpuSupportsAvx2Query() {
+  static const bool supported = __builtin_cpu_supports("avx2");
+  return supported;
+}
+
+// Same as InterleavedFilterQueryAllColumns for 128-bit coefficient rows,
+// computing the result bits of two columns at a time with AVX2: the left
+// and right segments of both columns are masked and combined in one 256-bit
+// vector, which is then folded down to the parity of each 128-bit half.
+// Only call this if CpuSupportsAvx2Query().
+template <typename InterleavedSolutionStorage, typename FilterQueryHasher>
+__attribute__((__target__("avx2"))) inline bool
+InterleavedFilterQueryAllColumnsAvx2(
+    typename FilterQueryHasher::Hash hash,
+    typename InterleavedSolutionStorage::Index segment_num,
+    typename InterleavedSolutionStorage::Index num_columns,
+    typename InterleavedSolutionStorage::Index start_bit,
+    const FilterQueryHasher &hasher, const InterleavedSolutionStorage &iss) {
+  using CoeffRow = typename InterleavedSolutionStorage::CoeffRow;
+  using Index = typename InterleavedSolutionStorage::Index;
+  using ResultRow = typename InterleavedSolutionStorage::ResultRow;
+
+  static_assert(sizeof(CoeffRow) == 16, "for 128-bit coefficient rows");
+  static_assert(sizeof(Index) == sizeof(typename FilterQueryHasher::Index),
+                "must be same");
+  static_assert(
+      sizeof(CoeffRow) == sizeof(typename FilterQueryHasher::CoeffRow),
+      "must be same");
+  static_assert(
+      sizeof(ResultRow) == sizeof(typename FilterQueryHasher::ResultRow),
+      "must be same");
+
+  constexpr auto kCoeffBits = static_cast<Index>(sizeof(CoeffRow) * 8U);
+  constexpr auto kResultBits = static_cast<Index>(sizeof(ResultRow) * 8U);
+
+  const CoeffRow cr = hasher.GetCoeffRow(hash);
+  const ResultRow expected = hasher.GetResultRowFromHash(hash);
+
+  const CoeffRow cr_left = cr << static_cast<unsigned>(start_bit);
+  const CoeffRow cr_right =
+      start_bit == 0 ? CoeffRow{0}
+                     : cr >> static_cast<unsigned>(kCoeffBits - start_bit);
+  const Index right_segment_num =
+      segment_num + (start_bit == 0 ? 0 : num_columns);
+
+  const __m256i left_mask = _mm256_set_epi64x(
+      static_cast<int64_t>(Upper64of128(cr_left)),
+      static_cast<int64_t>(Lower64of128(cr_left)),
+      static_cast<int64_t>(Upper64of128(cr_left)),
+      static_cast<int64_t>(Lower64of128(cr_left)));
+  const __m256i right_mask = _mm256_set_epi64x(
+      static_cast<int64_t>(Upper64of128(cr_right)),
+      static_cast<int64_t>(Lower64of128(cr_right)),
+      static_cast<int64_t>(Upper64of128(cr_right)),
+      static_cast<int64_t>(Lower64of128(cr_right)));
+
+  ResultRow sr = 0;
+  Index i = 0;
+  for (; i + 2 <= num_columns; i += 2) {
+    const CoeffRow l0 = iss.LoadSegment(segment_num + i);
+    const CoeffRow l1 = iss.LoadSegment(segment_num + i + 1);
+    const CoeffRow r0 = iss.LoadSegment(right_segment_num + i);
+    const CoeffRow r1 = iss.LoadSegment(right_segment_num + i + 1);
+    const __m256i left = _mm256_set_epi64x(
+        static_cast<int64_t>(Upper64of128(l1)),
+        static_cast<int64_t>(Lower64of128(l1)),
+        static_cast<int64_t>(Upper64of128(l0)),
+        static_cast<int64_t>(Lower64of128(l0)));
+    const __m256i right = _mm256_set_epi64x(
+        static_cast<int64_t>(Upper64of128(r1)),
+        static_cast<int64_t>(Lower64of128(r1)),
+        static_cast<int64_t>(Upper64of128(r0)),
+        static_cast<int64_t>(Lower64of128(r0)));
+    __m256i x = _mm256_xor_si256(_mm256_and_si256(left, left_mask),
+                                 _mm256_and_si256(right, right_mask));
+    // Fold the two 64-bit halves of each column, then each 64-bit lane down
+    // to its lowest bit
+    x = _mm256_xor_si256(x, _mm256_shuffle_epi32(x, 0x4E));
+    x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 32));
+    x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 16));
+    x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 8));
+    x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 4));
+    x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 2));
+    x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 1));
+    // Lanes 0 and 2 hold the parities of columns i and i + 1
+    const int lanes =
+        _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_slli_epi64(x, 63)));
+    sr ^= static_cast<ResultRow>((lanes & 1) | ((lanes >> 1) & 2)) << i;
+  }
+  for (; i < num_columns; ++i) {
+    CoeffRow soln_data = (iss.LoadSegment(segment_num + i) & cr_left) ^
+                         (iss.LoadSegment(right_segment_num + i) & cr_right);
+    sr ^= static_cast<ResultRow>(BitParity(soln_data)) << i;
+  }
+  const ResultRow mask =
+      num_columns >= kResultBits
+          ? static_cast<ResultRow>(~ResultRow{0})
+          : static_cast<ResultRow>((ResultRow{1} << num_columns) - 1);
+  return ((sr ^ expected) & mask) == 0;
+}
+#endif  // ROCKSDB_RIBBON_AVX2_QUERY
 
 }  // namespace ribbon
 
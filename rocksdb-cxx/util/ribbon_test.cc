@@ -741,6 +741,33 @@ TYPED_TEST(RibbonTypeParamTest, CompactnessAndBacktrackAndFpRate) {
         }
         isoln_query_nanos += timer.ElapsedNanos();
         isoln_query_count += FLAGS_max_check;
+        // The batch variant of the query agrees
+        for (cur = other_keys_begin;
+             isoln.GetNumStarts() > 0 && cur != other_keys_end; ++cur) {
+          Hash hash;
+          Index segment_num;
+          Index num_columns;
+          Index start_bit;
+          ROCKSDB_NAMESPACE::ribbon::InterleavedPrepareQuery(
+              *cur, hasher, isoln, &hash, &segment_num, &num_columns,
+              &start_bit);
+          ASSERT_EQ(isoln.FilterQuery(*cur, hasher),
+                    ROCKSDB_NAMESPACE::ribbon::InterleavedFilterQueryAllColumns(
+                        hash, segment_num, num_columns, start_bit, hasher,
+                        isoln));
+#ifdef ROCKSDB_RIBBON_AVX2_QUERY
+          if constexpr (sizeof(CoeffRow) == 16) {
+            if (ROCKSDB_NAMESPACE::ribbon::CpuSupportsAvx2Query()) {
+              ASSERT_EQ(
+                  isoln.FilterQuery(*cur, hasher),
+                  ROCKSDB_NAMESPACE::ribbon::
+                      InterleavedFilterQueryAllColumnsAvx2(
+                          hash, segment_num, num_columns, start_bit, hasher,
+                          isoln));
+            }
+          }
+#endif  // ROCKSDB_RIBBON_AVX2_QUERY
+        }
         {
           double expected_fp_count = isoln.ExpectedFpRate() * FLAGS_max_check;
           // For expected FP rate, also include false positives due to
@@ -7,50 +7,50 @@
 #pragma once
 
 #if USE_COROUTINES
-#include <atomic>
+#include <cassert>
+#include <vector>
 
-#include "folly/CPortability.h"
-#include "folly/CppAttributes.h"
-#include "folly/Executor.h"
 #include "util/async_file_reader.h"
+#include "util/coro_task.h"
 
 namespace ROCKSDB_NAMESPACE {
-// Implements a simple executor that runs callback functions in the same
-// thread, unlike CPUThreadExecutor which may schedule the callback on
-// another thread. Runs in a tight loop calling the queued callbacks,
-// and polls for async IO completions when idle. The completions will
-// resume suspended coroutines and they get added to the queue, which
-// will get picked up by this loop.
+// Implements a simple executor that runs a batch of coroutines to completion
+// on the calling thread. Each coroutine runs until it suspends on an async
+// read (or completes), and once none can make progress the executor polls
+// the AsyncFileReader for IO completions, which resumes the suspended
+// coroutines. With the PosixFileSystem and io_uring available, the reads of
+// all coroutines in a batch are in flight in the same ring at once, so the
+// IO of several SST files and levels overlaps.
 // Any possibility of deadlock is precluded because the file system
 // guarantees that async IO completion callbacks will not be scheduled
 // to run in this thread or this executor.
-class SingleThreadExecutor : public folly::Executor {
+class SingleThreadExecutor {
  public:
-  explicit SingleThreadExecutor(AsyncFileReader& reader)
-      : reader_(reader), busy_(false) {}
+  explicit SingleThreadExecutor(AsyncFileReader& reader) : reader_(reader) {}
 
-  void add(folly::Func callback) override {
-    auto& q = q_;
-    q.push(std::move(callback));
-    if (q.size() == 1 && !busy_) {
-      while (!q.empty()) {
-        q.front()();
-        q.pop();
-
-        if (q.empty()) {
-          // Prevent recursion, as the Wait may queue resumed coroutines
-          busy_ = true;
-          reader_.Wait();
-          busy_ = false;
-        }
-      }
+  // Run all tasks to completion and return their results, in order.
+  template <typename T>
+  std::vector<T> CollectAll(std::vector<CoroTask<T>>&& tasks) {
+    for (CoroTask<T>& task : tasks) {
+      task.Start();
+    }
+    while (reader_.HasPending()) {
+      reader_.Wait();
+    }
+    std::vector<T> results;
+    results.reserve(tasks.size());
+    for (CoroTask<T>& task : tasks) {
+      // Tasks only ever suspend on reads, so all of them are done once no
+      // read is outstanding
+      assert(task.IsDone());
+      results.emplace_back(task.TakeResult());
     }
+    tasks.clear();
+    return results;
   }
 
  private:
-  std::queue<folly::Func> q_;
   AsyncFileReader& reader_;
-  bool busy_;
 };
 }  // namespace ROCKSDB_NAMESPACE
 #endif  // USE_COROUTINES
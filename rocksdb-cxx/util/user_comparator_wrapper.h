@@ -15,14 +15,21 @@ namespace ROCKSDB_NAMESPACE {
 
 // Wrapper of user comparator, with auto increment to
 // perf_context.user_key_comparison_count.
+//
+// The wrapper recognizes the built-in BytewiseComparator() and
+// ReverseBytewiseComparator(), by far the most common user comparators, and
+// compares with inlined Slice functions instead of virtual calls. As
+// InternalKeyComparator, DBIter, the memtable and the block iterators all
+// compare through a wrapper, this takes the virtual calls out of their hot
+// loops for column families using those comparators.
 class UserComparatorWrapper {
  public:
   // `UserComparatorWrapper`s constructed with the default constructor are not
   // usable and will segfault on any attempt to use them for comparisons.
-  UserComparatorWrapper() : user_comparator_(nullptr) {}
+  UserComparatorWrapper() : user_comparator_(nullptr), kind_(Kind::kCustom) {}
 
   explicit UserComparatorWrapper(const Comparator* const user_cmp)
-      : user_comparator_(user_cmp) {}
+      : user_comparator_(user_cmp), kind_(KindOf(user_cmp)) {}
 
   ~UserComparatorWrapper() = default;
 
@@ -30,11 +37,14 @@ class UserComparatorWrapper {
 
   int Compare(const Slice& a, const Slice& b) const {
     PERF_COUNTER_ADD(user_key_comparison_count, 1);
-    return user_comparator_->Compare(a, b);
+    return CompareImpl(a, b);
   }
 
   bool Equal(const Slice& a, const Slice& b) const {
     PERF_COUNTER_ADD(user_key_comparison_count, 1);
+    if (kind_ != Kind::kCustom) {
+      return a == b;
+    }
     return user_comparator_->Equal(a, b);
   }
 
@@ -44,21 +54,62 @@ class UserComparatorWrapper {
 
   int CompareWithoutTimestamp(const Slice& a, const Slice& b) const {
     PERF_COUNTER_ADD(user_key_comparison_count, 1);
+    if (kind_ != Kind::kCustom) {
+      return CompareImpl(a, b);
+    }
     return user_comparator_->CompareWithoutTimestamp(a, b);
   }
 
   int CompareWithoutTimestamp(const Slice& a, bool a_has_ts, const Slice& b,
                               bool b_has_ts) const {
     PERF_COUNTER_ADD(user_key_comparison_count, 1);
+    if (kind_ != Kind::kCustom) {
+      // No timestamps
+      return CompareImpl(a, b);
+    }
     return user_comparator_->CompareWithoutTimestamp(a, a_has_ts, b, b_has_ts);
   }
 
   bool EqualWithoutTimestamp(const Slice& a, const Slice& b) const {
+    if (kind_ != Kind::kCustom) {
+      return a == b;
+    }
     return user_comparator_->EqualWithoutTimestamp(a, b);
   }
 
  private:
+  enum class Kind : uint8_t {
+    kCustom,
+    // BytewiseComparator()
+    kBytewise,
+    // ReverseBytewiseComparator()
+    kReverseBytewise,
+  };
+
+  static Kind KindOf(const Comparator* user_cmp) {
+    if (user_cmp != nullptr) {
+      if (user_cmp == BytewiseComparator()) {
+        return Kind::kBytewise;
+      } else if (user_cmp == ReverseBytewiseComparator()) {
+        return Kind::kReverseBytewise;
+      }
+    }
+    return Kind::kCustom;
+  }
+
+  int CompareImpl(const Slice& a, const Slice& b) const {
+    switch (kind_) {
+      case Kind::kBytewise:
+        return a.compare(b);
+      case Kind::kReverseBytewise:
+        return -a.compare(b);
+      default:
+        return user_comparator_->Compare(a, b);
+    }
+  }
+
   const Comparator* user_comparator_;
+  Kind kind_;
 };
 
 }  // namespace ROCKSDB_NAMESPACE